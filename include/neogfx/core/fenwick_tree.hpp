@@ -0,0 +1,161 @@
+// fenwick_tree.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <vector>
+
+namespace neogfx
+{
+    // Binary indexed (Fenwick) tree of non-negative values supporting O(log n) update of a single value, O(log n)
+    // prefix sums and O(log n) search for the element containing a given prefix sum (e.g. the row at a position).
+    template <typename T, typename Allocator = std::allocator<T>>
+    class fenwick_tree
+    {
+    public:
+        typedef T value_type;
+        typedef Allocator allocator_type;
+        typedef std::size_t size_type;
+    public:
+        struct bad_index : std::logic_error { bad_index() : std::logic_error("neogfx::fenwick_tree::bad_index") {} };
+    public:
+        fenwick_tree(const allocator_type& aAllocator = allocator_type{}) :
+            iTree{ aAllocator }
+        {
+        }
+    public:
+        size_type size() const
+        {
+            return iTree.size();
+        }
+        bool empty() const
+        {
+            return iTree.empty();
+        }
+        void clear()
+        {
+            iTree.clear();
+        }
+        // O(n)
+        void assign(size_type aCount, const value_type& aValue)
+        {
+            iTree.resize(aCount);
+            // node i (one based) covers the lowbit(i) values ending at i
+            for (size_type i = 1u; i <= aCount; ++i)
+                iTree[i - 1u] = aValue * static_cast<value_type>(i & (~i + 1u));
+        }
+        // O(n)
+        template <typename Iter>
+        void assign(Iter aFirst, Iter aLast)
+        {
+            iTree.assign(aFirst, aLast);
+            build();
+        }
+        // O(n); the values after aIndex keep their values but move up by aCount
+        void insert(size_type aIndex, size_type aCount, const value_type& aValue)
+        {
+            if (aIndex > size())
+                throw bad_index();
+            unbuild();
+            iTree.insert(std::next(iTree.begin(), aIndex), aCount, aValue);
+            build();
+        }
+        // O(n); the values after aLast keep their values but move down
+        void erase(size_type aFirst, size_type aLast)
+        {
+            if (aFirst > aLast || aLast > size())
+                throw bad_index();
+            unbuild();
+            iTree.erase(std::next(iTree.begin(), aFirst), std::next(iTree.begin(), aLast));
+            build();
+        }
+        value_type value(size_type aIndex) const
+        {
+            if (aIndex >= size())
+                throw bad_index();
+            return prefix_sum(aIndex + 1u) - prefix_sum(aIndex);
+        }
+        void set(size_type aIndex, const value_type& aValue)
+        {
+            add(aIndex, aValue - value(aIndex));
+        }
+        void add(size_type aIndex, const value_type& aDelta)
+        {
+            if (aIndex >= size())
+                throw bad_index();
+            for (auto i = aIndex + 1u; i <= size(); i += (i & (~i + 1u)))
+                iTree[i - 1u] += aDelta;
+        }
+        // sum of the first aCount values
+        value_type prefix_sum(size_type aCount) const
+        {
+            if (aCount > size())
+                throw bad_index();
+            value_type sum{};
+            for (auto i = aCount; i > 0u; i -= (i & (~i + 1u)))
+                sum += iTree[i - 1u];
+            return sum;
+        }
+        value_type total() const
+        {
+            return prefix_sum(size());
+        }
+        // index of the element spanning aSum, i.e. the number of leading values whose sum does not exceed aSum;
+        // returns size() if aSum is at or beyond the total
+        size_type find(value_type aSum) const
+        {
+            size_type index = 0u;
+            size_type step = 1u;
+            while (step <= size() / 2u)
+                step *= 2u;
+            for (; step > 0u; step /= 2u)
+                if (index + step <= size() && iTree[index + step - 1u] <= aSum)
+                {
+                    index += step;
+                    aSum -= iTree[index - 1u];
+                }
+            return index;
+        }
+    private:
+        // turns a vector of values into the tree: each node passes its partial sum on to the node covering it
+        void build()
+        {
+            for (size_type i = 1u; i <= size(); ++i)
+            {
+                auto const parent = i + (i & (~i + 1u));
+                if (parent <= size())
+                    iTree[parent - 1u] += iTree[i - 1u];
+            }
+        }
+        // the inverse of build(), done in reverse so that each node's partial sum is still complete when it is taken
+        // back from the node covering it
+        void unbuild()
+        {
+            for (size_type i = size(); i >= 1u; --i)
+            {
+                auto const parent = i + (i & (~i + 1u));
+                if (parent <= size())
+                    iTree[parent - 1u] -= iTree[i - 1u];
+            }
+        }
+    private:
+        std::vector<value_type, allocator_type> iTree;
+    };
+}
\ No newline at end of file
@@ -20,6 +20,9 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <boost/pool/pool_alloc.hpp>
 #include <neolib/core/vecarray.hpp>
 #include <neolib/core/lifetime.hpp>
@@ -42,7 +45,85 @@ namespace neogfx::game
     public:
         typedef const void* const_iterator; // todo
         typedef void* iterator; // todo
+    public:
+        typedef std::pair<entity_id, entity_id> collision_pair;
+        static constexpr std::size_t MinimumCandidatesPerThread = 256;
     private:
+        // Threads are started on first use and kept for the lifetime of the tree so per-frame parallel
+        // detection doesn't pay for thread creation; run() uses the calling thread as worker zero.
+        class worker_pool
+        {
+        public:
+            worker_pool() : iJob{ nullptr }, iGeneration{ 0 }, iActive{ 0 }, iPending{ 0 }, iStop{ false }
+            {
+            }
+            ~worker_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ iMutex };
+                    iStop = true;
+                }
+                iWork.notify_all();
+                for (auto& thread : iThreads)
+                    thread.join();
+            }
+        public:
+            void run(uint32_t aThreadCount, const std::function<void(uint32_t)>& aJob)
+            {
+                if (aThreadCount <= 1)
+                {
+                    aJob(0);
+                    return;
+                }
+                while (iThreads.size() + 1 < aThreadCount)
+                {
+                    auto const index = static_cast<uint32_t>(iThreads.size() + 1);
+                    auto const generation = iGeneration;
+                    iThreads.emplace_back([this, index, generation]() { work(index, generation); });
+                }
+                {
+                    std::lock_guard<std::mutex> lock{ iMutex };
+                    iJob = &aJob;
+                    iActive = aThreadCount;
+                    iPending = aThreadCount - 1;
+                    ++iGeneration;
+                }
+                iWork.notify_all();
+                aJob(0);
+                std::unique_lock<std::mutex> lock{ iMutex };
+                iDone.wait(lock, [this]() { return iPending == 0; });
+            }
+        private:
+            void work(uint32_t aIndex, uint64_t aGeneration)
+            {
+                std::unique_lock<std::mutex> lock{ iMutex };
+                for (;;)
+                {
+                    iWork.wait(lock, [&]() { return iStop || iGeneration != aGeneration; });
+                    if (iStop)
+                        return;
+                    aGeneration = iGeneration;
+                    if (aIndex >= iActive)
+                        continue;
+                    auto const& job = *iJob;
+                    lock.unlock();
+                    job(aIndex);
+                    lock.lock();
+                    if (--iPending == 0)
+                        iDone.notify_one();
+                }
+            }
+        private:
+            std::mutex iMutex;
+            std::condition_variable iWork;
+            std::condition_variable iDone;
+            std::vector<std::thread> iThreads;
+            const std::function<void(uint32_t)>* iJob;
+            uint64_t iGeneration;
+            uint32_t iActive;
+            uint32_t iPending;
+            bool iStop;
+        };
         class node : public neolib::lifetime
         {
         private:
@@ -55,17 +136,18 @@ namespace neogfx::game
         public:
             node(aabb_quadtree& aTree, const aabb_2d& aAabb) : iTree{ aTree }, iParent{ nullptr }, iDepth{ 1 }, iAabb { aAabb }, iChildren{}
             {
-                iTree.iDepth = std::max(iTree.iDepth, iDepth);
+                iTree.node_created(iDepth);
                 populate_quadrants();
             }
             node(const node& aParent, const aabb_2d& aAabb) : iTree{ aParent.iTree }, iParent{ &aParent }, iDepth{ aParent.iDepth + 1 }, iAabb { aAabb }, iChildren{}
             {
-                iTree.iDepth = std::max(iTree.iDepth, iDepth);
+                iTree.node_created(iDepth);
                 populate_quadrants();
             }
             ~node()
             {
                 set_destroying();
+                iTree.node_destroyed(iDepth);
                 if (has_child<0, 0>())
                     remove_child<0, 0>();
                 if (has_child<0, 1>())
@@ -100,19 +182,18 @@ namespace neogfx::game
             {
                 return iAabb;
             }
-            void add_entity(entity_id aEntity, const collider_type& aCollider)
+            void add_entity(entity_id aEntity, const aabb_2d& aAabb)
             {
-                iTree.iDepth = std::max(iTree.iDepth, iDepth);
                 if (is_split())
                 {
-                    if (aabb_intersects(iQuadrants[0][0], aCollider.currentAabb))
-                        child<0, 0>().add_entity(aEntity, aCollider);
-                    if (aabb_intersects(iQuadrants[0][1], aCollider.currentAabb))
-                        child<0, 1>().add_entity(aEntity, aCollider);
-                    if (aabb_intersects(iQuadrants[1][0], aCollider.currentAabb))
-                        child<1, 0>().add_entity(aEntity, aCollider);
-                    if (aabb_intersects(iQuadrants[1][1], aCollider.currentAabb))
-                        child<1, 1>().add_entity(aEntity, aCollider);
+                    if (aabb_intersects(iQuadrants[0][0], aAabb))
+                        child<0, 0>().add_entity(aEntity, aAabb);
+                    if (aabb_intersects(iQuadrants[0][1], aAabb))
+                        child<0, 1>().add_entity(aEntity, aAabb);
+                    if (aabb_intersects(iQuadrants[1][0], aAabb))
+                        child<1, 0>().add_entity(aEntity, aAabb);
+                    if (aabb_intersects(iQuadrants[1][1], aAabb))
+                        child<1, 1>().add_entity(aEntity, aAabb);
                 }
                 else
                 {
@@ -121,41 +202,33 @@ namespace neogfx::game
                         split();
                 }
             }
-            void remove_entity(entity_id aEntity, const collider_type& aCollider)
+            void remove_entity(entity_id aEntity, const aabb_2d& aAabb)
             {
-                if (aCollider.previousAabb && aCollider.currentAabb)
-                    remove_entity(aEntity, aCollider, aabb_union(*aCollider.previousAabb, *aCollider.currentAabb));
-            }
-            void remove_entity(entity_id aEntity, const collider_type& aCollider, const aabb_2d& aAabb)
-            {
-                if (!aabb_intersects(aCollider.currentAabb, iAabb))
+                auto existing = std::find(iEntities.begin(), iEntities.end(), aEntity);
+                if (existing != iEntities.end())
+                    iEntities.erase(existing);
+                if (has_child<0, 0>() && aabb_intersects(iQuadrants[0][0], aAabb))
                 {
-                    auto existing = std::find(iEntities.begin(), iEntities.end(), aEntity);
-                    if (existing != iEntities.end())
-                        iEntities.erase(existing);
+                    child<0, 0>().remove_entity(aEntity, aAabb);
+                    prune_child<0, 0>();
                 }
-                if (has_child<0, 0>() && aabb_intersects(iQuadrants[0][0], aAabb))
-                    child<0, 0>().remove_entity(aEntity, aCollider, aAabb);
                 if (has_child<0, 1>() && aabb_intersects(iQuadrants[0][1], aAabb))
-                    child<0, 1>().remove_entity(aEntity, aCollider, aAabb);
+                {
+                    child<0, 1>().remove_entity(aEntity, aAabb);
+                    prune_child<0, 1>();
+                }
                 if (has_child<1, 0>() && aabb_intersects(iQuadrants[1][0], aAabb))
-                    child<1, 0>().remove_entity(aEntity, aCollider, aAabb);
+                {
+                    child<1, 0>().remove_entity(aEntity, aAabb);
+                    prune_child<1, 0>();
+                }
                 if (has_child<1, 1>() && aabb_intersects(iQuadrants[1][1], aAabb))
-                    child<1, 1>().remove_entity(aEntity, aCollider, aAabb);
-                if (empty())
-                    iTree.destroy_node(*this);
-            }
-            void update_entity(entity_id aEntity, const collider_type& aCollider)
-            {
-                iTree.iDepth = std::max(iTree.iDepth, iDepth);
-                auto const& currentAabb = aCollider.currentAabb;
-                auto const& previousAabb = aCollider.previousAabb;
-                if (currentAabb == previousAabb)
-                    return;
-                if (aabb_intersects(currentAabb, iAabb))
-                    add_entity(aEntity, aCollider);
-                if (aabb_intersects(previousAabb, iAabb))
-                    remove_entity(aEntity, aCollider, previousAabb);
+                {
+                    child<1, 1>().remove_entity(aEntity, aAabb);
+                    prune_child<1, 1>();
+                }
+                if (is_split() && !has_child<0, 0>() && !has_child<0, 1>() && !has_child<1, 0>() && !has_child<1, 1>())
+                    iChildren = std::nullopt;
             }
             bool empty() const
             {
@@ -270,6 +343,18 @@ namespace neogfx::game
                 }
                 return false;
             }
+            template <std::size_t X, std::size_t Y>
+            void prune_child()
+            {
+                auto& c = (*iChildren)[X][Y];
+                if (c != nullptr && !c->is_split() && c->entities().empty())
+                {
+                    auto n = c;
+                    c = nullptr;
+                    n->iParent = nullptr; // detach so destruction doesn't unsplit (and possibly destroy) us mid-removal
+                    iTree.destroy_node(*n);
+                }
+            }
             bool is_split() const
             {
                 return iChildren != std::nullopt;
@@ -278,15 +363,15 @@ namespace neogfx::game
             {
                 for (auto e : entities())
                 {
-                    auto const& collider = iTree.iEcs.component<collider_type>().entity_record(e);
-                    if (aabb_intersects(iQuadrants[0][0], collider.currentAabb))
-                        child<0, 0>().add_entity(e, collider);
-                    if (aabb_intersects(iQuadrants[0][1], collider.currentAabb))
-                        child<0, 1>().add_entity(e, collider);
-                    if (aabb_intersects(iQuadrants[1][0], collider.currentAabb))
-                        child<1, 0>().add_entity(e, collider);
-                    if (aabb_intersects(iQuadrants[1][1], collider.currentAabb))
-                        child<1, 1>().add_entity(e, collider);
+                    auto const& treeAabb = *iTree.iEcs.component<collider_type>().entity_record(e).fatAabb;
+                    if (aabb_intersects(iQuadrants[0][0], treeAabb))
+                        child<0, 0>().add_entity(e, treeAabb);
+                    if (aabb_intersects(iQuadrants[0][1], treeAabb))
+                        child<0, 1>().add_entity(e, treeAabb);
+                    if (aabb_intersects(iQuadrants[1][0], treeAabb))
+                        child<1, 0>().add_entity(e, treeAabb);
+                    if (aabb_intersects(iQuadrants[1][1], treeAabb))
+                        child<1, 1>().add_entity(e, treeAabb);
                 }
                 iEntities.clear();
             }
@@ -317,14 +402,17 @@ namespace neogfx::game
         };
         typedef typename allocator_type::template rebind<node>::other node_allocator;
     public:
-        aabb_quadtree(i_ecs& aEcs, const aabb_2d& aRootAabb = aabb_2d{ vec2{-4096.0, -4096.0}, vec2{4096.0, 4096.0} }, scalar aMinimumQuadrantSize = 16.0, const allocator_type& aAllocator = allocator_type{}) :
+        aabb_quadtree(i_ecs& aEcs, const aabb_2d& aRootAabb = aabb_2d{ vec2{-4096.0, -4096.0}, vec2{4096.0, 4096.0} }, scalar aMinimumQuadrantSize = 16.0, scalar aFatAabbMargin = 8.0, const allocator_type& aAllocator = allocator_type{}) :
             iAllocator{ aAllocator },
             iEcs{ aEcs },
             iRootAabb{ aRootAabb },
+            iMinimumQuadrantSize{ aMinimumQuadrantSize },
+            iFatAabbMargin{ aFatAabbMargin },
             iCount{ 0 },
-            iDepth{ 0 },
+            iNodesAtDepth{},
             iRootNode{ *this, aRootAabb },
-            iMinimumQuadrantSize{ aMinimumQuadrantSize },
+            iEntityCount{ 0 },
+            iReinsertCount{ 0 },
             iCollisionUpdateId{ 0 }
         {
         }
@@ -333,25 +421,65 @@ namespace neogfx::game
         {
             return iMinimumQuadrantSize;
         }
+        scalar fat_aabb_margin() const
+        {
+            return iFatAabbMargin;
+        }
         void full_update()
         {
-            iDepth = 0;
             iRootNode.~node();
             new(&iRootNode) node{ *this, iRootAabb };
-            for (auto entity : iEcs.component<collider_type>().entities())
+            iEntityCount = 0;
+            iReinsertCount = 0;
+            auto& colliders = iEcs.component<collider_type>();
+            auto const& infos = iEcs.component<entity_info>();
+            for (auto entity : colliders.entities())
             {
-                auto& collider = iEcs.component<collider_type>().entity_record(entity);
-                iRootNode.add_entity(entity, collider);
+                auto& collider = colliders.entity_record(entity);
+                if (infos.entity_record(entity).destroyed || !collider.currentAabb)
+                {
+                    collider.fatAabb = std::nullopt;
+                    continue;
+                }
+                collider.fatAabb = fat_aabb(*collider.currentAabb);
+                iRootNode.add_entity(entity, *collider.fatAabb);
+                ++iEntityCount;
+                ++iReinsertCount;
             }
         }
         void dynamic_update()
         {
-            iDepth = 0;
-            for (auto entity : iEcs.component<collider_type>().entities())
+            iReinsertCount = 0;
+            uint32_t liveEntities = 0;
+            auto& colliders = iEcs.component<collider_type>();
+            auto const& infos = iEcs.component<entity_info>();
+            for (auto entity : colliders.entities())
             {
-                auto& collider = iEcs.component<collider_type>().entity_record(entity);
-                iRootNode.update_entity(entity, collider);
+                auto& collider = colliders.entity_record(entity);
+                if (infos.entity_record(entity).destroyed || !collider.currentAabb)
+                {
+                    if (collider.fatAabb)
+                    {
+                        iRootNode.remove_entity(entity, *collider.fatAabb);
+                        collider.fatAabb = std::nullopt;
+                        --iEntityCount;
+                    }
+                    continue;
+                }
+                ++liveEntities;
+                if (collider.fatAabb && aabb_contains(*collider.fatAabb, *collider.currentAabb))
+                    continue;
+                if (collider.fatAabb)
+                    iRootNode.remove_entity(entity, *collider.fatAabb);
+                else
+                    ++iEntityCount;
+                collider.fatAabb = fat_aabb(*collider.currentAabb);
+                iRootNode.add_entity(entity, *collider.fatAabb);
+                ++iReinsertCount;
             }
+            // entities purged from the ECS without us seeing them destroyed leave stale entries behind; rebuild if so
+            if (liveEntities != iEntityCount)
+                full_update();
         }
         template <typename CollisionAction>
         void collisions(CollisionAction aCollisionAction) const
@@ -383,6 +511,38 @@ namespace neogfx::game
                 });
             }
         }
+        // Candidates are partitioned into contiguous runs across aThreadCount threads (0 = hardware concurrency)
+        // taken from a persistent worker pool. Each thread collects the pairs its candidates would report into
+        // its own buffer and the buffers are replayed in run order, so pairs are reported in exactly the order
+        // collisions() reports them whatever the number of threads used.
+        template <typename CollisionAction>
+        void parallel_collisions(CollisionAction aCollisionAction, uint32_t aThreadCount = 0) const
+        {
+            auto const& candidates = iEcs.component<collider_type>().entities();
+            if (aThreadCount == 0)
+                aThreadCount = std::max(1u, std::thread::hardware_concurrency());
+            auto const threadCount = static_cast<uint32_t>(std::max<std::size_t>(1,
+                std::min<std::size_t>(aThreadCount, candidates.size() / MinimumCandidatesPerThread)));
+            iPairBuffers.resize(threadCount);
+            iWorkers.run(threadCount, [&](uint32_t aThread)
+            {
+                auto& buffer = iPairBuffers[aThread];
+                buffer.clear();
+                auto const first = std::next(candidates.begin(), candidates.size() * aThread / threadCount);
+                auto const last = std::next(candidates.begin(), candidates.size() * (aThread + 1) / threadCount);
+                for (auto candidate = first; candidate != last; ++candidate)
+                    candidate_collisions(*candidate, buffer);
+            });
+            auto const& infos = iEcs.component<entity_info>();
+            for (auto const& buffer : iPairBuffers)
+                for (auto const& pair : buffer)
+                {
+                    // an earlier collision action may have destroyed one of the pair
+                    if (infos.entity_record(pair.first).destroyed || infos.entity_record(pair.second).destroyed)
+                        continue;
+                    aCollisionAction(pair.first, pair.second);
+                }
+        }
         template <typename ResultContainer>
         void pick(const vec2& aPoint, ResultContainer& aResult, std::function<bool(entity_id aMatch, const vec2& aPoint)> aColliderPredicate = [](entity_id, const vec2&) { return true; }) const
         {
@@ -414,7 +574,15 @@ namespace neogfx::game
         }
         uint32_t depth() const
         {
-            return iDepth;
+            return static_cast<uint32_t>(iNodesAtDepth.size());
+        }
+        uint32_t entity_count() const
+        {
+            return iEntityCount;
+        }
+        uint32_t reinsert_count() const
+        {
+            return iReinsertCount;
         }
     public:
         const node& root_node() const
@@ -422,6 +590,49 @@ namespace neogfx::game
             return iRootNode;
         }
     private:
+        aabb_2d fat_aabb(const aabb_2d& aAabb) const
+        {
+            auto const margin = vec2{ iFatAabbMargin, iFatAabbMargin };
+            return aabb_2d{ aAabb.min - margin, aAabb.max + margin };
+        }
+        // the pairs collisions() would report for aCandidate, in the same order; the shared collisionEventId
+        // stamp used there to skip hits reached through more than one quadrant is replaced by a search of the
+        // candidate's own (short) run of pairs so threads never write to colliders
+        void candidate_collisions(entity_id aCandidate, std::vector<collision_pair>& aPairs) const
+        {
+            auto const& colliders = iEcs.component<collider_type>();
+            auto const& infos = iEcs.component<entity_info>();
+            if (infos.entity_record(aCandidate).destroyed)
+                return;
+            auto const& candidateCollider = colliders.entity_record(aCandidate);
+            auto const firstPair = aPairs.size();
+            iRootNode.visit(candidateCollider, [&](entity_id aHit)
+            {
+                if (aCandidate < aHit && !infos.entity_record(aHit).destroyed &&
+                    (candidateCollider.mask & colliders.entity_record(aHit).mask) == 0 &&
+                    std::find(std::next(aPairs.begin(), firstPair), aPairs.end(), collision_pair{ aCandidate, aHit }) == aPairs.end())
+                    aPairs.emplace_back(aCandidate, aHit);
+            });
+        }
+        static bool aabb_contains(const aabb_2d& aOuter, const aabb_2d& aInner)
+        {
+            return aInner.min.x >= aOuter.min.x && aInner.min.y >= aOuter.min.y &&
+                aInner.max.x <= aOuter.max.x && aInner.max.y <= aOuter.max.y;
+        }
+        // depth is tracked as a count of live nodes at each level so it shrinks again as branches are
+        // pruned by re-insertion and removal rather than only ever recording the deepest split seen
+        void node_created(uint32_t aDepth)
+        {
+            if (iNodesAtDepth.size() < aDepth)
+                iNodesAtDepth.resize(aDepth);
+            ++iNodesAtDepth[aDepth - 1];
+        }
+        void node_destroyed(uint32_t aDepth)
+        {
+            --iNodesAtDepth[aDepth - 1];
+            while (!iNodesAtDepth.empty() && iNodesAtDepth.back() == 0)
+                iNodesAtDepth.pop_back();
+        }
         node* create_node(const node& aParent, const aabb_2d& aAabb)
         {
             ++iCount;
@@ -443,9 +654,14 @@ namespace neogfx::game
         i_ecs& iEcs;
         aabb_2d iRootAabb;
         scalar iMinimumQuadrantSize;
+        scalar iFatAabbMargin;
         uint32_t iCount;
-        mutable uint32_t iDepth;
+        std::vector<uint32_t> iNodesAtDepth;
         node iRootNode;
+        uint32_t iEntityCount;
+        uint32_t iReinsertCount;
         mutable uint32_t iCollisionUpdateId;
+        mutable std::vector<std::vector<collision_pair>> iPairBuffers;
+        mutable worker_pool iWorkers;
     };
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+// barnes_hut_tree.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/core/numerical.hpp>
+
+namespace neogfx::game
+{
+    // Octree of centres of mass used to approximate universal gravitation in O(n log n).
+    class barnes_hut_tree
+    {
+    public:
+        static constexpr scalar DefaultTheta = 0.5;
+        static constexpr uint32_t MaximumDepth = 32;
+    private:
+        static constexpr uint32_t NoChild = static_cast<uint32_t>(-1);
+        struct body
+        {
+            vec3 position;
+            scalar mass;
+        };
+        struct node
+        {
+            vec3 centre;
+            scalar halfSize;
+            vec3 weightedPosition;
+            scalar mass;
+            vec3 centreOfMass;
+            uint32_t bodyCount;
+            uint32_t body;
+            bool split;
+            std::array<uint32_t, 8> children;
+        };
+    public:
+        barnes_hut_tree(scalar aTheta = DefaultTheta) :
+            iTheta{ aTheta }
+        {
+        }
+    public:
+        scalar theta() const
+        {
+            return iTheta;
+        }
+        void set_theta(scalar aTheta)
+        {
+            iTheta = aTheta;
+        }
+        void clear()
+        {
+            iBodies.clear();
+            iNodes.clear();
+        }
+        void add(const vec3& aPosition, scalar aMass)
+        {
+            if (aMass != 0.0)
+                iBodies.push_back(body{ aPosition, aMass });
+        }
+        void build()
+        {
+            iNodes.clear();
+            if (iBodies.empty())
+                return;
+            vec3 min = iBodies[0].position;
+            vec3 max = iBodies[0].position;
+            for (auto const& b : iBodies)
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    min[axis] = std::min(min[axis], b.position[axis]);
+                    max[axis] = std::max(max[axis], b.position[axis]);
+                }
+            auto const extents = max - min;
+            auto const halfSize = std::max(std::max(extents.x, extents.y), std::max(extents.z, 1.0)) / 2.0 * (1.0 + 1e-6);
+            new_node((min + max) / 2.0, halfSize);
+            for (uint32_t b = 0u; b < iBodies.size(); ++b)
+                insert(b);
+            for (auto& n : iNodes)
+                n.centreOfMass = n.weightedPosition / n.mass;
+        }
+        uint32_t node_count() const
+        {
+            return static_cast<uint32_t>(iNodes.size());
+        }
+    public:
+        // Returns the gravitational force exerted on the body of mass aMass at aPosition, which must have been added to
+        // the tree, by every other body in the tree. Nodes on the body's own path from the root are never approximated
+        // by their centre of mass (which includes the body itself) but are always opened, and the body's contribution is
+        // removed from the leaf holding it; other bodies coincident with aPosition are ignored as they are by the exact
+        // solver.
+        vec3 force(const vec3& aPosition, scalar aMass, scalar aGravitationalConstant) const
+        {
+            vec3 result;
+            if (iNodes.empty() || aMass == 0.0)
+                return result;
+            thread_local std::vector<std::pair<uint32_t, bool>> stack;
+            stack.clear();
+            stack.emplace_back(0u, true);
+            while (!stack.empty())
+            {
+                auto const [index, holdsBody] = stack.back();
+                auto const& n = iNodes[index];
+                stack.pop_back();
+                if (n.split)
+                {
+                    vec3 const distance = aPosition - n.centreOfMass;
+                    if (holdsBody || n.halfSize * 2.0 >= iTheta * distance.magnitude())
+                    {
+                        auto const bodyOctant = holdsBody ? octant(n, aPosition) : NoChild;
+                        for (uint32_t o = 0u; o < 8u; ++o)
+                            if (n.children[o] != NoChild)
+                                stack.emplace_back(n.children[o], o == bodyOctant);
+                        continue;
+                    }
+                    result += attraction(distance, n.mass, aMass, aGravitationalConstant);
+                    continue;
+                }
+                auto mass = n.mass;
+                auto weightedPosition = n.weightedPosition;
+                if (holdsBody)
+                {
+                    mass -= aMass;
+                    weightedPosition -= aMass * aPosition;
+                }
+                if (mass <= 0.0)
+                    continue;
+                result += attraction(aPosition - weightedPosition / mass, mass, aMass, aGravitationalConstant);
+            }
+            return result;
+        }
+    private:
+        static vec3 attraction(const vec3& aDistance, scalar aSourceMass, scalar aMass, scalar aGravitationalConstant)
+        {
+            auto const magnitude = aDistance.magnitude();
+            if (magnitude == 0.0)
+                return vec3{};
+            return -aGravitationalConstant * aSourceMass * aMass * aDistance / std::pow(magnitude, 3.0);
+        }
+        static uint32_t octant(const node& aNode, const vec3& aPosition)
+        {
+            return
+                (aPosition.x >= aNode.centre.x ? 1u : 0u) |
+                (aPosition.y >= aNode.centre.y ? 2u : 0u) |
+                (aPosition.z >= aNode.centre.z ? 4u : 0u);
+        }
+        uint32_t new_node(const vec3& aCentre, scalar aHalfSize)
+        {
+            iNodes.push_back(node{ aCentre, aHalfSize, vec3{}, 0.0, vec3{}, 0u, NoChild, false, {} });
+            iNodes.back().children.fill(NoChild);
+            return static_cast<uint32_t>(iNodes.size() - 1u);
+        }
+        uint32_t child_for(uint32_t aNode, const vec3& aPosition)
+        {
+            auto const& n = iNodes[aNode];
+            auto const childOctant = octant(n, aPosition);
+            if (n.children[childOctant] == NoChild)
+            {
+                auto const quarterSize = n.halfSize / 2.0;
+                vec3 const childCentre{
+                    n.centre.x + ((childOctant & 1u) ? quarterSize : -quarterSize),
+                    n.centre.y + ((childOctant & 2u) ? quarterSize : -quarterSize),
+                    n.centre.z + ((childOctant & 4u) ? quarterSize : -quarterSize) };
+                auto const child = new_node(childCentre, quarterSize);
+                iNodes[aNode].children[childOctant] = child;
+            }
+            return iNodes[aNode].children[childOctant];
+        }
+        void insert(uint32_t aBody)
+        {
+            auto const& b = iBodies[aBody];
+            uint32_t current = 0u;
+            for (uint32_t depth = 0u;; ++depth)
+            {
+                auto& n = iNodes[current];
+                if (!n.split && (n.bodyCount == 0u || depth >= MaximumDepth))
+                {
+                    // empty leaf or maximum depth reached (coincident bodies): accumulate here
+                    n.weightedPosition += b.mass * b.position;
+                    n.mass += b.mass;
+                    ++n.bodyCount;
+                    n.body = aBody;
+                    return;
+                }
+                if (!n.split)
+                {
+                    // single body leaf: push its body down a level (routed by its exact position so force()
+                    // can follow the same path to find the leaf holding a body)
+                    n.split = true;
+                    auto const& existing = iBodies[n.body];
+                    auto const existingChild = child_for(current, existing.position);
+                    auto& e = iNodes[existingChild];
+                    e.weightedPosition = existing.mass * existing.position;
+                    e.mass = existing.mass;
+                    e.bodyCount = 1u;
+                    e.body = iNodes[current].body;
+                }
+                auto& parent = iNodes[current];
+                parent.weightedPosition += b.mass * b.position;
+                parent.mass += b.mass;
+                ++parent.bodyCount;
+                current = child_for(current, b.position);
+            }
+        }
+    private:
+        scalar iTheta;
+        std::vector<body> iBodies;
+        std::vector<node> iNodes;
+    };
+}
\ No newline at end of file
@@ -88,6 +88,7 @@ namespace neogfx::game
         std::optional<aabb_2d> previousAabb;
         std::optional<aabb_2d> currentAabb;
         uint32_t collisionEventId;
+        std::optional<aabb_2d> fatAabb;
 
         struct meta : i_component_data::meta
         {
@@ -103,7 +104,7 @@ namespace neogfx::game
             }
             static uint32_t field_count()
             {
-                return 5;
+                return 6;
             }
             static component_data_field_type field_type(uint32_t aFieldIndex)
             {
@@ -117,6 +118,8 @@ namespace neogfx::game
                     return component_data_field_type::Aabb2d | component_data_field_type::Optional | component_data_field_type::Internal;
                 case 4:
                     return component_data_field_type::Uint32 | component_data_field_type::Internal;
+                case 5:
+                    return component_data_field_type::Aabb2d | component_data_field_type::Optional | component_data_field_type::Internal;
                 default:
                     throw invalid_field_index();
                 }
@@ -129,7 +132,8 @@ namespace neogfx::game
                     "AABB (Untransformed)",
                     "AABB (Previous)",
                     "AABB (Current)",
-                    "Collision Event Id"
+                    "Collision Event Id",
+                    "AABB (Fat)"
                 };
                 return sFieldNames[aFieldIndex];
             }
@@ -66,6 +66,9 @@ namespace neogfx::game
         bool apply() override;
     public:
         void run_cycle(collision_detection_cycle aCycle = collision_detection_cycle::Default);
+        bool parallel_detection_enabled() const;
+        void enable_parallel_detection(uint32_t aThreadCount = 0);
+        void disable_parallel_detection();
         template <typename Visitor>
         void visit_aabbs(const Visitor& aVisitor) const
         {
@@ -101,5 +104,6 @@ namespace neogfx::game
         aabb_octree<box_collider> iBroadphaseTree;
         aabb_quadtree<box_collider_2d> iBroadphase2dTree;
         std::atomic<bool> iCollidersUpdated;
+        std::optional<uint32_t> iParallelDetectionThreads;
     };
 }
\ No newline at end of file
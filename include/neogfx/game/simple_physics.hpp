@@ -25,9 +25,16 @@
 #include <neogfx/game/mesh_filter.hpp>
 #include <neogfx/game/rigid_body.hpp>
 #include <neogfx/game/mesh_render_cache.hpp>
+#include <neogfx/game/barnes_hut_tree.hpp>
 
 namespace neogfx::game
 {
+    enum class gravitation_solver : uint32_t
+    {
+        Exact       = 0x00000000,
+        BarnesHut   = 0x00000001
+    };
+
     class simple_physics : public game::system<entity_info, box_collider, box_collider_2d, mesh_filter, rigid_body, mesh_render_cache>
     {
     public:
@@ -42,6 +49,9 @@ namespace neogfx::game
         bool universal_gravitation_enabled() const;
         void enable_universal_gravitation();
         void disable_universal_gravitation();
+        gravitation_solver universal_gravitation_solver() const;
+        scalar barnes_hut_theta() const;
+        void set_universal_gravitation_solver(gravitation_solver aSolver, scalar aBarnesHutTheta = barnes_hut_tree::DefaultTheta);
     public:
         void yield_after(std::chrono::duration<double, std::milli> aTime);
     public:
@@ -60,5 +70,7 @@ namespace neogfx::game
         };
     private:
         std::chrono::duration<double, std::milli> iYieldTime = std::chrono::duration<double, std::milli>{ 1.0 };
+        gravitation_solver iGravitationSolver = gravitation_solver::Exact;
+        barnes_hut_tree iBarnesHutTree;
     };
 }
\ No newline at end of file
@@ -166,12 +166,16 @@ namespace neogfx
     public:
         void clear_glyph() override;
         void set_first_glyph(const i_rendering_context& aContext, const glyph& aGlyph) override;
+        void set_distance_field_effect(text_effect_type aEffect, dimension aWidth) override;
     private:
         cache_uniform(uGlyphRenderTargetExtents)
         cache_uniform(uGlyphGuiCoordinates)
         cache_uniform(uGlyphRenderOutput)
         cache_uniform(uGlyphSubpixel)
         cache_uniform(uGlyphSubpixelFormat)
+        cache_uniform(uGlyphDistanceFieldEffect)
+        cache_uniform(uGlyphDistanceFieldSpread)
+        cache_uniform(uGlyphDistanceFieldWidth)
         cache_uniform(uGlyphEnabled)
     };
 
@@ -60,7 +60,7 @@ namespace neogfx
         void apply_gradient(i_gradient_shader& aShader) override;
         // i_graphics_context
     public:
-        ping_pong_buffers_t ping_pong_buffers(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, const optional_color& aClearColor = color{ vec4{0.0, 0.0, 0.0, 0.0} }) const override;
+        ping_pong_buffers_t ping_pong_buffers(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, const optional_color& aClearColor = color{ vec4{0.0, 0.0, 0.0, 0.0} }, texture_data_type aDataType = texture_data_type::UnsignedByte) const override;
     public:
         delta to_device_units(const delta& aValue) const override;
         size to_device_units(const size& aValue) const override;
@@ -67,6 +67,7 @@ namespace neogfx
     public:
         virtual void clear_glyph() = 0;
         virtual void set_first_glyph(const i_rendering_context& aContext, const glyph& aGlyph) = 0;
+        virtual void set_distance_field_effect(text_effect_type aEffect, dimension aWidth) = 0;
     };
 
     class i_stipple_shader : public i_fragment_shader
@@ -82,7 +82,7 @@ namespace neogfx
         virtual ~i_graphics_context() = default;
         // operations
     public:
-        virtual ping_pong_buffers_t ping_pong_buffers(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, const optional_color& aClearColor = color{ vec4{0.0, 0.0, 0.0, 0.0} }) const = 0;
+        virtual ping_pong_buffers_t ping_pong_buffers(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, const optional_color& aClearColor = color{ vec4{0.0, 0.0, 0.0, 0.0} }, texture_data_type aDataType = texture_data_type::UnsignedByte) const = 0;
     public:
         virtual delta to_device_units(const delta& aValue) const = 0;
         virtual size to_device_units(const size& aValue) const = 0;
@@ -237,7 +237,7 @@ namespace neogfx
         point const effectOffset{ aGlowSize, aGlowSize };
         auto const effectExtents = aGlyphText.extents(aGlyphTextBegin, aGlyphTextEnd) + effectOffset * 2.0;
         rect const effectRect{ point{}, effectExtents };
-        aPingPongBuffers.second->blur(effectRect, *aPingPongBuffers.first, effectRect, blurring_algorithm::Gaussian, 5, 1.0);
+        aPingPongBuffers.second->blur(effectRect, *aPingPongBuffers.first, effectRect, blurring_algorithm::Gaussian, static_cast<uint32_t>(std::ceil(aGlowSize)), aGlowSize / 2.0);
     }
 
     template <typename Iter>
@@ -264,7 +264,8 @@ namespace neogfx
     template <typename Iter>
     inline void draw_glyph_text(const i_graphics_context& aGc, const vec3& aPoint, const glyph_text& aGlyphText, Iter aGlyphTextBegin, Iter aGlyphTextEnd, const text_appearance& aAppearance)
     {
-        if (aAppearance.effect() && aAppearance.effect()->type() == text_effect_type::Glow)
+        // glows no wider than the glyph distance field spread are rendered directly from glyph distance fields
+        if (aAppearance.effect() && aAppearance.effect()->type() == text_effect_type::Glow && aAppearance.effect()->width() > GlyphDistanceFieldSpread)
             draw_glyph_text_glow(aGc, aPoint, aGlyphText, aGlyphTextBegin, aGlyphTextEnd, aAppearance.effect()->color(), aAppearance.effect()->width());
         draw_glyph_text_normal(aGc, aPoint, aGlyphText, aGlyphTextBegin, aGlyphTextEnd, aAppearance);
     }
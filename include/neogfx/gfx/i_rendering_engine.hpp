@@ -123,9 +123,12 @@ namespace neogfx
         virtual const i_vertex_buffer& vertex_buffer(i_vertex_provider& aProvider) const = 0;
         virtual i_vertex_buffer& vertex_buffer(i_vertex_provider& aProvider) = 0;
         virtual void execute_vertex_buffers() = 0;
+        // number of times writing to any vertex buffer had to wait for the GPU
+        virtual uint32_t vertex_buffer_stall_count() const = 0;
+        virtual void reset_vertex_buffer_stall_count() = 0;
     public:
-        virtual i_texture& ping_pong_buffer1(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample) = 0;
-        virtual i_texture& ping_pong_buffer2(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample) = 0;
+        virtual i_texture& ping_pong_buffer1(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, texture_data_type aDataType = texture_data_type::UnsignedByte) = 0;
+        virtual i_texture& ping_pong_buffer2(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, texture_data_type aDataType = texture_data_type::UnsignedByte) = 0;
     public:
         virtual bool is_subpixel_rendering_on() const = 0;
         virtual void subpixel_rendering_on() = 0;
@@ -33,10 +33,26 @@ namespace neogfx
     public:
         virtual ~i_texture_atlas() = default;
     public:
+        virtual bool has_sub_texture(texture_id aSubTextureId) const = 0;
         virtual const i_sub_texture& sub_texture(texture_id aSubTextureId) const = 0;
         virtual i_sub_texture& sub_texture(texture_id aSubTextureId) = 0;
         virtual i_sub_texture& create_sub_texture(const size& aSize, dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat = texture_data_format::RGBA) = 0;
         virtual i_sub_texture& create_sub_texture(const i_image& aImage) = 0;
         virtual void destroy_sub_texture(i_sub_texture& aSubTexture) = 0;
+    public:
+        virtual uint32_t page_count() const = 0;
+        virtual uint32_t sub_texture_count() const = 0;
+        // fraction of total page area allocated to sub-textures
+        virtual double occupancy() const = 0;
+        virtual uint64_t memory_usage() const = 0;
+        virtual const std::optional<uint64_t>& memory_budget() const = 0;
+        virtual void set_memory_budget(const std::optional<uint64_t>& aMemoryBudget) = 0;
+        // an evictable sub-texture may be destroyed by evict() in which case aEvicted is called beforehand so the owner
+        // can drop its references to it
+        virtual void set_evictable(const i_sub_texture& aSubTexture, std::function<void()> aEvicted) = 0;
+        virtual void touch(const i_sub_texture& aSubTexture) = 0;
+        // destroys pages of evictable sub-textures that have not been touched for the last EvictionAge calls, least recently
+        // used first, until memory usage is within budget; if aDefragment is true sparsely occupied pages are also released
+        virtual void evict(bool aDefragment = false) = 0;
     };
 }
\ No newline at end of file
@@ -94,5 +94,8 @@ namespace neogfx
         virtual void detach_shader() = 0;
     public:
         virtual void reclaim(std::size_t aStartIndex, std::size_t aEndIndex) = 0;
+    public:
+        virtual uint32_t stall_count() const = 0;
+        virtual void reset_stall_count() = 0;
     };
 }
\ No newline at end of file
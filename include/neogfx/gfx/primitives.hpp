@@ -42,7 +42,8 @@ namespace neogfx
     {
         None,
         Default, // todo
-        Blit
+        Blit,
+        Additive
     };
 
     enum class smoothing_mode
@@ -0,0 +1,55 @@
+// range_allocator.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <map>
+#include <set>
+
+namespace neogfx
+{
+    // Best-fit sub-allocator for ranges of a linear space (e.g. the vertices of a vertex buffer).
+    // Free ranges are indexed both by offset (for coalescing) and by length (for O(log n) allocation);
+    // it deals only in offsets so requires no graphics context.
+    class range_allocator
+    {
+    public:
+        typedef std::size_t size_type;
+    public:
+        range_allocator();
+    public:
+        std::optional<size_type> allocate(size_type aCount);
+        void deallocate(size_type aStart, size_type aEnd);
+        void clear();
+    public:
+        bool empty() const;
+        size_type free_space() const;
+        size_type largest_free_range() const;
+        size_type free_range_count() const;
+        double fragmentation() const;
+    private:
+        void add_free_range(size_type aStart, size_type aEnd);
+        void remove_free_range(std::map<size_type, size_type>::iterator aRange);
+    private:
+        std::map<size_type, size_type> iFreeByOffset;
+        std::set<std::pair<size_type, size_type>> iFreeByLength;
+        size_type iFreeSpace;
+    };
+}
\ No newline at end of file
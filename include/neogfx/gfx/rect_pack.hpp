@@ -55,27 +55,34 @@ namespace neogfx
             }
             ~node()
             {
-                if (iChildren[0] != nullptr)
-                {
-                    iAllocator.destroy(iChildren[0]);
-                    iAllocator.deallocate(iChildren[0]);
-                }
-                if (iChildren[1] != nullptr)
-                {
-                    iAllocator.destroy(iChildren[1]);
-                    iAllocator.deallocate(iChildren[1]);
-                }
+                destroy_children();
             }
         public:
             bool is_leaf() const 
             {
                 return iChildren[0] == nullptr;
             }
+            bool is_free() const
+            {
+                return is_leaf() && !iInUse;
+            }
             const neogfx::rect& rect() const
             {
                 return iRect;
             }
             node* insert(const size& aElementSize);
+            bool remove(const neogfx::rect& aElement);
+        private:
+            void destroy_children()
+            {
+                for (auto& child : iChildren)
+                    if (child != nullptr)
+                    {
+                        iAllocator.destroy(child);
+                        iAllocator.deallocate(child);
+                        child = nullptr;
+                    }
+            }
         private:
             allocator_type& iAllocator;
             bool iInUse;
@@ -85,9 +92,15 @@ namespace neogfx
     public:
         rect_pack(const size& aDimensions);
     public:
+        const size& dimensions() const;
+        dimension used_area() const;
+        bool empty() const;
         bool insert(const size& aElementSize, rect& aResult);
+        bool remove(const rect& aElement);
     private:
+        size iDimensions;
         node::allocator_type iAllocator;
         node iRoot;
+        dimension iUsedArea;
     };
 }
\ No newline at end of file
@@ -32,18 +32,37 @@ namespace neogfx
     private:
         typedef std::map<dimension, std::string> sets;
         typedef std::map<std::u32string, sets> emojis;
+        // Emoji sequences as a trie with each node's edges stored contiguously and sorted by code point.
+        struct trie_node
+        {
+            uint32_t firstEdge;
+            uint32_t edgeCount;
+            bool terminal;
+        };
+        struct trie_edge
+        {
+            char32_t codePoint;
+            uint32_t node;
+        };
+        static constexpr uint32_t NoNode = static_cast<uint32_t>(-1);
     public:
         emoji_atlas();
     public:
         virtual bool is_emoji(char32_t aCodePoint) const;
         virtual bool is_emoji(const std::u32string& aCodePoints) const;
+        virtual bool is_emoji(const char32_t* aCodePoints, const char32_t* aCodePointsEnd) const;
         virtual emoji_id emoji(char32_t aCodePoint, dimension aDesiredSize) const;
         virtual emoji_id emoji(const std::u32string& aCodePoints, dimension aDesiredSize = 64) const;
         virtual const i_texture& emoji_texture(emoji_id aId) const;
+    private:
+        void build_trie();
+        uint32_t trie_child(uint32_t aNode, char32_t aCodePoint) const;
     private:
         const std::string kFilePath;
         std::unique_ptr<i_texture_atlas> iTextureAtlas;
         emojis iEmojis;
         mutable std::unordered_map<std::u32string, std::optional<emoji_id>> iEmojiMap;
+        std::vector<trie_node> iTrieNodes;
+        std::vector<trie_edge> iTrieEdges;
     };
 }
\ No newline at end of file
@@ -185,6 +185,8 @@ namespace neogfx
         point_size fixed_size(uint32_t aFixedSizeIndex) const;
     public:
         const i_glyph_texture& glyph_texture(const glyph& aGlyph) const;
+        bool glyph_texture_ready(const glyph& aGlyph) const;
+        const i_glyph_texture& glyph_distance_field(const glyph& aGlyph) const;
     public:
         bool operator==(const font& aRhs) const;
         bool operator!=(const font& aRhs) const;
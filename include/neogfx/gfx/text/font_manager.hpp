@@ -27,6 +27,7 @@
 #include <neolib/core/string_ci.hpp>
 #include <neogfx/gfx/texture_atlas.hpp>
 #include <neogfx/gfx/text/emoji_atlas.hpp>
+#include <neogfx/gfx/text/glyph_text_cache.hpp>
 #include <neogfx/gfx/text/i_font_manager.hpp>
 
 namespace neogfx
@@ -57,6 +58,8 @@ namespace neogfx
         struct error_initializing_font_library : std::runtime_error { error_initializing_font_library() : std::runtime_error("neogfx::font_manager::error_initializing_font_library") {} };
         struct no_matching_font_found : std::runtime_error { no_matching_font_found() : std::runtime_error("neogfx::font_manager::no_matching_font_found") {} };
         struct failed_to_allocate_glyph_space : std::runtime_error { failed_to_allocate_glyph_space() : std::runtime_error("neogfx::font_manager::failed_to_allocate_glyph_space") {} };
+    public:
+        static constexpr uint64_t DefaultGlyphAtlasMemoryBudget = 64u * 1024u * 1024u;
     public:
         font_manager();
         ~font_manager();
@@ -72,7 +75,6 @@ namespace neogfx
         i_native_font_face& create_font(const font_info& aInfo, const i_device_resolution& aDevice) override;
         i_native_font_face& create_font(i_native_font& aFont, neogfx::font_style aStyle, font::point_size aSize, const i_device_resolution& aDevice) override;
         i_native_font_face& create_font(i_native_font& aFont, const std::string& aStyleName, font::point_size aSize, const i_device_resolution& aDevice) override;
-        bool is_font_file(const std::string& aFileName) const override;
         i_native_font_face& load_font_from_file(const std::string& aFileName, const i_device_resolution& aDevice) override;
         i_native_font_face& load_font_from_file(const std::string& aFileName, neogfx::font_style aStyle, font::point_size aSize, const i_device_resolution& aDevice) override;
         i_native_font_face& load_font_from_file(const std::string& aFileName, const std::string& aStyleName, font::point_size aSize, const i_device_resolution& aDevice) override;
@@ -84,6 +86,7 @@ namespace neogfx
         std::string font_family(uint32_t aFamilyIndex) const override;
         uint32_t font_style_count(uint32_t aFamilyIndex) const override;
         std::string font_style(uint32_t aFamilyIndex, uint32_t aStyleIndex) const override;
+        const font_enumeration_info& enumeration_info() const override;
     private:
         font_id allocate_font_id() override;
     public:
@@ -93,6 +96,13 @@ namespace neogfx
         i_texture_atlas& glyph_atlas() override;
         const i_emoji_atlas& emoji_atlas() const override;
         i_emoji_atlas& emoji_atlas() override;
+        const neogfx::glyph_text_cache& glyph_text_cache() const override;
+        neogfx::glyph_text_cache& glyph_text_cache() override;
+    public:
+        const code_point_ranges& prewarm_glyph_ranges() const override;
+        void set_prewarm_glyph_ranges(const code_point_ranges& aRanges) override;
+        bool glyph_redraw_needed() override;
+        neogfx::glyph_rasterizer& glyph_rasterizer() override;
     protected:
         void add_ref(font_id aId) override;
         void release(font_id aId) override;
@@ -109,9 +119,13 @@ namespace neogfx
         FT_Library iFontLib;
         native_font_list iNativeFonts;
         font_family_list iFontFamilies;
+        font_enumeration_info iEnumerationInfo;
     private:
         id_cache iIdCache;
         texture_atlas iGlyphAtlas;
         neogfx::emoji_atlas iEmojiAtlas;
+        neogfx::glyph_text_cache iGlyphTextCache;
+        code_point_ranges iPrewarmGlyphRanges;
+        std::unique_ptr<neogfx::glyph_rasterizer> iGlyphRasterizer;
     };
 }
\ No newline at end of file
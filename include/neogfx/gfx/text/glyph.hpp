@@ -351,6 +351,14 @@ namespace neogfx
         {
             return aFont.glyph_texture(*this);
         }
+        bool glyph_texture_ready() const
+        {
+            return font().glyph_texture_ready(*this);
+        }
+        const i_glyph_texture& glyph_distance_field() const
+        {
+            return font().glyph_distance_field(*this);
+        }
     private:
         character_type iType;
         value_type iValue;
@@ -0,0 +1,168 @@
+// glyph_text_cache.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <neogfx/gfx/text/glyph.hpp>
+
+namespace neogfx
+{
+    // Bounded LRU cache of shaped text keyed by font identity, text and shaping flags so unchanging
+    // text (labels, menu items, item view cells, ...) is not re-run through bidi classification and
+    // HarfBuzz every time it is measured or drawn. Text shaped with a per-character font selector is
+    // keyed by its runs of font identities. Entries are only valid for as long as the font faces they
+    // name exist; native_font_face invalidates its entries when it is destroyed so recycled font ids
+    // never match stale text.
+    class glyph_text_cache
+    {
+    public:
+        static constexpr std::size_t DefaultCapacity = 4096;
+    private:
+        typedef std::vector<std::pair<std::size_t, font_id>> font_runs; // (first character, font)
+        struct key
+        {
+            font_runs fonts;
+            uint32_t flags;
+            std::string utf8;
+            std::u32string utf32;
+
+            bool operator==(const key& aOther) const
+            {
+                return fonts == aOther.fonts && flags == aOther.flags && utf8 == aOther.utf8 && utf32 == aOther.utf32;
+            }
+            bool uses(font_id aFont) const
+            {
+                for (auto const& run : fonts)
+                    if (run.second == aFont)
+                        return true;
+                return false;
+            }
+        };
+        struct key_hash
+        {
+            std::size_t operator()(const key& aKey) const
+            {
+                std::size_t result = std::hash<std::string>{}(aKey.utf8) ^ (std::hash<std::u32string>{}(aKey.utf32) << 1);
+                for (auto const& run : aKey.fonts)
+                    result = (result * 31u) ^ (static_cast<std::size_t>(run.second) << 32) ^ run.first;
+                result ^= (static_cast<std::size_t>(aKey.flags) << 16);
+                return result;
+            }
+        };
+        typedef std::list<std::pair<key, glyph_text>> entry_list;
+        typedef std::unordered_map<key, entry_list::iterator, key_hash> entry_index;
+    public:
+        glyph_text_cache(std::size_t aCapacity = DefaultCapacity);
+    public:
+        std::size_t capacity() const;
+        void set_capacity(std::size_t aCapacity);
+        std::size_t size() const;
+        uint64_t hits() const;
+        uint64_t misses() const;
+        void reset_statistics();
+    public:
+        void invalidate();
+        void invalidate(font_id aFont);
+    public:
+        template <typename Shaper>
+        glyph_text find(font_id aFont, uint32_t aFlags, std::string::const_iterator aTextBegin, std::string::const_iterator aTextEnd, Shaper aShaper)
+        {
+            thread_local key lookup;
+            lookup.fonts.assign(1, { 0u, aFont });
+            lookup.flags = aFlags;
+            lookup.utf8.assign(aTextBegin, aTextEnd);
+            lookup.utf32.clear();
+            return find(lookup, aShaper);
+        }
+        template <typename Shaper>
+        glyph_text find(font_id aFont, uint32_t aFlags, std::u32string::const_iterator aTextBegin, std::u32string::const_iterator aTextEnd, Shaper aShaper)
+        {
+            thread_local key lookup;
+            lookup.fonts.assign(1, { 0u, aFont });
+            lookup.flags = aFlags;
+            lookup.utf8.clear();
+            lookup.utf32.assign(aTextBegin, aTextEnd);
+            return find(lookup, aShaper);
+        }
+        template <typename FontSelector, typename Shaper>
+        glyph_text find(const FontSelector& aFontSelector, uint32_t aFlags, std::string::const_iterator aTextBegin, std::string::const_iterator aTextEnd, Shaper aShaper)
+        {
+            thread_local key lookup;
+            select_fonts(lookup.fonts, aFontSelector, static_cast<std::size_t>(std::distance(aTextBegin, aTextEnd)));
+            lookup.flags = aFlags;
+            lookup.utf8.assign(aTextBegin, aTextEnd);
+            lookup.utf32.clear();
+            return find(lookup, aShaper);
+        }
+        template <typename FontSelector, typename Shaper>
+        glyph_text find(const FontSelector& aFontSelector, uint32_t aFlags, std::u32string::const_iterator aTextBegin, std::u32string::const_iterator aTextEnd, Shaper aShaper)
+        {
+            thread_local key lookup;
+            select_fonts(lookup.fonts, aFontSelector, static_cast<std::size_t>(std::distance(aTextBegin, aTextEnd)));
+            lookup.flags = aFlags;
+            lookup.utf8.clear();
+            lookup.utf32.assign(aTextBegin, aTextEnd);
+            return find(lookup, aShaper);
+        }
+    private:
+        template <typename FontSelector>
+        static void select_fonts(font_runs& aRuns, const FontSelector& aFontSelector, std::size_t aLength)
+        {
+            aRuns.clear();
+            for (std::size_t index = 0; index < aLength; ++index)
+            {
+                auto const id = aFontSelector(index).id();
+                if (aRuns.empty() || aRuns.back().second != id)
+                    aRuns.emplace_back(index, id);
+            }
+        }
+        template <typename Shaper>
+        glyph_text find(const key& aKey, Shaper aShaper)
+        {
+            {
+                std::scoped_lock<std::mutex> lock{ iMutex };
+                auto existing = iIndex.find(aKey);
+                if (existing != iIndex.end())
+                {
+                    ++iHits;
+                    iEntries.splice(iEntries.begin(), iEntries, existing->second);
+                    return existing->second->second;
+                }
+                ++iMisses;
+            }
+            glyph_text result = aShaper();
+            insert(aKey, result);
+            return result;
+        }
+        void insert(const key& aKey, const glyph_text& aGlyphText);
+        void trim(entry_list& aDiscarded);
+    private:
+        mutable std::mutex iMutex;
+        std::size_t iCapacity;
+        entry_list iEntries;
+        entry_index iIndex;
+        uint64_t iHits;
+        uint64_t iMisses;
+    };
+}
\ No newline at end of file
@@ -32,6 +32,8 @@ namespace neogfx
 
     class i_texture_atlas;
     class i_emoji_atlas;
+    class glyph_text_cache;
+    class glyph_rasterizer;
 
     class i_fallback_font_info
     {
@@ -42,6 +44,14 @@ namespace neogfx
         virtual const std::string& fallback_for(const std::string& aFontFamilyName) const = 0;
     };
 
+    // Cold start (no usable font index) is indicated by scannedFonts being non-zero.
+    struct font_enumeration_info
+    {
+        std::chrono::microseconds duration;
+        uint32_t indexedFonts;
+        uint32_t scannedFonts;
+    };
+
     class i_font_manager : public neolib::i_small_cookie_consumer
     {
         friend class native_font;
@@ -49,6 +59,8 @@ namespace neogfx
         struct bad_font_family_index : std::logic_error { bad_font_family_index() : std::logic_error("neogfx::i_font_manager::bad_font_family_index") {} };
         struct bad_font_style_index : std::logic_error { bad_font_style_index() : std::logic_error("neogfx::i_font_manager::bad_font_style_index") {} };
         struct no_fallback_font : std::logic_error { no_fallback_font() : std::logic_error("neogfx::i_font_manager::no_fallback_font") {} };
+    public:
+        typedef std::vector<std::pair<char32_t, char32_t>> code_point_ranges;
     public:
         virtual ~i_font_manager() = default;
     public:
@@ -63,7 +75,6 @@ namespace neogfx
         virtual i_native_font_face& create_font(const font_info& aInfo, const i_device_resolution& aDevice) = 0;
         virtual i_native_font_face& create_font(i_native_font& aFont, neogfx::font_style aStyle, font::point_size aSize, const i_device_resolution& aDevice) = 0;
         virtual i_native_font_face& create_font(i_native_font& aFont, const std::string& aStyleName, font::point_size aSize, const i_device_resolution& aDevice) = 0;
-        virtual bool is_font_file(const std::string& aFileName) const = 0;
         virtual i_native_font_face& load_font_from_file(const std::string& aFileName, const i_device_resolution& aDevice) = 0;
         virtual i_native_font_face& load_font_from_file(const std::string& aFileName, neogfx::font_style aStyle, font::point_size aSize, const i_device_resolution& aDevice) = 0;
         virtual i_native_font_face& load_font_from_file(const std::string& aFileName, const std::string& aStyleName, font::point_size aSize, const i_device_resolution& aDevice) = 0;
@@ -75,6 +86,7 @@ namespace neogfx
         virtual std::string font_family(uint32_t aFamilyIndex) const = 0;
         virtual uint32_t font_style_count(uint32_t aFamilyIndex) const = 0;
         virtual std::string font_style(uint32_t aFamilyIndex, uint32_t aStyleIndex) const = 0;
+        virtual const font_enumeration_info& enumeration_info() const = 0;
     private:
         virtual font_id allocate_font_id() = 0;
     public:
@@ -84,6 +96,15 @@ namespace neogfx
         virtual i_texture_atlas& glyph_atlas() = 0;
         virtual const i_emoji_atlas& emoji_atlas() const = 0;
         virtual i_emoji_atlas& emoji_atlas() = 0;
+        virtual const neogfx::glyph_text_cache& glyph_text_cache() const = 0;
+        virtual neogfx::glyph_text_cache& glyph_text_cache() = 0;
+    public:
+        // Glyphs for these (inclusive) code point ranges are rasterized in the background when a font is created.
+        virtual const code_point_ranges& prewarm_glyph_ranges() const = 0;
+        virtual void set_prewarm_glyph_ranges(const code_point_ranges& aRanges) = 0;
+        // Returns true (once) if glyphs skipped while drawing because they were still being rasterized are now ready.
+        virtual bool glyph_redraw_needed() = 0;
+        virtual neogfx::glyph_rasterizer& glyph_rasterizer() = 0;
     public:
         bool has_font(const std::string& aFamily, const std::string& aStyle) const
         {
@@ -38,6 +38,10 @@ namespace neogfx
         BGRA
     };
 
+    // Glyph distance fields encode signed distances (in pixels) of up to this many pixels either side of the glyph edge
+    // so outline and glow effects no wider than this can be rendered with a single quad per glyph.
+    constexpr dimension GlyphDistanceFieldSpread = 8.0;
+
     class i_glyph_texture
     {
     public:
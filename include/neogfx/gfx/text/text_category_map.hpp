@@ -1971,11 +1971,79 @@ namespace neogfx
             { 0x100001, text_category::Unknown },
             { 0x10FFFD, text_category::LTR }
         };
+
+        // Two level (page and offset) form of text_category_MAP built on first use: uniform pages (the vast majority)
+        // share a single page per category so the whole table is a few tens of kilobytes.
+        class text_category_table
+        {
+        public:
+            static constexpr uint32_t PageBits = 8u;
+            static constexpr uint32_t PageSize = 1u << PageBits;
+            static constexpr uint32_t CodePointCount = 0x110000u;
+            static constexpr uint32_t PageCount = CodePointCount / PageSize;
+            static constexpr uint32_t AsciiCount = 0x80u;
+        private:
+            typedef std::array<text_category, PageSize> page;
+        public:
+            static const text_category_table& instance()
+            {
+                static const text_category_table sTable;
+                return sTable;
+            }
+        public:
+            text_category operator[](char32_t aCodePoint) const
+            {
+                if (aCodePoint < AsciiCount)
+                    return iAscii[aCodePoint];
+                if (aCodePoint >= CodePointCount)
+                    return text_category::Unknown;
+                return iPages[iPageIndices[aCodePoint >> PageBits]][aCodePoint & (PageSize - 1u)];
+            }
+        private:
+            text_category_table()
+            {
+                std::size_t const mapSize = sizeof(text_category_MAP) / sizeof(text_category_MAP[0]);
+                std::array<uint16_t, 0x100> uniformPages;
+                uniformPages.fill(0xFFFFu);
+                std::size_t range = 0;
+                page next;
+                for (uint32_t p = 0; p < PageCount; ++p)
+                {
+                    for (uint32_t o = 0; o < PageSize; ++o)
+                    {
+                        uint32_t const codePoint = p * PageSize + o;
+                        while (range + 1u < mapSize && text_category_MAP[range + 1u].first <= codePoint)
+                            ++range;
+                        next[o] = text_category_MAP[range].second;
+                    }
+                    bool const uniform = std::all_of(next.begin(), next.end(), [&](text_category c) { return c == next[0]; });
+                    auto& uniformPage = uniformPages[static_cast<std::size_t>(next[0])];
+                    if (uniform && uniformPage != 0xFFFFu)
+                        iPageIndices[p] = uniformPage;
+                    else
+                    {
+                        iPageIndices[p] = static_cast<uint16_t>(iPages.size());
+                        iPages.push_back(next);
+                        if (uniform)
+                            uniformPage = iPageIndices[p];
+                    }
+                }
+                for (uint32_t codePoint = 0; codePoint < AsciiCount; ++codePoint)
+                    iAscii[codePoint] = iPages[iPageIndices[0]][codePoint];
+            }
+        private:
+            std::array<text_category, AsciiCount> iAscii;
+            std::array<uint16_t, PageCount> iPageIndices;
+            std::vector<page> iPages;
+        };
     }
 
     inline text_category get_text_category(const i_emoji_atlas& aEmojiAtlas, const char32_t* aCodePoint, const char32_t* aCodePointEnd)
     {
         char32_t ch = aCodePoint[0];
+        // no emoji sequence starts with an ASCII code point (keycaps need a variation selector and are not in the atlas)
+        if (ch < detail::text_category_table::AsciiCount)
+            return detail::text_category_table::instance()[ch];
         if (aEmojiAtlas.is_emoji(ch))
         {
             if (aCodePoint + 1 == aCodePointEnd || aCodePoint[1] != 0xEF0E)
@@ -1984,17 +2052,7 @@ namespace neogfx
         }
         else if (ch == 0xFE0F || ch == 0xFE0E)
             return text_category::Control;
-        const detail::text_category_MAP_VALUE_TYPE* rangeStart = std::lower_bound(
-            &detail::text_category_MAP[0], 
-            &detail::text_category_MAP[0] + sizeof(detail::text_category_MAP) / sizeof(detail::text_category_MAP[0]),
-            detail::text_category_MAP_VALUE_TYPE(ch, text_category::Unknown),
-            [](const detail::text_category_MAP_VALUE_TYPE& lhs, const detail::text_category_MAP_VALUE_TYPE& rhs) -> bool
-        {
-            return lhs.first < rhs.first;
-        });
-        if (rangeStart != &detail::text_category_MAP[0] && ch < rangeStart->first)
-            --rangeStart;
-        return rangeStart->second;
+        return detail::text_category_table::instance()[ch];
     }
 
     inline text_category get_text_category(const i_emoji_atlas& aEmojiAtlas, char32_t aCodePoint)
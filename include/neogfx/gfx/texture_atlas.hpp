@@ -21,8 +21,7 @@
 
 #include <neogfx/neogfx.hpp>
 #include <unordered_map>
-#include <set>
-#include <tuple>
+#include <functional>
 #include "i_texture_atlas.hpp"
 #include "i_texture_manager.hpp"
 #include "texture.hpp"
@@ -35,51 +34,75 @@ namespace neogfx
 
     class texture_atlas : public i_texture_atlas
     {
+    public:
+        static constexpr double DefragmentOccupancyThreshold = 0.25;
+        // evict() is called once per frame so this keeps the glyphs of surfaces that are not being repainted for
+        // about ten seconds at 60 Hz
+        static constexpr uint64_t EvictionAge = 600u;
     private:
         struct fragments
         {
-            struct fragment_less_than
-            {
-                bool operator()(const rect& aLhs, const rect& aRhs) const
-                {
-                    return std::forward_as_tuple(aLhs.width() * aLhs.height(), aLhs.top_left()) <
-                        std::forward_as_tuple(aRhs.width() * aRhs.height(), aRhs.top_left());
-                }
-            };
             rect_pack pack;
-            std::set<rect, fragment_less_than> used;
-            std::set<rect, fragment_less_than> freed; // todo: use this when bin pack is full
+            uint32_t subTextureCount = 0u;
             bool insert(const size& aSize, rect& aResult)
             {
                 if (pack.insert(aSize, aResult))
                 {
-                    used.insert(aResult);
+                    ++subTextureCount;
                     return true;
                 }
                 else
                     return false;
             }
+            void remove(const rect& aSpace)
+            {
+                if (pack.remove(aSpace))
+                    --subTextureCount;
+            }
         };
         typedef std::pair<texture, fragments> page;
         typedef std::list<page> pages;
-        typedef std::pair<pages::iterator, neogfx::sub_texture> entry;
+        struct entry
+        {
+            pages::iterator page;
+            rect space;
+            neogfx::sub_texture subTexture;
+            uint64_t lastUse;
+            std::function<void()> evicted;
+        };
         typedef std::unordered_map<texture_id, entry> entries;
     public:
         texture_atlas(const size& aPageSize);
     public:
+        virtual bool has_sub_texture(texture_id aSubTextureId) const;
         virtual const i_sub_texture& sub_texture(texture_id aSubTextureId) const;
         virtual i_sub_texture& sub_texture(texture_id aSubTextureId);
         virtual i_sub_texture& create_sub_texture(const size& aSize, dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat = texture_data_format::RGBA);
         virtual i_sub_texture& create_sub_texture(const i_image& aImage);
         virtual void destroy_sub_texture(i_sub_texture& aSubTexture);
+    public:
+        virtual uint32_t page_count() const;
+        virtual uint32_t sub_texture_count() const;
+        virtual double occupancy() const;
+        virtual uint64_t memory_usage() const;
+        virtual const std::optional<uint64_t>& memory_budget() const;
+        virtual void set_memory_budget(const std::optional<uint64_t>& aMemoryBudget);
+        virtual void set_evictable(const i_sub_texture& aSubTexture, std::function<void()> aEvicted);
+        virtual void touch(const i_sub_texture& aSubTexture);
+        virtual void evict(bool aDefragment = false);
     private:
         const size& page_size() const;
         pages::iterator create_page(dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat);
         std::pair<pages::iterator, rect> allocate_space(const size& aSize, dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat);
+        i_sub_texture& add_entry(const std::pair<pages::iterator, rect>& aSpace, const size& aSize);
+        void destroy_page(pages::iterator aPage);
+        static uint64_t page_memory(const page& aPage);
     private:
         i_texture_manager& iTextureManager;
         size iPageSize;
         pages iPages;
         entries iEntries;
+        std::optional<uint64_t> iMemoryBudget;
+        uint64_t iGeneration;
     };
 }
\ No newline at end of file
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <vector>
+#include <algorithm>
 #include <neogfx/core/event.hpp>
 #include <neogfx/gui/widget/i_dock.hpp>
 #include <neogfx/gui/layout/i_layout_item.hpp>
@@ -227,6 +229,10 @@ namespace neogfx
         virtual bool invalidated() const = 0;
         virtual void invalidate(bool aDeferLayout = true) = 0;
         virtual void validate() = 0;
+        // the generation is advanced (along with those of the layouts containing the layout) whenever anything that can
+        // change the size hints of the layout's items changes; size hints are cached against it
+        virtual uint32_t generation() const = 0;
+        virtual void invalidate_size_hints() = 0;
         // helpers
     public:
         template <typename ItemType>
@@ -315,7 +321,7 @@ namespace neogfx
     {
     public:
         global_layout_state() :
-            iLayoutId{ 0u }
+            iLayoutId{ 0u }, iSizeHintsId{ 0u }
         {
         }
     public:
@@ -338,8 +344,21 @@ namespace neogfx
         {
             return iLayoutInProgress;
         }
+        // advanced when something that can change the size hints of any item changes (the style or the DPI); all
+        // cached size hints are then stale. A widget whose own size hints change invalidates those of its parent
+        // layout instead.
+        uint32_t size_hints_id() const
+        {
+            return iSizeHintsId;
+        }
+        void invalidate_size_hints()
+        {
+            if (++iSizeHintsId == static_cast<uint32_t>(-1))
+                iSizeHintsId = 0u;
+        }
     private:
         uint32_t iLayoutId;
+        uint32_t iSizeHintsId;
         bool iLayoutInProgress;
     };
 
@@ -348,6 +367,11 @@ namespace neogfx
         return global_layout_state::instance().id();
     }
 
+    inline uint32_t global_size_hints_id()
+    {
+        return global_layout_state::instance().size_hints_id();
+    }
+
     class scoped_layout_items : private neolib::scoped_flag
     {
     public:
@@ -361,4 +385,59 @@ namespace neogfx
         {
         }
     };
+
+    // Size hints (minimum or maximum sizes) of a layout item keyed by the space that was available, valid for one
+    // generation of the layout they were calculated for and one global size hints id. Every hint used by the current
+    // or the previous layout pass is kept; older ones are discarded when a new hint is stored so resizing (which asks
+    // for new available spaces on every pass) neither evicts hints still in use nor accumulates stale ones.
+    class size_hint_cache
+    {
+    private:
+        struct entry
+        {
+            optional_size availableSpace;
+            size hint;
+            uint32_t lastUsed;
+        };
+    public:
+        size_hint_cache() :
+            iGeneration{ static_cast<uint32_t>(-1) }, iSizeHintsId{ static_cast<uint32_t>(-1) }
+        {
+        }
+    public:
+        const size* find(uint32_t aGeneration, const optional_size& aAvailableSpace)
+        {
+            if (aGeneration != iGeneration || global_size_hints_id() != iSizeHintsId)
+                return nullptr;
+            for (auto& e : iHints)
+                if (e.availableSpace == aAvailableSpace)
+                {
+                    e.lastUsed = global_layout_id();
+                    return &e.hint;
+                }
+            return nullptr;
+        }
+        const size& insert(uint32_t aGeneration, const optional_size& aAvailableSpace, const size& aHint)
+        {
+            auto const layoutId = global_layout_id();
+            if (aGeneration != iGeneration || global_size_hints_id() != iSizeHintsId)
+            {
+                iGeneration = aGeneration;
+                iSizeHintsId = global_size_hints_id();
+                clear();
+            }
+            else
+                iHints.erase(std::remove_if(iHints.begin(), iHints.end(), [layoutId](const entry& e) { return layoutId - e.lastUsed > 1u; }), iHints.end());
+            iHints.push_back(entry{ aAvailableSpace, aHint, layoutId });
+            return iHints.back().hint;
+        }
+        void clear()
+        {
+            iHints.clear();
+        }
+    private:
+        uint32_t iGeneration;
+        uint32_t iSizeHintsId;
+        std::vector<entry> iHints;
+    };
 }
\ No newline at end of file
@@ -133,6 +133,8 @@ namespace neogfx
         bool invalidated() const override;
         void invalidate(bool aDeferLayout = true) override;
         void validate() override;
+        uint32_t generation() const override;
+        void invalidate_size_hints() override;
     public:
         point position() const override;
         void set_position(const point& aPosition) override;
@@ -203,5 +205,8 @@ namespace neogfx
         item_list iItems;
         bool iLayoutStarted;
         bool iInvalidated;
+        uint32_t iGeneration;
+        mutable size_hint_cache iMinimumSizeHints;
+        mutable size_hint_cache iMaximumSizeHints;
     };
 }
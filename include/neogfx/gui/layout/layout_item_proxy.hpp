@@ -105,13 +105,14 @@ namespace neogfx
         bool operator==(const layout_item_proxy& aOther) const;
     private:
         bool subject_is_proxy() const;
+        uint32_t layout_generation() const;
     private:
         std::shared_ptr<i_layout_item> iSubject;
         bool iSubjectIsProxy;
         mutable std::pair<uint32_t, bool> iVisible;
-        mutable std::pair<uint32_t, size> iMinimumSize;
-        mutable std::pair<uint32_t, size> iMaximumSize;
-        mutable std::pair<uint32_t, size> iFixedSize;
+        mutable size_hint_cache iMinimumSize;
+        mutable size_hint_cache iMaximumSize;
+        mutable size_hint_cache iFixedSize;
         mutable std::optional<const i_anchor_t<decltype(layout_item<object<i_layout>>::MinimumSize)>*> iMinimumSizeAnchor;
     };
 }
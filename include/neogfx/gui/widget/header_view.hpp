@@ -94,14 +94,17 @@ namespace neogfx
         virtual void item_model_changed(const i_item_model& aItemModel);
         virtual void item_added(const item_presentation_model_index& aItemIndex);
         virtual void item_changed(const item_presentation_model_index& aItemIndex);
+        virtual void items_changed(item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow);
         virtual void item_removed(const item_presentation_model_index& aItemIndex);
         virtual void items_sorting();
         virtual void items_sorted();
         virtual void items_filtering();
         virtual void items_filtered();
+        virtual void items_updated();
     private:
         void init();
         void update_buttons();
+        bool update_incrementally(uint32_t aFirstRow, uint32_t aEndRow);
         void update_from_row(uint32_t aRow, i_graphics_context& aGc);
         bool update_section_width(uint32_t aColumn, const size& aCellExtents, i_graphics_context& aGc);
     private:
@@ -239,6 +239,7 @@ namespace neogfx
         declare_event(item_added, const item_model_index&)
         declare_event(item_changed, const item_model_index&)
         declare_event(item_removed, const item_model_index&)
+        declare_event(items_updated, item_model_index::row_type /* aFirstRow */, item_model_index::row_type /* aEndRow */)
     public:
         typedef neolib::generic_iterator iterator;
         typedef neolib::generic_iterator const_iterator;
@@ -246,6 +247,7 @@ namespace neogfx
         struct wrong_model_type : std::logic_error { wrong_model_type() : std::logic_error("neogfx::i_item_model::wrong_model_type") {} };
         struct bad_column_index : std::logic_error { bad_column_index() : std::logic_error("neogfx::i_item_model::bad_column_index") {} };
         struct item_not_found : std::logic_error { item_not_found() : std::logic_error("neogfx::i_item_model::item_not_found") {} };
+        struct not_updating : std::logic_error { not_updating() : std::logic_error("neogfx::i_item_model::not_updating") {} };
     public:
         virtual ~i_item_model() = default;
     public:
@@ -296,6 +298,12 @@ namespace neogfx
         virtual iterator append_item(const item_model_index& aIndex, const item_cell_data& aCellData) = 0;
         virtual void clear() = 0;
         virtual iterator erase(const_iterator aPosition) = 0;
+        // Between begin_update() and end_update() (which can be nested) item added, changed and removed events are
+        // not triggered; instead a single items_updated event for the range of rows that may have changed is triggered
+        // by the outermost end_update().
+        virtual void begin_update() = 0;
+        virtual void end_update() = 0;
+        virtual bool updating() const = 0;
         virtual void insert_cell_data(const_iterator aItem, item_model_index::column_type aColumnIndex, const item_cell_data& aCellData) = 0;
         virtual void insert_cell_data(const item_model_index& aIndex, const item_cell_data& aCellData) = 0;
         virtual void update_cell_data(const item_model_index& aIndex, const item_cell_data& aCellData) = 0;
@@ -303,4 +311,20 @@ namespace neogfx
         virtual const item_cell_info& cell_info(const item_model_index& aIndex) const = 0;
         virtual const item_cell_data& cell_data(const item_model_index& aIndex) const = 0;
     };
+
+    class scoped_item_model_update
+    {
+    public:
+        scoped_item_model_update(i_item_model& aModel) :
+            iModel{ aModel }
+        {
+            iModel.begin_update();
+        }
+        ~scoped_item_model_update()
+        {
+            iModel.end_update();
+        }
+    private:
+        i_item_model& iModel;
+    };
 }
\ No newline at end of file
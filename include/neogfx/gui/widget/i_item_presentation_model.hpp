@@ -156,6 +156,8 @@ namespace neogfx
         declare_event(item_model_changed, const i_item_model&)
         declare_event(item_added, const item_presentation_model_index&)
         declare_event(item_changed, const item_presentation_model_index&)
+        // triggered instead of item_changed for each of a range of rows, e.g. when a page of a virtual item model is fetched
+        declare_event(items_changed, item_presentation_model_index::row_type /* aFirstRow */, item_presentation_model_index::row_type /* aEndRow */)
         declare_event(item_removed, const item_presentation_model_index&)
         declare_event(item_expanding, const item_presentation_model_index&)
         declare_event(item_collapsing, const item_presentation_model_index&)
@@ -169,6 +171,7 @@ namespace neogfx
         declare_event(items_sorted)
         declare_event(items_filtering)
         declare_event(items_filtered)
+        declare_event(items_updated)
     public:
         struct cell_meta_type
         {
@@ -184,6 +187,11 @@ namespace neogfx
         public:
             virtual void visit(cell_meta_type& aMeta) = 0;
         };
+        enum class column_width_mode
+        {
+            Exact,      // widest cell of every row; the whole column is measured
+            Estimated   // widest cell of a sample of rows, widened as other cells are measured (e.g. come into view)
+        };
         enum class sort_direction
         {
             Ascending,
@@ -227,6 +235,8 @@ namespace neogfx
     public:
         virtual void accept(i_meta_visitor& aVisitor, bool aIgnoreCollapsedState = false) = 0;
     public:
+        virtual column_width_mode width_mode() const = 0;
+        virtual void set_width_mode(column_width_mode aMode) = 0;
         virtual dimension column_width(item_presentation_model_index::column_type aColumnIndex, const i_graphics_context& aGc, bool aIncludePadding = true) const = 0;
         virtual const std::string& column_heading_text(item_presentation_model_index::column_type aColumnIndex) const = 0;
         virtual size column_heading_extents(item_presentation_model_index::column_type aColumnIndex, const i_graphics_context& aGc) const = 0;
@@ -277,6 +287,9 @@ namespace neogfx
         virtual optional_texture cell_image(const item_presentation_model_index& aIndex) const = 0;
         virtual neogfx::glyph_text& cell_glyph_text(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const = 0;
         virtual size cell_extents(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const = 0;
+        // shaped cell text is only kept for rows in [aFirstRow, aEndRow) (typically the rows around a view's viewport);
+        // text shaped for any other row is discarded by the next call
+        virtual void retain_glyph_text(item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow) const = 0;
         virtual dimension indent(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const = 0;
     public:
         virtual bool sortable() const = 0;
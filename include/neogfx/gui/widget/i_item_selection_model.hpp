@@ -236,6 +236,8 @@ namespace neogfx
         virtual bool is_selected(const item_presentation_model_index& aIndex) const = 0;
         virtual bool is_selectable(const item_presentation_model_index& aIndex) const = 0;
         virtual void select(const item_presentation_model_index& aIndex, item_selection_operation aOperation) = 0;
+        virtual void select(const item_presentation_model_index& aFirst, const item_presentation_model_index& aLast, item_selection_operation aOperation) = 0;
+        virtual void select_all() = 0;
     public:
         virtual bool sorting() const = 0;
         virtual bool filtering() const = 0;
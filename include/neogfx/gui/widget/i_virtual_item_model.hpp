@@ -0,0 +1,91 @@
+// i_virtual_item_model.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gui/widget/i_item_model.hpp>
+#include <neogfx/gui/widget/i_item_presentation_model.hpp>
+
+namespace neogfx
+{
+    // The storage layer behind a virtual item model. A row is identified by its position in the source's current
+    // (sorted and filtered) view of its data. A source is only ever called by one thread at a time but fetch() may be
+    // called on a worker thread.
+    class i_item_data_source
+    {
+    public:
+        typedef i_item_presentation_model::sort sort;       // the column is an item model column
+        typedef i_item_presentation_model::filter filter;   // the column is an item model column
+    public:
+        virtual ~i_item_data_source() = default;
+    public:
+        virtual uint32_t rows() const = 0;
+        virtual uint32_t columns() const = 0;
+        virtual std::string column_name(item_model_index::column_type aColumnIndex) const = 0;
+        virtual item_data_type column_data_type(item_model_index::column_type aColumnIndex) const = 0;
+        // aCells receives the cells of aRowCount rows starting at aFirstRow, row by row with columns() cells per row
+        virtual void fetch(item_model_index::row_type aFirstRow, uint32_t aRowCount, std::vector<item_cell_data>& aCells) = 0;
+    public:
+        virtual bool can_sort() const = 0;
+        // primary sort first; an empty sort order restores the source's natural order
+        virtual void sort_by(const std::vector<sort>& aSortOrder) = 0;
+        virtual bool can_filter() const = 0;
+        // only rows matching every filter remain in view; no filters brings every row into view
+        virtual void filter_by(const std::vector<filter>& aFilters) = 0;
+    };
+
+    enum class item_fetch_mode : uint32_t
+    {
+        Synchronous,    // a page is fetched when a cell in it is first asked for
+        Asynchronous    // pages are fetched on a worker thread; cells of pages not yet fetched are empty until rows_fetched
+    };
+
+    // An item model whose rows are owned by an i_item_data_source: the row count is known up front, rows are fetched
+    // a page at a time when first needed and only a bounded number of the most recently used pages is kept. Sorting
+    // and filtering are done by the source. The model's rows cannot be added, removed or changed through the model.
+    class i_virtual_item_model : public i_item_model
+    {
+    public:
+        declare_event(rows_fetched, item_model_index::row_type /* aFirstRow */, item_model_index::row_type /* aEndRow */)
+    public:
+        typedef i_item_data_source::sort sort;
+        typedef i_item_data_source::filter filter;
+    public:
+        struct read_only : std::logic_error { read_only() : std::logic_error("neogfx::i_virtual_item_model::read_only") {} };
+        struct cannot_filter : std::logic_error { cannot_filter() : std::logic_error("neogfx::i_virtual_item_model::cannot_filter") {} };
+    public:
+        virtual i_item_data_source& source() const = 0;
+        virtual item_fetch_mode fetch_mode() const = 0;
+        virtual uint32_t page_size() const = 0;
+        virtual uint32_t max_resident_pages() const = 0;
+        virtual void set_max_resident_pages(uint32_t aMaxResidentPages) = 0;
+        virtual bool resident(item_model_index::row_type aRow) const = 0;
+        // synchronously makes the pages containing the rows resident, whatever the fetch mode
+        virtual void fetch(item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow) const = 0;
+        // discards every resident page and rereads the row count, e.g. after the source's data has changed
+        virtual void refresh() = 0;
+    public:
+        virtual bool can_sort() const = 0;
+        virtual void sort_by(const std::vector<sort>& aSortOrder) = 0;
+        virtual bool can_filter() const = 0;
+        // throws cannot_filter if the source cannot filter
+        virtual void filter_by(const std::vector<filter>& aFilters) = 0;
+    };
+}
\ No newline at end of file
@@ -213,6 +213,7 @@ namespace neogfx
         define_declared_event(ItemAdded, item_added, const item_model_index&)
         define_declared_event(ItemChanged, item_changed, const item_model_index&)
         define_declared_event(ItemRemoved, item_removed, const item_model_index&)
+        define_declared_event(ItemsUpdated, items_updated, item_model_index::row_type, item_model_index::row_type)
     public:
         typedef ContainerTraits container_traits;
         typedef typename container_traits::value_type value_type;
@@ -237,7 +238,7 @@ namespace neogfx
         };
         typedef typename container_traits::template rebind<item_model_index::row_type, column_info>::other::row_cell_array column_info_array;
     public:
-        basic_item_model()
+        basic_item_model() : iUpdateDepth{ 0u }
         {
             base_type::set_alive();
         }
@@ -479,15 +480,15 @@ namespace neogfx
         i_item_model::iterator insert_item(i_item_model::const_iterator aPosition, const value_type& aValue) override
         {
             auto result = base_iterator{ iItems.insert(aPosition.get<const_sibling_iterator, const_iterator, iterator, const_sibling_iterator, sibling_iterator>(), row_type{ aValue, row_cell_array{} }) };
-            ItemAdded.trigger(iterator_to_index(result));
+            notify_item_added(iterator_to_index(result));
             return result;
         }
         i_item_model::iterator insert_item(i_item_model::const_iterator aPosition, const value_type& aValue, const item_cell_data& aCellData) override
         {
             auto result = base_iterator{ iItems.insert(aPosition.get<const_sibling_iterator, const_iterator, iterator, const_sibling_iterator, sibling_iterator>(), row_type{ aValue, row_cell_array{} }) };
             do_insert_cell_data(result, 0, aCellData);
-            ItemAdded.trigger(iterator_to_index(result));
-            ItemChanged.trigger(iterator_to_index(result));
+            notify_item_added(iterator_to_index(result));
+            notify_item_changed(iterator_to_index(result));
             return result;
         }
         i_item_model::iterator insert_item(i_item_model::const_iterator aPosition, const item_cell_data& aCellData) override
@@ -511,7 +512,7 @@ namespace neogfx
             if constexpr (container_traits::is_tree)
             {
                 auto result = base_iterator{ iItems.insert(aParent.get<const_sibling_iterator, const_iterator, iterator, const_sibling_iterator, sibling_iterator>().end(), row_type{ aValue, row_cell_array{} }) };
-                ItemAdded.trigger(iterator_to_index(result));
+                notify_item_added(iterator_to_index(result));
                 return result;
             }
             else
@@ -541,12 +542,13 @@ namespace neogfx
         }
         void clear() override
         {
+            scoped_item_model_update update{ *this };
             while (!empty())
                 erase(begin());
         }
         i_item_model::iterator erase(i_item_model::const_iterator aPosition) override
         {
-            ItemRemoved.trigger(iterator_to_index(aPosition));
+            notify_item_removed(iterator_to_index(aPosition));
             auto result = base_iterator{ iItems.erase(aPosition.get<const_iterator, const_iterator, iterator, const_sibling_iterator, sibling_iterator>()) };
             return result;
         }
@@ -556,7 +558,7 @@ namespace neogfx
             {
                 item_model_index index = iterator_to_index(aItem);
                 index.set_column(aColumnIndex);
-                ItemChanged.trigger(index);
+                notify_item_changed(index);
             }
         }
         void insert_cell_data(const item_model_index& aIndex, const item_cell_data& aCellData) override
@@ -575,7 +577,26 @@ namespace neogfx
             row(aIndex).cells[aIndex.column()] = aCellData;
             if (default_cell_info(aIndex.column()).dataType == item_data_type::Unknown)
                 default_cell_info(aIndex.column()).dataType = static_cast<item_data_type>(aCellData.index());
-            ItemChanged.trigger(aIndex);
+            notify_item_changed(aIndex);
+        }
+        void begin_update() override
+        {
+            ++iUpdateDepth;
+        }
+        void end_update() override
+        {
+            if (iUpdateDepth == 0u)
+                throw base_type::not_updating();
+            if (--iUpdateDepth == 0u && iUpdatedFrom != std::nullopt)
+            {
+                auto const from = std::min(*iUpdatedFrom, rows());
+                iUpdatedFrom = std::nullopt;
+                ItemsUpdated.trigger(from, rows());
+            }
+        }
+        bool updating() const override
+        {
+            return iUpdateDepth != 0u;
         }
     public:
         using base_type::item;
@@ -588,6 +609,33 @@ namespace neogfx
             return row(aIndex).value;
         }
     private:
+        void notify_item_added(const item_model_index& aIndex)
+        {
+            if (updating())
+                updated_from(aIndex);
+            else
+                ItemAdded.trigger(aIndex);
+        }
+        void notify_item_changed(const item_model_index& aIndex)
+        {
+            if (updating())
+                updated_from(aIndex);
+            else
+                ItemChanged.trigger(aIndex);
+        }
+        void notify_item_removed(const item_model_index& aIndex)
+        {
+            if (updating())
+                updated_from(aIndex);
+            else
+                ItemRemoved.trigger(aIndex);
+        }
+        void updated_from(const item_model_index& aIndex)
+        {
+            // every row from the lowest row added, changed or removed onwards may be different
+            if (iUpdatedFrom == std::nullopt || *iUpdatedFrom > aIndex.row())
+                iUpdatedFrom = aIndex.row();
+        }
         row_type& row(const item_model_index& aIndex)
         {
             return *std::next(iItems.begin(), aIndex.row());
@@ -647,6 +695,8 @@ namespace neogfx
     private:
         container_type iItems;
         column_info_array iColumns;
+        uint32_t iUpdateDepth;
+        item_model_index::optional_row_type iUpdatedFrom;
     };
 
     typedef basic_item_model<void*> item_model;
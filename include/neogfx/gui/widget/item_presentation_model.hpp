@@ -22,15 +22,23 @@
 #include <neogfx/neogfx.hpp>
 #include <vector>
 #include <deque>
+#include <list>
+#include <unordered_map>
+#include <numeric>
+#include <future>
+#include <thread>
+#include <regex>
+#include <locale>
 #include <boost/algorithm/string.hpp>
 #include <neolib/core/vecarray.hpp>
-#include <neolib/core/segmented_array.hpp>
 #include <neolib/core/scoped.hpp>
 #include <neogfx/core/object.hpp>
+#include <neogfx/core/fenwick_tree.hpp>
 #include <neogfx/gfx/i_graphics_context.hpp>
 #include <neogfx/app/i_app.hpp>
 #include <neogfx/gui/widget/spin_box.hpp>
 #include <neogfx/gui/widget/item_model.hpp>
+#include <neogfx/gui/widget/virtual_item_model.hpp>
 #include <neogfx/gui/widget/i_item_presentation_model.hpp>
 #include <neogfx/gui/widget/i_skin_manager.hpp>
 
@@ -47,6 +55,7 @@ namespace neogfx
         define_declared_event(ItemModelChanged, item_model_changed, const i_item_model&)
         define_declared_event(ItemAdded, item_added, const item_presentation_model_index&)
         define_declared_event(ItemChanged, item_changed, const item_presentation_model_index&)
+        define_declared_event(ItemsChanged, items_changed, item_presentation_model_index::row_type, item_presentation_model_index::row_type)
         define_declared_event(ItemRemoved, item_removed, const item_presentation_model_index&)
         define_declared_event(ItemExpanding, item_expanding, const item_presentation_model_index&)
         define_declared_event(ItemCollapsing, item_collapsing, const item_presentation_model_index&)
@@ -60,16 +69,20 @@ namespace neogfx
         define_declared_event(ItemsSorted, items_sorted)
         define_declared_event(ItemsFiltering, items_filtering)
         define_declared_event(ItemsFiltered, items_filtered)
+        define_declared_event(ItemsUpdated, items_updated)
     public:
         using typename base_type::sort_direction;
         using typename base_type::optional_sort_direction;
         using typename base_type::sort;
         using typename base_type::optional_sort;
+        using typename base_type::column_width_mode;
         using typename base_type::filter_search_key;
         using typename base_type::filter_search_type;
         using typename base_type::case_sensitivity;
     private:
         typedef ItemModel item_model_type;
+        // rows of a virtual item model are sorted and filtered by its data source
+        static constexpr bool is_virtual_item_model = std::is_base_of_v<i_virtual_item_model, item_model_type>;
         typedef typename item_model_type::container_traits::template rebind<item_presentation_model_index::row_type, cell_meta_type, true>::other container_traits;
         typedef typename container_traits::row_cell_array row_cell_array;
         typedef typename container_traits::container_type container_type;
@@ -79,7 +92,6 @@ namespace neogfx
         typedef typename container_traits::sibling_iterator sibling_iterator;
         typedef typename container_traits::allocator_type allocator_type;
         typedef typename container_type::value_type row_type;
-        typedef std::optional<i_scrollbar::value_type> optional_position;
     private:
         typedef std::vector<item_presentation_model_index::optional_row_type, typename std::allocator_traits<allocator_type>:: template rebind_alloc<item_presentation_model_index::optional_row_type>> row_map_type;
         typedef std::vector<item_presentation_model_index::optional_column_type, typename std::allocator_traits<allocator_type>:: template rebind_alloc<item_presentation_model_index::optional_column_type>> column_map_type;
@@ -95,16 +107,28 @@ namespace neogfx
             optional_size imageSize;
         };
         typedef typename container_traits::template rebind<item_presentation_model_index::row_type, column_info>::other::row_cell_array column_info_array;
+        struct tree_node
+        {
+            const row_type* row;
+            std::optional<iterator> visible; // shown nodes only
+            uint32_t depth;
+            uint32_t descendants;
+        };
+        struct row_page
+        {
+            std::vector<row_type> rows;
+            std::list<uint32_t>::iterator used;
+        };
     public:
         using typename base_type::no_item_model;
         using typename base_type::bad_index;
         using typename base_type::no_mapped_row;
     public:
-        basic_item_presentation_model() : iItemModel{ nullptr }, iSortable{ false }, iInitializing{ false }, iFiltering{ false }
+        basic_item_presentation_model() : iItemModel{ nullptr }, iSortable{ false }, iWidthMode{ column_width_mode::Exact }, iRowHeightsValid{ false }, iTreeIndexValid{ false }, iInitializing{ false }, iFiltering{ false }
         {
             init();
         }
-        basic_item_presentation_model(i_item_model& aItemModel, bool aSortable = false) : iItemModel{ nullptr }, iSortable{ aSortable }, iInitializing{ false }, iFiltering{ false }
+        basic_item_presentation_model(i_item_model& aItemModel, bool aSortable = false) : iItemModel{ nullptr }, iSortable{ aSortable }, iWidthMode{ column_width_mode::Exact }, iRowHeightsValid{ false }, iTreeIndexValid{ false }, iInitializing{ false }, iFiltering{ false }
         {
             init();
             set_item_model(aItemModel, aSortable);
@@ -141,11 +165,19 @@ namespace neogfx
                 iItemModelSink += item_model().item_added([this](const item_model_index& aItemIndex) { item_added(aItemIndex); });
                 iItemModelSink += item_model().item_changed([this](const item_model_index& aItemIndex) { item_changed(aItemIndex); });
                 iItemModelSink += item_model().item_removed([this](const item_model_index& aItemIndex) { item_removed(aItemIndex); });
+                iItemModelSink += item_model().items_updated([this](item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow) { items_updated(aFirstRow, aEndRow); });
+                if constexpr (is_virtual_item_model)
+                {
+                    iItemModelSink += item_model().rows_fetched([this](item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow) { rows_fetched(aFirstRow, aEndRow); });
+                    // measuring every row of the column would fetch every page
+                    iWidthMode = column_width_mode::Estimated;
+                }
                 iItemModelSink += item_model().destroying([this]() 
                 { 
                     iItemModel = nullptr;
                     iColumns.clear(); 
                     iRows.clear(); 
+                    discard_row_pages();
                     reset_maps();
                     reset_meta();
                     reset_sort();
@@ -154,8 +186,20 @@ namespace neogfx
                 for (item_model_index::column_type col = 0; col < item_model().columns(); ++col)
                     iColumns.emplace_back(col);
                 iRows.clear();
-                for (item_model_index::row_type row = 0; row < item_model().rows(); ++row)
-                    item_added(item_model_index{ row });
+                discard_row_pages();
+                iAppliedFilters = std::nullopt;
+                // the rows of a virtual item model map 1:1 to the model's rows so have no presentation rows to load
+                if constexpr (!is_virtual_item_model)
+                {
+                    if constexpr (container_traits::is_flat)
+                    {
+                        iRows.reserve(item_model().rows());
+                        for (item_model_index::row_type row = 0; row < item_model().rows(); ++row)
+                            iRows.push_back(row_type{ row });
+                    }
+                    else
+                        load_tree();
+                }
                 reset_maps();
                 reset_meta();
                 reset_sort();
@@ -164,11 +208,21 @@ namespace neogfx
         }
         item_model_index to_item_model_index(const item_presentation_model_index& aIndex) const override
         {
-            return item_model_index{ row(aIndex).value, model_column(aIndex.column()) };
+            if constexpr (is_virtual_item_model)
+                return item_model_index{ aIndex.row(), model_column(aIndex.column()) };
+            else
+                return item_model_index{ row(aIndex).value, model_column(aIndex.column()) };
         }
         bool has_item_model_index(const item_model_index& aIndex) const override
         {
-            return aIndex.row() < row_map().size() && row_map()[aIndex.row()];
+            if constexpr (is_virtual_item_model)
+                return aIndex.row() < rows();
+            if (aIndex.row() >= row_map().size() || !row_map()[aIndex.row()])
+                return false;
+            if constexpr (container_traits::is_tree)
+                return iTreeNodes[*row_map()[aIndex.row()]].visible != std::nullopt;
+            else
+                return true;
         }
         item_presentation_model_index from_item_model_index(const item_model_index& aIndex, bool aIgnoreColumn = false) const override
         {
@@ -179,7 +233,9 @@ namespace neogfx
     public:
         uint32_t rows() const override
         {
-            if constexpr (container_traits::is_flat)
+            if constexpr (is_virtual_item_model)
+                return has_item_model() ? item_model().rows() : 0u;
+            else if constexpr (container_traits::is_flat)
                 return static_cast<uint32_t>(iRows.size());
             else
                 return static_cast<uint32_t>(iRows.ksize());
@@ -195,7 +251,14 @@ namespace neogfx
     public:
         void accept(i_meta_visitor& aVisitor, bool aIgnoreCollapsedState = false) override
         {
-            if constexpr (container_traits::is_flat)
+            if constexpr (is_virtual_item_model)
+            {
+                for (auto& page : iRowPages)
+                    for (auto& row : page.second.rows)
+                        for (auto& cell : row.cells)
+                            aVisitor.visit(cell);
+            }
+            else if constexpr (container_traits::is_flat)
             {
                 for (auto row = iRows.begin(); row != iRows.end(); ++row)
                     for (auto& cell : row->cells)
@@ -215,6 +278,18 @@ namespace neogfx
             }
         }
     public:
+        column_width_mode width_mode() const override
+        {
+            return iWidthMode;
+        }
+        void set_width_mode(column_width_mode aMode) override
+        {
+            if (iWidthMode != aMode)
+            {
+                iWidthMode = aMode;
+                reset_column_meta();
+            }
+        }
         dimension column_width(item_presentation_model_index::column_type aColumnIndex, const i_graphics_context& aGc, bool aIncludePadding = true) const override
         {
             if (iColumns.size() < aColumnIndex + 1u)
@@ -223,10 +298,22 @@ namespace neogfx
             if (columnWidth != std::nullopt)
                 return *columnWidth + (aIncludePadding ? cell_padding(aGc).size().cx : 0.0);
             columnWidth = 0.0;
-            for (item_presentation_model_index::row_type row = 0u; row < rows(); ++row)
+            if (iWidthMode == column_width_mode::Estimated && rows() > ColumnWidthSampleSize)
             {
-                auto const cellWidth = cell_extents(item_presentation_model_index{ row, aColumnIndex }, aGc).cx;
-                columnWidth = std::max(*columnWidth, cellWidth);
+                // evenly spaced sample including the first and last rows
+                for (item_presentation_model_index::row_type sample = 0u; sample < ColumnWidthSampleSize; ++sample)
+                {
+                    auto const row = static_cast<item_presentation_model_index::row_type>(static_cast<uint64_t>(sample) * (rows() - 1u) / (ColumnWidthSampleSize - 1u));
+                    columnWidth = std::max(*columnWidth, cell_extents(item_presentation_model_index{ row, aColumnIndex }, aGc).cx);
+                }
+            }
+            else
+            {
+                for (item_presentation_model_index::row_type row = 0u; row < rows(); ++row)
+                {
+                    auto const cellWidth = cell_extents(item_presentation_model_index{ row, aColumnIndex }, aGc).cx;
+                    columnWidth = std::max(*columnWidth, cellWidth);
+                }
             }
             return *columnWidth + (aIncludePadding ? cell_padding(aGc).size().cx : 0.0);
         }
@@ -295,12 +382,40 @@ namespace neogfx
                 else
                     ItemCollapsing.trigger(aIndex);
                 cell_meta(indexFirstColumn).expanded = !cell_meta(indexFirstColumn).expanded;
-                if (cell_meta(indexFirstColumn).expanded)
-                    std::next(begin(), aIndex.row()).unskip_children();
+                bool const expanded = cell_meta(indexFirstColumn).expanded;
+                // only the k rows shown or hidden below the node are touched: O(k log n); the node's descendants are
+                // walked in step with the rows shown below it, skipping the subtree of any descendant not shown
+                auto const position = tree_node_position(aIndex.row());
+                auto const end = position + 1u + iTreeNodes[position].descendants;
+                auto node = *iTreeNodes[position].visible;
+                if (expanded)
+                    node.unskip_children();
+                item_presentation_model_index::row_type toggled = 0u;
+                auto shown = std::next(node);
+                for (auto descendant = position + 1u; descendant < end && shown != iRows.kend();)
+                {
+                    if (iTreeNodes[descendant].row != &*shown)
+                    {
+                        descendant += 1u + iTreeNodes[descendant].descendants;
+                        continue;
+                    }
+                    if (expanded)
+                        iTreeNodes[descendant].visible = shown;
+                    else
+                        iTreeNodes[descendant].visible = std::nullopt;
+                    iTreeVisibleNodes.set(descendant, expanded ? 1u : 0u);
+                    ++toggled;
+                    ++descendant;
+                    ++shown;
+                }
+                if (!expanded)
+                    node.skip_children();
+                if (iWidthMode == column_width_mode::Exact)
+                    reset_column_meta();
+                if (expanded)
+                    insert_row_heights(aIndex.row() + 1u, toggled);
                 else
-                    std::next(begin(), aIndex.row()).skip_children();
-                reset_maps();
-                reset_meta();
+                    erase_row_heights(aIndex.row() + 1u, toggled);
                 if (cell_meta(indexFirstColumn).expanded)
                     ItemExpanded.trigger(aIndex);
                 else
@@ -415,6 +530,8 @@ namespace neogfx
     public:
         dimension item_height(const item_presentation_model_index& aIndex, const i_units_context& aUnitsContext) const override
         {
+            if constexpr (is_virtual_item_model)
+                return uniform_row_height(aUnitsContext);
             dimension height = 0.0;
             for (uint32_t col = 0; col < row(aIndex).cells.size(); ++col)
             {
@@ -437,76 +554,39 @@ namespace neogfx
         }
         double total_height(const i_units_context& aUnitsContext) const override
         {
-            if (iTotalHeight != std::nullopt)
-                return *iTotalHeight;
-            i_scrollbar::value_type height = 0.0;
-            for (item_presentation_model_index::row_type row = 0; row < rows(); ++row)
-                height += item_height(item_presentation_model_index(row, 0), aUnitsContext);
-            iTotalHeight = height;
-            return *iTotalHeight;
+            if constexpr (is_virtual_item_model)
+                return rows() * uniform_row_height(aUnitsContext);
+            return row_heights(aUnitsContext).total();
         }
         double item_position(const item_presentation_model_index& aIndex, const i_units_context& aUnitsContext) const override
         {
-            if (iPositions[aIndex.row()] == std::nullopt)
-            {
-                auto pred = [](const optional_position& lhs, const optional_position& rhs) -> bool
-                {
-                    if (lhs == std::nullopt && rhs == std::nullopt)
-                        return false;
-                    else if (lhs != std::nullopt && rhs == std::nullopt)
-                        return true;
-                    else if (lhs == std::nullopt && rhs != std::nullopt)
-                        return false;
-                    else
-                        return *lhs < *rhs;
-                };
-                auto i = std::lower_bound(iPositions.begin(), iPositions.end(), optional_position(), pred);
-                auto row = static_cast<item_presentation_model_index::row_type>(std::distance(iPositions.begin(), i));
-                double position = (row == 0 ? 0.0 : **(std::prev(i)) + item_height(item_presentation_model_index(row - 1), aUnitsContext));
-                while (row <= aIndex.row())
-                {
-                    iPositions[row] = position;
-                    position += item_height(item_presentation_model_index(row), aUnitsContext);
-                    ++row;
-                }
-            }
-            return *iPositions[aIndex.row()];
+            if constexpr (is_virtual_item_model)
+                return aIndex.row() * uniform_row_height(aUnitsContext);
+            auto const& heights = row_heights(aUnitsContext);
+            measure_row(aIndex.row(), aUnitsContext);
+            return heights.prefix_sum(aIndex.row());
         }
         std::pair<item_presentation_model_index::row_type, coordinate> item_at(double aPosition, const i_units_context& aUnitsContext) const override
         {
             if (rows() == 0)
                 return std::pair<item_presentation_model_index::row_type, coordinate>{ 0u, 0.0 };
-            auto pred = [](const optional_position& lhs, const optional_position& rhs) -> bool
+            auto const position = std::max(aPosition, 0.0);
+            if constexpr (is_virtual_item_model)
             {
-                if (lhs == std::nullopt && rhs == std::nullopt)
-                    return false;
-                else if (lhs != std::nullopt && rhs == std::nullopt)
-                    return true;
-                else if (lhs == std::nullopt && rhs != std::nullopt)
-                    return false;
-                else
-                    return *lhs < *rhs;
-            };
-            auto i = std::lower_bound(iPositions.begin(), iPositions.end(), aPosition, pred);
-            if ((i == iPositions.end() || (*i != std::nullopt && **i > aPosition)) && i != iPositions.begin())
-                --i;
-            while (*i == std::nullopt)
-            {
-                auto j = std::lower_bound(iPositions.begin(), iPositions.end(), optional_position(), pred);
-                auto row = static_cast<item_presentation_model_index::row_type>(std::distance(iPositions.begin(), j));
-                double position = (row == 0 ? 0.0 : **(std::prev(j)) + item_height(item_presentation_model_index(row - 1), aUnitsContext));
-                while (row < iPositions.size())
-                {
-                    iPositions[row] = position;
-                    position += item_height(item_presentation_model_index(row), aUnitsContext);
-                    ++row;
-                }
-                i = std::lower_bound(iPositions.begin(), iPositions.end(), aPosition, pred);
-                if ((i == iPositions.end() || (*i != std::nullopt && **i > aPosition)) && i != iPositions.begin())
-                    --i;
+                auto const height = uniform_row_height(aUnitsContext);
+                auto const row = static_cast<item_presentation_model_index::row_type>(std::min<double>(std::floor(position / height), rows() - 1u));
+                return std::pair<item_presentation_model_index::row_type, coordinate>{ row, static_cast<coordinate>(row * height - aPosition) };
             }
-            auto const result = std::pair<item_presentation_model_index::row_type, coordinate>{ static_cast<item_presentation_model_index::row_type>(std::distance(iPositions.begin(), i)), static_cast<coordinate>(**i - aPosition) };
-            return result;
+            auto const& heights = row_heights(aUnitsContext);
+            auto row = static_cast<item_presentation_model_index::row_type>(std::min<std::size_t>(heights.find(position), rows() - 1u));
+            // measuring a row changes its height (so it may no longer span the position) but not its position, so the
+            // lookup is repeated until it lands on a row that has already been measured
+            while (!iRowHeightMeasured[row])
+            {
+                measure_row(row, aUnitsContext);
+                row = static_cast<item_presentation_model_index::row_type>(std::min<std::size_t>(heights.find(position), rows() - 1u));
+            }
+            return std::pair<item_presentation_model_index::row_type, coordinate>{ row, static_cast<coordinate>(heights.prefix_sum(row) - aPosition) };
         }
     public:
         item_cell_flags cell_flags(const item_presentation_model_index& aIndex) const override
@@ -532,7 +612,7 @@ namespace neogfx
                     row(aIndex).cells.resize(aIndex.column() + 1);
                     if constexpr (container_traits::is_tree)
                         if (aIndex.column() == 0)
-                            row(aIndex).cells[aIndex.column()].expanded = !std::next(begin(), aIndex.row()).children_skipped();
+                            row(aIndex).cells[aIndex.column()].expanded = !visible_tree_node(aIndex.row()).visible->children_skipped();
                 }
                 return row(aIndex).cells[aIndex.column()];
             }
@@ -711,20 +791,23 @@ namespace neogfx
         }
         neogfx::glyph_text& cell_glyph_text(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const override
         {
-            optional_font cellFont = cell_font(aIndex);
-            if (cell_meta(aIndex).text != std::nullopt)
-                return *cell_meta(aIndex).text;
-            cell_meta(aIndex).text = aGc.to_glyph_text(cell_to_string(aIndex), cellFont == std::nullopt ? default_font() : *cellFont);
-            return *cell_meta(aIndex).text;
+            auto& cellMeta = cell_meta(aIndex);
+            if (cellMeta.text != std::nullopt)
+                return *cellMeta.text;
+            cellMeta.text = shape_cell_text(aIndex, aGc);
+            if (!glyph_text_retained(aIndex.row()))
+                iGlyphTextStrays.push_back(aIndex.row());
+            return *cellMeta.text;
         }
         size cell_extents(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const override
         {
-            auto oldItemHeight = item_height(aIndex, aGc);
             auto const& cellFont = (cell_font(aIndex) == std::nullopt ? default_font() : *cell_font(aIndex));
             auto& cellMeta = cell_meta(aIndex);
             if (cellMeta.extents != std::nullopt)
                 return units_converter(aGc).from_device_units(*cellMeta.extents);
-            size cellExtents = cell_glyph_text(aIndex, aGc).extents();
+            // measuring a row outside the retained window (e.g. for an exact column width) does not keep its text
+            size cellExtents = (cellMeta.text != std::nullopt || glyph_text_retained(aIndex.row()) ?
+                cell_glyph_text(aIndex, aGc).extents() : shape_cell_text(aIndex, aGc).extents());
             auto const& cellInfo = item_model().cell_info(to_item_model_index(aIndex));
             if (cell_editable(aIndex) && cellInfo.dataStep != neolib::none)
             {
@@ -746,10 +829,36 @@ namespace neogfx
             }
             cellExtents.cy = std::max(cellExtents.cy, cellFont.height());
             cellMeta.extents = cellExtents.ceil();
-            if (iTotalHeight != std::nullopt)
-                *iTotalHeight += (item_height(aIndex, aGc) - oldItemHeight);
+            if (iWidthMode == column_width_mode::Estimated)
+            {
+                auto& columnWidth = column(aIndex.column()).width;
+                auto const cellWidth = units_converter(aGc).from_device_units(*cellMeta.extents).cx;
+                if (columnWidth != std::nullopt && *columnWidth < cellWidth)
+                    columnWidth = cellWidth;
+            }
+            if (iRowHeightsValid && aIndex.row() < iRowHeights.size() && iRowHeightMeasured[aIndex.row()])
+                iRowHeights.set(aIndex.row(), item_height(aIndex, aGc));
             return units_converter(aGc).from_device_units(*cell_meta(aIndex).extents);
         }
+        void retain_glyph_text(item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow) const override
+        {
+            aEndRow = std::max(aFirstRow, aEndRow);
+            auto discard = [&](item_presentation_model_index::row_type aRow)
+            {
+                auto const rowMeta = find_row(aRow);
+                if (rowMeta != nullptr && (aRow < aFirstRow || aRow >= aEndRow))
+                    for (auto& cell : rowMeta->cells)
+                        cell.text = std::nullopt;
+            };
+            if (iGlyphTextWindow != std::nullopt)
+                for (auto row = iGlyphTextWindow->first; row < std::min(iGlyphTextWindow->second, rows()); ++row)
+                    discard(row);
+            for (auto row : iGlyphTextStrays)
+                if (row < rows())
+                    discard(row);
+            iGlyphTextStrays.clear();
+            iGlyphTextWindow.emplace(aFirstRow, aEndRow);
+        }
         dimension indent(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const override
         {
             if constexpr (container_traits::is_flat)
@@ -758,15 +867,15 @@ namespace neogfx
                 return 0.0;
             else
             {
-                auto baseIter = typename item_model_type::const_base_iterator{ item_model().index_to_iterator(to_item_model_index(aIndex)) };
-                auto treeIter = baseIter.get<typename item_model_type::const_iterator, typename item_model_type::const_iterator,
-                    typename item_model_type::iterator, typename item_model_type::const_sibling_iterator, typename item_model_type::sibling_iterator>();
-                return (treeIter.depth() + 1) * cell_tree_expander_size(aIndex, aGc)->cx;
+                return (visible_tree_node(aIndex.row()).depth + 1) * cell_tree_expander_size(aIndex, aGc)->cx;
             }
         }
     public:
         bool sortable() const override
         {
+            if constexpr (is_virtual_item_model)
+                if (has_item_model() && !item_model().can_sort())
+                    return false;
             return iSortable;
         }
         optional_sort sorting_by() const override
@@ -794,32 +903,42 @@ namespace neogfx
                     break;
                 }
             }
-            execute_sort(true);
+            if constexpr (is_virtual_item_model)
+                execute_source_sort();
+            else
+                execute_sort(true);
         }
         void reset_sort() override
         {
             iSortOrder.clear();
             if (sortable())
-                execute_sort();
+            {
+                if constexpr (is_virtual_item_model)
+                    execute_source_sort();
+                else
+                    execute_sort();
+            }
         }
     public:
         optional_item_presentation_model_index find_item(const filter_search_key& aFilterSearchKey, item_presentation_model_index::column_type aColumnIndex = 0, filter_search_type aFilterSearchType = filter_search_type::Prefix, case_sensitivity aCaseSensitivity = case_sensitivity::CaseInsensitive) const override
         {
+            filter_matcher const matcher{ filter{ aColumnIndex, aFilterSearchKey, aFilterSearchType, aCaseSensitivity }, 0u };
+            if (matcher.empty())
+                return optional_item_presentation_model_index{};
             for (item_presentation_model_index::row_type row = 0; row < rows(); ++row)
             {
-                auto modelIndex = to_item_model_index(item_presentation_model_index{ row, aColumnIndex });
-                auto const& origValue = item_model().cell_data(modelIndex).to_string();
-                auto const& value = aCaseSensitivity == case_sensitivity::CaseSensitive ? origValue : boost::to_upper_copy<std::string>(origValue);
-                auto const& origKey = aFilterSearchKey;
-                auto const& key = aCaseSensitivity == case_sensitivity::CaseSensitive ? origKey : boost::to_upper_copy<std::string>(origKey);
-                if (key.empty())
-                    continue;
-                switch (aFilterSearchType)
+                if constexpr (is_virtual_item_model)
                 {
-                case filter_search_type::Prefix:
-                    if (value.size() >= key.size() && value.substr(0, key.size()) == key)
-                        return from_item_model_index(modelIndex);
+                    // only the rows already fetched are searched; the rest of a page not resident is skipped
+                    if (!item_model().resident(row))
+                    {
+                        row = (row / item_model().page_size() + 1u) * item_model().page_size() - 1u;
+                        continue;
+                    }
                 }
+                auto modelIndex = to_item_model_index(item_presentation_model_index{ row, aColumnIndex });
+                if (matcher.matches(item_model().cell_data(modelIndex)))
+                    return from_item_model_index(modelIndex);
             }
             return optional_item_presentation_model_index{};
         }
@@ -837,6 +956,9 @@ namespace neogfx
         }
         void filter_by(item_presentation_model_index::column_type aColumnIndex, const filter_search_key& aFilterSearchKey, filter_search_type aFilterSearchType = filter_search_type::Value, case_sensitivity aCaseSensitivity = case_sensitivity::CaseInsensitive) override
         {
+            if constexpr (is_virtual_item_model)
+                if (!item_model().can_filter())
+                    throw typename item_model_type::cannot_filter();
             iFilters.push_back(filter{ aColumnIndex, aFilterSearchKey, aFilterSearchType, aCaseSensitivity });
             for (auto i = iFilters.begin(); i != std::prev(iFilters.end()); ++i)
             {
@@ -873,6 +995,8 @@ namespace neogfx
         }
         void execute_sort(bool aForce = false)
         {
+            if constexpr (is_virtual_item_model)
+                return; // see execute_source_sort()
             if (!sortable() && !aForce)
                 return;
             if (rows() <= 1)
@@ -883,78 +1007,373 @@ namespace neogfx
                 return;
             }
             ItemsSorting.trigger();
-            auto sortPredicate = [&](const typename container_type::value_type& aLhs, const typename container_type::value_type& aRhs) -> bool
+            // sort keys (with strings case folded) are computed once per sort rather than in every comparison
+            std::vector<sort_key> keys;
+            auto const modelRows = item_model().rows();
+            build_sort_keys(keys, modelRows);
+            auto sortPredicate = [&](item_model_index::row_type aLhs, item_model_index::row_type aRhs) -> bool
             {
                 for (std::size_t i = 0; i < iSortOrder.size(); ++i)
                 {
-                    auto col = iSortOrder[i].first;
-                    auto const& v1 = item_model().cell_data(item_model_index{ aLhs.value, model_column(col) });
-                    auto const& v2 = item_model().cell_data(item_model_index{ aRhs.value, model_column(col) });
-                    if (std::holds_alternative<std::string>(v1) && std::holds_alternative<std::string>(v2))
+                    auto const& k1 = keys[i * modelRows + aLhs];
+                    auto const& k2 = keys[i * modelRows + aRhs];
+                    if (k1.isString && k2.isString)
                     {
-                        std::string s1 = boost::to_upper_copy<std::string>(std::get<std::string>(v1));
-                        std::string s2 = boost::to_upper_copy<std::string>(std::get<std::string>(v2));
-                        if (s1 < s2)
+                        auto const compare = k1.folded.compare(k2.folded);
+                        if (compare < 0)
                             return iSortOrder[i].second == sort_direction::Ascending;
-                        else if (s2 < s1)
+                        else if (compare > 0)
                             return iSortOrder[i].second == sort_direction::Descending;
                     }
-                    if (v1 < v2)
+                    if (*k1.value < *k2.value)
                         return iSortOrder[i].second == sort_direction::Ascending;
-                    else if (v2 < v1)
+                    else if (*k2.value < *k1.value)
                         return iSortOrder[i].second == sort_direction::Descending;
                 }
                 return false;
             };
             if constexpr (container_traits::is_flat)
-                std::sort(iRows.begin(), iRows.end(), sortPredicate);
+            {
+                // stable so that rows equal under the sort order keep their previous relative order
+                std::vector<item_model_index::row_type> order(iRows.size());
+                std::transform(iRows.begin(), iRows.end(), order.begin(), [](const row_type& aRow) { return aRow.value; });
+                std::vector<std::size_t> positions(iRows.size());
+                std::iota(positions.begin(), positions.end(), 0u);
+                parallel_stable_sort(positions.begin(), positions.end(), [&](std::size_t aLhs, std::size_t aRhs) { return sortPredicate(order[aLhs], order[aRhs]); });
+                container_type sorted{ iRows.get_allocator() };
+                sorted.reserve(iRows.size());
+                for (auto position : positions)
+                    sorted.push_back(std::move(iRows[position]));
+                iRows.swap(sorted);
+            }
             else
-                iRows.sort(sortPredicate);
+                iRows.sort([&](const row_type& aLhs, const row_type& aRhs) { return sortPredicate(aLhs.value, aRhs.value); });
             reset_maps();
-            reset_position_meta(0);
+            reset_position_meta();
+            ItemsSorted.trigger();
+        }
+        void execute_source_sort()
+        {
+            if (!item_model().can_sort())
+                return;
+            if (iSortOrder.empty())
+            {
+                sort_by(0, sort_direction::Ascending);
+                return;
+            }
+            ItemsSorting.trigger();
+            std::vector<typename item_model_type::sort> sortOrder;
+            for (auto const& s : iSortOrder)
+                sortOrder.emplace_back(model_column(s.first), s.second);
+            // the model's rows are replaced (items_updated) by those of the source's sorted view
+            item_model().sort_by(sortOrder);
             ItemsSorted.trigger();
         }
+        bool source_filters() const
+        {
+            if constexpr (is_virtual_item_model)
+                return item_model().can_filter();
+            else
+                return false;
+        }
         void execute_filter()
         {
             neolib::scoped_flag sf1{ iInitializing };
             neolib::scoped_flag sf2{ iFiltering };
             ItemsFiltering.trigger();
-            iRows.clear();
-            for (item_model_index::row_type row = 0; row < item_model().rows(); ++row)
+            if constexpr (is_virtual_item_model)
             {
-                bool matches = true;
-                for (auto const& filter : iFilters)
+                std::vector<typename item_model_type::filter> filters;
+                for (auto const& f : iFilters)
+                    filters.emplace_back(model_column(std::get<0>(f)), std::get<1>(f), std::get<2>(f), std::get<3>(f));
+                // the model's rows are replaced (items_updated) by those of the source's filtered view
+                item_model().filter_by(filters);
+                iAppliedFilters = iFilters;
+                ItemsFiltered.trigger();
+                return;
+            }
+            std::vector<filter_matcher> matchers;
+            for (auto const& filter : iFilters)
+            {
+                matchers.emplace_back(filter, model_column(std::get<0>(filter)));
+                if (matchers.back().empty())
+                    matchers.pop_back();
+            }
+            // if the new filters can only remove rows from the current result (e.g. the search key has been extended)
+            // then only the current result is scanned rather than the whole model
+            std::vector<item_model_index::row_type> candidates;
+            bool incremental = false;
+            if constexpr (container_traits::is_flat)
+                if (iAppliedFilters && narrows(*iAppliedFilters, iFilters))
                 {
-                    auto const& origValue = item_model().cell_data(item_model_index{ row, model_column(std::get<0>(filter)) }).to_string();
-                    auto const& value = (std::get<3>(filter) == case_sensitivity::CaseSensitive ? origValue : boost::to_upper_copy<std::string>(origValue));
-                    auto const& origKey = std::get<1>(filter);
-                    auto const& key = (std::get<3>(filter) == case_sensitivity::CaseSensitive ? origKey : boost::to_upper_copy<std::string>(origKey));
-                    if (key.empty())
-                        continue;
-                    switch (std::get<2>(filter))
+                    incremental = true;
+                    candidates.reserve(iRows.size());
+                    for (auto const& row : iRows)
+                        candidates.push_back(row.value);
+                    if (!std::is_sorted(candidates.begin(), candidates.end()))
+                        std::sort(candidates.begin(), candidates.end());
+                }
+            if (!incremental)
+            {
+                candidates.resize(item_model().rows());
+                std::iota(candidates.begin(), candidates.end(), 0u);
+            }
+            std::vector<char> results(candidates.size(), 1);
+            if (!matchers.empty())
+            {
+                auto scan = [&](std::size_t aFirst, std::size_t aLast)
+                {
+                    for (auto c = aFirst; c < aLast; ++c)
                     {
-                    case filter_search_type::Prefix:
-                        if (value.size() < key.size() || value.substr(0, key.size()) != key)
-                            matches = false;
-                        break;
-                    case filter_search_type::Glob:
-                        // todo
-                        break;
-                    case filter_search_type::Regex:
-                        // todo
-                        break;
+                        for (auto const& matcher : matchers)
+                            if (!matcher.matches(item_model().cell_data(item_model_index{ candidates[c], matcher.model_column() })))
+                            {
+                                results[c] = 0;
+                                break;
+                            }
                     }
-                }
-                if (matches)
-                    item_added(item_model_index{ row });
+                };
+                auto const threadCount = worker_thread_count(candidates.size());
+                std::vector<std::future<void>> workers;
+                for (std::size_t t = 1u; t < threadCount; ++t)
+                    workers.push_back(std::async(std::launch::async, scan, candidates.size() * t / threadCount, candidates.size() * (t + 1u) / threadCount));
+                scan(0u, candidates.size() / threadCount);
+                for (auto& w : workers)
+                    w.get();
             }
+            iRows.clear();
+            if constexpr (container_traits::is_flat)
+            {
+                for (std::size_t c = 0; c < candidates.size(); ++c)
+                    if (results[c])
+                        iRows.push_back(row_type{ candidates[c] });
+            }
+            else
+                load_tree(&results); // every model row is a candidate
+            iAppliedFilters = iFilters;
             reset_maps();
             reset_cell_meta();
-            reset_position_meta(0);
+            reset_position_meta();
             ItemsFiltered.trigger();
             execute_sort();
         }
     private:
+        static constexpr item_presentation_model_index::row_type ColumnWidthSampleSize = 256u;
+    private:
+        // A filter compiled once per filtering pass; case insensitive matching folds the cell text a character at a
+        // time (as boost::to_upper does) rather than upper casing a copy of every cell. Safe to use concurrently.
+        class filter_matcher
+        {
+        public:
+            filter_matcher(const filter& aFilter, item_model_index::column_type aModelColumn) :
+                iModelColumn{ aModelColumn },
+                iType{ std::get<2>(aFilter) },
+                iCaseSensitive{ std::get<3>(aFilter) == case_sensitivity::CaseSensitive },
+                iCtype{ std::use_facet<std::ctype<char>>(std::locale{}) },
+                iKey{ std::get<1>(aFilter) }
+            {
+                if (!iCaseSensitive)
+                    iCtype.toupper(&iKey[0], &iKey[0] + iKey.size());
+                if (iType == filter_search_type::Regex && !iKey.empty())
+                {
+                    try
+                    {
+                        iRegex.emplace(std::get<1>(aFilter), iCaseSensitive ? std::regex::ECMAScript : std::regex::ECMAScript | std::regex::icase);
+                    }
+                    catch (const std::regex_error&)
+                    {
+                        // incomplete pattern (still being typed); ignore the filter as for an empty search key
+                        iKey.clear();
+                    }
+                }
+            }
+        public:
+            item_model_index::column_type model_column() const
+            {
+                return iModelColumn;
+            }
+            bool empty() const
+            {
+                return iKey.empty();
+            }
+            bool matches(const item_cell_data& aValue) const
+            {
+                if (std::holds_alternative<std::string>(aValue))
+                    return matches(std::get<std::string>(aValue));
+                return matches(aValue.to_string());
+            }
+            bool matches(const std::string& aValue) const
+            {
+                switch (iType)
+                {
+                case filter_search_type::Prefix:
+                    if (aValue.size() < iKey.size())
+                        return false;
+                    for (std::size_t i = 0; i < iKey.size(); ++i)
+                        if (fold(aValue[i]) != iKey[i])
+                            return false;
+                    return true;
+                case filter_search_type::Glob:
+                    return glob_matches(aValue);
+                case filter_search_type::Regex:
+                    return std::regex_search(aValue, *iRegex);
+                default:
+                    return true;
+                }
+            }
+        private:
+            char fold(char aCharacter) const
+            {
+                return iCaseSensitive ? aCharacter : iCtype.toupper(aCharacter);
+            }
+            // '*' matches any sequence and '?' any single character; the whole value must match
+            bool glob_matches(const std::string& aValue) const
+            {
+                std::size_t k = 0;
+                std::size_t v = 0;
+                std::optional<std::size_t> starKey;
+                std::size_t starValue = 0;
+                while (v < aValue.size())
+                {
+                    if (k < iKey.size() && iKey[k] == '*')
+                    {
+                        starKey = k++;
+                        starValue = v;
+                    }
+                    else if (k < iKey.size() && (iKey[k] == '?' || iKey[k] == fold(aValue[v])))
+                    {
+                        ++k;
+                        ++v;
+                    }
+                    else if (starKey)
+                    {
+                        k = *starKey + 1u;
+                        v = ++starValue;
+                    }
+                    else
+                        return false;
+                }
+                while (k < iKey.size() && iKey[k] == '*')
+                    ++k;
+                return k == iKey.size();
+            }
+        private:
+            item_model_index::column_type iModelColumn;
+            filter_search_type iType;
+            bool iCaseSensitive;
+            const std::ctype<char>& iCtype;
+            std::string iKey;
+            std::optional<std::regex> iRegex;
+        };
+        // Whether every row matching aNext also matches aPrevious.
+        static bool narrows(const filter& aPrevious, const filter& aNext)
+        {
+            auto const& previousKey = std::get<1>(aPrevious);
+            auto const& nextKey = std::get<1>(aNext);
+            if (previousKey.empty())
+                return true;
+            if (std::get<0>(aPrevious) != std::get<0>(aNext) || std::get<2>(aPrevious) != std::get<2>(aNext) || std::get<3>(aPrevious) != std::get<3>(aNext))
+                return false;
+            if (previousKey == nextKey)
+                return true;
+            bool const extended = nextKey.size() > previousKey.size() && nextKey.compare(0, previousKey.size(), previousKey) == 0;
+            switch (std::get<2>(aNext))
+            {
+            case filter_search_type::Prefix:
+                return extended;
+            case filter_search_type::Glob:
+                // "abc*" -> "abc*def" narrows but "abc" -> "abc*" widens
+                return extended && previousKey.back() == '*';
+            default:
+                return false;
+            }
+        }
+        static bool narrows(const std::vector<filter>& aPrevious, const std::vector<filter>& aNext)
+        {
+            for (auto const& previous : aPrevious)
+            {
+                auto next = std::find_if(aNext.begin(), aNext.end(), [&](const filter& aFilter) { return std::get<0>(aFilter) == std::get<0>(previous); });
+                if (next == aNext.end() ? !std::get<1>(previous).empty() : !narrows(previous, *next))
+                    return false;
+            }
+            return true;
+        }
+        struct sort_key
+        {
+            const item_cell_data* value;
+            bool isString;
+            std::string folded;
+        };
+        static constexpr std::size_t ParallelThreshold = 65536u;
+        static std::size_t worker_thread_count(std::size_t aCount)
+        {
+            if (aCount < ParallelThreshold)
+                return 1u;
+            return std::max<std::size_t>(1u, std::min<std::size_t>(std::thread::hardware_concurrency(), aCount / (ParallelThreshold / 4u)));
+        }
+        void build_sort_keys(std::vector<sort_key>& aKeys, item_model_index::row_type aModelRows) const
+        {
+            aKeys.assign(iSortOrder.size() * aModelRows, sort_key{ nullptr, false });
+            std::vector<sort_key*> strings;
+            for (std::size_t i = 0; i < iSortOrder.size(); ++i)
+            {
+                auto const col = model_column(iSortOrder[i].first);
+                for (auto const& row : iRows)
+                {
+                    auto& key = aKeys[i * aModelRows + row.value];
+                    key.value = &item_model().cell_data(item_model_index{ row.value, col });
+                    key.isString = std::holds_alternative<std::string>(*key.value);
+                    if (key.isString)
+                        strings.push_back(&key);
+                }
+            }
+            auto fold = [&](std::size_t aFirst, std::size_t aLast)
+            {
+                for (auto s = aFirst; s < aLast; ++s)
+                    strings[s]->folded = boost::to_upper_copy<std::string>(std::get<std::string>(*strings[s]->value));
+            };
+            auto const threadCount = worker_thread_count(strings.size());
+            std::vector<std::future<void>> workers;
+            for (std::size_t t = 1u; t < threadCount; ++t)
+                workers.push_back(std::async(std::launch::async, fold, strings.size() * t / threadCount, strings.size() * (t + 1u) / threadCount));
+            fold(0u, strings.size() / threadCount);
+            for (auto& w : workers)
+                w.get();
+        }
+        template <typename RandomIt, typename Compare>
+        static void parallel_stable_sort(RandomIt aFirst, RandomIt aLast, Compare aCompare)
+        {
+            auto const count = static_cast<std::size_t>(std::distance(aFirst, aLast));
+            auto const threadCount = worker_thread_count(count);
+            if (threadCount < 2u)
+            {
+                std::stable_sort(aFirst, aLast, aCompare);
+                return;
+            }
+            // stable sort equal sized runs concurrently then stable merge adjacent pairs of runs until one remains
+            std::vector<RandomIt> bounds;
+            for (std::size_t t = 0; t <= threadCount; ++t)
+                bounds.push_back(aFirst + count * t / threadCount);
+            std::vector<std::future<void>> workers;
+            for (std::size_t t = 0; t < threadCount; ++t)
+                workers.push_back(std::async(std::launch::async, [&, t]() { std::stable_sort(bounds[t], bounds[t + 1u], aCompare); }));
+            for (auto& w : workers)
+                w.get();
+            while (bounds.size() > 2u)
+            {
+                workers.clear();
+                std::vector<RandomIt> merged;
+                for (std::size_t b = 0; b + 2u < bounds.size(); b += 2u)
+                    workers.push_back(std::async(std::launch::async, [&, b]() { std::inplace_merge(bounds[b], bounds[b + 1u], bounds[b + 2u], aCompare); }));
+                for (std::size_t b = 0; b < bounds.size(); b += 2u)
+                    merged.push_back(bounds[b]);
+                if (bounds.size() % 2u == 0u)
+                    merged.push_back(bounds.back());
+                for (auto& w : workers)
+                    w.get();
+                bounds.swap(merged);
+            }
+        }
         void item_model_column_info_changed(item_model_index::column_type aColumnIndex)
         {
             if (has_item_model_index(item_model_index{ 0, aColumnIndex }))
@@ -967,52 +1386,97 @@ namespace neogfx
         }
         void item_added(const item_model_index& aItemIndex)
         {
+            if (!iFiltering)
+                iAppliedFilters = std::nullopt;
+            std::optional<uint32_t> parentPosition;
             if constexpr (container_traits::is_tree)
-                if (item_model().has_parent(aItemIndex) && !has_item_model_index(item_model().parent(aItemIndex)))
-                    return;
+                if (item_model().has_parent(aItemIndex))
+                {
+                    auto const parentIndex = item_model().parent(aItemIndex);
+                    if (!has_item_model_index(parentIndex))
+                        return;
+                    parentPosition = *row_map()[parentIndex.row()];
+                }
             for (auto& row : iRows)
                 if (row.value >= aItemIndex.row())
                     ++row.value;
             if constexpr (container_traits::is_flat)
+            {
                 iRows.push_back(row_type{ aItemIndex.row() });
+                if (!iInitializing)
+                    reset_maps(aItemIndex);
+            }
             else
             {
-                if (!item_model().has_parent(aItemIndex))
-                {
-                    auto const pos = iRows.csend();
-                    iRows.insert(pos, row_type{ aItemIndex.row() });
-                }
-                else
-                {
-                    auto const parentIndex = from_item_model_index(item_model().parent(aItemIndex));
-                    auto const pos = const_sibling_iterator{ std::next(iRows.cbegin(), parentIndex.row()) };
-                    iRows.insert(pos.end(), row_type{ aItemIndex.row() });
-                }
+                // the tree index is in pre-order so its position is also that of the parent's node in the tree
+                auto const& added = parentPosition == std::nullopt ?
+                    *iRows.insert(iRows.csend(), row_type{ aItemIndex.row() }) :
+                    *iRows.insert(const_sibling_iterator{ std::next(iRows.cbegin(), *parentPosition) }.end(), row_type{ aItemIndex.row() });
+                insert_tree_node(aItemIndex.row(), parentPosition, added);
             }
 
-            if (!iInitializing || container_traits::is_tree)
-                reset_maps(aItemIndex);
-
             if (!iInitializing)
             {
-                reset_meta();
+                if (has_item_model_index(aItemIndex))
+                    insert_row_heights(from_item_model_index(aItemIndex, true).row(), 1u);
+                reset_changed_meta();
                 execute_sort();
                 ItemAdded.trigger(from_item_model_index(aItemIndex, true));
             }
         }
+        // Adds the model's rows to an empty tree in a single pass rather than through item_added() (which looks up each
+        // row's parent): the model's rows are in pre-order so a row's parent is the nearest of the rows on the stack of
+        // its ancestors. A row is not added if it is excluded (aIncluded is indexed by model row) or its parent is not.
+        void load_tree(const std::vector<char>* aIncluded = nullptr)
+        {
+            const item_model_type& model = item_model();
+            std::vector<std::pair<i_item_model::const_iterator, std::optional<const_sibling_iterator>>> ancestors;
+            item_model_index::row_type modelRow = 0u;
+            for (auto node = model.begin(); node != model.end(); ++node, ++modelRow)
+            {
+                std::optional<const_sibling_iterator> parent;
+                if (model.has_parent(node))
+                {
+                    auto const modelParent = model.parent(node);
+                    while (!ancestors.empty() && ancestors.back().first != modelParent)
+                        ancestors.pop_back();
+                    parent = !ancestors.empty() ? ancestors.back().second : std::nullopt;
+                    if (parent == std::nullopt)
+                    {
+                        ancestors.emplace_back(node, std::nullopt);
+                        continue;
+                    }
+                }
+                else
+                    ancestors.clear();
+                if (aIncluded != nullptr && !(*aIncluded)[modelRow])
+                {
+                    ancestors.emplace_back(node, std::nullopt);
+                    continue;
+                }
+                if (parent == std::nullopt)
+                    ancestors.emplace_back(node, const_sibling_iterator{ iRows.insert(iRows.csend(), row_type{ modelRow }) });
+                else
+                    ancestors.emplace_back(node, const_sibling_iterator{ iRows.insert(parent->end(), row_type{ modelRow }) });
+            }
+        }
         void item_changed(const item_model_index& aItemIndex)
         {
+            iAppliedFilters = std::nullopt;
             if (!has_item_model_index(aItemIndex))
                 return;
             if (!iInitializing)
             {
-                reset_maps();
-                reset_meta();
+                // a change does not move any rows (sorting resets the row maps itself)
+                iColumnMap.clear();
+                reset_changed_meta();
                 execute_sort();
                 auto& cellMeta = cell_meta(from_item_model_index(aItemIndex));
                 cellMeta.text = std::nullopt;
                 cellMeta.extents = std::nullopt;
-                column(mapped_column(aItemIndex.column())).width = std::nullopt;
+                reset_row_height(from_item_model_index(aItemIndex).row());
+                if (iWidthMode == column_width_mode::Exact)
+                    column(mapped_column(aItemIndex.column())).width = std::nullopt;
                 ItemChanged.trigger(from_item_model_index(aItemIndex));
             }
         }
@@ -1022,28 +1486,93 @@ namespace neogfx
                 return;
             if (!iInitializing)
                 ItemRemoved.trigger(from_item_model_index(aItemIndex));
-            iRows.erase(std::next(begin(), from_item_model_index(aItemIndex).row()));
+            auto const removedRow = from_item_model_index(aItemIndex).row();
+            auto const rowsBefore = rows();
+            if constexpr (container_traits::is_tree)
+                erase_tree_node(aItemIndex.row());
+            iRows.erase(std::next(begin(), removedRow));
             for (auto& row : iRows)
                 if (row.value >= aItemIndex.row())
                     --row.value;
-            reset_maps(aItemIndex);
-            reset_position_meta(0);
+            if constexpr (container_traits::is_flat)
+                reset_maps(aItemIndex);
+            // a tree node is removed along with its descendants
+            erase_row_heights(removedRow, rowsBefore - rows());
+        }
+        void items_updated(item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow)
+        {
+            {
+                neolib::scoped_flag sf{ iInitializing };
+                iAppliedFilters = std::nullopt;
+                if constexpr (is_virtual_item_model)
+                    discard_row_pages(); // the rows are those of the source's new view
+                else if constexpr (container_traits::is_flat)
+                {
+                    // model rows before the updated range are unchanged
+                    iRows.erase(std::remove_if(iRows.begin(), iRows.end(), [aFirstRow](const row_type& aRow) { return aRow.value >= aFirstRow; }), iRows.end());
+                    for (auto row = aFirstRow; row < aEndRow; ++row)
+                        iRows.push_back(row_type{ row });
+                }
+                else
+                {
+                    iRows.clear();
+                    load_tree();
+                }
+            }
+            reset_maps();
+            reset_meta();
+            if (!iFilters.empty() && !source_filters())
+                execute_filter();
+            else
+                execute_sort();
+            ItemsUpdated.trigger();
+        }
+        void rows_fetched(item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow)
+        {
+            // the rows' cells (until now empty) are measured again when next needed
+            aEndRow = std::min(aEndRow, rows());
+            if (aFirstRow >= aEndRow)
+                return;
+            for (auto row = aFirstRow; row < aEndRow; ++row)
+            {
+                auto const rowMeta = find_row(row);
+                if (rowMeta == nullptr)
+                    continue;
+                for (auto& cellMeta : rowMeta->cells)
+                {
+                    cellMeta.text = std::nullopt;
+                    cellMeta.extents = std::nullopt;
+                }
+            }
+            ItemsChanged.trigger(aFirstRow, aEndRow);
         }
     private:
         void reset_maps(const item_model_index& aFrom = {}) const
         {
             if (aFrom.row() < iRowMap.size() && (iRowMapDirtyFrom == std::nullopt || *iRowMapDirtyFrom > aFrom.row()))
                 iRowMapDirtyFrom = aFrom.row();
+            iTreeIndexValid = false;
             iColumnMap.clear();
         }
         item_presentation_model_index::row_type mapped_row(item_model_index::row_type aRowIndex) const
         {
-            if (aRowIndex < row_map().size() && row_map()[aRowIndex])
+            if (!has_item_model_index(item_model_index{ aRowIndex }))
+                throw no_mapped_row();
+            if constexpr (is_virtual_item_model)
+                return aRowIndex;
+            else if constexpr (container_traits::is_tree)
+                return static_cast<item_presentation_model_index::row_type>(iTreeVisibleNodes.prefix_sum(*row_map()[aRowIndex]));
+            else
                 return *row_map()[aRowIndex];
-            throw no_mapped_row();
         }
+        // for a tree the row map maps a model row to the position of its node in the tree index
         const row_map_type& row_map() const
         {
+            if constexpr (container_traits::is_tree)
+            {
+                tree_index();
+                return iRowMap;
+            }
             if (iRowMapDirtyFrom)
                 iRowMap.erase(std::next(iRowMap.begin(), *iRowMapDirtyFrom), iRowMap.end());
             iRowMapDirtyFrom = std::nullopt;
@@ -1059,6 +1588,101 @@ namespace neogfx
         {
             return const_cast<row_map_type&>(to_const(*this).row_map());
         }
+        // The tree index holds every node of a tree in pre-order with its depth and descendant count, and a Fenwick tree
+        // of which nodes are shown (i.e. have no collapsed ancestor) so that a row and its node are found from each other
+        // in O(log n). It is rebuilt in O(n) when the tree is loaded, sorted or filtered; adding or removing a node splices
+        // it in O(n) and expanding and collapsing a node update it in place.
+        void tree_index() const
+        {
+            if (iTreeIndexValid)
+                return;
+            auto& tree = const_cast<container_type&>(iRows);
+            iTreeNodes.clear();
+            iRowMap.assign(has_item_model() ? item_model().rows() : 0u, item_presentation_model_index::optional_row_type{});
+            iRowMapDirtyFrom = std::nullopt;
+            std::vector<uint32_t> shown;
+            std::vector<uint32_t> ancestorEnds;
+            auto visible = tree.kbegin();
+            for (auto node = tree.begin(); node != tree.end(); ++node)
+            {
+                auto const position = static_cast<uint32_t>(iTreeNodes.size());
+                while (!ancestorEnds.empty() && ancestorEnds.back() <= position)
+                    ancestorEnds.pop_back();
+                auto const descendants = static_cast<uint32_t>(node.descendent_count());
+                iTreeNodes.push_back(tree_node{ &*node, std::nullopt, static_cast<uint32_t>(ancestorEnds.size()), descendants });
+                ancestorEnds.push_back(position + 1u + descendants);
+                if (node->value < iRowMap.size())
+                    iRowMap[node->value] = position;
+                if (visible != tree.kend() && &*visible == &*node)
+                {
+                    iTreeNodes.back().visible = visible++;
+                    shown.push_back(1u);
+                }
+                else
+                    shown.push_back(0u);
+            }
+            iTreeVisibleNodes.assign(shown.begin(), shown.end());
+            iTreeIndexValid = true;
+        }
+        void insert_tree_node(item_model_index::row_type aModelRow, const std::optional<uint32_t>& aParentPosition, const row_type& aNode) const
+        {
+            if (!iTreeIndexValid)
+                return; // rebuilt when next needed
+            // a node is appended to its parent's children so follows the last of the parent's descendants
+            auto const position = aParentPosition == std::nullopt ?
+                static_cast<uint32_t>(iTreeNodes.size()) : *aParentPosition + 1u + iTreeNodes[*aParentPosition].descendants;
+            auto const depth = aParentPosition == std::nullopt ? 0u : iTreeNodes[*aParentPosition].depth + 1u;
+            std::optional<iterator> visible;
+            if (aParentPosition == std::nullopt || !iTreeNodes[*aParentPosition].visible->children_skipped())
+            {
+                auto const row = iTreeVisibleNodes.prefix_sum(position);
+                auto& tree = const_cast<container_type&>(iRows);
+                visible = row == 0u ? tree.kbegin() : std::next(*iTreeNodes[iTreeVisibleNodes.find(row - 1u)].visible);
+            }
+            for (uint32_t ancestor = 0u; ancestor < position; ++ancestor)
+                if (iTreeNodes[ancestor].depth < depth && ancestor + 1u + iTreeNodes[ancestor].descendants >= position)
+                    ++iTreeNodes[ancestor].descendants;
+            iTreeNodes.insert(std::next(iTreeNodes.begin(), position), tree_node{ &aNode, visible, depth, 0u });
+            iTreeVisibleNodes.insert(position, 1u, visible != std::nullopt ? 1u : 0u);
+            for (auto& mapped : iRowMap)
+                if (mapped != std::nullopt && *mapped >= position)
+                    ++*mapped;
+            iRowMap.insert(std::next(iRowMap.begin(), std::min<std::size_t>(aModelRow, iRowMap.size())), position);
+        }
+        // to be called before the node is erased from the tree; its descendants go with it
+        void erase_tree_node(item_model_index::row_type aModelRow) const
+        {
+            if (!iTreeIndexValid)
+                return; // rebuilt when next needed
+            auto const position = *row_map()[aModelRow];
+            auto const count = 1u + iTreeNodes[position].descendants;
+            for (uint32_t ancestor = 0u; ancestor < position; ++ancestor)
+                if (iTreeNodes[ancestor].depth < iTreeNodes[position].depth && ancestor + 1u + iTreeNodes[ancestor].descendants > position)
+                    iTreeNodes[ancestor].descendants -= count;
+            iTreeNodes.erase(std::next(iTreeNodes.begin(), position), std::next(iTreeNodes.begin(), position + count));
+            iTreeVisibleNodes.erase(position, position + count);
+            for (auto& mapped : iRowMap)
+                if (mapped != std::nullopt && *mapped >= position)
+                {
+                    if (*mapped < position + count)
+                        mapped = std::nullopt;
+                    else
+                        *mapped -= count;
+                }
+            iRowMap.erase(std::next(iRowMap.begin(), aModelRow));
+        }
+        uint32_t tree_node_position(item_presentation_model_index::row_type aRow) const
+        {
+            tree_index();
+            auto const position = static_cast<uint32_t>(iTreeVisibleNodes.find(aRow));
+            if (position >= iTreeNodes.size())
+                throw bad_index();
+            return position;
+        }
+        const tree_node& visible_tree_node(item_presentation_model_index::row_type aRow) const
+        {
+            return iTreeNodes[tree_node_position(aRow)];
+        }
         item_presentation_model_index::column_type mapped_column(item_model_index::column_type aColumnIndex) const
         {
             if (aColumnIndex >= iColumnMap.size())
@@ -1097,20 +1721,49 @@ namespace neogfx
         {
             reset_cell_meta();
             reset_column_meta();
-            reset_position_meta(0);
+            reset_position_meta();
+        }
+        void reset_changed_meta() const
+        {
+            // estimated column widths are widened when the added or changed cells are measured rather than reset; the
+            // heights of the rows added or changed are updated by the caller
+            if (iWidthMode == column_width_mode::Exact)
+            {
+                reset_cell_meta();
+                reset_column_meta();
+            }
         }
         void reset_cell_meta(const std::optional<item_presentation_model_index::column_type>& aColumn = {}) const
         {
-            for (item_presentation_model_index::row_type row = 0; row < rows(); ++row)
+            // only cells that have been measured have meta to reset
+            auto reset = [&](const row_type& aRow)
             {
-                for (item_presentation_model_index::column_type col = 0; col < iColumns.size(); ++col)
+                for (item_presentation_model_index::column_type col = 0; col < aRow.cells.size(); ++col)
                 {
                     if (aColumn != std::nullopt && col != *aColumn)
                         continue;
-                    cell_meta(item_presentation_model_index(row, col)).text = std::nullopt;
-                    cell_meta(item_presentation_model_index(row, col)).extents = std::nullopt;
+                    aRow.cells[col].text = std::nullopt;
+                    aRow.cells[col].extents = std::nullopt;
                 }
+            };
+            if constexpr (is_virtual_item_model)
+            {
+                for (auto const& page : iRowPages)
+                    for (auto const& row : page.second.rows)
+                        reset(row);
             }
+            else
+                for (auto const& row : iRows)
+                    reset(row);
+        }
+        bool glyph_text_retained(item_presentation_model_index::row_type aRow) const
+        {
+            return iGlyphTextWindow == std::nullopt || (aRow >= iGlyphTextWindow->first && aRow < iGlyphTextWindow->second);
+        }
+        neogfx::glyph_text shape_cell_text(const item_presentation_model_index& aIndex, const i_graphics_context& aGc) const
+        {
+            optional_font cellFont = cell_font(aIndex);
+            return aGc.to_glyph_text(cell_to_string(aIndex), cellFont == std::nullopt ? default_font() : *cellFont);
         }
         void reset_column_meta(const std::optional<item_presentation_model_index::column_type>& aColumn = {}) const
         {
@@ -1122,12 +1775,76 @@ namespace neogfx
                 column(col).headingExtents = std::nullopt;
             }
         }
-        void reset_position_meta(item_presentation_model_index::row_type aFromRow) const
+        void reset_position_meta() const
         {
-            iTotalHeight = std::nullopt;
-            iPositions.resize(rows());
-            for (std::size_t i = aFromRow; i < iPositions.size(); ++i)
-                iPositions[i] = std::nullopt;
+            iRowHeightsValid = false;
+        }
+        // the row is measured again when next needed; other rows keep their heights
+        void reset_row_height(item_presentation_model_index::row_type aRow) const
+        {
+            if (iRowHeightsValid && aRow < iRowHeightMeasured.size() && iRowHeightMeasured[aRow])
+            {
+                iRowHeightMeasured[aRow] = false;
+                iRowHeights.set(aRow, *iEstimatedRowHeight);
+            }
+        }
+        // O(n) splices which, unlike a reset, keep the heights of rows already measured
+        void insert_row_heights(item_presentation_model_index::row_type aRow, item_presentation_model_index::row_type aCount) const
+        {
+            if (!iRowHeightsValid || iRowHeights.size() + aCount != rows() || aRow > iRowHeights.size())
+            {
+                reset_position_meta();
+                return;
+            }
+            iRowHeights.insert(aRow, aCount, *iEstimatedRowHeight);
+            iRowHeightMeasured.insert(std::next(iRowHeightMeasured.begin(), aRow), aCount, false);
+        }
+        void erase_row_heights(item_presentation_model_index::row_type aRow, item_presentation_model_index::row_type aCount) const
+        {
+            if (!iRowHeightsValid || iRowHeights.size() != rows() + aCount || aRow + aCount > iRowHeights.size())
+            {
+                reset_position_meta();
+                return;
+            }
+            iRowHeights.erase(aRow, aRow + aCount);
+            iRowHeightMeasured.erase(std::next(iRowHeightMeasured.begin(), aRow), std::next(iRowHeightMeasured.begin(), aRow + aCount));
+        }
+        // Row heights are held in a prefix sum tree so positions and the row at a position are O(log n); rows are
+        // assumed to be a single line high (estimated from the default font) until they are measured, which happens
+        // when their position is queried, i.e. when they are scrolled into view.
+        const fenwick_tree<double>& row_heights(const i_units_context& aUnitsContext) const
+        {
+            if (!iRowHeightsValid || iRowHeights.size() != rows())
+            {
+                iEstimatedRowHeight = estimated_row_height(aUnitsContext);
+                iRowHeights.assign(rows(), *iEstimatedRowHeight);
+                iRowHeightMeasured.assign(rows(), false);
+                iRowHeightsValid = true;
+            }
+            return iRowHeights;
+        }
+        dimension estimated_row_height(const i_units_context& aUnitsContext) const
+        {
+            return units_converter(aUnitsContext).from_device_units(size{ 0.0, std::ceil(default_font().height()) }).cy +
+                cell_padding(aUnitsContext).size().cy + cell_spacing(aUnitsContext).cy;
+        }
+        // Rows of a virtual item model are not measured (measuring a row would fetch it) so every row is the estimated
+        // height and a row's position is simply proportional to its index.
+        dimension uniform_row_height(const i_units_context& aUnitsContext) const
+        {
+            if (!iRowHeightsValid || iEstimatedRowHeight == std::nullopt)
+            {
+                iEstimatedRowHeight = estimated_row_height(aUnitsContext);
+                iRowHeightsValid = true;
+            }
+            return *iEstimatedRowHeight;
+        }
+        void measure_row(item_presentation_model_index::row_type aRow, const i_units_context& aUnitsContext) const
+        {
+            if (aRow >= iRowHeightMeasured.size() || iRowHeightMeasured[aRow])
+                return;
+            iRowHeightMeasured[aRow] = true;
+            iRowHeights.set(aRow, item_height(item_presentation_model_index{ aRow }, aUnitsContext));
         }
     private:
         const_iterator cbegin() const
@@ -1169,7 +1886,12 @@ namespace neogfx
     private:
         const row_type& row(item_presentation_model_index::row_type aRow) const
         {
-            return *std::next(begin(), aRow);
+            if constexpr (is_virtual_item_model)
+                return row_page_row(aRow);
+            else if constexpr (container_traits::is_flat)
+                return *std::next(begin(), aRow);
+            else
+                return *visible_tree_node(aRow).row;
         }
         const row_type& row(item_presentation_model_index aIndex) const
         {
@@ -1177,12 +1899,59 @@ namespace neogfx
         }
         row_type& row(item_presentation_model_index::row_type aRow)
         {
-            return *std::next(begin(), aRow);
+            return const_cast<row_type&>(to_const(*this).row(aRow));
         }
         row_type& row(item_presentation_model_index aIndex)
         {
             return row(aIndex.row());
         }
+        // the row's meta if it has any, without making it resident
+        const row_type* find_row(item_presentation_model_index::row_type aRow) const
+        {
+            if constexpr (is_virtual_item_model)
+            {
+                auto const page = iRowPages.find(aRow / item_model().page_size());
+                if (page == iRowPages.end())
+                    return nullptr;
+                return &page->second.rows[aRow % item_model().page_size()];
+            }
+            else
+                return aRow < rows() ? &row(aRow) : nullptr;
+        }
+        // The cell meta of a virtual item model's rows is kept a page at a time for as many of the most recently used
+        // pages as the model keeps resident rather than for every row, so meta set through the presentation model (e.g.
+        // a cell's checked state) is lost when its page is evicted; such state belongs in the model's data source.
+        const row_type& row_page_row(item_presentation_model_index::row_type aRow) const
+        {
+            if (aRow >= rows())
+                throw bad_index();
+            auto const pageSize = item_model().page_size();
+            auto const pageIndex = aRow / pageSize;
+            auto existing = iRowPages.find(pageIndex);
+            if (existing == iRowPages.end())
+            {
+                while (!iRowPagesUsed.empty() && iRowPages.size() >= item_model().max_resident_pages())
+                {
+                    iRowPages.erase(iRowPagesUsed.back());
+                    iRowPagesUsed.pop_back();
+                }
+                iRowPagesUsed.push_front(pageIndex);
+                existing = iRowPages.emplace(pageIndex, row_page{ {}, iRowPagesUsed.begin() }).first;
+                auto const firstRow = pageIndex * pageSize;
+                auto const endRow = std::min(firstRow + pageSize, rows());
+                existing->second.rows.reserve(endRow - firstRow);
+                for (auto row = firstRow; row < endRow; ++row)
+                    existing->second.rows.push_back(row_type{ row });
+            }
+            else
+                iRowPagesUsed.splice(iRowPagesUsed.begin(), iRowPagesUsed, existing->second.used);
+            return existing->second.rows[aRow - pageIndex * pageSize];
+        }
+        void discard_row_pages() const
+        {
+            iRowPages.clear();
+            iRowPagesUsed.clear();
+        }
         const column_info& column(item_presentation_model_index::column_type aColumnIndex) const
         {
             while(iColumns.size() <= aColumnIndex)
@@ -1196,19 +1965,30 @@ namespace neogfx
     private:
         i_item_model* iItemModel;
         bool iSortable;
+        column_width_mode iWidthMode;
         sink iItemModelSink;
         optional_size iCellSpacing;
         optional_padding iCellPadding;
         container_type iRows;
+        mutable std::unordered_map<uint32_t, row_page> iRowPages;
+        mutable std::list<uint32_t> iRowPagesUsed;
         mutable row_map_type iRowMap;
         mutable item_model_index::optional_row_type iRowMapDirtyFrom;
+        mutable bool iTreeIndexValid;
+        mutable std::vector<tree_node> iTreeNodes;
+        mutable fenwick_tree<uint32_t> iTreeVisibleNodes;
         mutable column_info_array iColumns;
         mutable column_map_type iColumnMap;
         mutable optional_font iDefaultFont;
-        mutable std::optional<i_scrollbar::value_type> iTotalHeight;
-        mutable neolib::segmented_array<optional_position, 256> iPositions;
+        mutable bool iRowHeightsValid;
+        mutable std::optional<dimension> iEstimatedRowHeight;
+        mutable fenwick_tree<double> iRowHeights;
+        mutable std::vector<bool> iRowHeightMeasured;
+        mutable std::optional<std::pair<item_presentation_model_index::row_type, item_presentation_model_index::row_type>> iGlyphTextWindow;
+        mutable std::vector<item_presentation_model_index::row_type> iGlyphTextStrays;
         std::deque<sort> iSortOrder;
         std::vector<filter> iFilters;
+        std::optional<std::vector<filter>> iAppliedFilters;
         sink iSink;
         bool iInitializing;
         bool iFiltering;
@@ -1216,4 +1996,5 @@ namespace neogfx
 
     typedef basic_item_presentation_model<item_model> item_presentation_model;
     typedef basic_item_presentation_model<item_tree_model> item_tree_presentation_model;
+    typedef basic_item_presentation_model<virtual_item_model> virtual_item_presentation_model;
 }
\ No newline at end of file
@@ -46,6 +46,8 @@ namespace neogfx
         basic_item_selection_model(item_selection_mode aMode = item_selection_mode::SingleSelection) :
             iModel{ nullptr },
             iMode{ aMode },
+            iStashAll{ false },
+            iRowsBeforeToggle{ 0u },
             iSorting{ false },
             iFiltering{ false }
         {
@@ -54,6 +56,8 @@ namespace neogfx
         basic_item_selection_model(i_item_presentation_model& aModel, item_selection_mode aMode = item_selection_mode::SingleSelection) :
             iModel{ nullptr },
             iMode{ aMode },
+            iStashAll{ false },
+            iRowsBeforeToggle{ 0u },
             iSorting{ false },
             iFiltering{ false }
         {
@@ -88,7 +92,16 @@ namespace neogfx
 
             iModel = &aModel;
 
-            iSink += presentation_model().item_removed([this](const item_presentation_model_index&)
+            iSink += presentation_model().item_added([this](const item_presentation_model_index& aIndex)
+            {
+                // a sortable model has already been re-sorted (and the selection reindexed) before this is triggered
+                if (!presentation_model().sortable())
+                {
+                    shift_rows(iSelection, aIndex.row(), 1);
+                    shift_rows(iPreviousSelection, aIndex.row(), 1);
+                }
+            });
+            iSink += presentation_model().item_removed([this](const item_presentation_model_index& aIndex)
             {
                 if (has_current_index())
                 {
@@ -97,25 +110,53 @@ namespace neogfx
                     else if (iCurrentIndex->row() >= presentation_model().rows() - 1u)
                         iCurrentIndex->set_row(iCurrentIndex->row() - 1u);
                 }
-                reindex();
+                remove_rows(iSelection, aIndex.row(), aIndex.row());
+                remove_rows(iPreviousSelection, aIndex.row(), aIndex.row());
+                shift_rows(iSelection, aIndex.row() + 1u, -1);
+                shift_rows(iPreviousSelection, aIndex.row() + 1u, -1);
+            });
+            iSink += presentation_model().item_expanding([this](const item_presentation_model_index&)
+            {
+                iRowsBeforeToggle = presentation_model().rows();
+            });
+            iSink += presentation_model().item_collapsing([this](const item_presentation_model_index&)
+            {
+                iRowsBeforeToggle = presentation_model().rows();
             });
             iSink += presentation_model().item_expanded([this](const item_presentation_model_index& aIndex)
             {
+                // the rows shown below the node push the rows after them down
+                auto const shown = presentation_model().rows() - iRowsBeforeToggle;
                 if (has_current_index() && current_index().row() > aIndex.row())
-                    iCurrentIndex = std::nullopt;
-                reindex();
+                    iCurrentIndex->set_row(iCurrentIndex->row() + shown);
+                shift_rows(iSelection, aIndex.row() + 1u, static_cast<int32_t>(shown));
+                shift_rows(iPreviousSelection, aIndex.row() + 1u, static_cast<int32_t>(shown));
             });
             iSink += presentation_model().item_collapsed([this](const item_presentation_model_index& aIndex)
             {
+                // the rows hidden below the node are no longer selected and the rows after them move up
+                auto const hidden = iRowsBeforeToggle - presentation_model().rows();
                 if (has_current_index() && current_index().row() > aIndex.row())
-                    iCurrentIndex = std::nullopt;
-                reindex();
+                {
+                    if (current_index().row() <= aIndex.row() + hidden)
+                        iCurrentIndex = std::nullopt;
+                    else
+                        iCurrentIndex->set_row(iCurrentIndex->row() - hidden);
+                }
+                if (hidden != 0u)
+                {
+                    remove_rows(iSelection, aIndex.row() + 1u, aIndex.row() + hidden);
+                    remove_rows(iPreviousSelection, aIndex.row() + 1u, aIndex.row() + hidden);
+                    shift_rows(iSelection, aIndex.row() + hidden + 1u, -static_cast<int32_t>(hidden));
+                    shift_rows(iPreviousSelection, aIndex.row() + hidden + 1u, -static_cast<int32_t>(hidden));
+                }
             });
             iSink += presentation_model().items_sorting([this]()
             {
                 neolib::scoped_flag sf{ iSorting };
                 iSavedModelIndex = has_current_index() ? presentation_model().to_item_model_index(current_index()) : optional_item_model_index{};
                 unset_current_index();
+                stash(true);
             });
             iSink += presentation_model().items_sorted([this]()
             {
@@ -130,6 +171,7 @@ namespace neogfx
                 neolib::scoped_flag sf{ iFiltering };
                 iSavedModelIndex = has_current_index() ? presentation_model().to_item_model_index(current_index()) : optional_item_model_index{};
                 unset_current_index();
+                stash(false);
             });
             iSink += presentation_model().items_filtered([this]()
             {
@@ -139,8 +181,20 @@ namespace neogfx
                 else if (presentation_model().rows() >= 1)
                     set_current_index(item_presentation_model_index{ 0u, 0u });
                 iSavedModelIndex = std::nullopt;
+                // selected rows that pass the filter stay selected
                 reindex();
             });
+            iSink += presentation_model().items_updated([this]()
+            {
+                // the model's rows have been replaced (e.g. by a virtual item model's data source re-sorting or
+                // re-filtering) so a stashed selection of model rows no longer refers to the same items
+                if (iStash != std::nullopt)
+                    iStash->clear();
+                if (has_current_index() && current_index().row() >= presentation_model().rows())
+                    iCurrentIndex = std::nullopt;
+                remove_rows(iSelection, presentation_model().rows(), std::numeric_limits<item_presentation_model_index::row_type>::max() - 1u);
+                remove_rows(iPreviousSelection, presentation_model().rows(), std::numeric_limits<item_presentation_model_index::row_type>::max() - 1u);
+            });
             iSink += neolib::destroying(presentation_model(), [this]()
             {
                 auto oldModel = iModel;
@@ -316,117 +370,51 @@ namespace neogfx
         }
         bool is_selected(const item_presentation_model_index& aIndex) const override
         {
-            return (presentation_model().cell_meta(aIndex).selection & item_cell_selection_flags::Selected) == item_cell_selection_flags::Selected;
+            return find_range(iSelection, aIndex.row()) != iSelection.end();
         }    
         bool is_selectable(const item_presentation_model_index& aIndex) const override
         {
             return (presentation_model().cell_flags(aIndex) & item_cell_flags::Selectable) == item_cell_flags::Selectable;
         }
         void select(const item_presentation_model_index& aIndex, item_selection_operation aOperation) override
+        {
+            select(aIndex, aIndex, aOperation);
+        }
+        void select(const item_presentation_model_index& aFirst, const item_presentation_model_index& aLast, item_selection_operation aOperation) override
         {
             if (aOperation == item_selection_operation::None)
                 return;
             else if (mode() == item_selection_mode::NoSelection)
                 aOperation = item_selection_operation::Clear;
             // todo: cell and column
-            static auto find = [](const item_presentation_model_index& aIndex, concrete_item_selection& aSelection)
-            {
-                if (aSelection.empty())
-                    return aSelection.end();
-                auto existing = aSelection.lower_bound(aIndex.with_column(0u));
-                if (existing == aSelection.end())
-                    existing = std::prev(existing);
-                if (existing->second().topLeft.row() <= aIndex.row() &&
-                    existing->second().bottomRight.row() >= aIndex.row())
-                    return existing;
-                return aSelection.end();
-            };
-            static auto find_adjacent = [](const item_presentation_model_index& aIndex, concrete_item_selection& aSelection)
+            auto const firstRow = std::min(aFirst.row(), aLast.row());
+            auto const lastRow = std::max(aFirst.row(), aLast.row());
+            bool const clear = (aOperation & item_selection_operation::Clear) == item_selection_operation::Clear;
+            bool const rowCurrentlySelected = !clear && is_selected(item_presentation_model_index{ firstRow, 0u });
+            bool const select = (aOperation & item_selection_operation::Select) == item_selection_operation::Select ||
+                ((aOperation & item_selection_operation::Toggle) == item_selection_operation::Toggle && !rowCurrentlySelected);
+            bool const deselect = (aOperation & item_selection_operation::Deselect) == item_selection_operation::Deselect ||
+                ((aOperation & item_selection_operation::Toggle) == item_selection_operation::Toggle && rowCurrentlySelected);
+            auto update = [&, this](concrete_item_selection& aSelection)
             {
-                if (aSelection.empty())
-                    return aSelection.end();
-                auto existing = find(aIndex.with_row(aIndex.row() - 1u), aSelection);
-                if (existing != aSelection.end())
-                    return existing;
-                return find(aIndex.with_row(aIndex.row() + 1u), aSelection);
-            };
-            auto update = [&, this](concrete_item_selection& aSelection, bool aUpdateCells)
-            {
-                bool const clear = (aOperation & item_selection_operation::Clear) == item_selection_operation::Clear;
-                bool const rowCurrentlySelected = (presentation_model().cell_meta(aIndex.with_column(0u)).selection & item_cell_selection_flags::Selected) ==
-                    item_cell_selection_flags::Selected;
-                bool const select = (aOperation & item_selection_operation::Select) == item_selection_operation::Select ||
-                    ((aOperation & item_selection_operation::Toggle) == item_selection_operation::Toggle && !rowCurrentlySelected);
-                bool const deselect = (aOperation & item_selection_operation::Deselect) == item_selection_operation::Deselect ||
-                    ((aOperation & item_selection_operation::Toggle) == item_selection_operation::Toggle && rowCurrentlySelected);
                 if (clear)
-                {
-                    if (aUpdateCells)
-                    {
-                        struct selection_clearer : i_item_presentation_model::i_meta_visitor
-                        {
-                            void visit(i_item_presentation_model::cell_meta_type& aMeta) override
-                            {
-                                aMeta.selection &= ~item_cell_selection_flags::Selected;
-                            }
-                        } selectionClearer;
-                        presentation_model().accept(selectionClearer, true);
-                    }
                     aSelection.clear();
-                }
                 if (select)
-                {
-                    if (find(aIndex, aSelection) == aSelection.end())
-                    {
-                        auto adjacent = find_adjacent(aIndex, aSelection);
-                        if (adjacent == aSelection.end())
-                            aSelection.emplace(aIndex.with_column(0u), selection_area{ aIndex.with_column(0u), aIndex.with_column(presentation_model().columns() - 1u) });
-                        else
-                        {
-                            if (adjacent->second().bottomRight.row() == aIndex.row() - 1u)
-                                adjacent->second().bottomRight = aIndex.with_column(presentation_model().columns() - 1u);
-                            else
-                            {
-                                aSelection.emplace(aIndex.with_column(0u), selection_area{ aIndex.with_column(0u), adjacent->second().bottomRight });
-                                aSelection.erase(adjacent);
-                            }
-                        }
-                    }
-                    if (aUpdateCells)
-                        for (auto& cellIndex : *this)
-                            if (cellIndex.row() == aIndex.row())
-                                presentation_model().cell_meta(cellIndex).selection |= item_cell_selection_flags::Selected;
-                }
+                    add_rows(aSelection, firstRow, lastRow);
                 else if (deselect)
-                {
-                    if (aUpdateCells)
-                        for (auto& cellIndex : *this)
-                            if (cellIndex.row() == aIndex.row())
-                                presentation_model().cell_meta(cellIndex).selection &= ~item_cell_selection_flags::Selected;
-                    auto existing = find(aIndex, aSelection);
-                    if (existing != aSelection.end())
-                    {
-                        if (existing->second().topLeft.row() == existing->second().bottomRight.row())
-                            aSelection.erase(existing);
-                        else if (existing->second().topLeft.row() == aIndex.row())
-                        {
-                            aSelection.emplace(aIndex.with_row(aIndex.row() + 1u).with_column(0u), selection_area{ aIndex.with_row(aIndex.row() + 1u).with_column(0u), existing->second().bottomRight });
-                            aSelection.erase(existing);
-                        }
-                        else if (existing->second().bottomRight.row() == aIndex.row())
-                            existing->second().bottomRight.set_row(aIndex.row() - 1u);
-                        else
-                        {
-                            aSelection.emplace(aIndex.with_row(aIndex.row() + 1u).with_column(0u), selection_area{ aIndex.with_row(aIndex.row() + 1u).with_column(0u), existing->second().bottomRight });
-                            existing->second().bottomRight.set_row(aIndex.row() - 1u);
-                        }
-                    }
-                }
+                    remove_rows(aSelection, firstRow, lastRow);
             };
-            update(iSelection, true);
+            update(iSelection);
             if ((aOperation & item_selection_operation::Internal) != item_selection_operation::Internal)
                 SelectionChanged.trigger(iSelection, iPreviousSelection);
-            update(iPreviousSelection, false);
+            update(iPreviousSelection);
+        }
+        void select_all() override
+        {
+            if (mode() != item_selection_mode::MultipleSelection && mode() != item_selection_mode::ExtendedSelection)
+                return;
+            if (has_presentation_model() && presentation_model().rows() > 0u)
+                select(item_presentation_model_index{ 0u, 0u }, item_presentation_model_index{ presentation_model().rows() - 1u, 0u }, item_selection_operation::ClearAndSelect);
         }
     public:
         bool sorting() const override
@@ -460,14 +448,139 @@ namespace neogfx
                 CurrentIndexChanged.trigger(iCurrentIndex, previousIndex);
             }
         }
+        // The selection is a normalised (non-overlapping, non-adjacent) set of row ranges keyed by their first row so
+        // hit testing, selecting and deselecting are O(log n) in the number of ranges.
+        template <typename Selection>
+        static auto find_range(Selection& aSelection, item_presentation_model_index::row_type aRow)
+        {
+            auto existing = aSelection.lower_bound(item_presentation_model_index{ aRow, 0u });
+            if (existing != aSelection.end() && existing->second().topLeft.row() == aRow)
+                return existing;
+            if (existing == aSelection.begin())
+                return aSelection.end();
+            existing = std::prev(existing);
+            if (existing->second().bottomRight.row() >= aRow)
+                return existing;
+            return aSelection.end();
+        }
+        void add_rows(concrete_item_selection& aSelection, item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aLastRow) const
+        {
+            // absorb any overlapping or adjacent ranges
+            auto existing = aSelection.lower_bound(item_presentation_model_index{ aFirstRow, 0u });
+            if (existing != aSelection.begin() && std::prev(existing)->second().bottomRight.row() + 1u >= aFirstRow)
+                existing = std::prev(existing);
+            while (existing != aSelection.end() && existing->second().topLeft.row() <= aLastRow + 1u)
+            {
+                aFirstRow = std::min(aFirstRow, existing->second().topLeft.row());
+                aLastRow = std::max(aLastRow, existing->second().bottomRight.row());
+                auto const next = std::next(existing);
+                aSelection.erase(existing);
+                existing = next;
+            }
+            emplace_range(aSelection, aFirstRow, aLastRow);
+        }
+        void remove_rows(concrete_item_selection& aSelection, item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aLastRow) const
+        {
+            auto existing = aSelection.lower_bound(item_presentation_model_index{ aFirstRow, 0u });
+            if (existing != aSelection.begin() && std::prev(existing)->second().bottomRight.row() >= aFirstRow)
+                existing = std::prev(existing);
+            std::optional<std::pair<item_presentation_model_index::row_type, item_presentation_model_index::row_type>> before;
+            std::optional<std::pair<item_presentation_model_index::row_type, item_presentation_model_index::row_type>> after;
+            while (existing != aSelection.end() && existing->second().topLeft.row() <= aLastRow)
+            {
+                auto const rangeFirst = existing->second().topLeft.row();
+                auto const rangeLast = existing->second().bottomRight.row();
+                if (rangeFirst < aFirstRow)
+                    before.emplace(rangeFirst, aFirstRow - 1u);
+                if (rangeLast > aLastRow)
+                    after.emplace(aLastRow + 1u, rangeLast);
+                auto const next = std::next(existing);
+                aSelection.erase(existing);
+                existing = next;
+            }
+            if (before)
+                emplace_range(aSelection, before->first, before->second);
+            if (after)
+                emplace_range(aSelection, after->first, after->second);
+        }
+        void shift_rows(concrete_item_selection& aSelection, item_presentation_model_index::row_type aFromRow, int32_t aDelta) const
+        {
+            // rows from aFromRow onwards move by aDelta; O(number of ranges)
+            std::vector<std::pair<item_presentation_model_index::row_type, item_presentation_model_index::row_type>> moved;
+            auto existing = aSelection.lower_bound(item_presentation_model_index{ aFromRow, 0u });
+            if (existing != aSelection.begin() && std::prev(existing)->second().bottomRight.row() >= aFromRow)
+            {
+                // split a range straddling aFromRow
+                auto const straddling = std::prev(existing);
+                auto const rangeFirst = straddling->second().topLeft.row();
+                auto const rangeLast = straddling->second().bottomRight.row();
+                aSelection.erase(straddling);
+                emplace_range(aSelection, rangeFirst, aFromRow - 1u);
+                moved.emplace_back(aFromRow, rangeLast);
+                existing = aSelection.lower_bound(item_presentation_model_index{ aFromRow, 0u });
+            }
+            while (existing != aSelection.end())
+            {
+                moved.emplace_back(existing->second().topLeft.row(), existing->second().bottomRight.row());
+                auto const next = std::next(existing);
+                aSelection.erase(existing);
+                existing = next;
+            }
+            for (auto const& range : moved)
+                add_rows(aSelection, range.first + aDelta, range.second + aDelta);
+        }
+        void emplace_range(concrete_item_selection& aSelection, item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aLastRow) const
+        {
+            auto const lastColumn = presentation_model().columns() > 0u ? presentation_model().columns() - 1u : 0u;
+            aSelection.emplace(item_presentation_model_index{ aFirstRow, 0u }, selection_area{ item_presentation_model_index{ aFirstRow, 0u }, item_presentation_model_index{ aLastRow, lastColumn } });
+        }
+        // Before the presentation model sorts or filters its rows the selection is stashed as the model rows it covers,
+        // and afterwards reindex() maps those back to presentation rows and rebuilds the ranges from them; both are
+        // O(s log s) in the number of selected rows rather than O(n) in the number of rows. If the same rows are only
+        // being reordered a selection of every row is stashed as such.
+        void stash(bool aSameRows)
+        {
+            iStash.emplace();
+            iStashAll = aSameRows && !iSelection.empty() && presentation_model().rows() > 0u && iSelection.size() == 1u &&
+                iSelection.begin()->second().topLeft.row() == 0u && iSelection.begin()->second().bottomRight.row() == presentation_model().rows() - 1u;
+            if (iStashAll)
+                return;
+            for (auto const& range : iSelection)
+                for (auto row = range.second().topLeft.row(); row <= range.second().bottomRight.row() && row < presentation_model().rows(); ++row)
+                    iStash->push_back(presentation_model().to_item_model_index(item_presentation_model_index{ row, 0u }).row());
+        }
         void reindex()
         {
             iPreviousSelection.clear();
             iSelection.clear();
-            for (item_presentation_model_index::row_type row = 0; row < presentation_model().rows(); ++row)
-                for (item_presentation_model_index::column_type column = 0; column < presentation_model().columns(); ++column)
-                    if ((presentation_model().cell_meta(item_presentation_model_index{ row, column }).selection & item_cell_selection_flags::Selected) == item_cell_selection_flags::Selected)
-                        select(item_presentation_model_index{ row, column }, item_selection_operation::Select | item_selection_operation::Internal);
+            if (iStashAll)
+            {
+                if (presentation_model().rows() > 0u)
+                {
+                    emplace_range(iSelection, 0u, presentation_model().rows() - 1u);
+                    emplace_range(iPreviousSelection, 0u, presentation_model().rows() - 1u);
+                }
+            }
+            else if (iStash != std::nullopt)
+            {
+                std::vector<item_presentation_model_index::row_type> rows;
+                rows.reserve(iStash->size());
+                for (auto modelRow : *iStash)
+                    if (presentation_model().has_item_model_index(item_model_index{ modelRow }))
+                        rows.push_back(presentation_model().from_item_model_index(item_model_index{ modelRow }, true).row());
+                std::sort(rows.begin(), rows.end());
+                for (auto run = rows.begin(); run != rows.end();)
+                {
+                    auto runEnd = std::next(run);
+                    while (runEnd != rows.end() && *runEnd == *std::prev(runEnd) + 1u)
+                        ++runEnd;
+                    emplace_range(iSelection, *run, *std::prev(runEnd));
+                    emplace_range(iPreviousSelection, *run, *std::prev(runEnd));
+                    run = runEnd;
+                }
+            }
+            iStash = std::nullopt;
+            iStashAll = false;
         }
     private:
         i_item_presentation_model* iModel;
@@ -476,6 +589,9 @@ namespace neogfx
         optional_item_model_index iSavedModelIndex;
         concrete_item_selection iPreviousSelection;
         concrete_item_selection iSelection;
+        std::optional<std::vector<item_model_index::row_type>> iStash;
+        bool iStashAll;
+        item_presentation_model_index::row_type iRowsBeforeToggle;
         bool iSorting;
         bool iFiltering;
         sink iSink;
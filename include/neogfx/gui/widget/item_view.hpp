@@ -140,11 +140,13 @@ namespace neogfx
         virtual void item_model_changed(const i_item_model& aItemModel);
         virtual void item_added(const item_presentation_model_index& aItemIndex);
         virtual void item_changed(const item_presentation_model_index& aItemIndex);
+        virtual void items_changed(item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow);
         virtual void item_removed(const item_presentation_model_index& aItemIndex);
         virtual void items_sorting();
         virtual void items_sorted();
         virtual void items_filtering();
         virtual void items_filtered();
+        virtual void items_updated();
     protected:
         virtual void presentation_model_added(i_item_presentation_model& aNewModel);
         virtual void presentation_model_changed(i_item_presentation_model& aNewModel, i_item_presentation_model& aOldModel);
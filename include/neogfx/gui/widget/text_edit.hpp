@@ -229,7 +229,8 @@ namespace neogfx
         public:
             double x = 0.0;
         };
-        typedef neolib::segmented_array<paragraph_positioned_glyph, 256> glyph_container_type;
+        static constexpr std::size_t GlyphSegmentSize = 256;
+        typedef neolib::segmented_array<paragraph_positioned_glyph, GlyphSegmentSize> glyph_container_type;
         class document_glyphs : public glyph_font_cache, public glyph_container_type
         {
         public:
@@ -374,17 +375,19 @@ namespace neogfx
                         dimension cy = glyph.extents(glyphFont).cy;
                         if (i == glyphsStartIndex || cy != previousHeight)
                         {
-                            iHeights[i] = cy;
+                            iHeights[i - glyphsStartIndex] = cy;
                             previousHeight = cy;
                         }
                     }
-                    iHeights[end_index()] = 0.0;
+                    iHeights[glyphsEndIndex - glyphsStartIndex] = 0.0;
                 }
+                // heights are keyed relative to the paragraph so they survive edits to preceding paragraphs
+                auto const glyphsStart = parent().iGlyphs.begin() + start_index();
                 dimension result = 0.0;
-                auto start = iHeights.lower_bound(aStart - parent().iGlyphs.begin());
-                if (start != iHeights.begin() && aStart < parent().iGlyphs.begin() + start->first)
+                auto start = iHeights.lower_bound(aStart - glyphsStart);
+                if (start != iHeights.begin() && aStart < glyphsStart + start->first)
                     --start;
-                auto stop = iHeights.lower_bound(aEnd - parent().iGlyphs.begin());
+                auto stop = iHeights.lower_bound(aEnd - glyphsStart);
                 if (start == stop && stop != iHeights.end())
                     ++stop;
                 for (auto i = start; i != stop; ++i)
@@ -405,6 +408,35 @@ namespace neogfx
             size extents;
         };
         typedef std::vector<glyph_line> glyph_lines;
+        struct line_layout
+        {
+            size area;
+            bool verticalScrollbar;
+            bool horizontalScrollbar;
+            // paragraphs reshaped since the lines were laid out span glyphs [dirtyStart, dirtyEnd); the glyphs after
+            // them are those of the previous layout moved by glyphDelta
+            bool dirty = false;
+            document_glyphs::size_type dirtyStart = 0;
+            document_glyphs::size_type dirtyEnd = 0;
+            std::ptrdiff_t glyphDelta = 0;
+
+            void invalidate(document_glyphs::size_type aStart, document_glyphs::size_type aOldEnd, document_glyphs::size_type aNewEnd)
+            {
+                auto const delta = static_cast<std::ptrdiff_t>(aNewEnd) - static_cast<std::ptrdiff_t>(aOldEnd);
+                if (!dirty)
+                {
+                    dirty = true;
+                    dirtyStart = aStart;
+                    dirtyEnd = aNewEnd;
+                }
+                else
+                {
+                    dirtyStart = std::min(dirtyStart, aStart);
+                    dirtyEnd = (dirtyEnd >= aOldEnd ? static_cast<document_glyphs::size_type>(static_cast<std::ptrdiff_t>(dirtyEnd) + delta) : aNewEnd);
+                }
+                glyphDelta += delta;
+            }
+        };
         class glyph_column : public column_info
         {
         public:
@@ -595,6 +627,7 @@ namespace neogfx
         glyph_paragraphs iGlyphParagraphs;
         glyph_columns iGlyphColumns;
         size iTextExtents;
+        std::optional<line_layout> iLineLayout;
         uint64_t iCursorAnimationStartTime;
         typedef std::pair<position_type, position_type> find_span;
         typedef std::map<
@@ -0,0 +1,193 @@
+// virtual_item_model.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <neolib/task/timer.hpp>
+#include <neogfx/core/object.hpp>
+#include <neogfx/gui/widget/item_model.hpp>
+#include <neogfx/gui/widget/i_virtual_item_model.hpp>
+
+namespace neogfx
+{
+    // Pages are held in a hash table threaded on a most recently used list; a page is only evicted when another page
+    // is made resident so a reference to a cell returned by cell_data() remains valid until then. In asynchronous mode
+    // the pages of cells asked for are queued (most recent request first) for a fetcher thread and the fetched pages
+    // are collected by a timer on the thread that owns the model.
+    class virtual_item_model : public object<i_virtual_item_model>
+    {
+        typedef object<i_virtual_item_model> base_type;
+    public:
+        define_declared_event(ColumnInfoChanged, column_info_changed, item_model_index::column_type)
+        define_declared_event(ItemAdded, item_added, const item_model_index&)
+        define_declared_event(ItemChanged, item_changed, const item_model_index&)
+        define_declared_event(ItemRemoved, item_removed, const item_model_index&)
+        define_declared_event(ItemsUpdated, items_updated, item_model_index::row_type, item_model_index::row_type)
+        define_declared_event(RowsFetched, rows_fetched, item_model_index::row_type, item_model_index::row_type)
+    public:
+        typedef item_flat_container_traits<void*, item_cell_data, 0> container_traits;
+        using typename base_type::sort;
+        using typename base_type::filter;
+    public:
+        static constexpr uint32_t DefaultPageSize = 256u;
+        static constexpr uint32_t DefaultMaxResidentPages = 64u;
+    private:
+        typedef uint32_t page_index;
+        struct page
+        {
+            std::vector<item_cell_data> cells;
+            std::list<page_index>::iterator used;
+        };
+        struct page_request
+        {
+            uint32_t generation;
+            page_index index;
+            uint32_t firstRow;
+            uint32_t rowCount;
+        };
+        struct fetched_page
+        {
+            uint32_t generation;
+            page_index index;
+            std::optional<std::vector<item_cell_data>> cells; // std::nullopt if the source failed to fetch the page
+        };
+        struct column_info
+        {
+            std::string name;
+            item_cell_info info;
+        };
+    public:
+        virtual_item_model(i_item_data_source& aSource, item_fetch_mode aFetchMode = item_fetch_mode::Synchronous, uint32_t aPageSize = DefaultPageSize, uint32_t aMaxResidentPages = DefaultMaxResidentPages);
+        ~virtual_item_model();
+    public:
+        bool is_tree() const override;
+        uint32_t rows() const override;
+        uint32_t columns() const override;
+        uint32_t columns(const item_model_index& aIndex) const override;
+        const std::string& column_name(item_model_index::column_type aColumnIndex) const override;
+        void set_column_name(item_model_index::column_type aColumnIndex, const std::string& aName) override;
+        item_data_type column_data_type(item_model_index::column_type aColumnIndex) const override;
+        void set_column_data_type(item_model_index::column_type aColumnIndex, item_data_type aType) override;
+        const item_cell_data& column_min_value(item_model_index::column_type aColumnIndex) const override;
+        void set_column_min_value(item_model_index::column_type aColumnIndex, const item_cell_data& aValue) override;
+        const item_cell_data& column_max_value(item_model_index::column_type aColumnIndex) const override;
+        void set_column_max_value(item_model_index::column_type aColumnIndex, const item_cell_data& aValue) override;
+        const item_cell_data& column_step_value(item_model_index::column_type aColumnIndex) const override;
+        void set_column_step_value(item_model_index::column_type aColumnIndex, const item_cell_data& aValue) override;
+    public:
+        iterator index_to_iterator(const item_model_index& aIndex) override;
+        const_iterator index_to_iterator(const item_model_index& aIndex) const override;
+        item_model_index iterator_to_index(const_iterator aPosition) const override;
+        iterator begin() override;
+        const_iterator begin() const override;
+        iterator end() override;
+        const_iterator end() const override;
+        iterator sbegin() override;
+        const_iterator sbegin() const override;
+        iterator send() override;
+        const_iterator send() const override;
+        bool has_children(const_iterator aParent) const override;
+        bool has_children(const item_model_index& aParentIndex) const override;
+        bool has_parent(const_iterator aChild) const override;
+        bool has_parent(const item_model_index& aChildIndex) const override;
+        iterator parent(const_iterator aChild) override;
+        const_iterator parent(const_iterator aChild) const override;
+        item_model_index parent(const item_model_index& aChildIndex) const override;
+        iterator sbegin(const_iterator aParent) override;
+        const_iterator sbegin(const_iterator aParent) const override;
+        iterator send(const_iterator aParent) override;
+        const_iterator send(const_iterator aParent) const override;
+    public:
+        bool empty() const override;
+        void reserve(uint32_t aItemCount) override;
+        uint32_t capacity() const override;
+        iterator insert_item(const_iterator aPosition, const item_cell_data& aCellData) override;
+        iterator insert_item(const item_model_index& aIndex, const item_cell_data& aCellData) override;
+        iterator append_item(const_iterator aParent, const item_cell_data& aCellData) override;
+        iterator append_item(const item_model_index& aIndex, const item_cell_data& aCellData) override;
+        void clear() override;
+        iterator erase(const_iterator aPosition) override;
+        void begin_update() override;
+        void end_update() override;
+        bool updating() const override;
+        void insert_cell_data(const_iterator aItem, item_model_index::column_type aColumnIndex, const item_cell_data& aCellData) override;
+        void insert_cell_data(const item_model_index& aIndex, const item_cell_data& aCellData) override;
+        void update_cell_data(const item_model_index& aIndex, const item_cell_data& aCellData) override;
+    public:
+        const item_cell_info& cell_info(const item_model_index& aIndex) const override;
+        const item_cell_data& cell_data(const item_model_index& aIndex) const override;
+    public:
+        i_item_data_source& source() const override;
+        item_fetch_mode fetch_mode() const override;
+        uint32_t page_size() const override;
+        uint32_t max_resident_pages() const override;
+        void set_max_resident_pages(uint32_t aMaxResidentPages) override;
+        bool resident(item_model_index::row_type aRow) const override;
+        void fetch(item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow) const override;
+        void refresh() override;
+    public:
+        bool can_sort() const override;
+        void sort_by(const std::vector<sort>& aSortOrder) override;
+        bool can_filter() const override;
+        void filter_by(const std::vector<filter>& aFilters) override;
+    private:
+        const column_info& column(item_model_index::column_type aColumnIndex) const;
+        column_info& column(item_model_index::column_type aColumnIndex);
+        page_index page_of(item_model_index::row_type aRow) const;
+        uint32_t page_rows(page_index aPage) const;
+        const page* find_page(page_index aPage) const;
+        const page& make_resident(page_index aPage, std::vector<item_cell_data>&& aCells) const;
+        void evict(std::size_t aKeep) const;
+        const page& fetch_page(page_index aPage) const;
+        void request_page(page_index aPage) const;
+        void collect_fetched_pages();
+        void discard_pages();
+        void work();
+    private:
+        i_item_data_source& iSource;
+        item_fetch_mode iFetchMode;
+        uint32_t iPageSize;
+        uint32_t iMaxResidentPages;
+        uint32_t iRows;
+        uint32_t iColumnCount;
+        std::vector<column_info> iColumns;
+        uint32_t iUpdateDepth;
+        mutable std::unordered_map<page_index, page> iPages;
+        mutable std::list<page_index> iUsed;
+        mutable std::unordered_set<page_index> iRequested;
+        mutable bool iCollecting;
+        mutable std::optional<neolib::callback_timer> iCollector;
+        mutable std::mutex iSourceMutex;
+        mutable std::mutex iMutex;
+        mutable std::condition_variable iWork;
+        mutable std::deque<page_request> iRequests;
+        std::vector<fetched_page> iFetched;
+        uint32_t iGeneration;
+        bool iStopping;
+        std::thread iFetcher;
+    };
+}
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include "../../hid/native/windows_mouse.hpp"
 #include "../../hid/native/windows_window_manager.hpp"
 #include "../../gfx/native/windows_renderer.hpp"
+#include "../../gfx/native/software_renderer.hpp"
 //#include "../../audio/native/windows_audio.hpp"
 
 namespace neogfx
@@ -74,12 +75,22 @@ namespace neogfx
     template<> i_rendering_engine& service<i_rendering_engine>()
     { 
         auto const& programOptions = service<i_app>().program_options();
+        if (programOptions.renderer() == neogfx::renderer::Software)
+        {
+            static software_renderer sSoftwareRenderer;
+            return sSoftwareRenderer;
+        }
         static native::windows::renderer sWindowsRenderer{ programOptions.renderer(), programOptions.double_buffering() };
         return sWindowsRenderer; 
     }
 
     template<> void teardown_service<i_rendering_engine>()
     {
+        if (service<i_rendering_engine>().renderer() == neogfx::renderer::Software)
+        {
+            service<i_rendering_engine>().cleanup();
+            return;
+        }
         static_cast<native::windows::renderer&>(service<i_rendering_engine>()).~renderer();
         new(&service<i_rendering_engine>()) native::windows::renderer{ neogfx::renderer::None, false };
     }
@@ -105,6 +105,23 @@ namespace neogfx::game
             detect_collisions();
     }
 
+    bool collision_detector::parallel_detection_enabled() const
+    {
+        return iParallelDetectionThreads != std::nullopt;
+    }
+
+    void collision_detector::enable_parallel_detection(uint32_t aThreadCount)
+    {
+        scoped_component_lock<entity_info, box_collider_2d> lock{ ecs() };
+        iParallelDetectionThreads = aThreadCount;
+    }
+
+    void collision_detector::disable_parallel_detection()
+    {
+        scoped_component_lock<entity_info, box_collider_2d> lock{ ecs() };
+        iParallelDetectionThreads = std::nullopt;
+    }
+
     void collision_detector::update_colliders()
     {
         if (ecs().component_instantiated<box_collider>())
@@ -187,7 +204,7 @@ namespace neogfx::game
         if (ecs().component_instantiated<box_collider_2d>())
         {
             scoped_component_lock<entity_info, box_collider_2d> lock{ ecs() };
-            iBroadphase2dTree.full_update();
+            iBroadphase2dTree.dynamic_update();
         }
     }
 
@@ -205,11 +222,14 @@ namespace neogfx::game
         if (ecs().component_instantiated<box_collider_2d>())
         {
             scoped_component_lock<entity_info, box_collider_2d> lock{ ecs() };
-            iBroadphase2dTree.full_update();
-            iBroadphase2dTree.collisions([this](entity_id e1, entity_id e2)
+            auto const collisionAction = [this](entity_id e1, entity_id e2)
             {
                 Collision.trigger(e1, e2);
-            });
+            };
+            if (parallel_detection_enabled())
+                iBroadphase2dTree.parallel_collisions(collisionAction, *iParallelDetectionThreads);
+            else
+                iBroadphase2dTree.collisions(collisionAction);
         }
 
         iCollidersUpdated = false;
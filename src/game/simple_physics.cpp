@@ -91,6 +91,16 @@ namespace neogfx::game
             ecs().system<game_world>().ApplyingPhysics.trigger(worldClock.time);
             start_update(2);
             bool useUniversalGravitation = (universal_gravitation_enabled() && physicalConstants.gravitationalConstant != 0.0);
+            bool useBarnesHut = (useUniversalGravitation && iGravitationSolver == gravitation_solver::BarnesHut);
+            if (useBarnesHut)
+            {
+                iBarnesHutTree.clear();
+                for (auto const& rigidBody : rigidBodies.component_data())
+                    if (!ecs().component<entity_info>().entity_record(rigidBodies.entity(rigidBody)).destroyed)
+                        iBarnesHutTree.add(rigidBody.position, rigidBody.mass);
+                iBarnesHutTree.build();
+                useUniversalGravitation = false;
+            }
             if (useUniversalGravitation)
                 rigidBodies.sort([](const rigid_body& lhs, const rigid_body& rhs) { return lhs.mass > rhs.mass; });
             auto firstMassless = useUniversalGravitation ?
@@ -103,7 +113,9 @@ namespace neogfx::game
                 if (entity1Info.destroyed)
                     continue; // todo: add support for skip iterators
                 vec3 totalForce = rigidBody1.mass * uniformGravity;
-                if (useUniversalGravitation)
+                if (useBarnesHut)
+                    totalForce += iBarnesHutTree.force(rigidBody1.position, rigidBody1.mass, physicalConstants.gravitationalConstant);
+                else if (useUniversalGravitation)
                 {
                     for (auto iterRigidBody2 = rigidBodies.component_data().begin(); iterRigidBody2 != firstMassless; ++iterRigidBody2)
                     {
@@ -166,6 +178,22 @@ namespace neogfx::game
         return ecs().system<game_world>().disable_universal_gravitation();
     }
 
+    gravitation_solver simple_physics::universal_gravitation_solver() const
+    {
+        return iGravitationSolver;
+    }
+
+    scalar simple_physics::barnes_hut_theta() const
+    {
+        return iBarnesHutTree.theta();
+    }
+
+    void simple_physics::set_universal_gravitation_solver(gravitation_solver aSolver, scalar aBarnesHutTheta)
+    {
+        iGravitationSolver = aSolver;
+        iBarnesHutTree.set_theta(aBarnesHutTheta);
+    }
+
     void simple_physics::yield_after(std::chrono::duration<double, std::milli> aTime)
     {
         iYieldTime = aTime;
@@ -489,7 +489,18 @@ namespace neogfx
                 "    if (uGlyphEnabled)\n"
                 "    {\n"
                 "        float a = 0.0;\n"
-                "        if (uGlyphSubpixel)\n"
+                "        if (uGlyphDistanceFieldEffect != 0)\n"
+                "        {\n"
+                "            float d = (texture(tex, TexCoord).r - 0.5) * 2.0 * uGlyphDistanceFieldSpread;\n"
+                "            if (uGlyphDistanceFieldEffect == 1)\n" // Outline
+                "                a = clamp(d + uGlyphDistanceFieldWidth + 0.5, 0.0, 1.0);\n"
+                "            else\n" // Glow
+                "                a = pow(clamp(1.0 + d / uGlyphDistanceFieldWidth, 0.0, 1.0), 2.0);\n"
+                "            if (a == 0)\n"
+                "                discard;\n"
+                "            color = vec4(color.xyz, color.a * a);\n"
+                "        }\n"
+                "        else if (uGlyphSubpixel)\n"
                 "        {\n"
                 "            vec4 aaaAlpha = texture(tex, TexCoord);\n"
                 "            if (aaaAlpha.rgb == vec3(1.0, 1.0, 1.0))\n"
@@ -545,9 +556,18 @@ namespace neogfx
         uGlyphRenderOutput = sampler2DMS{ 7 };
         uGlyphSubpixel = aGlyph.glyph_texture().subpixel();
         uGlyphSubpixelFormat = subpixelRender ? aContext.subpixel_format() : subpixel_format::None;
+        uGlyphDistanceFieldEffect = text_effect_type::None;
+        uGlyphDistanceFieldSpread = static_cast<float>(GlyphDistanceFieldSpread);
+        uGlyphDistanceFieldWidth = 0.0f;
         uGlyphEnabled = true;
     }
 
+    void standard_glyph_shader::set_distance_field_effect(text_effect_type aEffect, dimension aWidth)
+    {
+        uGlyphDistanceFieldEffect = aEffect;
+        uGlyphDistanceFieldWidth = static_cast<float>(aWidth);
+    }
+
     standard_stipple_shader::standard_stipple_shader(const std::string& aName) :
         standard_fragment_shader<i_stipple_shader>{ aName }, iPosition{ 0.0 }
     {
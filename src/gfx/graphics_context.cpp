@@ -41,6 +41,7 @@
 #include <neogfx/gfx/i_texture.hpp>
 #include <neogfx/gui/widget/i_widget.hpp>
 #include <neogfx/gfx/text/text_category_map.hpp>
+#include <neogfx/gfx/text/glyph_text_cache.hpp>
 #include <neogfx/gfx/i_rendering_engine.hpp>
 #include <neogfx/gfx/i_rendering_context.hpp>
 #include <neogfx/game/mesh.hpp>
@@ -50,6 +51,33 @@
 
 namespace neogfx
 {
+    namespace
+    {
+        // blurs with a kernel radius above this are performed on a downsampled copy of the source
+        constexpr uint32_t MaxFullResolutionBlurRadius = 8u;
+
+        // Normalized one dimensional Gaussian kernel (centre weight first) for a given radius and sigma.
+        const std::vector<float>& gaussian_kernel(uint32_t aRadius, double aSigma)
+        {
+            thread_local std::map<std::pair<uint32_t, double>, std::vector<float>> tKernels;
+            auto existing = tKernels.find(std::make_pair(aRadius, aSigma));
+            if (existing != tKernels.end())
+                return existing->second;
+            std::vector<double> weights(aRadius + 1u);
+            double total = 0.0;
+            for (uint32_t i = 0u; i <= aRadius; ++i)
+            {
+                weights[i] = std::exp(-static_cast<double>(i * i) / (2.0 * aSigma * aSigma));
+                total += (i == 0u ? weights[i] : weights[i] * 2.0);
+            }
+            std::vector<float> kernel;
+            kernel.reserve(weights.size());
+            for (auto w : weights)
+                kernel.push_back(static_cast<float>(w / total));
+            return tKernels.emplace(std::make_pair(aRadius, aSigma), std::move(kernel)).first->second;
+        }
+    }
+
     struct graphics_context::glyph_text_data
     {
         struct cluster
@@ -205,9 +233,9 @@ namespace neogfx
         native_context().flush();
     }
 
-    graphics_context::ping_pong_buffers_t graphics_context::ping_pong_buffers(const size& aExtents, texture_sampling aSampling, const optional_color& aClearColor) const
+    graphics_context::ping_pong_buffers_t graphics_context::ping_pong_buffers(const size& aExtents, texture_sampling aSampling, const optional_color& aClearColor, texture_data_type aDataType) const
     {
-        auto buffer1 = std::make_unique<graphics_context>(service<i_rendering_engine>().ping_pong_buffer1(aExtents, aSampling));
+        auto buffer1 = std::make_unique<graphics_context>(service<i_rendering_engine>().ping_pong_buffer1(aExtents, aSampling, aDataType));
         {
             scoped_scissor ss{ *buffer1, rect{ point{}, aExtents} };
             if (aClearColor != std::nullopt)
@@ -218,7 +246,7 @@ namespace neogfx
             }
         }
         buffer1->render_target().deactivate_target();
-        auto buffer2 = std::make_unique<graphics_context>(service<i_rendering_engine>().ping_pong_buffer2(aExtents, aSampling));
+        auto buffer2 = std::make_unique<graphics_context>(service<i_rendering_engine>().ping_pong_buffer2(aExtents, aSampling, aDataType));
         {
             scoped_scissor ss{ *buffer2, rect{ point{}, aExtents} };
             if (aClearColor != std::nullopt)
@@ -898,12 +926,62 @@ namespace neogfx
 
     void graphics_context::blur(const rect& aDestinationRect, const i_graphics_context& aSource, const rect& aSourceRect, blurring_algorithm aAlgorithm, uint32_t aParameter1, double aParameter2) const
     {
-        // todo
+        if (aAlgorithm == blurring_algorithm::None || aParameter1 == 0u || aSourceRect.empty())
+        {
+            blit(aDestinationRect, aSource, aSourceRect);
+            return;
+        }
+        // separable Gaussian: a horizontal pass followed by a vertical pass (2(2r + 1) texture draws rather than (2r + 1)^2),
+        // each accumulating weighted, offset copies of its input with additive blending; taps beyond three standard
+        // deviations contribute nothing visible so the radius is clamped accordingly
+        double sigma = (aParameter2 > 0.0 ? aParameter2 : aParameter1 / 3.0);
+        uint32_t radius = std::min(aParameter1, static_cast<uint32_t>(std::ceil(sigma * 3.0)));
+        uint32_t const scale = std::max(1u, (radius + MaxFullResolutionBlurRadius - 1u) / MaxFullResolutionBlurRadius);
+        if (scale > 1u)
+        {
+            radius = (radius + scale - 1u) / scale;
+            sigma /= scale;
+        }
+        auto const& kernel = gaussian_kernel(radius, sigma);
+        size const scaledExtents{ std::ceil(aSourceRect.cx / scale), std::ceil(aSourceRect.cy / scale) };
+        rect const scaledRect{ point{}, scaledExtents };
+        // the passes accumulate into their own pair of floating point targets: 8-bit intermediates would round every
+        // weighted tap and band smooth gradients, and being distinct from the (8-bit, multisample) ping-pong buffers
+        // callers use they can never alias the source
+        auto const buffers = ping_pong_buffers(scaledExtents, texture_sampling::Scaled, color{ vec4{ 0.0, 0.0, 0.0, 0.0 } }, texture_data_type::Float);
+        auto const& first = *buffers.first;
+        auto const& second = *buffers.second;
+        auto const pass = [&](const i_graphics_context& aOutput, const i_graphics_context& aInput, const rect& aInputRect, bool aHorizontal)
+        {
+            scoped_render_target srt{ aOutput.render_target() };
+            scoped_scissor ss{ aOutput, scaledRect };
+            scoped_blending_mode sbm{ aOutput, neogfx::blending_mode::Additive };
+            auto const& inputTexture = aInput.render_target().target_texture();
+            for (int32_t tap = -static_cast<int32_t>(radius); tap <= static_cast<int32_t>(radius); ++tap)
+            {
+                scalar const weight = kernel[std::abs(tap)];
+                point const offset = aHorizontal ? point{ static_cast<coordinate>(tap), 0.0 } : point{ 0.0, static_cast<coordinate>(tap) };
+                aOutput.draw_texture(scaledRect + offset, inputTexture, aInputRect, color{ vec4{ weight, weight, weight, weight } });
+            }
+        };
+        if (scale > 1u)
+        {
+            {
+                scoped_render_target srt{ first.render_target() };
+                first.blit(scaledRect, aSource, aSourceRect);
+            }
+            pass(second, first, scaledRect, true);
+            {
+                scoped_render_target srt{ first.render_target() };
+                scoped_scissor ss{ first, scaledRect };
+                first.clear(color{ vec4{ 0.0, 0.0, 0.0, 0.0 } });
+            }
+        }
+        else
+            pass(second, aSource, aSourceRect, true);
+        pass(first, second, scaledRect, false);
         scoped_scissor ss{ *this, aDestinationRect };
-        dimension const w = aParameter1;
-        for (coordinate y = -w; y <= w; y += 1.0)
-            for (coordinate x = -w; x <= w; x += 1.0)
-                blit(aDestinationRect + point{ x, y }, aSource, aSourceRect);
+        blit(aDestinationRect, first, scaledRect);
     }
 
     glyph_text graphics_context::to_glyph_text(const std::string& aText, const font& aFont) const
@@ -913,12 +991,18 @@ namespace neogfx
 
     glyph_text graphics_context::to_glyph_text(std::string::const_iterator aTextBegin, std::string::const_iterator aTextEnd, const font& aFont) const
     {
-        return to_glyph_text(aTextBegin, aTextEnd, [&aFont](std::string::size_type) { return aFont; });
+        auto shape = [&]() { return to_glyph_text_impl(aTextBegin, aTextEnd, [&aFont](std::string::size_type) { return aFont; }); };
+        if (password() || iMnemonic != std::nullopt)
+            return shape();
+        return service<i_font_manager>().glyph_text_cache().find(aFont.id(), is_subpixel_rendering_on() ? 1u : 0u, aTextBegin, aTextEnd, shape);
     }
 
     glyph_text graphics_context::to_glyph_text(std::string::const_iterator aTextBegin, std::string::const_iterator aTextEnd, std::function<font(std::string::size_type)> aFontSelector) const
     {
-        return to_glyph_text_impl(aTextBegin, aTextEnd, aFontSelector);
+        auto shape = [&]() { return to_glyph_text_impl(aTextBegin, aTextEnd, aFontSelector); };
+        if (password() || iMnemonic != std::nullopt)
+            return shape();
+        return service<i_font_manager>().glyph_text_cache().find(aFontSelector, is_subpixel_rendering_on() ? 1u : 0u, aTextBegin, aTextEnd, shape);
     }
 
     glyph_text graphics_context::to_glyph_text(const std::u32string& aText, const font& aFont) const
@@ -928,12 +1012,18 @@ namespace neogfx
 
     glyph_text graphics_context::to_glyph_text(std::u32string::const_iterator aTextBegin, std::u32string::const_iterator aTextEnd, const font& aFont) const
     {
-        return to_glyph_text(aTextBegin, aTextEnd, [&aFont](std::u32string::size_type) { return aFont; });
+        auto shape = [&]() { return to_glyph_text_impl(aTextBegin, aTextEnd, [&aFont](std::u32string::size_type) { return aFont; }); };
+        if (password() || iMnemonic != std::nullopt)
+            return shape();
+        return service<i_font_manager>().glyph_text_cache().find(aFont.id(), is_subpixel_rendering_on() ? 1u : 0u, aTextBegin, aTextEnd, shape);
     }
 
     glyph_text graphics_context::to_glyph_text(std::u32string::const_iterator aTextBegin, std::u32string::const_iterator aTextEnd, std::function<font(std::u32string::size_type)> aFontSelector) const
     {
-        return to_glyph_text_impl(aTextBegin, aTextEnd, aFontSelector);
+        auto shape = [&]() { return to_glyph_text_impl(aTextBegin, aTextEnd, aFontSelector); };
+        if (password() || iMnemonic != std::nullopt)
+            return shape();
+        return service<i_font_manager>().glyph_text_cache().find(aFontSelector, is_subpixel_rendering_on() ? 1u : 0u, aTextBegin, aTextEnd, shape);
     }
 
     graphics_context::multiline_glyph_text graphics_context::to_multiline_glyph_text(const std::string& aText, const font& aFont, dimension aMaxWidth, alignment aAlignment) const
@@ -1759,8 +1849,8 @@ namespace neogfx
                             i->set_advance(size{});
                         }
                     }
-                    std::u32string sequence;
-                    sequence += chStart;
+                    thread_local std::u32string sequence;
+                    sequence.assign(1u, chStart);
                     auto j = i + 1;
                     bool absorbNext = false;
                     for (; j != result.end(); ++j)
@@ -1773,15 +1863,17 @@ namespace neogfx
                             absorbNext = true;
                             break;
                         }
-                        else if (service<i_font_manager>().emoji_atlas().is_emoji(sequence + ch))
-                            sequence += ch;
-                        else
+                        sequence.push_back(ch);
+                        if (!emojiAtlas.is_emoji(sequence.data(), sequence.data() + sequence.size()))
+                        {
+                            sequence.pop_back();
                             break;
+                        }
                     }
-                    if (sequence.size() > 1 && service<i_font_manager>().emoji_atlas().is_emoji(sequence))
+                    if (sequence.size() > 1 && emojiAtlas.is_emoji(sequence.data(), sequence.data() + sequence.size()))
                     {
                         auto g = *i;
-                        g.set_value(service<i_font_manager>().emoji_atlas().emoji(sequence, aFontSelector(cluster).height()));
+                        g.set_value(emojiAtlas.emoji(sequence, aFontSelector(cluster).height()));
                         g.set_source(glyph::source_type{ g.source().first, g.source().first + static_cast<uint32_t>(sequence.size()) });
                         emojiResult.push_back(g);
                         i = j - 1;
@@ -140,6 +140,9 @@ namespace neogfx
                 // neither are emoji...
                 if (left.glyph.subpixel() != right.glyph.subpixel())
                     return false;
+                // glyphs still being rasterized are not drawn so don't wait for them in order to compare textures
+                if (!left.glyph.glyph_texture_ready() || !right.glyph.glyph_texture_ready())
+                    return false;
                 const i_glyph_texture& leftGlyphTexture = left.glyph.glyph_texture();
                 const i_glyph_texture& rightGlyphTexture = right.glyph.glyph_texture();
                 if (leftGlyphTexture.subpixel() != rightGlyphTexture.subpixel())
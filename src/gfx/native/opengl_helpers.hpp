@@ -26,6 +26,7 @@
 #include <neogfx/gfx/i_rendering_context.hpp>
 #include <neogfx/gfx/i_shader_program.hpp>
 #include <neogfx/gfx/vertex_buffer.hpp>
+#include <neogfx/gfx/range_allocator.hpp>
 #include "opengl.hpp"
 
 namespace neogfx
@@ -60,7 +61,13 @@ namespace neogfx
         virtual void buffer_grown() = 0;
     };
 
-    template <typename T>
+    // A persistent mapped buffer split into RegionCount regions each guarded by its own fence so the CPU can
+    // write to one region whilst the GPU is still consuming another; the CPU only blocks if it is about to
+    // overwrite vertices of a region the GPU has yet to finish with. Each frame starts writing at the start of
+    // the region following the previous frame's vertices (see next_frame()). Regions are checked once per batch
+    // of writes: appending checks whole regions as it reaches them and anything else writing to vertices below
+    // size() must call prepare_write() for the range first; element access itself does no checking.
+    template <typename T, std::size_t RegionCount = 3>
     class opengl_buffer
     {
     public:
@@ -72,6 +79,14 @@ namespace neogfx
         typedef const_pointer const_iterator;
         typedef pointer iterator;
         typedef std::size_t size_type;
+    private:
+        typedef std::shared_ptr<std::remove_pointer_t<GLsync>> fence_pointer;
+        struct region
+        {
+            size_type inUseEnd = 0;
+            size_type fencedEnd = 0;
+            fence_pointer fence;
+        };
     public:
         struct no_owner : std::logic_error { no_owner() : std::logic_error{ "neogfx::opengl_buffer::no_owner" } {} };
     public:
@@ -155,16 +170,9 @@ namespace neogfx
         }
         std::size_t find_space_for(std::size_t aCount)
         {
-             // todo: optimize
-            for (auto space = iReclaimedSpace.begin(); space != iReclaimedSpace.end(); ++space)
-                if (space->second - space->first >= aCount)
-                {
-                    auto result = space->first;
-                    space->first += aCount;
-                    if (space->first == space->second)
-                        iReclaimedSpace.erase(space);
-                    return result;
-                }
+            auto const space = iReclaimedSpace.allocate(aCount);
+            if (space)
+                return *space;
             return size();
         }
         void push_back(const_reference aValue)
@@ -186,7 +194,18 @@ namespace neogfx
         }
         void clear()
         {
-            iSize = 0;
+            // writing restarts at the start of the current frame's region; earlier frames' regions are left alone
+            iSize = (capacity() != 0 ? iFrameRegion * region_capacity() : 0);
+            iPreparedEnd = iSize;
+            iReclaimedSpace.clear();
+        }
+        void next_frame()
+        {
+            fence();
+            if (capacity() == 0)
+                return;
+            iFrameRegion = (region_of(iSize != 0 ? iSize - 1 : 0) + 1) % RegionCount;
+            clear();
         }
     public:
         GLuint handle() const
@@ -234,27 +253,112 @@ namespace neogfx
         {
             if (!room_for(aExtra))
                 grow(std::max<size_type>(static_cast<size_type>((capacity() + aExtra) * 1.5), 16384));
+            if (size() + aExtra > iPreparedEnd)
+                prepare_write(size(), size() + aExtra);
         }
     public:
         void reclaim(std::size_t aStartIndex, std::size_t aEndIndex)
         {
-            if (aEndIndex != aStartIndex)
-                iReclaimedSpace.push_back(std::make_pair(aStartIndex, aEndIndex));
+            // everything at or beyond size() is already free (a clear() may have moved size() back below ranges
+            // handed out earlier) so only the part of the range below size() is returned to the allocator
+            aEndIndex = std::min(aEndIndex, size());
+            if (aStartIndex < aEndIndex)
+                iReclaimedSpace.deallocate(aStartIndex, aEndIndex);
+        }
+        const range_allocator& reclaimed_space() const
+        {
+            return iReclaimedSpace;
+        }
+    public:
+        size_type region_capacity() const
+        {
+            return std::max<size_type>(capacity() / RegionCount, 1);
+        }
+        size_type region_of(size_type aIndex) const
+        {
+            return std::min<size_type>(aIndex / region_capacity(), RegionCount - 1);
+        }
+        void mark_in_use(size_type aStartIndex, size_type aEndIndex)
+        {
+            if (aStartIndex == aEndIndex)
+                return;
+            for (auto r = region_of(aStartIndex); r <= region_of(aEndIndex - 1); ++r)
+                iRegions[r].inUseEnd = std::max(iRegions[r].inUseEnd, std::min(aEndIndex, (r + 1) * region_capacity()));
+        }
+        // waits (once) for the GPU to finish with the regions spanned by [aStartIndex, aEndIndex) if they hold
+        // vertices it may still be reading; appending to the last of those regions needs no further checks
+        void prepare_write(size_type aStartIndex, size_type aEndIndex)
+        {
+            if (aStartIndex >= aEndIndex)
+                return;
+            for (auto r = region_of(aStartIndex); r <= region_of(aEndIndex - 1); ++r)
+            {
+                auto& reg = iRegions[r];
+                auto const from = std::max(aStartIndex, r * region_capacity());
+                if (from < reg.inUseEnd)
+                    fence(); // overwriting vertices used by commands not yet fenced
+                if (reg.fence && from < reg.fencedEnd)
+                {
+                    GLenum status;
+                    glCheck(status = glClientWaitSync(reg.fence.get(), 0, 0));
+                    if (status == GL_TIMEOUT_EXPIRED)
+                    {
+                        ++iStallCount;
+                        glCheck(glClientWaitSync(reg.fence.get(), GL_SYNC_FLUSH_COMMANDS_BIT, ~0ull));
+                    }
+                    reg.fence.reset();
+                    reg.fencedEnd = 0;
+                }
+            }
+            auto const lastRegion = region_of(aEndIndex - 1);
+            iPreparedEnd = std::max(iPreparedEnd, lastRegion == RegionCount - 1 ? capacity() : (lastRegion + 1) * region_capacity());
+        }
+        void fence()
+        {
+            fence_pointer newFence;
+            for (auto& r : iRegions)
+            {
+                if (r.inUseEnd == 0)
+                    continue;
+                if (!newFence)
+                {
+                    GLsync sync;
+                    glCheck(sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+                    newFence = fence_pointer{ sync, [](GLsync aSync) { glCheck(glDeleteSync(aSync)); } };
+                }
+                r.fence = newFence;
+                r.fencedEnd = std::max(r.fencedEnd, r.inUseEnd);
+                r.inUseEnd = 0;
+            }
+        }
+        uint32_t stall_count() const
+        {
+            return iStallCount;
+        }
+        void reset_stall_count()
+        {
+            iStallCount = 0;
         }
     private:
         void grow(size_type aCapacity)
         {
-            opengl_buffer<T> temp{ aCapacity };
-            if (!empty())
+            opengl_buffer<T, RegionCount> temp{ aCapacity };
+            // only the current frame's vertices are still to be drawn; earlier regions belong to frames already
+            // submitted (for a persistent buffer the frame region never moves so everything is copied)
+            auto const liveStart = (capacity() != 0 ? std::min(iFrameRegion * region_capacity(), iSize) : 0);
+            if (liveStart != iSize)
             {
                 map();
-                std::copy(begin(), end(), std::back_inserter(temp));
+                std::copy(std::next(begin(), liveStart), end(), std::next(temp.map(), liveStart));
                 unmap();
             }
             std::swap(iBufferName, temp.iBufferName);
             std::swap(iCapacity, temp.iCapacity);
-            std::swap(iSize, temp.iSize);
             std::swap(iMemory, temp.iMemory);
+            for (auto& r : iRegions)
+                r = region{}; // the fences guard the old buffer which GL will now release once no longer in use
+            iFrameRegion = 0;
+            iPreparedEnd = capacity();
             iOwner->buffer_grown();
         }
     private:
@@ -263,7 +367,11 @@ namespace neogfx
         size_type iSize = 0;
         mutable pointer iMemory = nullptr;
         opengl_buffer_owner* iOwner = nullptr;
-        std::vector<std::pair<std::size_t, std::size_t>> iReclaimedSpace;
+        range_allocator iReclaimedSpace;
+        std::array<region, RegionCount> iRegions;
+        size_type iFrameRegion = 0;
+        size_type iPreparedEnd = 0;
+        uint32_t iStallCount = 0;
     };
 
     template <typename T>
@@ -441,10 +549,11 @@ namespace neogfx
     public:
         void execute()
         {
-            GLsync sync;
-            glCheck(sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
-            glCheck(glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, ~0ull));
-            glCheck(glDeleteSync(sync));
+            iBuffer.fence();
+        }
+        void next_frame()
+        {
+            iBuffer.next_frame();
         }
         void flush()
         {
@@ -462,6 +571,14 @@ namespace neogfx
         {
             return iBuffer.capacity();
         }
+        uint32_t stall_count() const override
+        {
+            return iBuffer.stall_count();
+        }
+        void reset_stall_count() override
+        {
+            iBuffer.reset_stall_count();
+        }
     private:
         void buffer_grown() override
         {
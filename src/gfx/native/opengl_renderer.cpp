@@ -41,35 +41,6 @@
 
 namespace neogfx
 {
-    frame_counter::frame_counter(uint32_t aDuration) : iTimer{ service<async_task>(), [this](neolib::callback_timer& aTimer)
-        {
-            aTimer.again();
-            ++iCounter;
-            for (auto w : iWidgets)
-                w->update();
-        }, aDuration }, iCounter{ 0 }
-    {
-    }
-
-    uint32_t frame_counter::counter() const
-    {
-        return iCounter;
-    }
-
-    void frame_counter::add(i_widget& aWidget)
-    {
-        auto iterWidget = std::find(iWidgets.begin(), iWidgets.end(), &aWidget);
-        if (iterWidget == iWidgets.end())
-            iWidgets.push_back(&aWidget);
-    }
-
-    void frame_counter::remove(i_widget& aWidget)
-    {
-        auto iterWidget = std::find(iWidgets.begin(), iWidgets.end(), &aWidget);
-        if (iterWidget != iWidgets.end())
-            iWidgets.erase(iterWidget);
-    }
-
     opengl_renderer::opengl_renderer(neogfx::renderer aRenderer) :
         iRenderer{ aRenderer },
         iLimitFrameRate{ true },
@@ -287,18 +258,35 @@ namespace neogfx
             auto& buffer = vb.second;
             buffer.flush();
             buffer.execute();
+            // persistent buffers hold cached vertices so only immediate buffers move on to a new region
+            if ((buffer.buffer_type() & vertex_buffer_type::Persist) != vertex_buffer_type::Persist)
+                buffer.next_frame();
         }
     }
 
-    i_texture& opengl_renderer::ping_pong_buffer1(const size& aExtents, texture_sampling aSampling)
+    uint32_t opengl_renderer::vertex_buffer_stall_count() const
+    {
+        uint32_t result = 0;
+        for (auto const& vb : iVertexBuffers)
+            result += vb.second.stall_count();
+        return result;
+    }
+
+    void opengl_renderer::reset_vertex_buffer_stall_count()
+    {
+        for (auto& vb : iVertexBuffers)
+            vb.second.reset_stall_count();
+    }
+
+    i_texture& opengl_renderer::ping_pong_buffer1(const size& aExtents, texture_sampling aSampling, texture_data_type aDataType)
     {
-        auto& bufferTexture = create_ping_pong_buffer(iPingPongBuffer1s, aExtents, aSampling);
+        auto& bufferTexture = create_ping_pong_buffer(iPingPongBuffer1s, aExtents, aSampling, aDataType);
         return bufferTexture;
     }
 
-    i_texture& opengl_renderer::ping_pong_buffer2(const size& aExtents, texture_sampling aSampling)
+    i_texture& opengl_renderer::ping_pong_buffer2(const size& aExtents, texture_sampling aSampling, texture_data_type aDataType)
     {
-        auto& bufferTexture = create_ping_pong_buffer(iPingPongBuffer2s, aExtents, aSampling);
+        auto& bufferTexture = create_ping_pong_buffer(iPingPongBuffer2s, aExtents, aSampling, aDataType);
         return bufferTexture;
     }
 
@@ -394,13 +382,13 @@ namespace neogfx
         return 0;
     }    
     
-    i_texture& opengl_renderer::create_ping_pong_buffer(ping_pong_buffers_t& aBufferList, const size& aExtents, texture_sampling aSampling)
+    i_texture& opengl_renderer::create_ping_pong_buffer(ping_pong_buffers_t& aBufferList, const size& aExtents, texture_sampling aSampling, texture_data_type aDataType)
     {
-        auto existing = aBufferList.lower_bound(std::make_pair(aSampling, aExtents));
-        if (existing != aBufferList.end() && existing->first.first == aSampling && existing->first.second >= aExtents)
+        auto existing = aBufferList.lower_bound(std::make_tuple(aSampling, aDataType, aExtents));
+        if (existing != aBufferList.end() && std::get<0>(existing->first) == aSampling && std::get<1>(existing->first) == aDataType && std::get<2>(existing->first) >= aExtents)
             return existing->second;
         auto const sizeMultiple = 1024;
         basic_size<int32_t> idealSize{ (((static_cast<int32_t>(aExtents.cx) - 1) / sizeMultiple) + 1) * sizeMultiple, (((static_cast<int32_t>(aExtents.cy) - 1) / sizeMultiple) + 1) * sizeMultiple };
-        return aBufferList.emplace(std::make_pair(aSampling, idealSize), texture{ idealSize, 1.0, aSampling }).first->second;
+        return aBufferList.emplace(std::make_tuple(aSampling, aDataType, idealSize), texture{ idealSize, 1.0, aSampling, texture_data_format::RGBA, aDataType }).first->second;
     }
 }
\ No newline at end of file
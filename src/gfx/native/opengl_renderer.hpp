@@ -22,6 +22,7 @@
 #include <neogfx/neogfx.hpp>
 #include <set>
 #include <map>
+#include <tuple>
 #include <neolib/task/timer.hpp>
 #include <neogfx/gfx/i_rendering_engine.hpp>
 #include <neogfx/gfx/text/font_manager.hpp>
@@ -29,27 +30,13 @@
 #include "opengl.hpp"
 #include "opengl_texture_manager.hpp"
 #include "opengl_helpers.hpp"
+#include "frame_counter.hpp"
 
 std::string glErrorString(GLenum aErrorCode);
 GLenum glCheckError(const char* file, unsigned int line);
 
 namespace neogfx
 {
-    class frame_counter
-    {
-    public:
-        frame_counter(uint32_t aDuration);
-    public:
-        uint32_t counter() const;
-    public:
-        void add(i_widget& aWidget);
-        void remove(i_widget& aWidget);
-    private:
-        neolib::callback_timer iTimer;
-        uint32_t iCounter;
-        std::vector<i_widget*> iWidgets;
-    };
-
     class opengl_renderer : public i_rendering_engine
     {
         // events
@@ -68,7 +55,7 @@ namespace neogfx
         // types
     public:
         typedef neolib::vector<neolib::ref_ptr<i_shader_program>> shader_program_list;
-        typedef std::map<std::pair<texture_sampling, size>, texture> ping_pong_buffers_t;
+        typedef std::map<std::tuple<texture_sampling, texture_data_type, size>, texture> ping_pong_buffers_t;
         typedef i_rendering_engine::handle opengl_context;
         // construction
     public:
@@ -105,9 +92,11 @@ namespace neogfx
         const i_vertex_buffer& vertex_buffer(i_vertex_provider& aProvider) const override;
         i_vertex_buffer& vertex_buffer(i_vertex_provider& aProvider) override;
         void execute_vertex_buffers() override;
+        uint32_t vertex_buffer_stall_count() const override;
+        void reset_vertex_buffer_stall_count() override;
     public:
-        i_texture& ping_pong_buffer1(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample) override;
-        i_texture& ping_pong_buffer2(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample) override;
+        i_texture& ping_pong_buffer1(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, texture_data_type aDataType = texture_data_type::UnsignedByte) override;
+        i_texture& ping_pong_buffer2(const size& aExtents, texture_sampling aSampling = texture_sampling::Multisample, texture_data_type aDataType = texture_data_type::UnsignedByte) override;
     public:
         bool is_subpixel_rendering_on() const override;
         void subpixel_rendering_on() override;
@@ -122,7 +111,7 @@ namespace neogfx
         void register_frame_counter(i_widget& aWidget, uint32_t aDuration) override;
         void unregister_frame_counter(i_widget& aWidget, uint32_t aDuration) override;
         uint32_t frame_counter(uint32_t aDuration) const override;
-        i_texture& create_ping_pong_buffer(ping_pong_buffers_t& aBufferList, const size& aExtents, texture_sampling aSampling);
+        i_texture& create_ping_pong_buffer(ping_pong_buffers_t& aBufferList, const size& aExtents, texture_sampling aSampling, texture_data_type aDataType);
     private:
         neogfx::renderer iRenderer;
         mutable std::optional<opengl_texture_manager> iTextureManager;
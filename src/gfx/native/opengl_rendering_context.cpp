@@ -723,6 +723,10 @@ namespace neogfx
                 glCheck(glEnable(GL_BLEND));
                 glCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
                 break;
+            case neogfx::blending_mode::Additive:
+                glCheck(glEnable(GL_BLEND));
+                glCheck(glBlendFunc(GL_ONE, GL_ONE));
+                break;
             }
         }
     }
@@ -1351,7 +1355,7 @@ namespace neogfx
                 auto const& vertices = drawOp.mesh.vertices;
                 auto const& uv = drawOp.mesh.uv;
                 if (!vertexArrays.room_for(drawOp.mesh.faces.size() * 3u))
-                    vertexArrays.execute();
+                    vertexArrays.execute(drawOp.mesh.faces.size() * 3u);
                 for (auto const& f : drawOp.mesh.faces)
                 {
                     for (auto vi : f)
@@ -1469,6 +1473,7 @@ namespace neogfx
                 {
                     draw();
                     bool updateGlyphShader = true;
+                    std::optional<std::pair<text_effect_type, dimension>> distanceFieldEffect;
                     for (auto op = aDrawGlyphOps.first; op != aDrawGlyphOps.second; ++op)
                     {
                         auto const& drawOp = static_variant_cast<const graphics_operation::draw_glyph&>(*op);
@@ -1476,16 +1481,42 @@ namespace neogfx
                         if (drawOp.glyph.is_whitespace() || drawOp.glyph.is_emoji())
                             continue;
 
+                        // a glyph still being rasterized in the background is drawn when ready rather than stalling the frame
+                        if (!drawOp.glyph.glyph_texture_ready())
+                            continue;
+
                         auto const& glyphTexture = drawOp.glyph.glyph_texture();
 
-                        bool const renderEffects = !drawOp.appearance.only_calculate_effect() && drawOp.appearance.effect() && drawOp.appearance.effect()->type() == text_effect_type::Outline;
+                        bool const renderEffects = !drawOp.appearance.only_calculate_effect() && drawOp.appearance.effect() &&
+                            (drawOp.appearance.effect()->type() == text_effect_type::Outline ||
+                                (drawOp.appearance.effect()->type() == text_effect_type::Glow && drawOp.appearance.effect()->width() <= GlyphDistanceFieldSpread));
                         if (!renderEffects && pass == 2)
                             continue;
 
+                        // outlines and glows no wider than the distance field spread are rendered with one distance field quad per glyph
+                        bool const useDistanceField = pass == 2 && drawOp.appearance.effect()->width() > 0.0 && drawOp.appearance.effect()->width() <= GlyphDistanceFieldSpread;
+                        if (useDistanceField && !updateGlyphShader && distanceFieldEffect != std::make_pair(drawOp.appearance.effect()->type(), drawOp.appearance.effect()->width()))
+                        {
+                            draw();
+                            updateGlyphShader = true;
+                        }
+
                         if (updateGlyphShader)
                         {
                             updateGlyphShader = false;
                             rendering_engine().default_shader_program().glyph_shader().set_first_glyph(*this, drawOp.glyph);
+                            distanceFieldEffect = std::nullopt;
+                            if (useDistanceField)
+                            {
+                                distanceFieldEffect = std::make_pair(drawOp.appearance.effect()->type(), drawOp.appearance.effect()->width());
+                                rendering_engine().default_shader_program().glyph_shader().set_distance_field_effect(distanceFieldEffect->first, distanceFieldEffect->second);
+                            }
+                        }
+                        else if (pass == 2 && !useDistanceField && distanceFieldEffect)
+                        {
+                            draw();
+                            distanceFieldEffect = std::nullopt;
+                            rendering_engine().default_shader_program().glyph_shader().set_distance_field_effect(text_effect_type::None, 0.0);
                         }
 
                         bool const subpixelRender = drawOp.glyph.subpixel() && glyphTexture.subpixel();
@@ -1499,7 +1530,52 @@ namespace neogfx
                                 drawOp.point.y + glyphFont.height() - (glyphTexture.placement().y + -glyphFont.descender()) - glyphTexture.texture().extents().cy,
                             drawOp.point.z };
 
-                        if (pass == 2)
+                        if (useDistanceField)
+                        {
+                            auto const& distanceField = drawOp.glyph.glyph_distance_field();
+                            vec3 const distanceFieldOrigin{
+                                drawOp.point.x + distanceField.placement().x,
+                                logical_coordinates().is_game_orientation() ?
+                                    drawOp.point.y + (distanceField.placement().y + -glyphFont.descender()) :
+                                    drawOp.point.y + glyphFont.height() - (distanceField.placement().y + -glyphFont.descender()) - distanceField.texture().extents().cy,
+                                drawOp.point.z };
+                            rect const outputRect = { point{ distanceFieldOrigin }, distanceField.texture().extents() };
+                            bool haveGradient = std::holds_alternative<gradient>(drawOp.appearance.effect()->color());
+                            if (haveGradient)
+                            {
+                                updateGlyphShader = true;
+                                draw();
+                                rendering_engine().default_shader_program().gradient_shader().set_gradient(
+                                    *this, static_variant_cast<gradient>(drawOp.appearance.effect()->color()), outputRect);
+                            }
+                            auto mesh = logical_coordinates().is_gui_orientation() ?
+                                to_ecs_component(
+                                    outputRect,
+                                    mesh_type::Triangles,
+                                    drawOp.point.z) :
+                                to_ecs_component(
+                                    game_rect{ outputRect },
+                                    mesh_type::Triangles,
+                                    drawOp.point.z);
+                            meshFilters.push_back(game::mesh_filter{ {}, mesh });
+                            meshRenderers.push_back(
+                                game::mesh_renderer{
+                                    game::material{
+                                        std::holds_alternative<color>(drawOp.appearance.effect()->color()) ?
+                                            to_ecs_component(static_variant_cast<const color&>(drawOp.appearance.effect()->color())) : std::optional<game::color>{},
+                                        {},
+                                        {},
+                                        to_ecs_component(distanceField.texture()),
+                                        shader_effect::Ignore
+                                    } });
+                            if (haveGradient)
+                            {
+                                updateGlyphShader = true;
+                                draw();
+                                rendering_engine().default_shader_program().gradient_shader().clear_gradient();
+                            }
+                        }
+                        else if (pass == 2)
                         {
                             auto const scanlineOffsets = (pass == 2 ? static_cast<uint32_t>(drawOp.appearance.effect()->width()) * 2u + 1u : 1u);
                             auto const offsets = scanlineOffsets * scanlineOffsets;
@@ -1714,6 +1790,7 @@ namespace neogfx
                     }
                     // todo: check vertex count is same as in cache
                     auto const vertexStartIndex = (meshRenderCache.state != game::cache_state::Invalid ? cacheIndices[0] : vertices.find_space_for(faces.size() * 3));
+                    vertices.prepare_write(vertexStartIndex, std::min(vertexStartIndex + faces.size() * 3, vertices.size()));
                     auto nextIndex = vertexStartIndex;
                     for (auto const& face : faces)
                     {
@@ -0,0 +1,407 @@
+// software_rasterizer.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gfx/text/i_glyph_texture.hpp>
+#include "software_texture.hpp"
+#include "software_rasterizer.hpp"
+
+namespace neogfx
+{
+    namespace
+    {
+        inline float to_unit(uint8_t aValue)
+        {
+            return aValue / 255.0f;
+        }
+
+        inline uint8_t to_byte(float aValue)
+        {
+            return static_cast<uint8_t>(std::clamp(aValue, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        // the blend equations are those the OpenGL renderer configures (see opengl_rendering_context::set_blending_mode);
+        // partial coverage at shape edges weights the result against the destination as a multisample resolve would
+        inline void blend_pixel(uint8_t* aDestination, const std::array<float, 4>& aSource, float aCoverage, blending_mode aBlendingMode)
+        {
+            std::array<float, 4> const destination = { to_unit(aDestination[0]), to_unit(aDestination[1]), to_unit(aDestination[2]), to_unit(aDestination[3]) };
+            std::array<float, 4> result;
+            for (std::size_t c = 0; c < 4; ++c)
+            {
+                switch (aBlendingMode)
+                {
+                case blending_mode::None:
+                    result[c] = aSource[c];
+                    break;
+                case blending_mode::Blit:
+                    result[c] = aSource[c] + destination[c] * (1.0f - aSource[3]);
+                    break;
+                case blending_mode::Default:
+                default:
+                    result[c] = aSource[c] * aSource[3] + destination[c] * (1.0f - aSource[3]);
+                    break;
+                case blending_mode::Additive:
+                    result[c] = aSource[c] + destination[c];
+                    break;
+                }
+                aDestination[c] = to_byte(destination[c] + (result[c] - destination[c]) * aCoverage);
+            }
+        }
+
+        inline scalar signed_area(const std::vector<vec2>& aContour)
+        {
+            scalar result = 0.0;
+            for (std::size_t i = 0; i < aContour.size(); ++i)
+            {
+                auto const& p = aContour[i];
+                auto const& q = aContour[(i + 1) % aContour.size()];
+                result += p.x * q.y - q.x * p.y;
+            }
+            return result / 2.0;
+        }
+    }
+
+    software_rasterizer::software_rasterizer(const software_texture& aTarget) :
+        iTarget{ aTarget },
+        iWidth{ static_cast<int32_t>(aTarget.extents().cx) },
+        iHeight{ static_cast<int32_t>(aTarget.extents().cy) },
+        iBorder{ aTarget.sampling() != texture_sampling::Data ? 1 : 0 }
+    {
+    }
+
+    const software_texture& software_rasterizer::target() const
+    {
+        return iTarget;
+    }
+
+    int32_t software_rasterizer::width() const
+    {
+        return iWidth;
+    }
+
+    int32_t software_rasterizer::height() const
+    {
+        return iHeight;
+    }
+
+    void software_rasterizer::clear(const clip& aClip, const color& aColor)
+    {
+        std::array<uint8_t, 4> const value = { aColor.red(), aColor.green(), aColor.blue(), aColor.alpha() };
+        for (int32_t y = aClip.top; y < aClip.bottom; ++y)
+            for (int32_t x = aClip.left; x < aClip.right; ++x)
+                std::copy(value.begin(), value.end(), pixel(x, y));
+    }
+
+    void software_rasterizer::set_pixel(const clip& aClip, int32_t aX, int32_t aY, const rgba& aColor, blending_mode aBlendingMode)
+    {
+        if (aX < aClip.left || aX >= aClip.right || aY < aClip.top || aY >= aClip.bottom)
+            return;
+        blend_pixel(pixel(aX, aY), aColor, 1.0f, aBlendingMode);
+    }
+
+    void software_rasterizer::fill_rect(const clip& aClip, const std::array<scalar, 4>& aRect, const paint& aPaint, blending_mode aBlendingMode)
+    {
+        scalar const left = std::min(aRect[0], aRect[2]);
+        scalar const top = std::min(aRect[1], aRect[3]);
+        scalar const right = std::max(aRect[0], aRect[2]);
+        scalar const bottom = std::max(aRect[1], aRect[3]);
+        auto c = aClip;
+        c.left = std::max(c.left, static_cast<int32_t>(std::floor(left)));
+        c.right = std::min(c.right, static_cast<int32_t>(std::ceil(right)));
+        c.top = std::max(c.top, static_cast<int32_t>(std::floor(top)));
+        c.bottom = std::min(c.bottom, static_cast<int32_t>(std::ceil(bottom)));
+        if (c.empty())
+            return;
+        auto const columnCoverage = [&](int32_t x)
+        {
+            return static_cast<float>(std::min(right, x + 1.0) - std::max(left, static_cast<scalar>(x)));
+        };
+        thread_local std::vector<float> columns;
+        columns.assign(static_cast<std::size_t>(c.right - c.left), 1.0f);
+        columns.front() = columnCoverage(c.left);
+        columns.back() = columnCoverage(c.right - 1);
+        for (int32_t y = c.top; y < c.bottom; ++y)
+        {
+            auto const rowCoverage = static_cast<float>(std::min(bottom, y + 1.0) - std::max(top, static_cast<scalar>(y)));
+            iCoverage.resize(columns.size());
+            for (std::size_t i = 0; i < columns.size(); ++i)
+                iCoverage[i] = columns[i] * rowCoverage;
+            composite(y, c.left, c.right, aPaint, aBlendingMode);
+        }
+    }
+
+    void software_rasterizer::fill(const clip& aClip, const contours& aContours, const paint& aPaint, blending_mode aBlendingMode)
+    {
+        scalar minX = std::numeric_limits<scalar>::max();
+        scalar minY = std::numeric_limits<scalar>::max();
+        scalar maxX = std::numeric_limits<scalar>::lowest();
+        scalar maxY = std::numeric_limits<scalar>::lowest();
+        for (auto const& contour : aContours)
+            for (auto const& p : contour)
+            {
+                minX = std::min(minX, p.x);
+                minY = std::min(minY, p.y);
+                maxX = std::max(maxX, p.x);
+                maxY = std::max(maxY, p.y);
+            }
+        if (minX > maxX)
+            return;
+        auto c = aClip;
+        c.left = std::max(c.left, static_cast<int32_t>(std::floor(minX)));
+        c.right = std::min(c.right, static_cast<int32_t>(std::ceil(maxX)));
+        c.top = std::max(c.top, static_cast<int32_t>(std::floor(minY)));
+        c.bottom = std::min(c.bottom, static_cast<int32_t>(std::ceil(maxY)));
+        if (c.empty())
+            return;
+        for (int32_t y = c.top; y < c.bottom; ++y)
+        {
+            iCoverage.assign(static_cast<std::size_t>(c.right - c.left), 0.0f);
+            bool covered = false;
+            for (uint32_t s = 0; s < SubScanlines; ++s)
+            {
+                scalar const sampleY = y + (s + 0.5) / SubScanlines;
+                iCrossings.clear();
+                for (auto const& contour : aContours)
+                    for (std::size_t i = 0; i < contour.size(); ++i)
+                    {
+                        auto const& p = contour[i];
+                        auto const& q = contour[(i + 1) % contour.size()];
+                        if ((p.y <= sampleY && q.y > sampleY) || (q.y <= sampleY && p.y > sampleY))
+                            iCrossings.emplace_back(p.x + (sampleY - p.y) * (q.x - p.x) / (q.y - p.y), q.y > p.y ? 1 : -1);
+                    }
+                if (iCrossings.empty())
+                    continue;
+                std::sort(iCrossings.begin(), iCrossings.end());
+                // non-zero winding rule
+                int32_t winding = 0;
+                scalar spanStart = 0.0;
+                for (auto const& crossing : iCrossings)
+                {
+                    auto const previousWinding = winding;
+                    winding += crossing.second;
+                    if (previousWinding == 0 && winding != 0)
+                        spanStart = crossing.first;
+                    else if (previousWinding != 0 && winding == 0)
+                    {
+                        add_coverage(spanStart, crossing.first, c.left, c.right);
+                        covered = true;
+                    }
+                }
+            }
+            if (covered)
+                composite(y, c.left, c.right, aPaint, aBlendingMode);
+        }
+    }
+
+    software_rasterizer::contour software_rasterizer::line_to_quad(const vec2& aStart, const vec2& aEnd, scalar aWidth)
+    {
+        // as with the OpenGL renderer each line is a quad extending half the line width beyond both of its ends so that
+        // the quads of connected lines overlap at their joins
+        auto const halfWidth = aWidth / 2.0;
+        auto const delta = aEnd - aStart;
+        auto const length = delta.magnitude();
+        auto const along = (length != 0.0 ? delta / length : vec2{ 1.0, 0.0 }) * halfWidth;
+        vec2 const across{ -along.y, along.x };
+        contour result{ aStart - along - across, aStart - along + across, aEnd + along + across, aEnd + along - across };
+        orient(result);
+        return result;
+    }
+
+    bool software_rasterizer::orient(contour& aContour)
+    {
+        // contours filled together must wind the same way for the non-zero rule to union rather than cancel them
+        auto const area = signed_area(aContour);
+        if (area < 0.0)
+            std::reverse(aContour.begin(), aContour.end());
+        return area != 0.0;
+    }
+
+    void software_rasterizer::add_coverage(scalar aFrom, scalar aTo, int32_t aLeft, int32_t aRight)
+    {
+        aFrom = std::max(aFrom, static_cast<scalar>(aLeft));
+        aTo = std::min(aTo, static_cast<scalar>(aRight));
+        if (aTo <= aFrom)
+            return;
+        float const weight = 1.0f / SubScanlines;
+        auto const first = static_cast<int32_t>(std::floor(aFrom));
+        auto const last = static_cast<int32_t>(std::floor(aTo));
+        if (first == last)
+        {
+            iCoverage[first - aLeft] += static_cast<float>(aTo - aFrom) * weight;
+            return;
+        }
+        iCoverage[first - aLeft] += static_cast<float>(first + 1.0 - aFrom) * weight;
+        for (int32_t x = first + 1; x < last; ++x)
+            iCoverage[x - aLeft] += weight;
+        if (last < aRight)
+            iCoverage[last - aLeft] += static_cast<float>(aTo - last) * weight;
+    }
+
+    void software_rasterizer::composite(int32_t aY, int32_t aLeft, int32_t aRight, const paint& aPaint, blending_mode aBlendingMode)
+    {
+        auto const count = aRight - aLeft;
+        for (int32_t i = 0; i < count; ++i)
+        {
+            if (iCoverage[i] <= 0.0f)
+                continue;
+            auto const source = shade(aPaint, aLeft + i + 0.5, aY + 0.5);
+            if (source == std::nullopt)
+                continue;
+            blend_pixel(pixel(aLeft + i, aY), *source, std::min(iCoverage[i], 1.0f), aBlendingMode);
+        }
+    }
+
+    // the stages are those of the standard shader program: gradient, then texture, then glyph coverage
+    std::optional<software_rasterizer::rgba> software_rasterizer::shade(const paint& aPaint, scalar aX, scalar aY) const
+    {
+        rgba result = aPaint.color;
+        if (!aPaint.gradientLut.empty())
+        {
+            auto const& box = aPaint.boundingBox;
+            scalar const width = std::max(box[2] - box[0], 1.0);
+            scalar const height = std::max(box[3] - box[1], 1.0);
+            scalar const u = (aX - box[0]) / width;
+            scalar const v = (aY - box[1]) / height;
+            scalar position = 0.0;
+            switch (aPaint.direction)
+            {
+            case gradient_direction::Vertical:
+                position = v;
+                break;
+            case gradient_direction::Horizontal:
+                position = u;
+                break;
+            case gradient_direction::Diagonal:
+                position = (u + v) / 2.0;
+                break;
+            case gradient_direction::Rectangular:
+                position = std::max(std::abs(u - 0.5), std::abs(v - 0.5)) * 2.0;
+                break;
+            case gradient_direction::Radial:
+                position = std::sqrt((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5)) * 2.0;
+                break;
+            }
+            result = aPaint.gradientLut[static_cast<std::size_t>(std::clamp(position, 0.0, 1.0) * (aPaint.gradientLut.size() - 1) + 0.5)];
+        }
+        if (aPaint.texture == std::nullopt)
+            return result;
+        auto const& textureSampler = *aPaint.texture;
+        auto const texel = sample(textureSampler, aX, aY);
+        auto const dataFormat = textureSampler.texture->data_format();
+        switch (textureSampler.source)
+        {
+        case coverage_source::Texture:
+            {
+                rgba t = texel;
+                if (dataFormat == texture_data_format::Red)
+                    t = rgba{ 1.0f, 1.0f, 1.0f, texel[0] };
+                else if (dataFormat == texture_data_format::SubPixel)
+                    t = rgba{ 1.0f, 1.0f, 1.0f, (texel[0] + texel[1] + texel[2]) / 3.0f };
+                switch (textureSampler.effect)
+                {
+                case shader_effect::None:
+                    for (std::size_t c = 0; c < 4; ++c)
+                        result[c] *= t[c];
+                    break;
+                case shader_effect::Colorize:
+                    {
+                        float const average = (t[0] + t[1] + t[2]) / 3.0f;
+                        result = rgba{ result[0] * average, result[1] * average, result[2] * average, result[3] * t[3] };
+                    }
+                    break;
+                case shader_effect::ColorizeMaximum:
+                    {
+                        float const maxChannel = std::max(t[0], std::max(t[1], t[2]));
+                        result = rgba{ result[0] * maxChannel, result[1] * maxChannel, result[2] * maxChannel, result[3] * t[3] };
+                    }
+                    break;
+                case shader_effect::ColorizeSpot:
+                    result[3] *= t[3];
+                    break;
+                case shader_effect::Monochrome:
+                    {
+                        float const gray = result[0] * t[0] * 0.299f + result[1] * t[1] * 0.587f + result[2] * t[2] * 0.114f;
+                        result = rgba{ result[0] * gray, result[1] * gray, result[2] * gray, result[3] * t[3] };
+                    }
+                    break;
+                case shader_effect::Ignore:
+                    break;
+                }
+            }
+            break;
+        case coverage_source::Glyph:
+            {
+                float const a = (dataFormat == texture_data_format::SubPixel ? (texel[0] + texel[1] + texel[2]) / 3.0f : texel[0]);
+                if (a == 0.0f)
+                    return {};
+                result[3] *= a;
+            }
+            break;
+        case coverage_source::DistanceFieldOutline:
+        case coverage_source::DistanceFieldGlow:
+            {
+                auto const d = (texel[0] - 0.5) * 2.0 * GlyphDistanceFieldSpread;
+                auto const a = static_cast<float>(textureSampler.source == coverage_source::DistanceFieldOutline ?
+                    std::clamp(d + textureSampler.effectWidth + 0.5, 0.0, 1.0) :
+                    std::pow(std::clamp(1.0 + d / textureSampler.effectWidth, 0.0, 1.0), 2.0));
+                if (a == 0.0f)
+                    return {};
+                result[3] *= a;
+            }
+            break;
+        }
+        return result;
+    }
+
+    software_rasterizer::rgba software_rasterizer::sample(const sampler& aSampler, scalar aX, scalar aY) const
+    {
+        auto const& m = aSampler.toTexel;
+        auto const u = m[0] * aX + m[1] * aY + m[2];
+        auto const v = m[3] * aX + m[4] * aY + m[5];
+        auto const& texture = *aSampler.texture;
+        auto const maxX = static_cast<int32_t>(texture.storage_extents().cx) - 1;
+        auto const maxY = static_cast<int32_t>(texture.storage_extents().cy) - 1;
+        auto const fetch = [&](int32_t aTexelX, int32_t aTexelY)
+        {
+            auto const t = texture.texel(std::clamp(aTexelX, 0, maxX), std::clamp(aTexelY, 0, maxY));
+            return rgba{ to_unit(t[0]), to_unit(t[1]), to_unit(t[2]), to_unit(t[3]) };
+        };
+        if (aSampler.nearest)
+            return fetch(static_cast<int32_t>(std::floor(u)), static_cast<int32_t>(std::floor(v)));
+        // texel centres are at half texel offsets as they are for GL_LINEAR filtering
+        auto const x0 = static_cast<int32_t>(std::floor(u - 0.5));
+        auto const y0 = static_cast<int32_t>(std::floor(v - 0.5));
+        auto const fx = static_cast<float>(u - 0.5 - x0);
+        auto const fy = static_cast<float>(v - 0.5 - y0);
+        auto const t00 = fetch(x0, y0);
+        auto const t10 = fetch(x0 + 1, y0);
+        auto const t01 = fetch(x0, y0 + 1);
+        auto const t11 = fetch(x0 + 1, y0 + 1);
+        rgba result;
+        for (std::size_t c = 0; c < 4; ++c)
+            result[c] = (t00[c] * (1.0f - fx) + t10[c] * fx) * (1.0f - fy) + (t01[c] * (1.0f - fx) + t11[c] * fx) * fy;
+        return result;
+    }
+
+    uint8_t* software_rasterizer::pixel(int32_t aX, int32_t aY) const
+    {
+        // device rows run top to bottom; storage rows, as with OpenGL, run bottom to top
+        return iTarget.texel(static_cast<uint32_t>(aX + iBorder), static_cast<uint32_t>(iBorder + iHeight - 1 - aY));
+    }
+}
\ No newline at end of file
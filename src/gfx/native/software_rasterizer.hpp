@@ -0,0 +1,106 @@
+// software_rasterizer.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <array>
+#include <neogfx/core/geometrical.hpp>
+#include <neogfx/core/color.hpp>
+#include <neogfx/gfx/primitives.hpp>
+
+namespace neogfx
+{
+    class software_texture;
+
+    // Scan converts shapes into a software texture render target. Shapes are given in device coordinates (pixels, top
+    // row first) and are covered with SubScanlines coverage samples per pixel row; sources are combined with the
+    // target using the same blend equations the OpenGL renderer configures for each blending mode.
+    class software_rasterizer
+    {
+    public:
+        static constexpr uint32_t SubScanlines = 4;
+        static constexpr std::size_t GradientLutSize = 256;
+    public:
+        typedef std::array<float, 4> rgba;
+        typedef std::vector<vec2> contour;
+        typedef std::vector<contour> contours;
+        enum class coverage_source : uint32_t
+        {
+            Texture,
+            Glyph,
+            DistanceFieldOutline,
+            DistanceFieldGlow
+        };
+        struct sampler
+        {
+            const software_texture* texture;
+            bool nearest;
+            coverage_source source;
+            shader_effect effect;
+            scalar effectWidth;
+            // maps device coordinates to texture storage coordinates: u = [0]x + [1]y + [2], v = [3]x + [4]y + [5]
+            std::array<scalar, 6> toTexel;
+        };
+        struct paint
+        {
+            rgba color;
+            std::vector<rgba> gradientLut;
+            gradient_direction direction;
+            std::array<scalar, 4> boundingBox;
+            std::optional<sampler> texture;
+        };
+        struct clip
+        {
+            int32_t left;
+            int32_t top;
+            int32_t right;
+            int32_t bottom;
+            bool empty() const { return left >= right || top >= bottom; }
+        };
+    public:
+        software_rasterizer(const software_texture& aTarget);
+    public:
+        const software_texture& target() const;
+        int32_t width() const;
+        int32_t height() const;
+    public:
+        void clear(const clip& aClip, const color& aColor);
+        void set_pixel(const clip& aClip, int32_t aX, int32_t aY, const rgba& aColor, blending_mode aBlendingMode);
+        void fill_rect(const clip& aClip, const std::array<scalar, 4>& aRect, const paint& aPaint, blending_mode aBlendingMode);
+        void fill(const clip& aClip, const contours& aContours, const paint& aPaint, blending_mode aBlendingMode);
+    public:
+        static contour line_to_quad(const vec2& aStart, const vec2& aEnd, scalar aWidth);
+        static bool orient(contour& aContour);
+    private:
+        void add_coverage(scalar aFrom, scalar aTo, int32_t aLeft, int32_t aRight);
+        void composite(int32_t aY, int32_t aLeft, int32_t aRight, const paint& aPaint, blending_mode aBlendingMode);
+        std::optional<rgba> shade(const paint& aPaint, scalar aX, scalar aY) const;
+        rgba sample(const sampler& aSampler, scalar aX, scalar aY) const;
+        uint8_t* pixel(int32_t aX, int32_t aY) const;
+    private:
+        const software_texture& iTarget;
+        int32_t iWidth;
+        int32_t iHeight;
+        int32_t iBorder;
+        std::vector<float> iCoverage;
+        std::vector<std::pair<scalar, int32_t>> iCrossings;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,427 @@
+// software_renderer.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neolib/app/i_power.hpp>
+#include <neogfx/hid/i_surface_manager.hpp>
+#include <neogfx/gui/widget/i_widget.hpp>
+#include "../../gui/window/native/i_native_window.hpp"
+#include "software_renderer.hpp"
+
+namespace neogfx
+{
+    namespace
+    {
+        // there is no display so metrics are those of a nominal 96 DPI screen
+        class headless_metrics : public i_device_metrics
+        {
+        public:
+            dimension horizontal_dpi() const override
+            {
+                return 96.0;
+            }
+            dimension vertical_dpi() const override
+            {
+                return 96.0;
+            }
+            dimension ppi() const override
+            {
+                return 96.0;
+            }
+        public:
+            bool metrics_available() const override
+            {
+                return true;
+            }
+            size extents() const override
+            {
+                return size{ 1920.0, 1080.0 };
+            }
+            dimension em_size() const override
+            {
+                return 0.0;
+            }
+        };
+    }
+
+    software_renderer::software_renderer() :
+        iLimitFrameRate{ true },
+        iFrameRateLimit{ 60u },
+        iSubpixelRendering{ false }
+    {
+    }
+
+    software_renderer::~software_renderer()
+    {
+        cleanup();
+    }
+
+    const i_device_metrics& software_renderer::default_screen_metrics() const
+    {
+        static const headless_metrics sMetrics;
+        return sMetrics;
+    }
+
+    renderer software_renderer::renderer() const
+    {
+        return neogfx::renderer::Software;
+    }
+
+    bool software_renderer::double_buffering() const
+    {
+        return false;
+    }
+
+    bool software_renderer::vsync_enabled() const
+    {
+        return false;
+    }
+
+    void software_renderer::enable_vsync()
+    {
+    }
+
+    void software_renderer::disable_vsync()
+    {
+    }
+
+    void software_renderer::initialize()
+    {
+    }
+
+    void software_renderer::cleanup()
+    {
+        iPingPongBuffer1s.clear();
+        iPingPongBuffer2s.clear();
+        iVertexBuffers.clear();
+        iFontManager = std::nullopt;
+        iTextureManager = std::nullopt;
+        iShaderPrograms.clear();
+    }
+
+    software_renderer::pixel_format_t software_renderer::set_pixel_format(const i_render_target&)
+    {
+        return 0;
+    }
+
+    const i_render_target* software_renderer::active_target() const
+    {
+        if (iTargetStack.empty())
+            return nullptr;
+        return iTargetStack.back();
+    }
+
+    void software_renderer::activate_context(const i_render_target& aTarget)
+    {
+        iTargetStack.push_back(&aTarget);
+    }
+
+    void software_renderer::deactivate_context()
+    {
+        if (iTargetStack.empty())
+            throw no_target_active();
+        iTargetStack.pop_back();
+
+        auto activeTarget = active_target();
+        if (activeTarget != nullptr)
+        {
+            iTargetStack.pop_back();
+            activeTarget->activate_target();
+        }
+    }
+
+    software_renderer::handle software_renderer::create_context(const i_render_target&)
+    {
+        return nullptr;
+    }
+
+    void software_renderer::destroy_context(handle)
+    {
+    }
+
+    const software_renderer::shader_program_list& software_renderer::shader_programs() const
+    {
+        return iShaderPrograms;
+    }
+
+    const i_shader_program& software_renderer::shader_program(const neolib::i_string& aName) const
+    {
+        for (auto const& s : shader_programs())
+            if (s->name() == aName)
+                return *s;
+        throw shader_program_not_found();
+    }
+
+    i_shader_program& software_renderer::shader_program(const neolib::i_string& aName)
+    {
+        return const_cast<i_shader_program&>(to_const(*this).shader_program(aName));
+    }
+
+    i_shader_program& software_renderer::add_shader_program(const neolib::i_ref_ptr<i_shader_program>& aShaderProgram)
+    {
+        iShaderPrograms.push_back(aShaderProgram);
+        return *aShaderProgram;
+    }
+
+    bool software_renderer::is_shader_program_active() const
+    {
+        for (auto const& shaderProgram : shader_programs())
+            if (shaderProgram->active())
+                return true;
+        return false;
+    }
+
+    i_shader_program& software_renderer::active_shader_program()
+    {
+        for (auto const& shaderProgram : shader_programs())
+            if (shaderProgram->active())
+                return *shaderProgram;
+        throw no_shader_program_active();
+    }
+
+    const i_standard_shader_program& software_renderer::default_shader_program() const
+    {
+        throw no_default_shader_program();
+    }
+
+    i_standard_shader_program& software_renderer::default_shader_program()
+    {
+        throw no_default_shader_program();
+    }
+
+    software_renderer::handle software_renderer::create_shader_program_object()
+    {
+        throw failed_to_create_shader_program("Shader programs are not supported by the software renderer");
+    }
+
+    void software_renderer::destroy_shader_program_object(handle)
+    {
+    }
+
+    software_renderer::handle software_renderer::create_shader_object(shader_type)
+    {
+        throw failed_to_create_shader();
+    }
+
+    void software_renderer::destroy_shader_object(handle)
+    {
+    }
+
+    std::unique_ptr<i_native_window> software_renderer::create_window(i_surface_manager&, i_surface_window&, const video_mode&, const std::string&, window_style)
+    {
+        throw headless();
+    }
+
+    std::unique_ptr<i_native_window> software_renderer::create_window(i_surface_manager&, i_surface_window&, const size&, const std::string&, window_style)
+    {
+        throw headless();
+    }
+
+    std::unique_ptr<i_native_window> software_renderer::create_window(i_surface_manager&, i_surface_window&, const point&, const size&, const std::string&, window_style)
+    {
+        throw headless();
+    }
+
+    std::unique_ptr<i_native_window> software_renderer::create_window(i_surface_manager&, i_surface_window&, i_native_surface&, const video_mode&, const std::string&, window_style)
+    {
+        throw headless();
+    }
+
+    std::unique_ptr<i_native_window> software_renderer::create_window(i_surface_manager&, i_surface_window&, i_native_surface&, const size&, const std::string&, window_style)
+    {
+        throw headless();
+    }
+
+    std::unique_ptr<i_native_window> software_renderer::create_window(i_surface_manager&, i_surface_window&, i_native_surface&, const point&, const size&, const std::string&, window_style)
+    {
+        throw headless();
+    }
+
+    bool software_renderer::creating_window() const
+    {
+        return false;
+    }
+
+    i_font_manager& software_renderer::font_manager()
+    {
+        if (iFontManager == std::nullopt)
+            iFontManager.emplace();
+        return *iFontManager;
+    }
+
+    i_texture_manager& software_renderer::texture_manager()
+    {
+        if (iTextureManager == std::nullopt)
+            iTextureManager.emplace();
+        return *iTextureManager;
+    }
+
+    bool software_renderer::vertex_buffer_allocated(i_vertex_provider& aProvider) const
+    {
+        return iVertexBuffers.find(&aProvider) != iVertexBuffers.end();
+    }
+
+    i_vertex_buffer& software_renderer::allocate_vertex_buffer(i_vertex_provider& aProvider, vertex_buffer_type aType)
+    {
+        auto existing = iVertexBuffers.find(&aProvider);
+        if (existing == iVertexBuffers.end())
+            return iVertexBuffers.try_emplace(&aProvider, aProvider, aType).first->second;
+        else
+            throw consumer_exists();
+    }
+
+    void software_renderer::deallocate_vertex_buffer(i_vertex_provider& aProvider)
+    {
+        auto existing = iVertexBuffers.find(&aProvider);
+        if (existing != iVertexBuffers.end())
+            iVertexBuffers.erase(existing);
+        else
+            throw consumer_not_found();
+    }
+
+    const i_vertex_buffer& software_renderer::vertex_buffer(i_vertex_provider& aProvider) const
+    {
+        auto existing = iVertexBuffers.find(&aProvider);
+        if (existing != iVertexBuffers.end())
+            return existing->second;
+        throw consumer_not_found();
+    }
+
+    i_vertex_buffer& software_renderer::vertex_buffer(i_vertex_provider& aProvider)
+    {
+        return const_cast<i_vertex_buffer&>(to_const(*this).vertex_buffer(aProvider));
+    }
+
+    void software_renderer::execute_vertex_buffers()
+    {
+    }
+
+    uint32_t software_renderer::vertex_buffer_stall_count() const
+    {
+        return 0u;
+    }
+
+    void software_renderer::reset_vertex_buffer_stall_count()
+    {
+    }
+
+    i_texture& software_renderer::ping_pong_buffer1(const size& aExtents, texture_sampling aSampling, texture_data_type aDataType)
+    {
+        auto& bufferTexture = create_ping_pong_buffer(iPingPongBuffer1s, aExtents, aSampling, aDataType);
+        return bufferTexture;
+    }
+
+    i_texture& software_renderer::ping_pong_buffer2(const size& aExtents, texture_sampling aSampling, texture_data_type aDataType)
+    {
+        auto& bufferTexture = create_ping_pong_buffer(iPingPongBuffer2s, aExtents, aSampling, aDataType);
+        return bufferTexture;
+    }
+
+    bool software_renderer::is_subpixel_rendering_on() const
+    {
+        return iSubpixelRendering;
+    }
+
+    void software_renderer::subpixel_rendering_on()
+    {
+        if (!iSubpixelRendering)
+        {
+            iSubpixelRendering = true;
+            SubpixelRenderingChanged.trigger();
+        }
+    }
+
+    void software_renderer::subpixel_rendering_off()
+    {
+        if (iSubpixelRendering)
+        {
+            iSubpixelRendering = false;
+            SubpixelRenderingChanged.trigger();
+        }
+    }
+
+    void software_renderer::render_now()
+    {
+        service<i_surface_manager>().render_surfaces();
+    }
+
+    bool software_renderer::frame_rate_limited() const
+    {
+        return iLimitFrameRate && neolib::service<neolib::i_power>().green_mode_active();
+    }
+
+    void software_renderer::enable_frame_rate_limiter(bool aEnable)
+    {
+        iLimitFrameRate = aEnable;
+    }
+
+    uint32_t software_renderer::frame_rate_limit() const
+    {
+        return iFrameRateLimit;
+    }
+
+    void software_renderer::set_frame_rate_limit(uint32_t aFps)
+    {
+        iFrameRateLimit = aFps;
+    }
+
+    bool software_renderer::use_rendering_priority() const
+    {
+        return false;
+    }
+
+    bool software_renderer::process_events()
+    {
+        // no native surfaces so no native events
+        return false;
+    }
+
+    void software_renderer::register_frame_counter(i_widget& aWidget, uint32_t aDuration)
+    {
+        auto iterFrameCounter = iFrameCounters.find(aDuration);
+        if (iterFrameCounter == iFrameCounters.end())
+            iterFrameCounter = iFrameCounters.emplace(aDuration, aDuration).first;
+        iterFrameCounter->second.add(aWidget);
+    }
+
+    void software_renderer::unregister_frame_counter(i_widget& aWidget, uint32_t aDuration)
+    {
+        auto iterFrameCounter = iFrameCounters.find(aDuration);
+        if (iterFrameCounter != iFrameCounters.end())
+            iterFrameCounter->second.remove(aWidget);
+    }
+
+    uint32_t software_renderer::frame_counter(uint32_t aDuration) const
+    {
+        auto iterFrameCounter = iFrameCounters.find(aDuration);
+        if (iterFrameCounter != iFrameCounters.end())
+            return iterFrameCounter->second.counter();
+        return 0;
+    }
+
+    i_texture& software_renderer::create_ping_pong_buffer(ping_pong_buffers_t& aBufferList, const size& aExtents, texture_sampling aSampling, texture_data_type aDataType)
+    {
+        auto existing = aBufferList.lower_bound(std::make_tuple(aSampling, aDataType, aExtents));
+        if (existing != aBufferList.end() && std::get<0>(existing->first) == aSampling && std::get<1>(existing->first) == aDataType && std::get<2>(existing->first) >= aExtents)
+            return existing->second;
+        auto const sizeMultiple = 1024;
+        basic_size<int32_t> idealSize{ (((static_cast<int32_t>(aExtents.cx) - 1) / sizeMultiple) + 1) * sizeMultiple, (((static_cast<int32_t>(aExtents.cy) - 1) / sizeMultiple) + 1) * sizeMultiple };
+        return aBufferList.emplace(std::make_tuple(aSampling, aDataType, idealSize), texture{ idealSize, 1.0, aSampling, texture_data_format::RGBA, aDataType }).first->second;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,995 @@
+// software_rendering_context.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neolib/core/scoped.hpp>
+#include <neogfx/gfx/text/glyph.hpp>
+#include <neogfx/gfx/text/i_emoji_atlas.hpp>
+#include <neogfx/gfx/text/i_font_manager.hpp>
+#include <neogfx/gfx/text/i_glyph_texture.hpp>
+#include <neogfx/gfx/i_texture_manager.hpp>
+#include <neogfx/gfx/shapes.hpp>
+#include <neogfx/game/ecs_helpers.hpp>
+#include "software_texture.hpp"
+#include "software_rendering_context.hpp"
+
+namespace neogfx
+{
+    namespace
+    {
+        inline vertices line_loop_to_lines(const vertices& aLineLoop, bool aClosed = true)
+        {
+            vertices result;
+            result.reserve(aLineLoop.size() * 2);
+            for (auto v = aLineLoop.begin(); v != aLineLoop.end(); ++v)
+            {
+                result.push_back(*v);
+                if (v != aLineLoop.begin() && (aClosed || v != std::prev(aLineLoop.end())))
+                    result.push_back(*v);
+            }
+            if (aClosed)
+                result.push_back(*aLineLoop.begin());
+            return result;
+        }
+
+        const software_texture& to_software_texture(const i_render_target& aTarget)
+        {
+            auto const target = dynamic_cast<const software_texture*>(&aTarget.target_texture());
+            if (target == nullptr)
+                throw software_rendering_context::unsupported_render_target();
+            return *target;
+        }
+
+        // the affine map taking a triangle's device coordinates to its texel coordinates
+        std::optional<std::array<scalar, 6>> texel_map(const std::array<vec2, 3>& aDevice, const std::array<vec2, 3>& aTexel)
+        {
+            auto const& d = aDevice;
+            auto const determinant = (d[1].x - d[0].x) * (d[2].y - d[0].y) - (d[2].x - d[0].x) * (d[1].y - d[0].y);
+            if (std::abs(determinant) < 1.0e-12)
+                return {};
+            std::array<scalar, 6> result;
+            for (std::size_t c = 0; c < 2; ++c)
+            {
+                auto const f0 = aTexel[0][c];
+                auto const f1 = aTexel[1][c];
+                auto const f2 = aTexel[2][c];
+                auto const a = ((f1 - f0) * (d[2].y - d[0].y) - (f2 - f0) * (d[1].y - d[0].y)) / determinant;
+                auto const b = ((d[1].x - d[0].x) * (f2 - f0) - (d[2].x - d[0].x) * (f1 - f0)) / determinant;
+                result[c * 3 + 0] = a;
+                result[c * 3 + 1] = b;
+                result[c * 3 + 2] = f0 - a * d[0].x - b * d[0].y;
+            }
+            return result;
+        }
+
+        bool same_texel_map(const std::array<scalar, 6>& aLeft, const std::array<scalar, 6>& aRight)
+        {
+            for (std::size_t i = 0; i < aLeft.size(); ++i)
+                if (std::abs(aLeft[i] - aRight[i]) > 1.0e-6 * std::max(1.0, std::abs(aLeft[i])))
+                    return false;
+            return true;
+        }
+    }
+
+    software_rendering_context::software_rendering_context(const i_render_target& aTarget, neogfx::blending_mode aBlendingMode) :
+        iRenderingEngine{ service<i_rendering_engine>() },
+        iTarget{ aTarget },
+        iRasterizer{ to_software_texture(aTarget) },
+        iOpacity{ 1.0 },
+        iBlendingMode{ aBlendingMode },
+        iSubpixelRendering{ rendering_engine().is_subpixel_rendering_on() },
+        iSrt{ iTarget },
+        iSnapToPixel{ false }
+    {
+        iSink += render_target().target_deactivating([this]()
+        {
+            flush();
+        });
+    }
+
+    software_rendering_context::software_rendering_context(const software_rendering_context& aOther) :
+        iRenderingEngine{ aOther.iRenderingEngine },
+        iTarget{ aOther.iTarget },
+        iRasterizer{ aOther.iRasterizer.target() },
+        iLogicalCoordinateSystem{ aOther.iLogicalCoordinateSystem },
+        iLogicalCoordinates{ aOther.iLogicalCoordinates },
+        iOpacity{ 1.0 },
+        iBlendingMode{ aOther.iBlendingMode },
+        iSubpixelRendering{ aOther.iSubpixelRendering },
+        iSrt{ iTarget },
+        iSnapToPixel{ false }
+    {
+        iSink += render_target().target_deactivating([this]()
+        {
+            flush();
+        });
+    }
+
+    software_rendering_context::~software_rendering_context()
+    {
+    }
+
+    template <typename ColorOrGradient>
+    software_rasterizer::paint software_rendering_context::to_paint(const ColorOrGradient& aFill, const rect& aBoundingBox) const
+    {
+        // a gradient fill takes precedence over a gradient set on the context which takes precedence over a color fill
+        if (std::holds_alternative<gradient>(aFill))
+            return to_paint(static_variant_cast<const gradient&>(aFill), aBoundingBox);
+        if (iGradient)
+            return to_paint(iGradient->first, iGradient->second);
+        if (std::holds_alternative<color>(aFill))
+            return to_paint(static_variant_cast<const color&>(aFill));
+        return software_rasterizer::paint{};
+    }
+
+    std::unique_ptr<i_rendering_context> software_rendering_context::clone() const
+    {
+        return std::unique_ptr<i_rendering_context>(new software_rendering_context(*this));
+    }
+
+    i_rendering_engine& software_rendering_context::rendering_engine()
+    {
+        return iRenderingEngine;
+    }
+
+    const i_render_target& software_rendering_context::render_target() const
+    {
+        return iTarget;
+    }
+
+    const i_render_target& software_rendering_context::render_target()
+    {
+        return iTarget;
+    }
+
+    rect software_rendering_context::rendering_area(bool aConsiderScissor) const
+    {
+        if (scissor_rect() == std::nullopt || !aConsiderScissor)
+            return rect{ point{}, render_target().target_extents() };
+        else
+            return *scissor_rect();
+    }
+
+    const graphics_operation::queue& software_rendering_context::queue() const
+    {
+        thread_local graphics_operation::queue tQueue;
+        return tQueue;
+    }
+
+    graphics_operation::queue& software_rendering_context::queue()
+    {
+        return const_cast<graphics_operation::queue&>(to_const(*this).queue());
+    }
+
+    void software_rendering_context::enqueue(const graphics_operation::operation& aOperation)
+    {
+        scoped_render_target srt{ render_target() };
+
+        queue().push_back(aOperation);
+    }
+
+    void software_rendering_context::flush()
+    {
+        if (queue().empty())
+            return;
+
+        for (auto batchStart = queue().begin(); batchStart != queue().end();)
+        {
+            auto batchEnd = std::next(batchStart);
+            while (batchEnd != queue().end() && graphics_operation::batchable(*batchStart, *batchEnd))
+                ++batchEnd;
+            graphics_operation::batch const opBatch{ &*batchStart, &*batchStart + (batchEnd - batchStart) };
+            batchStart = batchEnd;
+            switch (opBatch.first->index())
+            {
+            case graphics_operation::operation_type::SetLogicalCoordinateSystem:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    set_logical_coordinate_system(static_variant_cast<const graphics_operation::set_logical_coordinate_system&>(*op).system);
+                break;
+            case graphics_operation::operation_type::SetLogicalCoordinates:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    set_logical_coordinates(static_variant_cast<const graphics_operation::set_logical_coordinates&>(*op).coordinates);
+                break;
+            case graphics_operation::operation_type::ScissorOn:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    scissor_on(static_variant_cast<const graphics_operation::scissor_on&>(*op).rect);
+                break;
+            case graphics_operation::operation_type::ScissorOff:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    (void)op;
+                    scissor_off();
+                }
+                break;
+            case graphics_operation::operation_type::SnapToPixelOn:
+                set_snap_to_pixel(true);
+                break;
+            case graphics_operation::operation_type::SnapToPixelOff:
+                set_snap_to_pixel(false);
+                break;
+            case graphics_operation::operation_type::SetOpacity:
+                set_opacity(static_variant_cast<const graphics_operation::set_opacity&>(*(std::prev(opBatch.second))).opacity);
+                break;
+            case graphics_operation::operation_type::SetBlendingMode:
+                set_blending_mode(static_variant_cast<const graphics_operation::set_blending_mode&>(*(std::prev(opBatch.second))).blendingMode);
+                break;
+            case graphics_operation::operation_type::SetSmoothingMode:
+            case graphics_operation::operation_type::LineStippleOn:
+            case graphics_operation::operation_type::LineStippleOff:
+            case graphics_operation::operation_type::PushLogicalOperation:
+            case graphics_operation::operation_type::PopLogicalOperation:
+                // edges are always antialiased by coverage; stipples and logical operations are not supported
+                break;
+            case graphics_operation::operation_type::SubpixelRenderingOn:
+                subpixel_rendering_on();
+                break;
+            case graphics_operation::operation_type::SubpixelRenderingOff:
+                subpixel_rendering_off();
+                break;
+            case graphics_operation::operation_type::Clear:
+                clear(static_variant_cast<const graphics_operation::clear&>(*(std::prev(opBatch.second))).color);
+                break;
+            case graphics_operation::operation_type::ClearDepthBuffer:
+            case graphics_operation::operation_type::ClearStencilBuffer:
+                // there are no depth or stencil buffers
+                break;
+            case graphics_operation::operation_type::SetGradient:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    set_gradient(static_variant_cast<const graphics_operation::set_gradient&>(*op).gradient, static_variant_cast<const graphics_operation::set_gradient&>(*op).boundingBox);
+                break;
+            case graphics_operation::operation_type::ClearGradient:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    clear_gradient();
+                break;
+            case graphics_operation::operation_type::SetPixel:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    set_pixel(static_variant_cast<const graphics_operation::set_pixel&>(*op).point, static_variant_cast<const graphics_operation::set_pixel&>(*op).color);
+                break;
+            case graphics_operation::operation_type::DrawPixel:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    draw_pixel(static_variant_cast<const graphics_operation::draw_pixel&>(*op).point, static_variant_cast<const graphics_operation::draw_pixel&>(*op).color);
+                break;
+            case graphics_operation::operation_type::DrawLine:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_line&>(*op);
+                    draw_line(args.from, args.to, args.pen);
+                }
+                break;
+            case graphics_operation::operation_type::DrawRect:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_rect&>(*op);
+                    draw_rect(args.rect, args.pen);
+                }
+                break;
+            case graphics_operation::operation_type::DrawRoundedRect:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_rounded_rect&>(*op);
+                    draw_rounded_rect(args.rect, args.radius, args.pen);
+                }
+                break;
+            case graphics_operation::operation_type::DrawCircle:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_circle&>(*op);
+                    draw_circle(args.center, args.radius, args.pen, args.startAngle);
+                }
+                break;
+            case graphics_operation::operation_type::DrawArc:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_arc&>(*op);
+                    draw_arc(args.center, args.radius, args.startAngle, args.endAngle, args.pen);
+                }
+                break;
+            case graphics_operation::operation_type::DrawPath:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_path&>(*op);
+                    draw_path(args.path, args.pen);
+                }
+                break;
+            case graphics_operation::operation_type::DrawShape:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_shape&>(*op);
+                    draw_shape(args.mesh, args.position, args.pen);
+                }
+                break;
+            case graphics_operation::operation_type::DrawEntities:
+                // todo: render ECS entities (game worlds need the OpenGL renderer for now)
+                break;
+            case graphics_operation::operation_type::FillRect:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::fill_rect&>(*op);
+                    fill_rect(args.rect, args.fill);
+                }
+                break;
+            case graphics_operation::operation_type::FillRoundedRect:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::fill_rounded_rect&>(*op);
+                    fill_rounded_rect(args.rect, args.radius, args.fill);
+                }
+                break;
+            case graphics_operation::operation_type::FillCircle:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::fill_circle&>(*op);
+                    fill_circle(args.center, args.radius, args.fill);
+                }
+                break;
+            case graphics_operation::operation_type::FillArc:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::fill_arc&>(*op);
+                    fill_arc(args.center, args.radius, args.startAngle, args.endAngle, args.fill);
+                }
+                break;
+            case graphics_operation::operation_type::FillPath:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                    fill_path(static_variant_cast<const graphics_operation::fill_path&>(*op).path, static_variant_cast<const graphics_operation::fill_path&>(*op).fill);
+                break;
+            case graphics_operation::operation_type::FillShape:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::fill_shape&>(*op);
+                    fill_shape(args.mesh, args.position, args.fill);
+                }
+                break;
+            case graphics_operation::operation_type::DrawGlyph:
+                draw_glyph(opBatch);
+                break;
+            case graphics_operation::operation_type::DrawMesh:
+                for (auto op = opBatch.first; op != opBatch.second; ++op)
+                {
+                    auto const& args = static_variant_cast<const graphics_operation::draw_mesh&>(*op);
+                    draw_mesh(args.mesh, args.material, args.transformation);
+                }
+                break;
+            }
+        }
+        queue().clear();
+    }
+
+    neogfx::logical_coordinate_system software_rendering_context::logical_coordinate_system() const
+    {
+        if (iLogicalCoordinateSystem != std::nullopt)
+            return *iLogicalCoordinateSystem;
+        return render_target().logical_coordinate_system();
+    }
+
+    void software_rendering_context::set_logical_coordinate_system(neogfx::logical_coordinate_system aSystem)
+    {
+        iLogicalCoordinateSystem = aSystem;
+    }
+
+    logical_coordinates software_rendering_context::logical_coordinates() const
+    {
+        if (iLogicalCoordinates != std::nullopt)
+            return *iLogicalCoordinates;
+        auto result = render_target().logical_coordinates();
+        if (logical_coordinate_system() != render_target().logical_coordinate_system())
+        {
+            switch (logical_coordinate_system())
+            {
+            case neogfx::logical_coordinate_system::Specified:
+                break;
+            case neogfx::logical_coordinate_system::AutomaticGame:
+                if (render_target().logical_coordinate_system() == neogfx::logical_coordinate_system::AutomaticGui)
+                    std::swap(result.bottomLeft.y, result.topRight.y);
+                break;
+            case neogfx::logical_coordinate_system::AutomaticGui:
+                std::swap(result.bottomLeft.y, result.topRight.y);
+                break;
+            }
+        }
+        return result;
+    }
+
+    void software_rendering_context::set_logical_coordinates(const neogfx::logical_coordinates& aCoordinates)
+    {
+        iLogicalCoordinates = aCoordinates;
+    }
+
+    vec2 software_rendering_context::offset() const
+    {
+        return (iOffset != std::nullopt ? *iOffset : vec2{}) + (snap_to_pixel() ? 0.5 : 0.0);
+    }
+
+    void software_rendering_context::set_offset(const optional_vec2& aOffset)
+    {
+        iOffset = aOffset;
+    }
+
+    bool software_rendering_context::gradient_set() const
+    {
+        return !!iGradient;
+    }
+
+    void software_rendering_context::apply_gradient(i_gradient_shader&)
+    {
+        // there are no shaders; gradients are applied when shapes are painted (see to_paint)
+    }
+
+    bool software_rendering_context::snap_to_pixel() const
+    {
+        return iSnapToPixel;
+    }
+
+    void software_rendering_context::set_snap_to_pixel(bool aSnapToPixel)
+    {
+        iSnapToPixel = aSnapToPixel;
+    }
+
+    void software_rendering_context::scissor_on(const rect& aRect)
+    {
+        iScissorRects.push_back(aRect);
+        iScissorRect = std::nullopt;
+    }
+
+    void software_rendering_context::scissor_off()
+    {
+        if (!iScissorRects.empty())
+            iScissorRects.pop_back();
+        iScissorRect = std::nullopt;
+    }
+
+    const optional_rect& software_rendering_context::scissor_rect() const
+    {
+        if (iScissorRect == std::nullopt && !iScissorRects.empty())
+        {
+            for (auto const& rect : iScissorRects)
+                if (iScissorRect != std::nullopt)
+                    iScissorRect = iScissorRect->intersection(rect);
+                else
+                    iScissorRect = rect;
+        }
+        return iScissorRect;
+    }
+
+    void software_rendering_context::set_opacity(double aOpacity)
+    {
+        iOpacity = aOpacity;
+    }
+
+    neogfx::blending_mode software_rendering_context::blending_mode() const
+    {
+        return iBlendingMode;
+    }
+
+    void software_rendering_context::set_blending_mode(neogfx::blending_mode aBlendingMode)
+    {
+        iBlendingMode = aBlendingMode;
+    }
+
+    void software_rendering_context::set_gradient(const gradient& aGradient, const rect& aBoundingBox)
+    {
+        iGradient = std::make_pair(aGradient, aBoundingBox);
+    }
+
+    void software_rendering_context::clear_gradient()
+    {
+        iGradient = std::nullopt;
+    }
+
+    bool software_rendering_context::is_subpixel_rendering_on() const
+    {
+        return iSubpixelRendering;
+    }
+
+    void software_rendering_context::subpixel_rendering_on()
+    {
+        iSubpixelRendering = true;
+    }
+
+    void software_rendering_context::subpixel_rendering_off()
+    {
+        iSubpixelRendering = false;
+    }
+
+    void software_rendering_context::clear(const color& aColor)
+    {
+        iRasterizer.clear(current_clip(), aColor);
+    }
+
+    void software_rendering_context::set_pixel(const point& aPoint, const color& aColor)
+    {
+        draw_pixel(aPoint, aColor.with_alpha(1.0));
+    }
+
+    void software_rendering_context::draw_pixel(const point& aPoint, const color& aColor)
+    {
+        fill_rect(rect{ aPoint, size{1.0, 1.0} }, aColor);
+    }
+
+    void software_rendering_context::draw_line(const point& aFrom, const point& aTo, const pen& aPen)
+    {
+        auto v1 = aFrom.to_vec3();
+        auto v2 = aTo.to_vec3();
+        if (snap_to_pixel() && static_cast<int32_t>(aPen.width()) % 2 == 0)
+        {
+            v1 -= vec3{ 0.5, 0.5, 0.0 };
+            v2 -= vec3{ 0.5, 0.5, 0.0 };
+        }
+
+        stroke(vertices{ v1, v2 }, aPen.width(), to_paint(aPen.color(), rect{ aFrom, aTo }));
+    }
+
+    void software_rendering_context::draw_rect(const rect& aRect, const pen& aPen)
+    {
+        auto adjustedRect = aRect;
+        if (snap_to_pixel())
+        {
+            adjustedRect.position() -= size{ static_cast<int32_t>(aPen.width()) % 2 == 1 ? 0.0 : 0.5 };
+            adjustedRect = adjustedRect.with_epsilon(size{ 1.0, 1.0 });
+        }
+
+        vec3_array<8> lines = rect_vertices(adjustedRect, mesh_type::Outline, 0.0);
+        lines[1].x -= (aPen.width() + rect::default_epsilon);
+        lines[3].y -= (aPen.width() + rect::default_epsilon);
+        lines[5].x += (aPen.width() + rect::default_epsilon);
+        lines[7].y += (aPen.width() + rect::default_epsilon);
+
+        stroke(vertices{ lines.begin(), lines.end() }, aPen.width(), to_paint(aPen.color(), aRect));
+    }
+
+    void software_rendering_context::draw_rounded_rect(const rect& aRect, dimension aRadius, const pen& aPen)
+    {
+        auto adjustedRect = aRect;
+        if (snap_to_pixel())
+        {
+            adjustedRect.position() -= size{ static_cast<int32_t>(aPen.width()) % 2 == 1 ? 0.0 : 0.5 };
+            adjustedRect = adjustedRect.with_epsilon(size{ 1.0, 1.0 });
+        }
+
+        stroke(line_loop_to_lines(rounded_rect_vertices(adjustedRect, aRadius, mesh_type::Outline)), aPen.width(), to_paint(aPen.color(), aRect));
+    }
+
+    void software_rendering_context::draw_circle(const point& aCenter, dimension aRadius, const pen& aPen, angle aStartAngle)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        stroke(line_loop_to_lines(circle_vertices(aCenter, aRadius, aStartAngle, mesh_type::Outline)), aPen.width(),
+            to_paint(aPen.color(), rect{ aCenter - size{ aRadius, aRadius }, size{ aRadius * 2.0, aRadius * 2.0 } }));
+    }
+
+    void software_rendering_context::draw_arc(const point& aCenter, dimension aRadius, angle aStartAngle, angle aEndAngle, const pen& aPen)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        stroke(line_loop_to_lines(arc_vertices(aCenter, aRadius, aStartAngle, aEndAngle, aCenter, mesh_type::Outline), false), aPen.width(),
+            to_paint(aPen.color(), rect{ aCenter - size{ aRadius, aRadius }, size{ aRadius * 2.0, aRadius * 2.0 } }));
+    }
+
+    void software_rendering_context::draw_path(const path& aPath, const pen& aPen)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        auto const paint = to_paint(aPen.color(), aPath.bounding_rect());
+        for (auto const& subPath : aPath.sub_paths())
+        {
+            if (subPath.size() > 2)
+            {
+                auto const vertices = aPath.to_vertices(subPath);
+                switch (aPath.shape())
+                {
+                case path_shape::Quads:
+                    for (std::size_t v = 0; v + 3 < vertices.size(); v += 4)
+                        fill(neogfx::vertices{ vertices.begin() + v, vertices.begin() + v + 4 }, paint);
+                    break;
+                case path_shape::Lines:
+                    stroke(vertices, aPen.width(), paint);
+                    break;
+                case path_shape::LineLoop:
+                    stroke(line_loop_to_lines(vertices), aPen.width(), paint);
+                    break;
+                case path_shape::LineStrip:
+                    stroke(line_loop_to_lines(vertices, false), aPen.width(), paint);
+                    break;
+                case path_shape::ConvexPolygon:
+                    fill(vertices, paint);
+                    break;
+                default:
+                    for (auto const& v : vertices)
+                    {
+                        auto const topLeft = to_device(v);
+                        iRasterizer.fill_rect(current_clip(), { topLeft.x, topLeft.y, topLeft.x + 1.0, topLeft.y + 1.0 }, paint, blending_mode());
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void software_rendering_context::draw_shape(const game::mesh& aMesh, const vec3& aPosition, const pen& aPen)
+    {
+        auto lines = line_loop_to_lines(aMesh.vertices);
+        for (auto& v : lines)
+            v += aPosition;
+        stroke(lines, aPen.width(), to_paint(aPen.color(), bounding_rect(aMesh)));
+    }
+
+    void software_rendering_context::fill_rect(const rect& aRect, const brush& aFill)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        auto const topLeft = to_device(aRect.top_left().to_vec3());
+        auto const bottomRight = to_device(aRect.bottom_right().to_vec3());
+        iRasterizer.fill_rect(current_clip(), { topLeft.x, topLeft.y, bottomRight.x, bottomRight.y }, to_paint(aFill, aRect), blending_mode());
+    }
+
+    void software_rendering_context::fill_rounded_rect(const rect& aRect, dimension aRadius, const brush& aFill)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        if (aRect.empty())
+            return;
+
+        fill(rounded_rect_vertices(aRect, aRadius, mesh_type::TriangleFan), to_paint(aFill, aRect));
+    }
+
+    void software_rendering_context::fill_circle(const point& aCenter, dimension aRadius, const brush& aFill)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        fill(circle_vertices(aCenter, aRadius, 0.0, mesh_type::TriangleFan),
+            to_paint(aFill, rect{ aCenter - point{ aRadius, aRadius }, size{ aRadius * 2.0 } }));
+    }
+
+    void software_rendering_context::fill_arc(const point& aCenter, dimension aRadius, angle aStartAngle, angle aEndAngle, const brush& aFill)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        fill(arc_vertices(aCenter, aRadius, aStartAngle, aEndAngle, aCenter, mesh_type::TriangleFan),
+            to_paint(aFill, rect{ aCenter - point{ aRadius, aRadius }, size{ aRadius * 2.0 } }));
+    }
+
+    void software_rendering_context::fill_path(const path& aPath, const brush& aFill)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        auto const paint = to_paint(aFill, aPath.bounding_rect());
+        for (auto const& subPath : aPath.sub_paths())
+        {
+            if (subPath.size() > 2)
+            {
+                auto const vertices = aPath.to_vertices(subPath);
+                if (aPath.shape() == path_shape::Quads)
+                {
+                    for (std::size_t v = 0; v + 3 < vertices.size(); v += 4)
+                        fill(neogfx::vertices{ vertices.begin() + v, vertices.begin() + v + 4 }, paint);
+                }
+                else
+                    fill(vertices, paint);
+            }
+        }
+    }
+
+    void software_rendering_context::fill_shape(const game::mesh& aMesh, const vec3& aPosition, const brush& aFill)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        if (aMesh.vertices.empty())
+            return;
+
+        vec3 min = aMesh.vertices[0] + aPosition;
+        vec3 max = min;
+        for (auto const& v : aMesh.vertices)
+        {
+            min.x = std::min(min.x, v.x + aPosition.x);
+            max.x = std::max(max.x, v.x + aPosition.x);
+            min.y = std::min(min.y, v.y + aPosition.y);
+            max.y = std::max(max.y, v.y + aPosition.y);
+        }
+
+        // the faces are filled together so that edges shared by faces are not blended twice
+        software_rasterizer::contours triangles;
+        for (auto const& face : aMesh.faces)
+        {
+            triangles.emplace_back();
+            for (auto vi : face)
+                triangles.back().push_back(to_device(aMesh.vertices[vi] + aPosition));
+            if (!software_rasterizer::orient(triangles.back()))
+                triangles.pop_back();
+        }
+        iRasterizer.fill(current_clip(), triangles, to_paint(aFill, rect{ point{ min.x, min.y }, size{ max.x - min.x, max.y - min.y } }), blending_mode());
+    }
+
+    void software_rendering_context::draw_glyph(const graphics_operation::batch& aDrawGlyphOps)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        auto const gui = logical_coordinates().is_gui_orientation();
+        auto const to_mesh = [gui](const rect& aRect, scalar aZpos)
+        {
+            return gui ? to_ecs_component(aRect, mesh_type::Triangles, aZpos) : to_ecs_component(game_rect{ aRect }, mesh_type::Triangles, aZpos);
+        };
+
+        // passes as for the OpenGL renderer: paper and emoji, then special effects, then the glyphs themselves
+        for (auto op = aDrawGlyphOps.first; op != aDrawGlyphOps.second; ++op)
+        {
+            auto const& drawOp = static_variant_cast<const graphics_operation::draw_glyph&>(*op);
+            font const& glyphFont = drawOp.glyph.font();
+            rect const glyphRect{ point{ drawOp.point }, size{ drawOp.glyph.advance().cx, glyphFont.height() } };
+            if (drawOp.appearance.paper() != std::nullopt)
+                fill_rect(glyphRect, std::holds_alternative<color>(*drawOp.appearance.paper()) ?
+                    brush{ std::get<color>(*drawOp.appearance.paper()) } : brush{ std::get<gradient>(*drawOp.appearance.paper()) });
+            if (drawOp.glyph.is_emoji())
+            {
+                auto const& emojiAtlas = rendering_engine().font_manager().emoji_atlas();
+                auto const& emojiTexture = emojiAtlas.emoji_texture(drawOp.glyph.value()).as_sub_texture();
+                draw_mesh(to_mesh(glyphRect, drawOp.point.z), game::material{ {}, {}, {}, to_ecs_component(emojiTexture) }, mat44::identity());
+            }
+        }
+
+        for (int32_t pass = 2; pass <= 3; ++pass)
+        {
+            for (auto op = aDrawGlyphOps.first; op != aDrawGlyphOps.second; ++op)
+            {
+                auto const& drawOp = static_variant_cast<const graphics_operation::draw_glyph&>(*op);
+
+                if (drawOp.glyph.is_whitespace() || drawOp.glyph.is_emoji())
+                    continue;
+
+                if (!drawOp.glyph.glyph_texture_ready())
+                    continue;
+
+                auto const& appearance = drawOp.appearance;
+                bool const renderEffects = !appearance.only_calculate_effect() && appearance.effect() &&
+                    (appearance.effect()->type() == text_effect_type::Outline ||
+                        (appearance.effect()->type() == text_effect_type::Glow && appearance.effect()->width() <= GlyphDistanceFieldSpread));
+                if (!renderEffects && pass == 2)
+                    continue;
+
+                auto const& glyphTexture = drawOp.glyph.glyph_texture();
+                auto const& glyphFont = drawOp.glyph.font();
+                auto const glyph_origin = [&](const i_glyph_texture& aTexture)
+                {
+                    return vec3{
+                        drawOp.point.x + aTexture.placement().x,
+                        logical_coordinates().is_game_orientation() ?
+                            drawOp.point.y + (aTexture.placement().y + -glyphFont.descender()) :
+                            drawOp.point.y + glyphFont.height() - (aTexture.placement().y + -glyphFont.descender()) - aTexture.texture().extents().cy,
+                        drawOp.point.z };
+                };
+                auto const draw_quad = [&](const rect& aOutputRect, const i_texture& aTexture, const text_color& aColor,
+                    software_rasterizer::coverage_source aSource, scalar aEffectWidth)
+                {
+                    draw_mesh(to_mesh(aOutputRect, drawOp.point.z), game::material{ {}, {}, {}, to_ecs_component(aTexture), shader_effect::Ignore },
+                        mat44::identity(), to_paint(aColor, aOutputRect), aSource, aEffectWidth);
+                };
+
+                if (pass == 2)
+                {
+                    auto const effectWidth = appearance.effect()->width();
+                    if (effectWidth > 0.0 && effectWidth <= GlyphDistanceFieldSpread)
+                    {
+                        // outlines and glows no wider than the distance field spread are rendered with one distance field quad per glyph
+                        auto const& distanceField = drawOp.glyph.glyph_distance_field();
+                        draw_quad(rect{ point{ glyph_origin(distanceField) }, distanceField.texture().extents() }, distanceField.texture(), appearance.effect()->color(),
+                            appearance.effect()->type() == text_effect_type::Outline ?
+                                software_rasterizer::coverage_source::DistanceFieldOutline : software_rasterizer::coverage_source::DistanceFieldGlow,
+                            effectWidth);
+                    }
+                    else
+                    {
+                        auto const scanlineOffsets = static_cast<uint32_t>(effectWidth) * 2u + 1u;
+                        auto const offsets = scanlineOffsets * scanlineOffsets;
+                        point const offsetOrigin{ -effectWidth, -effectWidth };
+                        for (uint32_t offset = 0; offset < offsets; ++offset)
+                            draw_quad(rect{ point{ glyph_origin(glyphTexture) } + offsetOrigin +
+                                point{ static_cast<coordinate>(offset % scanlineOffsets), static_cast<coordinate>(offset / scanlineOffsets) }, glyphTexture.texture().extents() },
+                                glyphTexture.texture(), appearance.effect()->color(), software_rasterizer::coverage_source::Glyph, 0.0);
+                    }
+                }
+                else
+                    draw_quad(rect{ point{ glyph_origin(glyphTexture) }, glyphTexture.texture().extents() }, glyphTexture.texture(), appearance.ink(),
+                        software_rasterizer::coverage_source::Glyph, 0.0);
+            }
+        }
+    }
+
+    void software_rendering_context::draw_mesh(const game::mesh& aMesh, const game::material& aMaterial, const mat44& aTransformation)
+    {
+        software_rasterizer::paint paint{};
+        if (iGradient)
+            paint = to_paint(iGradient->first, iGradient->second);
+        else if (aMaterial.color != std::nullopt)
+        {
+            auto const rgba = aMaterial.color->rgba.as<float>();
+            paint.color = { rgba[0], rgba[1], rgba[2], rgba[3] * static_cast<float>(iOpacity) };
+        }
+        else
+            paint.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+        draw_mesh(aMesh, aMaterial, aTransformation, paint, software_rasterizer::coverage_source::Texture);
+    }
+
+    void software_rendering_context::draw_mesh(const game::mesh& aMesh, const game::material& aMaterial, const mat44& aTransformation, const software_rasterizer::paint& aPaint,
+        software_rasterizer::coverage_source aSource, scalar aEffectWidth)
+    {
+        neolib::scoped_flag snap{ iSnapToPixel, false };
+
+        thread_local std::vector<vec2> deviceVertices;
+        deviceVertices.clear();
+        for (auto const& v : aMesh.vertices)
+            deviceVertices.push_back(to_device(aTransformation * v));
+
+        auto const clip = current_clip();
+        thread_local software_rasterizer::contours triangles;
+        triangles.clear();
+
+        game::texture const* materialTexture = (aMaterial.texture != std::nullopt ? &*aMaterial.texture :
+            aMaterial.sharedTexture != std::nullopt ? &*aMaterial.sharedTexture->ptr : nullptr);
+        if (materialTexture == nullptr)
+        {
+            for (auto const& face : aMesh.faces)
+            {
+                triangles.push_back({ deviceVertices[face[0]], deviceVertices[face[1]], deviceVertices[face[2]] });
+                if (!software_rasterizer::orient(triangles.back()))
+                    triangles.pop_back();
+            }
+            iRasterizer.fill(clip, triangles, aPaint, blending_mode());
+            return;
+        }
+
+        // texture coordinates are mapped to storage texels exactly as the OpenGL renderer maps them (see draw_meshes)
+        auto const& texture = *service<i_texture_manager>().find_texture(materialTexture->id.cookie());
+        auto const nativeTexture = std::dynamic_pointer_cast<software_texture>(texture.native_texture());
+        if (!nativeTexture)
+            throw texture_not_resident();
+        vec2 const uvFixupCoefficient = materialTexture->extents;
+        vec2 uvFixupOffset;
+        if (materialTexture->type == texture_type::Texture)
+            uvFixupOffset = vec2{ 1.0, 1.0 };
+        else if (materialTexture->subTexture == std::nullopt)
+            uvFixupOffset = texture.as_sub_texture().atlas_location().top_left().to_vec2() + vec2{ 1.0, 1.0 };
+        else
+            uvFixupOffset = materialTexture->subTexture->min + vec2{ 1.0, 1.0 };
+
+        auto sampling = (materialTexture->sampling != std::nullopt ? *materialTexture->sampling : texture.sampling());
+        if (sampling == texture_sampling::Scaled)
+        {
+            auto const extents = size_u32{ texture.extents() };
+            auto const outputRect = bounding_rect(aMesh.vertices, aTransformation);
+            if (extents / 2u * 2u == extents && (outputRect.cx > extents.cx || outputRect.cy > extents.cy))
+                sampling = texture_sampling::Nearest;
+            else
+                sampling = texture_sampling::Normal;
+        }
+
+        auto paint = aPaint;
+        paint.texture = software_rasterizer::sampler{
+            &*nativeTexture,
+            sampling == texture_sampling::Nearest || sampling == texture_sampling::Data,
+            aSource,
+            aMaterial.shaderEffect != std::nullopt ? *aMaterial.shaderEffect : shader_effect::None,
+            aEffectWidth };
+
+        // faces sharing a texture mapping (the two triangles of a quad) are filled together so their shared edge is not blended twice
+        for (auto const& face : aMesh.faces)
+        {
+            std::array<vec2, 3> const device = { deviceVertices[face[0]], deviceVertices[face[1]], deviceVertices[face[2]] };
+            std::array<vec2, 3> const texel = {
+                aMesh.uv[face[0]].scale(uvFixupCoefficient) + uvFixupOffset,
+                aMesh.uv[face[1]].scale(uvFixupCoefficient) + uvFixupOffset,
+                aMesh.uv[face[2]].scale(uvFixupCoefficient) + uvFixupOffset };
+            auto const toTexel = texel_map(device, texel);
+            if (toTexel == std::nullopt)
+                continue;
+            if (!triangles.empty() && !same_texel_map(paint.texture->toTexel, *toTexel))
+            {
+                iRasterizer.fill(clip, triangles, paint, blending_mode());
+                triangles.clear();
+            }
+            paint.texture->toTexel = *toTexel;
+            triangles.push_back({ device.begin(), device.end() });
+            software_rasterizer::orient(triangles.back());
+        }
+        if (!triangles.empty())
+            iRasterizer.fill(clip, triangles, paint, blending_mode());
+    }
+
+    subpixel_format software_rendering_context::subpixel_format() const
+    {
+        // render targets are textures
+        return neogfx::subpixel_format::None;
+    }
+
+    vec2 software_rendering_context::to_device(const vec3& aPoint) const
+    {
+        // the projection the OpenGL renderer's vertex shader applies, with device rows running top to bottom
+        auto const logicalCoordinates = logical_coordinates();
+        auto const extents = render_target().target_extents();
+        auto const position = aPoint.xy + offset();
+        return vec2{
+            (position.x - logicalCoordinates.bottomLeft.x) * extents.cx / (logicalCoordinates.topRight.x - logicalCoordinates.bottomLeft.x),
+            (position.y - logicalCoordinates.topRight.y) * extents.cy / (logicalCoordinates.bottomLeft.y - logicalCoordinates.topRight.y) };
+    }
+
+    software_rasterizer::clip software_rendering_context::current_clip() const
+    {
+        auto const extents = basic_size<int32_t>{ render_target().target_extents() };
+        software_rasterizer::clip result{ 0, 0, extents.cx, extents.cy };
+        auto const sr = scissor_rect();
+        if (sr != std::nullopt)
+        {
+            // the scissor box as opengl_rendering_context::apply_scissor sets it, converted from rows counted from the bottom
+            auto const x = static_cast<int32_t>(std::ceil(sr->x));
+            auto const y = static_cast<int32_t>(logical_coordinates().is_gui_orientation() ? std::ceil(extents.cy - sr->cy - sr->y) : sr->y);
+            auto const cx = static_cast<int32_t>(std::ceil(sr->cx));
+            auto const cy = static_cast<int32_t>(std::ceil(sr->cy));
+            result.left = std::max(result.left, x);
+            result.right = std::min(result.right, x + cx);
+            result.top = std::max(result.top, extents.cy - (y + cy));
+            result.bottom = std::min(result.bottom, extents.cy - y);
+        }
+        return result;
+    }
+
+    software_rasterizer::paint software_rendering_context::to_paint(const color& aColor) const
+    {
+        software_rasterizer::paint result{};
+        result.color = { aColor.red<float>(), aColor.green<float>(), aColor.blue<float>(), aColor.alpha<float>() * static_cast<float>(iOpacity) };
+        return result;
+    }
+
+    software_rasterizer::paint software_rendering_context::to_paint(const gradient& aGradient, const rect& aBoundingBox) const
+    {
+        software_rasterizer::paint result{};
+        result.gradientLut.reserve(software_rasterizer::GradientLutSize);
+        for (std::size_t i = 0; i < software_rasterizer::GradientLutSize; ++i)
+        {
+            auto const c = aGradient.at(static_cast<scalar>(i) / (software_rasterizer::GradientLutSize - 1));
+            result.gradientLut.push_back({ c.red<float>(), c.green<float>(), c.blue<float>(), c.alpha<float>() });
+        }
+        result.direction = aGradient.direction();
+        auto const topLeft = to_device(aBoundingBox.top_left().to_vec3());
+        auto const bottomRight = to_device(aBoundingBox.bottom_right().to_vec3());
+        result.boundingBox = {
+            std::min(topLeft.x, bottomRight.x), std::min(topLeft.y, bottomRight.y),
+            std::max(topLeft.x, bottomRight.x), std::max(topLeft.y, bottomRight.y) };
+        return result;
+    }
+
+    void software_rendering_context::fill(const vertices& aOutline, const software_rasterizer::paint& aPaint)
+    {
+        software_rasterizer::contours outline{ 1 };
+        for (auto const& v : aOutline)
+            outline.back().push_back(to_device(v));
+        iRasterizer.fill(current_clip(), outline, aPaint, blending_mode());
+    }
+
+    void software_rendering_context::stroke(const vertices& aLines, dimension aWidth, const software_rasterizer::paint& aPaint)
+    {
+        // each pair of vertices is a line; the lines' quads are filled together so that the overlaps at joins are not blended twice
+        software_rasterizer::contours quads;
+        for (std::size_t v = 0; v + 1 < aLines.size(); v += 2)
+        {
+            quads.push_back(software_rasterizer::line_to_quad(aLines[v].xy, aLines[v + 1].xy, aWidth));
+            for (auto& corner : quads.back())
+                corner = to_device(vec3{ corner.x, corner.y, 0.0 });
+            software_rasterizer::orient(quads.back());
+        }
+        iRasterizer.fill(current_clip(), quads, aPaint, blending_mode());
+    }
+}
\ No newline at end of file
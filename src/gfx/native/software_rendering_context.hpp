@@ -0,0 +1,127 @@
+// software_rendering_context.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gfx/i_rendering_context.hpp>
+#include <neogfx/gfx/i_rendering_engine.hpp>
+#include <neogfx/gfx/path.hpp>
+#include <neogfx/game/mesh.hpp>
+#include <neogfx/game/material.hpp>
+#include "software_rasterizer.hpp"
+
+namespace neogfx
+{
+    class software_texture;
+
+    // Executes graphics operations on the CPU for the software renderer. Operations are processed in the same order,
+    // with the same coordinate mapping, scissoring, snapping and blending, as opengl_rendering_context processes them so
+    // that both renderers produce the same pixels, give or take antialiasing at shape edges.
+    class software_rendering_context : public i_rendering_context
+    {
+    public:
+        struct unsupported_render_target : std::logic_error { unsupported_render_target() : std::logic_error("neogfx::software_rendering_context::unsupported_render_target") {} };
+    public:
+        software_rendering_context(const i_render_target& aTarget, neogfx::blending_mode aBlendingMode = neogfx::blending_mode::Default);
+        software_rendering_context(const software_rendering_context& aOther);
+        ~software_rendering_context();
+    public:
+        std::unique_ptr<i_rendering_context> clone() const override;
+    public:
+        i_rendering_engine& rendering_engine() override;
+        const i_render_target& render_target() const override;
+        const i_render_target& render_target() override;
+        rect rendering_area(bool aConsiderScissor = true) const override;
+    public:
+        const graphics_operation::queue& queue() const override;
+        graphics_operation::queue& queue() override;
+        void enqueue(const graphics_operation::operation& aOperation) override;
+        void flush() override;
+    public:
+        neogfx::logical_coordinate_system logical_coordinate_system() const;
+        void set_logical_coordinate_system(neogfx::logical_coordinate_system aSystem);
+        neogfx::logical_coordinates logical_coordinates() const override;
+        void set_logical_coordinates(const neogfx::logical_coordinates& aCoordinates);
+        vec2 offset() const override;
+        void set_offset(const optional_vec2& aOffset) override;
+        bool gradient_set() const override;
+        void apply_gradient(i_gradient_shader& aShader) override;
+        bool snap_to_pixel() const;
+        void set_snap_to_pixel(bool aSnapToPixel);
+        void scissor_on(const rect& aRect);
+        void scissor_off();
+        const optional_rect& scissor_rect() const;
+        void set_opacity(double aOpacity);
+        neogfx::blending_mode blending_mode() const;
+        void set_blending_mode(neogfx::blending_mode aBlendingMode);
+        void set_gradient(const gradient& aGradient, const rect& aBoundingBox);
+        void clear_gradient();
+        bool is_subpixel_rendering_on() const;
+        void subpixel_rendering_on();
+        void subpixel_rendering_off();
+        void clear(const color& aColor);
+        void set_pixel(const point& aPoint, const color& aColor);
+        void draw_pixel(const point& aPoint, const color& aColor);
+        void draw_line(const point& aFrom, const point& aTo, const pen& aPen);
+        void draw_rect(const rect& aRect, const pen& aPen);
+        void draw_rounded_rect(const rect& aRect, dimension aRadius, const pen& aPen);
+        void draw_circle(const point& aCenter, dimension aRadius, const pen& aPen, angle aStartAngle);
+        void draw_arc(const point& aCenter, dimension aRadius, angle aStartAngle, angle aEndAngle, const pen& aPen);
+        void draw_path(const path& aPath, const pen& aPen);
+        void draw_shape(const game::mesh& aMesh, const vec3& aPosition, const pen& aPen);
+        void fill_rect(const rect& aRect, const brush& aFill);
+        void fill_rounded_rect(const rect& aRect, dimension aRadius, const brush& aFill);
+        void fill_circle(const point& aCenter, dimension aRadius, const brush& aFill);
+        void fill_arc(const point& aCenter, dimension aRadius, angle aStartAngle, angle aEndAngle, const brush& aFill);
+        void fill_path(const path& aPath, const brush& aFill);
+        void fill_shape(const game::mesh& aMesh, const vec3& aPosition, const brush& aFill);
+        void draw_glyph(const graphics_operation::batch& aDrawGlyphOps);
+        void draw_mesh(const game::mesh& aMesh, const game::material& aMaterial, const mat44& aTransformation);
+    public:
+        neogfx::subpixel_format subpixel_format() const override;
+    private:
+        vec2 to_device(const vec3& aPoint) const;
+        software_rasterizer::clip current_clip() const;
+        software_rasterizer::paint to_paint(const color& aColor) const;
+        software_rasterizer::paint to_paint(const gradient& aGradient, const rect& aBoundingBox) const;
+        template <typename ColorOrGradient>
+        software_rasterizer::paint to_paint(const ColorOrGradient& aFill, const rect& aBoundingBox) const;
+        void fill(const vertices& aOutline, const software_rasterizer::paint& aPaint);
+        void stroke(const vertices& aLines, dimension aWidth, const software_rasterizer::paint& aPaint);
+        void draw_mesh(const game::mesh& aMesh, const game::material& aMaterial, const mat44& aTransformation, const software_rasterizer::paint& aPaint,
+            software_rasterizer::coverage_source aSource, scalar aEffectWidth = 0.0);
+    private:
+        i_rendering_engine& iRenderingEngine;
+        const i_render_target& iTarget;
+        software_rasterizer iRasterizer;
+        mutable std::optional<neogfx::logical_coordinate_system> iLogicalCoordinateSystem;
+        mutable std::optional<neogfx::logical_coordinates> iLogicalCoordinates;
+        double iOpacity;
+        neogfx::blending_mode iBlendingMode;
+        bool iSubpixelRendering;
+        std::vector<rect> iScissorRects;
+        mutable optional_rect iScissorRect;
+        sink iSink;
+        scoped_render_target iSrt;
+        optional_vec2 iOffset;
+        bool iSnapToPixel;
+        std::optional<std::pair<gradient, rect>> iGradient;
+    };
+}
\ No newline at end of file
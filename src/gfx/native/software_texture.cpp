@@ -0,0 +1,401 @@
+// software_texture.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gfx/i_texture_manager.hpp>
+#include <neogfx/gfx/i_rendering_engine.hpp>
+#include "software_rendering_context.hpp"
+#include "software_texture.hpp"
+
+namespace neogfx
+{
+    namespace
+    {
+        inline size_u32 storage_size(const size_u32& aExtents, texture_sampling aSampling)
+        {
+            if (aSampling == texture_sampling::Data)
+                return aExtents;
+            return size_u32{ aExtents.cx + 2u, aExtents.cy + 2u };
+        }
+
+        inline uint8_t to_byte(float aValue)
+        {
+            return static_cast<uint8_t>(std::clamp(aValue, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    software_texture::software_texture(i_texture_manager& aManager, texture_id aId, const neogfx::size& aExtents, dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat, texture_data_type aDataType, neogfx::color_space aColorSpace, const optional_color& aColor) :
+        iManager{ aManager },
+        iId{ aId },
+        iDpiScaleFactor{ aDpiScaleFactor },
+        iColorSpace{ aColorSpace },
+        iSampling{ aSampling },
+        iDataFormat{ aDataFormat },
+        iDataType{ aDataType },
+        iSize{ aExtents },
+        iStorageSize{ storage_size(iSize, aSampling) },
+        iStorage{ size{ iStorageSize }, color{ vec4{ 0.0, 0.0, 0.0, 0.0 } }, aDpiScaleFactor, aSampling, aColorSpace },
+        iUri{ "neogfx::software_texture::internal" },
+        iLogicalCoordinateSystem{ neogfx::logical_coordinate_system::AutomaticGame },
+        iRenderTarget{ false }
+    {
+        if (aColor != std::nullopt)
+            for (uint32_t y = 0; y < iSize.cy; ++y)
+                for (uint32_t x = 0; x < iSize.cx; ++x)
+                    set_pixel(point{ static_cast<coordinate>(x), static_cast<coordinate>(y) }, *aColor);
+    }
+
+    software_texture::software_texture(i_texture_manager& aManager, texture_id aId, const i_image& aImage, texture_data_format aDataFormat, texture_data_type aDataType) :
+        iManager{ aManager },
+        iId{ aId },
+        iDpiScaleFactor{ aImage.dpi_scale_factor() },
+        iColorSpace{ aImage.color_space() },
+        iSampling{ aImage.sampling() },
+        iDataFormat{ aDataFormat },
+        iDataType{ aDataType },
+        iSize{ aImage.extents() },
+        iStorageSize{ storage_size(iSize, aImage.sampling()) },
+        iStorage{ size{ iStorageSize }, color{ vec4{ 0.0, 0.0, 0.0, 0.0 } }, aImage.dpi_scale_factor(), aImage.sampling(), aImage.color_space() },
+        iUri{ aImage.uri() },
+        iLogicalCoordinateSystem{ neogfx::logical_coordinate_system::AutomaticGame },
+        iRenderTarget{ false }
+    {
+        if (aImage.color_format() != color_format::RGBA8)
+            throw unsupported_color_format();
+        // images are stored top row first
+        auto const imageData = static_cast<const uint8_t*>(aImage.cpixels());
+        auto const offset = border();
+        for (uint32_t y = 0; y < iSize.cy; ++y)
+            std::copy(
+                imageData + y * iSize.cx * 4u,
+                imageData + (y + 1u) * iSize.cx * 4u,
+                texel(static_cast<uint32_t>(offset.x), static_cast<uint32_t>(offset.y) + iSize.cy - 1u - y));
+    }
+
+    software_texture::~software_texture()
+    {
+    }
+
+    texture_id software_texture::id() const
+    {
+        return iId;
+    }
+
+    texture_type software_texture::type() const
+    {
+        return texture_type::Texture;
+    }
+
+    bool software_texture::is_render_target() const
+    {
+        return iRenderTarget;
+    }
+
+    const i_sub_texture& software_texture::as_sub_texture() const
+    {
+        throw not_sub_texture();
+    }
+
+    dimension software_texture::dpi_scale_factor() const
+    {
+        return iDpiScaleFactor;
+    }
+
+    texture_sampling software_texture::sampling() const
+    {
+        switch (iSampling)
+        {
+        case texture_sampling::Multisample4x:
+        case texture_sampling::Multisample8x:
+        case texture_sampling::Multisample16x:
+        case texture_sampling::Multisample32x:
+            return texture_sampling::Multisample;
+        default:
+            return iSampling;
+        }
+    }
+
+    uint32_t software_texture::samples() const
+    {
+        // coverage is computed analytically so there is only ever one sample per texel
+        return 1u;
+    }
+
+    texture_data_format software_texture::data_format() const
+    {
+        return iDataFormat;
+    }
+
+    texture_data_type software_texture::data_type() const
+    {
+        return iDataType;
+    }
+
+    bool software_texture::is_empty() const
+    {
+        return false;
+    }
+
+    size software_texture::extents() const
+    {
+        return iSize;
+    }
+
+    size software_texture::storage_extents() const
+    {
+        return iStorageSize;
+    }
+
+    void software_texture::set_pixels(const rect& aRect, const void* aPixelData, uint32_t aPackAlignment)
+    {
+        auto const adjustedRect = basic_rect<int32_t>{ aRect + border() };
+        std::size_t const channels = (iDataFormat == texture_data_format::Red ? 1u : 4u);
+        std::size_t const channelSize = (iDataType == texture_data_type::Float ? sizeof(float) : sizeof(uint8_t));
+        std::size_t const rowSize = (adjustedRect.cx * channels * channelSize + aPackAlignment - 1u) / aPackAlignment * aPackAlignment;
+        auto const source = static_cast<const uint8_t*>(aPixelData);
+        for (int32_t y = 0; y < adjustedRect.cy; ++y)
+        {
+            auto const storageY = adjustedRect.y + y;
+            if (storageY < 0 || storageY >= static_cast<int32_t>(iStorageSize.cy))
+                continue;
+            auto const sourceRow = source + y * rowSize;
+            for (int32_t x = 0; x < adjustedRect.cx; ++x)
+            {
+                auto const storageX = adjustedRect.x + x;
+                if (storageX < 0 || storageX >= static_cast<int32_t>(iStorageSize.cx))
+                    continue;
+                auto const destination = texel(storageX, storageY);
+                auto const sourceTexel = sourceRow + x * channels * channelSize;
+                std::array<uint8_t, 4> value = { 0u, 0u, 0u, 0xFFu };
+                for (std::size_t c = 0; c < channels; ++c)
+                    if (iDataType == texture_data_type::Float)
+                        value[c] = to_byte(reinterpret_cast<const float*>(sourceTexel)[c]);
+                    else
+                        value[c] = sourceTexel[c];
+                std::copy(value.begin(), value.end(), destination);
+            }
+        }
+    }
+
+    void software_texture::set_pixels(const i_image& aImage)
+    {
+        set_pixels(rect{ point{}, aImage.extents() }, aImage.cpixels());
+    }
+
+    void software_texture::set_pixel(const point& aPosition, const color& aColor)
+    {
+        auto const storagePosition = basic_point<int32_t>{ aPosition + border() };
+        if (storagePosition.x < 0 || storagePosition.y < 0 ||
+            storagePosition.x >= static_cast<int32_t>(iStorageSize.cx) || storagePosition.y >= static_cast<int32_t>(iStorageSize.cy))
+            return;
+        auto const destination = texel(storagePosition.x, storagePosition.y);
+        destination[0] = aColor.red();
+        destination[1] = aColor.green();
+        destination[2] = aColor.blue();
+        destination[3] = aColor.alpha();
+    }
+
+    color software_texture::get_pixel(const point& aPosition) const
+    {
+        return read_pixel(aPosition);
+    }
+
+    void* software_texture::handle() const
+    {
+        return iStorage.pixels();
+    }
+
+    bool software_texture::is_resident() const
+    {
+        return true;
+    }
+
+    const std::string& software_texture::uri() const
+    {
+        return iUri;
+    }
+
+    dimension software_texture::horizontal_dpi() const
+    {
+        return dpi_scale_factor() * 96.0;
+    }
+
+    dimension software_texture::vertical_dpi() const
+    {
+        return dpi_scale_factor() * 96.0;
+    }
+
+    dimension software_texture::ppi() const
+    {
+        return size{ horizontal_dpi(), vertical_dpi() }.magnitude() / std::sqrt(2.0);
+    }
+
+    bool software_texture::metrics_available() const
+    {
+        return true;
+    }
+
+    dimension software_texture::em_size() const
+    {
+        return 0.0;
+    }
+
+    std::unique_ptr<i_rendering_context> software_texture::create_graphics_context(blending_mode aBlendingMode) const
+    {
+        iRenderTarget = true;
+        return std::unique_ptr<i_rendering_context>(new software_rendering_context{ *this, aBlendingMode });
+    }
+
+    int32_t software_texture::bind(const std::optional<uint32_t>&) const
+    {
+        // there are no texture units; the software renderer reads texels directly
+        return 0;
+    }
+
+    intptr_t software_texture::native_handle() const
+    {
+        return reinterpret_cast<intptr_t>(handle());
+    }
+
+    std::shared_ptr<i_native_texture> software_texture::native_texture() const
+    {
+        return std::dynamic_pointer_cast<i_native_texture>(iManager.find_texture(id()));
+    }
+
+    render_target_type software_texture::target_type() const
+    {
+        return render_target_type::Texture;
+    }
+
+    void* software_texture::target_handle() const
+    {
+        return native_texture()->handle();
+    }
+
+    void* software_texture::target_device_handle() const
+    {
+        return nullptr;
+    }
+
+    i_rendering_engine::pixel_format_t software_texture::pixel_format() const
+    {
+        return 0;
+    }
+
+    const i_texture& software_texture::target_texture() const
+    {
+        return *this;
+    }
+
+    size software_texture::target_extents() const
+    {
+        return extents();
+    }
+
+    neogfx::logical_coordinate_system software_texture::logical_coordinate_system() const
+    {
+        return iLogicalCoordinateSystem;
+    }
+
+    void software_texture::set_logical_coordinate_system(neogfx::logical_coordinate_system aSystem)
+    {
+        iLogicalCoordinateSystem = aSystem;
+    }
+
+    logical_coordinates software_texture::logical_coordinates() const
+    {
+        if (iLogicalCoordinates != std::nullopt)
+            return *iLogicalCoordinates;
+        neogfx::logical_coordinates result;
+        switch (iLogicalCoordinateSystem)
+        {
+        case neogfx::logical_coordinate_system::Specified:
+            throw logical_coordinates_not_specified();
+            break;
+        case neogfx::logical_coordinate_system::AutomaticGui:
+            result.bottomLeft = vec2{ 0.0, extents().cy };
+            result.topRight = vec2{ extents().cx, 0.0 };
+            break;
+        case neogfx::logical_coordinate_system::AutomaticGame:
+            result.bottomLeft = vec2{ 0.0, 0.0 };
+            result.topRight = vec2{ extents().cx, extents().cy };
+            break;
+        }
+        return result;
+    }
+
+    void software_texture::set_logical_coordinates(const neogfx::logical_coordinates& aCoordinates)
+    {
+        iLogicalCoordinates = aCoordinates;
+    }
+
+    void software_texture::activate_target() const
+    {
+        bool alreadyActive = target_active();
+        if (!alreadyActive)
+        {
+            TargetActivating.trigger();
+            service<i_rendering_engine>().activate_context(*this);
+            TargetActivated.trigger();
+        }
+    }
+
+    bool software_texture::target_active() const
+    {
+        return service<i_rendering_engine>().active_target() == this;
+    }
+
+    void software_texture::deactivate_target() const
+    {
+        if (target_active())
+        {
+            TargetDeactivating.trigger();
+            service<i_rendering_engine>().deactivate_context();
+            TargetDeactivated.trigger();
+            return;
+        }
+        throw not_active();
+    }
+
+    color_space software_texture::color_space() const
+    {
+        return iColorSpace;
+    }
+
+    color software_texture::read_pixel(const point& aPosition) const
+    {
+        // as with the OpenGL renderer the position is relative to the bottom left of the texture
+        auto const storagePosition = basic_point<int32_t>{ aPosition + border() };
+        if (storagePosition.x < 0 || storagePosition.y < 0 ||
+            storagePosition.x >= static_cast<int32_t>(iStorageSize.cx) || storagePosition.y >= static_cast<int32_t>(iStorageSize.cy))
+            return color{ vec4{ 0.0, 0.0, 0.0, 0.0 } };
+        auto const source = texel(storagePosition.x, storagePosition.y);
+        return color{ source[0], source[1], source[2], source[3] };
+    }
+
+    uint8_t* software_texture::texel(uint32_t aX, uint32_t aY) const
+    {
+        return static_cast<uint8_t*>(iStorage.pixels()) + (static_cast<std::size_t>(aY) * iStorageSize.cx + aX) * 4u;
+    }
+
+    point software_texture::border() const
+    {
+        return sampling() != texture_sampling::Data ? point{ 1.0, 1.0 } : point{ 0.0, 0.0 };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// software_texture_manager.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include "software_texture_manager.hpp"
+#include "software_texture.hpp"
+
+namespace neogfx
+{
+    std::shared_ptr<i_texture> software_texture_manager::create_texture(const neogfx::size& aExtents, dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat, texture_data_type aDataType, color_space aColorSpace, const optional_color& aColor)
+    {
+        return add_texture(std::make_shared<software_texture>(*this, allocate_texture_id(), aExtents, aDpiScaleFactor, aSampling, aDataFormat, aDataType, aColorSpace, aColor));
+    }
+
+    std::shared_ptr<i_texture> software_texture_manager::create_texture(const i_image& aImage, texture_data_format aDataFormat, texture_data_type aDataType)
+    {
+        auto existing = find_texture(aImage);
+        if (existing != textures().end())
+            return existing->first;
+        return add_texture(std::make_shared<software_texture>(*this, allocate_texture_id(), aImage, aDataFormat, aDataType));
+    }
+}
\ No newline at end of file
@@ -50,7 +50,7 @@ namespace neogfx
                 iDrawOnExit{ true }
             {
                 if (!room_for(aNeed) || aUseBarrier)
-                    execute();
+                    execute(aNeed);
                 set_transformation(optional_mat44{});
                 if (!room_for(aNeed) && !need(aNeed))
                     throw not_enough_room();
@@ -66,7 +66,7 @@ namespace neogfx
                 iDrawOnExit{ true }
             {
                 if (!room_for(aNeed) || aUseBarrier)
-                    execute();
+                    execute(aNeed);
                 set_transformation(aTransformation);
                 if (!room_for(aNeed) && !need(aNeed))
                     throw not_enough_room();
@@ -82,7 +82,7 @@ namespace neogfx
                 iDrawOnExit{ true }
             {
                 if (!room_for(aNeed) || aUseBarrier)
-                    execute();
+                    execute(aNeed);
                 set_transformation(optional_mat44{});
                 if (!room_for(aNeed) && !need(aNeed))
                     throw not_enough_room();
@@ -98,7 +98,7 @@ namespace neogfx
                 iDrawOnExit{ true }
             {
                 if (!room_for(aNeed) || aUseBarrier)
-                    execute();
+                    execute(aNeed);
                 set_transformation(aTransformation);
                 if (!room_for(aNeed) && !need(aNeed))
                     throw not_enough_room();
@@ -218,12 +218,15 @@ namespace neogfx
                     return false;
                 }
             }
-            void execute()
+            void execute(std::size_t aNeed = 0u)
             {
                 draw();
                 iUse.execute();
-                iUse.vertices().clear();
-                iStart = 0;
+                // vertices already drawn this frame may still be in use by the GPU so keep appending after them
+                // while there is room
+                if (!room_for(std::max<std::size_t>(aNeed, 1u)))
+                    iUse.vertices().clear();
+                iStart = static_cast<GLint>(iUse.vertices().size());
             }
             struct skip
             {
@@ -251,6 +254,7 @@ namespace neogfx
                 iParent.rendering_engine().vertex_buffer(iProvider).attach_shader(iParent, iParent.rendering_engine().active_shader_program());
                 if (!iUseBarrier && mode() == translated_mode())
                 {
+                    vertices().mark_in_use(static_cast<std::size_t>(iStart), static_cast<std::size_t>(iStart) + aCount);
                     glCheck(glDrawArrays(translated_mode(), iStart, static_cast<GLsizei>(aCount)));
                     iStart += static_cast<GLint>(aCount);
                 }
@@ -265,6 +269,7 @@ namespace neogfx
                     while (aCount > 0)
                     {
                         auto amount = std::min(chunk, aCount);
+                        vertices().mark_in_use(static_cast<std::size_t>(iStart), static_cast<std::size_t>(iStart) + amount);
                         glCheck(glDrawArrays(translated_mode(), iStart, static_cast<GLsizei>(amount)));
                         iStart += static_cast<GLint>(amount);
                         aCount -= amount;
@@ -0,0 +1,115 @@
+// range_allocator.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gfx/range_allocator.hpp>
+
+namespace neogfx
+{
+    range_allocator::range_allocator() :
+        iFreeSpace{ 0 }
+    {
+    }
+
+    std::optional<range_allocator::size_type> range_allocator::allocate(size_type aCount)
+    {
+        if (aCount == 0)
+            return {};
+        auto bestFit = iFreeByLength.lower_bound(std::make_pair(aCount, size_type{ 0 }));
+        if (bestFit == iFreeByLength.end())
+            return {};
+        auto const result = bestFit->second;
+        auto const range = iFreeByOffset.find(result);
+        auto const end = range->second;
+        remove_free_range(range);
+        if (result + aCount != end)
+            add_free_range(result + aCount, end);
+        return result;
+    }
+
+    void range_allocator::deallocate(size_type aStart, size_type aEnd)
+    {
+        if (aStart >= aEnd)
+            return;
+        // coalesce with any free ranges adjacent to (or overlapping) the range being freed
+        auto existing = iFreeByOffset.lower_bound(aStart);
+        if (existing != iFreeByOffset.begin() && std::prev(existing)->second >= aStart)
+            --existing;
+        while (existing != iFreeByOffset.end() && existing->first <= aEnd)
+        {
+            aStart = std::min(aStart, existing->first);
+            aEnd = std::max(aEnd, existing->second);
+            auto next = std::next(existing);
+            remove_free_range(existing);
+            existing = next;
+        }
+        add_free_range(aStart, aEnd);
+    }
+
+    void range_allocator::clear()
+    {
+        iFreeByOffset.clear();
+        iFreeByLength.clear();
+        iFreeSpace = 0;
+    }
+
+    bool range_allocator::empty() const
+    {
+        return iFreeByOffset.empty();
+    }
+
+    range_allocator::size_type range_allocator::free_space() const
+    {
+        return iFreeSpace;
+    }
+
+    range_allocator::size_type range_allocator::largest_free_range() const
+    {
+        if (iFreeByLength.empty())
+            return 0;
+        return std::prev(iFreeByLength.end())->first;
+    }
+
+    range_allocator::size_type range_allocator::free_range_count() const
+    {
+        return iFreeByOffset.size();
+    }
+
+    double range_allocator::fragmentation() const
+    {
+        // 0.0 = all free space is contiguous; approaches 1.0 as free space is split into many small ranges
+        if (free_space() == 0)
+            return 0.0;
+        return 1.0 - static_cast<double>(largest_free_range()) / static_cast<double>(free_space());
+    }
+
+    void range_allocator::add_free_range(size_type aStart, size_type aEnd)
+    {
+        iFreeByOffset.emplace(aStart, aEnd);
+        iFreeByLength.emplace(aEnd - aStart, aStart);
+        iFreeSpace += (aEnd - aStart);
+    }
+
+    void range_allocator::remove_free_range(std::map<size_type, size_type>::iterator aRange)
+    {
+        iFreeByLength.erase(std::make_pair(aRange->second - aRange->first, aRange->first));
+        iFreeSpace -= (aRange->second - aRange->first);
+        iFreeByOffset.erase(aRange);
+    }
+}
\ No newline at end of file
@@ -71,9 +71,44 @@ namespace neogfx
         return iChildren[0]->insert(aElementSize);
     }
 
+    bool rect_pack::node::remove(const neogfx::rect& aElement)
+    {
+        if (is_leaf())
+        {
+            if (!iInUse || iRect != aElement)
+                return false;
+            iInUse = false;
+            return true;
+        }
+        for (auto child : iChildren)
+            if (child->rect().contains(aElement) && child->remove(aElement))
+            {
+                // both halves free again so merge them back into a single free node
+                if (iChildren[0]->is_free() && iChildren[1]->is_free())
+                    destroy_children();
+                return true;
+            }
+        return false;
+    }
+
     rect_pack::rect_pack(const size& aDimensions) :
-        iRoot{ rect{ point{}, aDimensions }, iAllocator }
+        iDimensions{ aDimensions }, iRoot{ rect{ point{}, aDimensions }, iAllocator }, iUsedArea{ 0.0 }
+    {
+    }
+
+    const size& rect_pack::dimensions() const
     {
+        return iDimensions;
+    }
+
+    dimension rect_pack::used_area() const
+    {
+        return iUsedArea;
+    }
+
+    bool rect_pack::empty() const
+    {
+        return iRoot.is_free();
     }
 
     bool rect_pack::insert(const size& aElementSize, rect& aResult)
@@ -82,8 +117,17 @@ namespace neogfx
         if (result != nullptr)
         {
             aResult = result->rect();
+            iUsedArea += aResult.width() * aResult.height();
             return true;
         }
         return false;
     }
+
+    bool rect_pack::remove(const rect& aElement)
+    {
+        if (!iRoot.remove(aElement))
+            return false;
+        iUsedArea -= aElement.width() * aElement.height();
+        return true;
+    }
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #include <neogfx/neogfx.hpp>
 #include <sstream>
+#include <deque>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/filesystem.hpp>
@@ -82,18 +83,27 @@ namespace neogfx
         catch (...)
         {
         }
+        build_trie();
     }
 
     bool emoji_atlas::is_emoji(char32_t aCodePoint) const
     {
-        std::u32string str;
-        str += aCodePoint;
-        return is_emoji(str);
+        return is_emoji(&aCodePoint, &aCodePoint + 1);
     }
 
     bool emoji_atlas::is_emoji(const std::u32string& aCodePoints) const
     {
-        return iEmojiMap.find(aCodePoints) != iEmojiMap.end();
+        return is_emoji(aCodePoints.data(), aCodePoints.data() + aCodePoints.size());
+    }
+
+    bool emoji_atlas::is_emoji(const char32_t* aCodePoints, const char32_t* aCodePointsEnd) const
+    {
+        if (aCodePoints == aCodePointsEnd || iTrieNodes.empty())
+            return false;
+        uint32_t node = 0u;
+        for (auto codePoint = aCodePoints; codePoint != aCodePointsEnd && node != NoNode; ++codePoint)
+            node = trie_child(node, *codePoint);
+        return node != NoNode && iTrieNodes[node].terminal;
     }
 
     emoji_atlas::emoji_id emoji_atlas::emoji(char32_t aCodePoint, dimension aDesiredSize) const
@@ -123,4 +133,59 @@ namespace neogfx
     {
         return iTextureAtlas->sub_texture(aId);
     }
+
+    void emoji_atlas::build_trie()
+    {
+        // iEmojis is ordered so sequences sharing a prefix are adjacent with the prefix itself (if an emoji) first
+        std::vector<const std::u32string*> sequences;
+        sequences.reserve(iEmojis.size());
+        for (auto const& e : iEmojis)
+            sequences.push_back(&e.first);
+        iTrieNodes.assign(1u, trie_node{});
+        iTrieEdges.clear();
+        struct pending
+        {
+            uint32_t node;
+            std::size_t first;
+            std::size_t last;
+            std::size_t depth;
+        };
+        std::deque<pending> queue{ pending{ 0u, 0u, sequences.size(), 0u } };
+        while (!queue.empty())
+        {
+            auto const next = queue.front();
+            queue.pop_front();
+            auto s = next.first;
+            if (s < next.last && sequences[s]->size() == next.depth)
+            {
+                iTrieNodes[next.node].terminal = true;
+                ++s;
+            }
+            iTrieNodes[next.node].firstEdge = static_cast<uint32_t>(iTrieEdges.size());
+            while (s < next.last)
+            {
+                auto const codePoint = (*sequences[s])[next.depth];
+                auto e = s;
+                while (e < next.last && (*sequences[e])[next.depth] == codePoint)
+                    ++e;
+                auto const child = static_cast<uint32_t>(iTrieNodes.size());
+                iTrieNodes.push_back(trie_node{});
+                iTrieEdges.push_back(trie_edge{ codePoint, child });
+                queue.push_back(pending{ child, s, e, next.depth + 1u });
+                s = e;
+            }
+            iTrieNodes[next.node].edgeCount = static_cast<uint32_t>(iTrieEdges.size()) - iTrieNodes[next.node].firstEdge;
+        }
+    }
+
+    uint32_t emoji_atlas::trie_child(uint32_t aNode, char32_t aCodePoint) const
+    {
+        auto const& node = iTrieNodes[aNode];
+        auto const first = iTrieEdges.begin() + node.firstEdge;
+        auto const last = first + node.edgeCount;
+        if (first == last || aCodePoint < first->codePoint || aCodePoint > std::prev(last)->codePoint)
+            return NoNode;
+        auto const edge = std::lower_bound(first, last, aCodePoint, [](const trie_edge& aEdge, char32_t aCodePoint) { return aEdge.codePoint < aCodePoint; });
+        return edge != last && edge->codePoint == aCodePoint ? edge->node : NoNode;
+    }
 }
\ No newline at end of file
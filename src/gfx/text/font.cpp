@@ -567,6 +567,16 @@ namespace neogfx
         return native_font_face().glyph_texture(aGlyph);
     }
 
+    bool font::glyph_texture_ready(const glyph& aGlyph) const
+    {
+        return native_font_face().glyph_texture_ready(aGlyph);
+    }
+
+    const i_glyph_texture& font::glyph_distance_field(const glyph& aGlyph) const
+    {
+        return native_font_face().glyph_distance_field(aGlyph);
+    }
+
     bool font::operator==(const font& aRhs) const
     {
         return iInstance->native_font_face().handle() == aRhs.iInstance->native_font_face().handle() &&
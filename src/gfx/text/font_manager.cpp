@@ -19,6 +19,8 @@
 
 #include <neogfx/neogfx.hpp>
 #include <neolib/core/string_utils.hpp>
+#include <thread>
+#include <future>
 #include <boost/filesystem.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -32,6 +34,8 @@
 #include <neogfx/gfx/text/font_manager.hpp>
 #include "../../gfx/text/native/native_font_face.hpp"
 #include "../../gfx/text/native/native_font.hpp"
+#include "../../gfx/text/native/font_index.hpp"
+#include "../../gfx/text/native/glyph_rasterizer.hpp"
 
 namespace neogfx
 {
@@ -105,6 +109,17 @@ namespace neogfx
 #endif
             }
 
+            // no index (every font is scanned) if the system has nowhere to keep one
+            std::optional<std::string> get_font_index_path()
+            {
+#ifdef WIN32
+                char szPath[MAX_PATH];
+                if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, szPath)))
+                    return neolib::tidy_path(szPath) + "/neogfx/font_index.txt";
+#endif
+                return {};
+            }
+
             fallback_font_info default_fallback_font_info()
             {
 #ifdef WIN32
@@ -114,6 +129,35 @@ namespace neogfx
 #endif
             }
         }
+
+        struct font_file
+        {
+            std::string path;
+            uint64_t fileSize;
+            int64_t lastWriteTime;
+        };
+
+        // FreeType library instances are not thread-safe so each scanning thread uses its own.
+        font_index::entry scan_font_file(FT_Library aFontLib, const font_file& aFile)
+        {
+            font_index::entry result{ aFile.fileSize, aFile.lastWriteTime, false, {}, 0, {} };
+            FT_Face face;
+            if (FT_New_Face(aFontLib, aFile.path.c_str(), 0, &face))
+                return result;
+            FT_Done_Face(face);
+            try
+            {
+                native_font font{ aFontLib, aFile.path };
+                result.isFont = true;
+                result.familyName = font.family_name();
+                result.faceCount = font.face_count();
+                result.styles = font.styles();
+            }
+            catch (native_font::failed_to_load_font&)
+            {
+            }
+            return result;
+        }
     }
 
     fallback_font_info::fallback_font_info(std::vector<std::string> aFallbackFontFamilies) :
@@ -141,38 +185,90 @@ namespace neogfx
 
     font_manager::font_manager() :
         iGlyphAtlas{ size{1024.0, 1024.0} },
-        iEmojiAtlas{}
+        iEmojiAtlas{},
+        iPrewarmGlyphRanges{ { U'\x20', U'\x7E' }, { U'\xA0', U'\xFF' } },
+        iGlyphRasterizer{ std::make_unique<neogfx::glyph_rasterizer>() }
     {
         FT_Error error = FT_Init_FreeType(&iFontLib);
         if (error)
         {
             throw error_initializing_font_library();
         }
-        auto enumerate = [this](const std::string fontsDirectory)
+        iGlyphAtlas.set_memory_budget(DefaultGlyphAtlasMemoryBudget);
+        auto const enumerationStart = std::chrono::steady_clock::now();
+        iEnumerationInfo = font_enumeration_info{};
+        std::optional<font_index> index;
+        auto const indexPath = detail::platform_specific::get_font_index_path();
+        if (indexPath != std::nullopt)
+            index.emplace(*indexPath);
+        auto addFont = [this](const std::string& aPath, const font_index::entry& aEntry)
+        {
+            if (!aEntry.isFont)
+                return;
+            auto font = iNativeFonts.emplace(iNativeFonts.end(), iFontLib, aPath, aEntry.familyName, aEntry.faceCount, aEntry.styles);
+            iFontFamilies[neolib::make_ci_string(font->family_name())].push_back(font);
+        };
+        std::vector<detail::font_file> unindexedFiles;
+        auto enumerate = [&](const std::string fontsDirectory)
         {
             for (boost::filesystem::directory_iterator file(fontsDirectory); file != boost::filesystem::directory_iterator(); ++file)
             {
                 if (!boost::filesystem::is_regular_file(file->status()))
                     continue;
-                try
-                {
-                    if (is_font_file(file->path().string()))
-                    {
-                        auto font = iNativeFonts.emplace(iNativeFonts.end(), iFontLib, file->path().string());
-                        iFontFamilies[neolib::make_ci_string(font->family_name())].push_back(font);
-                    }
-                }
-                catch (native_font::failed_to_load_font&)
+                detail::font_file const fontFile{
+                    file->path().string(),
+                    static_cast<uint64_t>(boost::filesystem::file_size(file->path())),
+                    static_cast<int64_t>(boost::filesystem::last_write_time(file->path())) };
+                auto const indexed = (index != std::nullopt ? index->find(fontFile.path, fontFile.fileSize, fontFile.lastWriteTime) : nullptr);
+                if (indexed != nullptr)
                 {
+                    addFont(fontFile.path, *indexed);
+                    ++iEnumerationInfo.indexedFonts;
                 }
-                catch (...)
-                {
-                    throw;
-                }
+                else
+                    unindexedFiles.push_back(fontFile);
             }
         };
         enumerate(detail::platform_specific::get_system_font_directory());
         enumerate(detail::platform_specific::get_local_font_directory());
+        if (!unindexedFiles.empty())
+        {
+            std::size_t const MinimumFilesPerThread = 16;
+            std::size_t const threadCount = std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(),
+                (unindexedFiles.size() + MinimumFilesPerThread - 1) / MinimumFilesPerThread));
+            std::vector<font_index::entry> scanned(unindexedFiles.size());
+            std::vector<std::future<void>> scanners;
+            for (std::size_t t = 0; t < threadCount; ++t)
+                scanners.push_back(std::async(std::launch::async, [&, t]()
+                {
+                    FT_Library scannerLib;
+                    if (FT_Init_FreeType(&scannerLib))
+                        throw error_initializing_font_library();
+                    try
+                    {
+                        for (std::size_t f = t; f < unindexedFiles.size(); f += threadCount)
+                            scanned[f] = detail::scan_font_file(scannerLib, unindexedFiles[f]);
+                    }
+                    catch (...)
+                    {
+                        FT_Done_FreeType(scannerLib);
+                        throw;
+                    }
+                    FT_Done_FreeType(scannerLib);
+                }));
+            for (auto& scanner : scanners)
+                scanner.get();
+            for (std::size_t f = 0; f < unindexedFiles.size(); ++f)
+            {
+                addFont(unindexedFiles[f].path, scanned[f]);
+                if (index != std::nullopt)
+                    index->update(unindexedFiles[f].path, scanned[f]);
+            }
+            iEnumerationInfo.scannedFonts = static_cast<uint32_t>(unindexedFiles.size());
+        }
+        if (index != std::nullopt && index->dirty())
+            index->save();
+        iEnumerationInfo.duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - enumerationStart);
         for (auto& famlily : iFontFamilies)
             std::sort(famlily.second.begin(), famlily.second.end(),
                 [](auto const& f1, auto const& f2) { return f1->min_style() < f2->min_style() || (f1->min_style() == f2->min_style() && f1->min_weight() < f2->min_weight()); });
@@ -180,9 +276,11 @@ namespace neogfx
 
     font_manager::~font_manager()
     {
+        iGlyphTextCache.invalidate();
         iIdCache.clear();
         iFontFamilies.clear();
         iNativeFonts.clear();
+        iGlyphRasterizer.reset();
         FT_Done_FreeType(iFontLib);
     }
 
@@ -261,16 +359,6 @@ namespace neogfx
         return add_font(aFont.create_face(aStyleName, aSize, aDevice));
     }
 
-    bool font_manager::is_font_file(const std::string& aFileName) const
-    {
-        FT_Face face;
-        FT_Error error = FT_New_Face(iFontLib, aFileName.c_str(), 0, &face);
-        if (error)
-            return false;
-        FT_Done_Face(face);
-        return true;
-    }
-
     i_native_font_face& font_manager::load_font_from_file(const std::string& aFileName, const i_device_resolution& aDevice)
     {
         throw std::logic_error("neogfx::font_manager::load_font_from_file function overload not yet implemented");
@@ -362,6 +450,11 @@ namespace neogfx
         throw bad_font_family_index();
     }
 
+    const font_enumeration_info& font_manager::enumeration_info() const
+    {
+        return iEnumerationInfo;
+    }
+
     font_id font_manager::allocate_font_id()
     {
         return iIdCache.next_cookie();
@@ -392,6 +485,36 @@ namespace neogfx
         return iEmojiAtlas;
     }
 
+    const neogfx::glyph_text_cache& font_manager::glyph_text_cache() const
+    {
+        return iGlyphTextCache;
+    }
+
+    neogfx::glyph_text_cache& font_manager::glyph_text_cache()
+    {
+        return iGlyphTextCache;
+    }
+
+    const font_manager::code_point_ranges& font_manager::prewarm_glyph_ranges() const
+    {
+        return iPrewarmGlyphRanges;
+    }
+
+    void font_manager::set_prewarm_glyph_ranges(const code_point_ranges& aRanges)
+    {
+        iPrewarmGlyphRanges = aRanges;
+    }
+
+    bool font_manager::glyph_redraw_needed()
+    {
+        return iGlyphRasterizer->redraw_needed();
+    }
+
+    neogfx::glyph_rasterizer& font_manager::glyph_rasterizer()
+    {
+        return *iGlyphRasterizer;
+    }
+
     void font_manager::add_ref(font_id aId)
     {
         font_from_id(aId).native_font_face().add_ref();
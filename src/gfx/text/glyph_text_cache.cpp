@@ -0,0 +1,113 @@
+// glyph_text_cache.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gfx/text/glyph_text_cache.hpp>
+
+namespace neogfx
+{
+    glyph_text_cache::glyph_text_cache(std::size_t aCapacity) :
+        iCapacity{ aCapacity }, iHits{ 0 }, iMisses{ 0 }
+    {
+    }
+
+    std::size_t glyph_text_cache::capacity() const
+    {
+        return iCapacity;
+    }
+
+    void glyph_text_cache::set_capacity(std::size_t aCapacity)
+    {
+        entry_list discarded;
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        iCapacity = aCapacity;
+        trim(discarded);
+    }
+
+    std::size_t glyph_text_cache::size() const
+    {
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        return iEntries.size();
+    }
+
+    uint64_t glyph_text_cache::hits() const
+    {
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        return iHits;
+    }
+
+    uint64_t glyph_text_cache::misses() const
+    {
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        return iMisses;
+    }
+
+    void glyph_text_cache::reset_statistics()
+    {
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        iHits = 0;
+        iMisses = 0;
+    }
+
+    void glyph_text_cache::invalidate()
+    {
+        // cached glyph text holds references to font faces: discarded entries are destroyed after the
+        // lock is released as dropping the last reference to a face re-enters invalidate(font_id)
+        entry_list discarded;
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        iIndex.clear();
+        discarded.splice(discarded.end(), iEntries);
+    }
+
+    void glyph_text_cache::invalidate(font_id aFont)
+    {
+        entry_list discarded;
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        for (auto entry = iEntries.begin(); entry != iEntries.end();)
+        {
+            auto const next = std::next(entry);
+            if (entry->first.uses(aFont))
+            {
+                iIndex.erase(entry->first);
+                discarded.splice(discarded.end(), iEntries, entry);
+            }
+            entry = next;
+        }
+    }
+
+    void glyph_text_cache::insert(const key& aKey, const glyph_text& aGlyphText)
+    {
+        entry_list discarded;
+        std::scoped_lock<std::mutex> lock{ iMutex };
+        if (iCapacity == 0 || iIndex.find(aKey) != iIndex.end())
+            return;
+        iEntries.emplace_front(aKey, aGlyphText);
+        iIndex.emplace(aKey, iEntries.begin());
+        trim(discarded);
+    }
+
+    void glyph_text_cache::trim(entry_list& aDiscarded)
+    {
+        while (iEntries.size() > iCapacity)
+        {
+            iIndex.erase(iEntries.back().first);
+            aDiscarded.splice(aDiscarded.end(), iEntries, std::prev(iEntries.end()));
+        }
+    }
+}
\ No newline at end of file
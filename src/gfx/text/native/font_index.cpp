@@ -0,0 +1,150 @@
+// font_index.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include "font_index.hpp"
+
+namespace neogfx
+{
+    namespace
+    {
+        const std::string sIndexSignature = "neogfx_font_index";
+
+        bool storable(const std::string& aText)
+        {
+            return aText.find_first_of("\t\r\n") == std::string::npos;
+        }
+    }
+
+    font_index::font_index(const std::string& aIndexPath) :
+        iIndexPath{ aIndexPath }, iDirty{ false }
+    {
+        load();
+    }
+
+    const std::string& font_index::index_path() const
+    {
+        return iIndexPath;
+    }
+
+    const font_index::entry* font_index::find(const std::string& aFontPath, uint64_t aFileSize, int64_t aLastWriteTime)
+    {
+        auto existing = iEntries.find(aFontPath);
+        if (existing == iEntries.end() || existing->second.fileSize != aFileSize || existing->second.lastWriteTime != aLastWriteTime)
+            return nullptr;
+        iUsed.insert(aFontPath);
+        return &existing->second;
+    }
+
+    void font_index::update(const std::string& aFontPath, const entry& aEntry)
+    {
+        iEntries[aFontPath] = aEntry;
+        iUsed.insert(aFontPath);
+        iDirty = true;
+    }
+
+    bool font_index::dirty() const
+    {
+        return iDirty || iUsed.size() != iEntries.size();
+    }
+
+    void font_index::save()
+    {
+        boost::filesystem::path const indexPath{ iIndexPath };
+        boost::system::error_code ec;
+        if (indexPath.has_parent_path())
+            boost::filesystem::create_directories(indexPath.parent_path(), ec);
+        auto const temporaryPath = iIndexPath + ".tmp";
+        {
+            std::ofstream output{ temporaryPath, std::ios::out | std::ios::trunc };
+            if (!output)
+                return;
+            output << sIndexSignature << '\t' << Version << '\n';
+            for (auto const& e : iEntries)
+            {
+                // entries for fonts that no longer exist are dropped
+                if (iUsed.find(e.first) == iUsed.end() || !storable(e.first) || !storable(e.second.familyName))
+                    continue;
+                bool styleNamesStorable = true;
+                for (auto const& s : e.second.styles)
+                    styleNamesStorable = styleNamesStorable && storable(s.first.second);
+                if (!styleNamesStorable)
+                    continue;
+                output << "F\t" << e.first << '\t' << e.second.fileSize << '\t' << e.second.lastWriteTime << '\t' << (e.second.isFont ? 1 : 0) << '\t' <<
+                    e.second.faceCount << '\t' << e.second.styles.size() << '\t' << e.second.familyName << '\n';
+                for (auto const& s : e.second.styles)
+                    output << "S\t" << static_cast<uint32_t>(s.first.first) << '\t' << s.second << '\t' << s.first.second << '\n';
+            }
+            if (!output)
+                return;
+        }
+        boost::filesystem::rename(temporaryPath, indexPath, ec);
+        if (!ec)
+            iDirty = false;
+    }
+
+    void font_index::load()
+    {
+        std::ifstream input{ iIndexPath };
+        if (!input)
+            return;
+        std::string line;
+        if (!std::getline(input, line) || line != sIndexSignature + '\t' + std::to_string(Version))
+            return;
+        entry_map entries;
+        while (std::getline(input, line))
+        {
+            std::istringstream fields{ line };
+            std::string tag;
+            std::string path;
+            entry newEntry{};
+            int isFont = 0;
+            std::size_t styleCount = 0;
+            if (!std::getline(fields, tag, '\t') || tag != "F" || !std::getline(fields, path, '\t'))
+                return;
+            fields >> newEntry.fileSize >> newEntry.lastWriteTime >> isFont >> newEntry.faceCount >> styleCount;
+            if (!fields || fields.get() != '\t')
+                return;
+            std::getline(fields, newEntry.familyName);
+            newEntry.isFont = (isFont != 0);
+            for (std::size_t s = 0; s < styleCount; ++s)
+            {
+                if (!std::getline(input, line))
+                    return;
+                std::istringstream styleFields{ line };
+                uint32_t style = 0;
+                FT_Long faceIndex = 0;
+                std::string styleName;
+                if (!std::getline(styleFields, tag, '\t') || tag != "S")
+                    return;
+                styleFields >> style >> faceIndex;
+                if (!styleFields || styleFields.get() != '\t')
+                    return;
+                std::getline(styleFields, styleName);
+                newEntry.styles.emplace(std::make_pair(static_cast<font_style>(style), styleName), faceIndex);
+            }
+            entries.emplace(path, std::move(newEntry));
+        }
+        // only a fully parsed index is used; a truncated or corrupt one is simply rebuilt
+        iEntries = std::move(entries);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+// font_index.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include "native_font.hpp"
+
+namespace neogfx
+{
+    // On-disk cache of font file metadata (family, faces and styles) keyed by path and validated by file size and
+    // modification time so unchanged font files do not have to be opened during font enumeration.
+    class font_index
+    {
+    public:
+        static constexpr uint32_t Version = 1u;
+    public:
+        struct entry
+        {
+            uint64_t fileSize;
+            int64_t lastWriteTime;
+            bool isFont;
+            std::string familyName;
+            FT_Long faceCount;
+            native_font::style_map styles;
+        };
+        typedef std::unordered_map<std::string, entry> entry_map;
+    public:
+        font_index(const std::string& aIndexPath);
+    public:
+        const std::string& index_path() const;
+        const entry* find(const std::string& aFontPath, uint64_t aFileSize, int64_t aLastWriteTime);
+        void update(const std::string& aFontPath, const entry& aEntry);
+        bool dirty() const;
+        void save();
+    private:
+        void load();
+    private:
+        std::string iIndexPath;
+        entry_map iEntries;
+        std::unordered_set<std::string> iUsed;
+        bool iDirty;
+    };
+}
\ No newline at end of file
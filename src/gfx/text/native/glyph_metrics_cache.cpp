@@ -0,0 +1,167 @@
+// glyph_metrics_cache.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include "glyph_metrics_cache.hpp"
+
+namespace neogfx
+{
+    glyph_metrics_cache::glyph_metrics_cache(FT_Long aGlyphCount) :
+        iGlyphCount{ static_cast<glyph_index_t>(std::max<FT_Long>(aGlyphCount, 0)) }, iKerningCount{ 0u }
+    {
+        for (auto& table : iAdvances)
+        {
+            table.inUse = false;
+            table.loadFlags = 0;
+        }
+    }
+
+    glyph_metrics_cache::~glyph_metrics_cache()
+    {
+        for (auto& table : iAdvances)
+            if (table.pages != nullptr)
+                for (std::size_t p = 0; p < page_count(); ++p)
+                    delete table.pages[p].load();
+    }
+
+    bool glyph_metrics_cache::advance(glyph_index_t aGlyph, FT_Int32 aLoadFlags, FT_Fixed& aAdvance) const
+    {
+        if (aGlyph >= iGlyphCount)
+            return false;
+        auto const table = advances(aLoadFlags);
+        if (table == nullptr)
+            return false;
+        auto const page = table->pages[aGlyph >> PageBits].load(std::memory_order_acquire);
+        if (page == nullptr)
+            return false;
+        auto const value = (*page)[aGlyph & (PageSize - 1u)].load(std::memory_order_relaxed);
+        if (value == NotCached)
+            return false;
+        aAdvance = value;
+        return true;
+    }
+
+    void glyph_metrics_cache::set_advance(glyph_index_t aGlyph, FT_Int32 aLoadFlags, FT_Fixed aAdvance)
+    {
+        if (aGlyph >= iGlyphCount || aAdvance <= NotCached || aAdvance > std::numeric_limits<int32_t>::max())
+            return;
+        auto table = advances(aLoadFlags);
+        if (table == nullptr)
+        {
+            std::lock_guard<std::mutex> lock{ iAdvancesMutex };
+            table = advances(aLoadFlags);
+            for (auto candidate = iAdvances.begin(); table == nullptr && candidate != iAdvances.end(); ++candidate)
+                if (!candidate->inUse.load(std::memory_order_relaxed))
+                {
+                    candidate->loadFlags = aLoadFlags;
+                    candidate->pages = std::make_unique<std::atomic<advance_page*>[]>(page_count());
+                    candidate->inUse.store(true, std::memory_order_release);
+                    table = &*candidate;
+                }
+            if (table == nullptr)
+                return; // too many load flag variants; these advances are not cached
+        }
+        auto& slot = table->pages[aGlyph >> PageBits];
+        auto page = slot.load(std::memory_order_acquire);
+        if (page == nullptr)
+        {
+            auto newPage = std::make_unique<advance_page>();
+            for (auto& value : *newPage)
+                value.store(NotCached, std::memory_order_relaxed);
+            advance_page* existing = nullptr;
+            if (slot.compare_exchange_strong(existing, newPage.get(), std::memory_order_acq_rel))
+                page = newPage.release();
+            else
+                page = existing;
+        }
+        (*page)[aGlyph & (PageSize - 1u)].store(static_cast<int32_t>(aAdvance), std::memory_order_relaxed);
+    }
+
+    bool glyph_metrics_cache::kerning(glyph_index_t aLeftGlyph, glyph_index_t aRightGlyph, FT_Pos& aDelta) const
+    {
+        auto const pair = (static_cast<uint64_t>(aLeftGlyph) << 32u) | aRightGlyph;
+        std::shared_lock<std::shared_mutex> lock{ iKerningMutex };
+        if (iKerning.empty())
+            return false;
+        for (auto slot = kerning_slot(pair, iKerning.size());; slot = (slot + 1u) & (iKerning.size() - 1u))
+        {
+            auto const& entry = iKerning[slot];
+            if (entry.pair == pair)
+            {
+                aDelta = entry.delta;
+                return true;
+            }
+            if (entry.pair == EmptyPair)
+                return false;
+        }
+    }
+
+    void glyph_metrics_cache::set_kerning(glyph_index_t aLeftGlyph, glyph_index_t aRightGlyph, FT_Pos aDelta)
+    {
+        auto const pair = (static_cast<uint64_t>(aLeftGlyph) << 32u) | aRightGlyph;
+        std::unique_lock<std::shared_mutex> lock{ iKerningMutex };
+        // keep the load factor at or below 3/4
+        if ((iKerningCount + 1u) * 4u > iKerning.size() * 3u)
+        {
+            std::vector<kerning_entry> grown(std::max(MinimumKerningCapacity, iKerning.size() * 2u), kerning_entry{ EmptyPair, 0 });
+            for (auto const& entry : iKerning)
+                if (entry.pair != EmptyPair)
+                    insert_kerning(grown, entry.pair, entry.delta);
+            iKerning.swap(grown);
+        }
+        if (insert_kerning(iKerning, pair, aDelta))
+            ++iKerningCount;
+    }
+
+    std::size_t glyph_metrics_cache::page_count() const
+    {
+        return (static_cast<std::size_t>(iGlyphCount) + PageSize - 1u) / PageSize;
+    }
+
+    glyph_metrics_cache::advance_table* glyph_metrics_cache::advances(FT_Int32 aLoadFlags) const
+    {
+        for (auto& table : iAdvances)
+        {
+            if (!table.inUse.load(std::memory_order_acquire))
+                break;
+            if (table.loadFlags == aLoadFlags)
+                return &table;
+        }
+        return nullptr;
+    }
+
+    std::size_t glyph_metrics_cache::kerning_slot(uint64_t aPair, std::size_t aCapacity)
+    {
+        return static_cast<std::size_t>((aPair * 0x9E3779B97F4A7C15ull) >> 32u) & (aCapacity - 1u);
+    }
+
+    bool glyph_metrics_cache::insert_kerning(std::vector<kerning_entry>& aTable, uint64_t aPair, FT_Pos aDelta)
+    {
+        for (auto slot = kerning_slot(aPair, aTable.size());; slot = (slot + 1u) & (aTable.size() - 1u))
+        {
+            auto& entry = aTable[slot];
+            if (entry.pair == aPair || entry.pair == EmptyPair)
+            {
+                bool const added = (entry.pair == EmptyPair);
+                entry = kerning_entry{ aPair, aDelta };
+                return added;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+// glyph_metrics_cache.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace neogfx
+{
+    // Per-face cache of glyph advances and kerning pairs filled on first use. Advances are stored in pages of atomics
+    // indexed by glyph index (one set of pages for each distinct set of FreeType load flags) so lookups are lock free;
+    // kerning pairs are held in an open addressing hash table guarded by a reader/writer lock. All operations are safe
+    // to call concurrently.
+    class glyph_metrics_cache
+    {
+    public:
+        typedef FT_UInt glyph_index_t;
+    public:
+        static constexpr uint32_t PageBits = 8u;
+        static constexpr uint32_t PageSize = 1u << PageBits;
+        static constexpr std::size_t MaxLoadFlagVariants = 4u;
+    private:
+        static constexpr int32_t NotCached = std::numeric_limits<int32_t>::min();
+        static constexpr uint64_t EmptyPair = ~0ull;
+        static constexpr std::size_t MinimumKerningCapacity = 64u;
+        typedef std::array<std::atomic<int32_t>, PageSize> advance_page;
+        struct advance_table
+        {
+            std::atomic<bool> inUse;
+            FT_Int32 loadFlags;
+            std::unique_ptr<std::atomic<advance_page*>[]> pages;
+        };
+        struct kerning_entry
+        {
+            uint64_t pair;
+            FT_Pos delta;
+        };
+    public:
+        glyph_metrics_cache(FT_Long aGlyphCount);
+        ~glyph_metrics_cache();
+    public:
+        bool advance(glyph_index_t aGlyph, FT_Int32 aLoadFlags, FT_Fixed& aAdvance) const;
+        void set_advance(glyph_index_t aGlyph, FT_Int32 aLoadFlags, FT_Fixed aAdvance);
+        bool kerning(glyph_index_t aLeftGlyph, glyph_index_t aRightGlyph, FT_Pos& aDelta) const;
+        void set_kerning(glyph_index_t aLeftGlyph, glyph_index_t aRightGlyph, FT_Pos aDelta);
+    private:
+        std::size_t page_count() const;
+        advance_table* advances(FT_Int32 aLoadFlags) const;
+        static std::size_t kerning_slot(uint64_t aPair, std::size_t aCapacity);
+        static bool insert_kerning(std::vector<kerning_entry>& aTable, uint64_t aPair, FT_Pos aDelta);
+    private:
+        glyph_index_t iGlyphCount;
+        mutable std::array<advance_table, MaxLoadFlagVariants> iAdvances;
+        std::mutex iAdvancesMutex;
+        mutable std::shared_mutex iKerningMutex;
+        std::vector<kerning_entry> iKerning;
+        std::size_t iKerningCount;
+    };
+}
\ No newline at end of file
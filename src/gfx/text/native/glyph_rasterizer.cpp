@@ -0,0 +1,313 @@
+// glyph_rasterizer.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include "native_font_face.hpp"
+#include "glyph_rasterizer.hpp"
+
+namespace neogfx
+{
+    glyph_pixel_mode to_glyph_pixel_mode(unsigned char aFreeTypePixelMode)
+    {
+        switch (aFreeTypePixelMode)
+        {
+        default:
+        case FT_PIXEL_MODE_NONE:
+            return glyph_pixel_mode::None;
+        case FT_PIXEL_MODE_MONO:
+            return glyph_pixel_mode::Mono;
+        case FT_PIXEL_MODE_GRAY:
+            return glyph_pixel_mode::Gray;
+        case FT_PIXEL_MODE_GRAY2:
+            return glyph_pixel_mode::Gray2Bit;
+        case FT_PIXEL_MODE_GRAY4:
+            return glyph_pixel_mode::Gray4Bit;
+        case FT_PIXEL_MODE_LCD:
+            return glyph_pixel_mode::LCD;
+        case FT_PIXEL_MODE_LCD_V:
+            return glyph_pixel_mode::LCD_V;
+        case FT_PIXEL_MODE_BGRA:
+            return glyph_pixel_mode::BGRA;
+        }
+    }
+
+    void rasterize_glyph(FT_Face aFace, FT_UInt aGlyphIndex, glyph_bitmap& aResult)
+    {
+        try
+        {
+            freetypeCheck(FT_Load_Glyph(aFace, aGlyphIndex, FT_LOAD_TARGET_LCD | FT_LOAD_NO_BITMAP));
+        }
+        catch (freetype_error fe)
+        {
+            std::cerr << "neogfx: warning: Cannot load font glyph" << std::endl;
+            throw native_font_face::freetype_load_glyph_error(fe.what());
+        }
+        try
+        {
+            freetypeCheck(FT_Render_Glyph(aFace->glyph, FT_RENDER_MODE_LCD));
+        }
+        catch (freetype_error fe)
+        {
+            std::cerr << "neogfx: warning: Cannot render font glyph" << std::endl;
+            throw native_font_face::freetype_render_glyph_error(fe.what());
+        }
+
+        FT_Bitmap const& bitmap = aFace->glyph->bitmap;
+
+        aResult.pixelMode = to_glyph_pixel_mode(bitmap.pixel_mode);
+        aResult.subpixel = (aResult.pixelMode == glyph_pixel_mode::LCD);
+        aResult.extents = size_u32{ bitmap.width / (aResult.subpixel ? 3u : 1u), bitmap.rows };
+        aResult.placement = point{
+            aFace->glyph->metrics.horiBearingX / 64.0,
+            (aFace->glyph->metrics.horiBearingY - aFace->glyph->metrics.height) / 64.0 };
+
+        std::size_t const stride = aResult.extents.cx;
+        aResult.data.assign(stride * aResult.extents.cy * (aResult.subpixel ? 4u : 1u), 0x00);
+
+        if (aResult.subpixel)
+        {
+            // sub-pixel FIR filter.
+            static double coefficients[] = { 0.5 / 16.0, 4.0 / 16.0, 7.0 / 16.0, 4.0 / 16.0, 0.5 / 16.0 };
+            for (uint32_t y = 0; y < bitmap.rows; y++)
+            {
+                for (uint32_t x = 0; x < bitmap.width; x++)
+                {
+                    uint8_t alpha = 0;
+                    for (int32_t z = -2; z <= 2; ++z)
+                        alpha += static_cast<uint8_t>(bitmap.buffer[std::max(0, std::min<int32_t>(bitmap.width - 1, x + z)) + bitmap.pitch * y] * coefficients[z + 2]);
+                    aResult.data[((x / 3) + (bitmap.rows - 1 - y) * stride) * 4u + x % 3] = alpha;
+                }
+            }
+        }
+        else
+        {
+            for (uint32_t y = 0; y < bitmap.rows; y++)
+                switch (bitmap.pixel_mode)
+                {
+                case FT_PIXEL_MODE_MONO: // 1 bit per pixel monochrome
+                    for (uint32_t x = 0; x < bitmap.width; x += 8)
+                        for (uint32_t b = 0; b < std::min(bitmap.width - x, 8u); ++b)
+                            aResult.data[(x + b) + (bitmap.rows - 1 - y) * stride] =
+                                ((bitmap.buffer[x / 8 + bitmap.pitch * y] & (1 << (7 - b))) != 0 ? 0xFF : 0x00);
+                    break;
+                case FT_PIXEL_MODE_GRAY:
+                default:
+                    for (uint32_t x = 0; x < bitmap.width; x++)
+                        aResult.data[x + (bitmap.rows - 1 - y) * stride] = bitmap.buffer[x + bitmap.pitch * y];
+                    break;
+                }
+        }
+    }
+
+    glyph_rasterizer::face_queue::face_queue(const face_source& aSource) :
+        iSource{ aSource }, iCancelled{ false }
+    {
+    }
+
+    const glyph_rasterizer::face_source& glyph_rasterizer::face_queue::source() const
+    {
+        return iSource;
+    }
+
+    bool glyph_rasterizer::face_queue::cancelled() const
+    {
+        return iCancelled;
+    }
+
+    void glyph_rasterizer::face_queue::cancel()
+    {
+        // waits for any glyph of this face currently being rasterized as the font data may be about to be released
+        std::lock_guard<std::mutex> rasterizing{ iRasterizeMutex };
+        iCancelled = true;
+        std::lock_guard<std::mutex> lock{ iMutex };
+        iPending.clear();
+        iReady.clear();
+        iFailed.clear();
+    }
+
+    std::optional<glyph_rasterizer::result> glyph_rasterizer::face_queue::take(glyph_index_t aGlyph)
+    {
+        std::lock_guard<std::mutex> lock{ iMutex };
+        auto existing = iReady.find(aGlyph);
+        if (existing == iReady.end())
+            return {};
+        std::optional<result> taken{ std::move(existing->second) };
+        iReady.erase(existing);
+        return taken;
+    }
+
+    void glyph_rasterizer::face_queue::discard(glyph_index_t aGlyph)
+    {
+        std::lock_guard<std::mutex> lock{ iMutex };
+        iPending.erase(aGlyph);
+        iReady.erase(aGlyph);
+    }
+
+    bool glyph_rasterizer::face_queue::request(glyph_index_t aGlyph, bool aUrgent, bool& aQueue)
+    {
+        std::lock_guard<std::mutex> lock{ iMutex };
+        aQueue = false;
+        if (iReady.find(aGlyph) != iReady.end() || iFailed.find(aGlyph) != iFailed.end())
+            return true;
+        auto existing = iPending.find(aGlyph);
+        if (existing != iPending.end())
+            existing->second = existing->second || aUrgent;
+        else
+        {
+            iPending.emplace(aGlyph, aUrgent);
+            aQueue = true;
+        }
+        return false;
+    }
+
+    bool glyph_rasterizer::face_queue::complete(glyph_index_t aGlyph, result&& aResult)
+    {
+        std::lock_guard<std::mutex> lock{ iMutex };
+        auto existing = iPending.find(aGlyph);
+        if (existing == iPending.end())
+            return false; // discarded (rasterized synchronously in the meantime)
+        bool const urgent = existing->second;
+        iPending.erase(existing);
+        // a failure is remembered rather than handed over so that the glyph is not queued again every frame
+        if (aResult != std::nullopt)
+            iReady[aGlyph] = std::move(aResult);
+        else
+            iFailed.insert(aGlyph);
+        return urgent;
+    }
+
+    glyph_rasterizer::glyph_rasterizer(uint32_t aThreadCount) :
+        iStopping{ false }, iRedrawNeeded{ false }
+    {
+        for (uint32_t t = 0; t < std::max(aThreadCount, 1u); ++t)
+            iThreads.emplace_back([this]() { work(); });
+    }
+
+    glyph_rasterizer::~glyph_rasterizer()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ iMutex };
+            iStopping = true;
+        }
+        iWork.notify_all();
+        for (auto& t : iThreads)
+            t.join();
+    }
+
+    uint32_t glyph_rasterizer::default_thread_count()
+    {
+        // leave a core for the thread doing the rendering; a few threads are enough to keep up with text
+        auto const hardwareThreads = std::thread::hardware_concurrency();
+        return std::max(1u, std::min(4u, hardwareThreads > 1u ? hardwareThreads - 1u : 1u));
+    }
+
+    std::shared_ptr<glyph_rasterizer::face_queue> glyph_rasterizer::create_queue(const face_source& aSource)
+    {
+        return std::make_shared<face_queue>(aSource);
+    }
+
+    bool glyph_rasterizer::request(const std::shared_ptr<face_queue>& aQueue, glyph_index_t aGlyph, bool aUrgent)
+    {
+        bool queue = false;
+        if (aQueue->request(aGlyph, aUrgent, queue))
+            return true;
+        if (queue)
+        {
+            {
+                std::lock_guard<std::mutex> lock{ iMutex };
+                if (aUrgent)
+                    iJobs.push_front(job{ aQueue, aGlyph });
+                else
+                    iJobs.push_back(job{ aQueue, aGlyph });
+            }
+            iWork.notify_one();
+        }
+        return false;
+    }
+
+    bool glyph_rasterizer::redraw_needed()
+    {
+        return iRedrawNeeded.exchange(false);
+    }
+
+    void glyph_rasterizer::work()
+    {
+        FT_Library library = nullptr;
+        if (FT_Init_FreeType(&library) != FT_Err_Ok)
+            library = nullptr;
+        std::unordered_map<std::shared_ptr<face_queue>, FT_Face> faces;
+        for (;;)
+        {
+            job next;
+            {
+                std::unique_lock<std::mutex> lock{ iMutex };
+                iWork.wait(lock, [this]() { return iStopping || !iJobs.empty(); });
+                if (iStopping)
+                    break;
+                next = std::move(iJobs.front());
+                iJobs.pop_front();
+            }
+            for (auto f = faces.begin(); f != faces.end();)
+                if (f->first->cancelled())
+                {
+                    FT_Done_Face(f->second);
+                    f = faces.erase(f);
+                }
+                else
+                    ++f;
+            auto& queue = *next.queue;
+            std::lock_guard<std::mutex> rasterizing{ queue.iRasterizeMutex };
+            if (queue.cancelled())
+                continue;
+            result bitmap;
+            try
+            {
+                if (library == nullptr)
+                    throw freetype_error("neoGFX FreeType error: cannot initialize glyph rasterizer");
+                auto face = faces.find(next.queue);
+                if (face == faces.end())
+                {
+                    auto const& source = queue.source();
+                    FT_Face newFace = nullptr;
+                    freetypeCheck(FT_New_Memory_Face(library, source.data, source.dataSize, source.faceIndex, &newFace));
+                    auto const sizeError = FT_Set_Char_Size(newFace, 0, source.charSize, source.horizontalDpi, source.verticalDpi);
+                    if (sizeError != FT_Err_Ok)
+                    {
+                        FT_Done_Face(newFace);
+                        freetypeCheck(sizeError);
+                    }
+                    face = faces.emplace(next.queue, newFace).first;
+                }
+                bitmap.emplace();
+                rasterize_glyph(face->second, next.glyph, *bitmap);
+            }
+            catch (...)
+            {
+                // the glyph is left for the synchronous path which substitutes a replacement glyph
+                bitmap = std::nullopt;
+            }
+            if (queue.complete(next.glyph, std::move(bitmap)))
+                iRedrawNeeded = true;
+        }
+        for (auto const& f : faces)
+            FT_Done_Face(f.second);
+        if (library != nullptr)
+            FT_Done_FreeType(library);
+    }
+}
\ No newline at end of file
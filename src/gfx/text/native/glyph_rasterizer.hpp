@@ -0,0 +1,120 @@
+// glyph_rasterizer.hpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <neogfx/core/geometrical.hpp>
+#include <neogfx/gfx/text/i_glyph_texture.hpp>
+
+namespace neogfx
+{
+    // A rendered glyph ready to be uploaded into the glyph atlas; rows are stored bottom up with four bytes per texel
+    // if the glyph is sub-pixel filtered and one byte per texel otherwise.
+    struct glyph_bitmap
+    {
+        size_u32 extents;
+        point placement;
+        glyph_pixel_mode pixelMode;
+        bool subpixel;
+        std::vector<uint8_t> data;
+    };
+
+    glyph_pixel_mode to_glyph_pixel_mode(unsigned char aFreeTypePixelMode);
+    // Loads and renders a glyph of an already sized face; the face must not be in use by any other thread.
+    void rasterize_glyph(FT_Face aFace, FT_UInt aGlyphIndex, glyph_bitmap& aResult);
+
+    // Rasterizes glyphs on worker threads, each with its own FreeType library and faces, so that font creation
+    // (pre-warming) and drawing text containing new glyphs do not have to wait for FreeType. Finished bitmaps are
+    // collected from a per-face queue by the thread that owns the glyph atlas which does the upload.
+    class glyph_rasterizer
+    {
+    public:
+        typedef FT_UInt glyph_index_t;
+        typedef std::optional<glyph_bitmap> result; // std::nullopt if the glyph could not be rasterized
+        struct face_source
+        {
+            const FT_Byte* data;
+            FT_Long dataSize;
+            FT_Long faceIndex;
+            FT_F26Dot6 charSize;
+            FT_UInt horizontalDpi;
+            FT_UInt verticalDpi;
+        };
+        class face_queue
+        {
+            friend class glyph_rasterizer;
+        public:
+            face_queue(const face_source& aSource);
+        public:
+            const face_source& source() const;
+            bool cancelled() const;
+            void cancel();
+            std::optional<result> take(glyph_index_t aGlyph);
+            void discard(glyph_index_t aGlyph);
+        private:
+            bool request(glyph_index_t aGlyph, bool aUrgent, bool& aQueue);
+            bool complete(glyph_index_t aGlyph, result&& aResult);
+        private:
+            face_source iSource;
+            std::atomic<bool> iCancelled;
+            std::mutex iMutex;
+            std::mutex iRasterizeMutex;
+            std::unordered_map<glyph_index_t, bool> iPending;
+            std::unordered_map<glyph_index_t, result> iReady;
+            std::unordered_set<glyph_index_t> iFailed;
+        };
+    private:
+        struct job
+        {
+            std::shared_ptr<face_queue> queue;
+            glyph_index_t glyph;
+        };
+    public:
+        glyph_rasterizer(uint32_t aThreadCount = default_thread_count());
+        ~glyph_rasterizer();
+    public:
+        static uint32_t default_thread_count();
+        std::shared_ptr<face_queue> create_queue(const face_source& aSource);
+        // Returns true if the glyph has already been rasterized (or could not be, in which case it is left to the
+        // synchronous path) otherwise queues it (if not already queued); urgent requests (glyphs waiting to be drawn)
+        // jump the queue and cause redraw_needed() to be set on completion.
+        bool request(const std::shared_ptr<face_queue>& aQueue, glyph_index_t aGlyph, bool aUrgent);
+        // Returns (and clears) whether an urgent request has completed since the last call.
+        bool redraw_needed();
+    private:
+        void work();
+    private:
+        std::mutex iMutex;
+        std::condition_variable iWork;
+        std::deque<job> iJobs;
+        bool iStopping;
+        std::atomic<bool> iRedrawNeeded;
+        std::vector<std::thread> iThreads;
+    };
+}
\ No newline at end of file
@@ -67,5 +67,7 @@ namespace neogfx
         virtual void* aux_handle() const = 0;
         virtual glyph_index_t glyph_index(char32_t aCodePoint) const = 0;
         virtual i_glyph_texture& glyph_texture(const glyph& aGlyph) const = 0;
+        virtual bool glyph_texture_ready(const glyph& aGlyph) const = 0;
+        virtual i_glyph_texture& glyph_distance_field(const glyph& aGlyph) const = 0;
     };
 }
\ No newline at end of file
@@ -35,6 +35,12 @@ namespace neogfx
         iCache.shrink_to_fit();
     }
 
+    native_font::native_font(FT_Library aFontLib, const std::string aFileName, const std::string& aFamilyName, FT_Long aFaceCount, const style_map& aStyles) :
+        iFontLib(aFontLib), iSource(filename_type(aFileName)), iCache{}, iFamilyName(aFamilyName), iFaceCount(aFaceCount), iStyleMap(aStyles)
+    {
+        // constructed from previously indexed metadata: the file is not opened until a face is created
+    }
+
     native_font::native_font(FT_Library aFontLib, const void* aData, std::size_t aSizeInBytes) :
         iFontLib(aFontLib), iSource(memory_block_type(aData, aSizeInBytes)), iCache{}, iFaceCount(0)
     {
@@ -75,6 +81,16 @@ namespace neogfx
         return std::next(iStyleMap.begin(), aStyleIndex)->first.second;
     }
 
+    FT_Long native_font::face_count() const
+    {
+        return iFaceCount;
+    }
+
+    const native_font::style_map& native_font::styles() const
+    {
+        return iStyleMap;
+    }
+
     namespace
     {
         uint32_t matching_bits(uint32_t lhs, uint32_t rhs)
@@ -35,15 +35,16 @@ namespace neogfx
     public:
         typedef std::string filename_type;
         typedef std::pair<const void*, std::size_t> memory_block_type;
+        typedef std::map<std::pair<font_style, std::string>, FT_Long> style_map;
     private:
         typedef neolib::variant<filename_type, memory_block_type> source_type;
-        typedef std::map<std::pair<font_style, std::string>, FT_Long> style_map;
         typedef std::map<std::tuple<FT_Long, font::point_size, size>, ref_ptr<i_native_font_face>> face_map;
     public:
         struct failed_to_load_font : std::runtime_error { failed_to_load_font() : std::runtime_error("neogfx::native_font::failed_to_load_font") {} };
         struct no_matching_style_found : std::runtime_error { no_matching_style_found() : std::runtime_error("neogfx::native_font::no_matching_style_found") {} };
     public:
         native_font(FT_Library aFontLib, const std::string aFileName);
+        native_font(FT_Library aFontLib, const std::string aFileName, const std::string& aFamilyName, FT_Long aFaceCount, const style_map& aStyles);
         native_font(FT_Library aFontLib, const void* aData, std::size_t aSizeInBytes);
         ~native_font();
     public:
@@ -54,6 +55,9 @@ namespace neogfx
         const std::string& style_name(uint32_t aStyleIndex) const override;
         void create_face(font_style aStyle, font::point_size aSize, const i_device_resolution& aDevice, i_ref_ptr<i_native_font_face>& aResult) override;
         void create_face(const std::string& aStyleName, font::point_size aSize, const i_device_resolution& aDevice, i_ref_ptr<i_native_font_face>& aResult) override;
+    public:
+        FT_Long face_count() const;
+        const style_map& styles() const;
     private:
         void register_face(FT_Long aFaceIndex);
         FT_Face open_face(FT_Long aFaceIndex);
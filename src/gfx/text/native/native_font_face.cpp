@@ -19,7 +19,6 @@
 
 #include <neogfx/neogfx.hpp>
 #include <unordered_map>
-#include <boost/functional/hash.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
@@ -38,29 +37,27 @@ namespace neogfx
 {
     namespace
     {
-        typedef std::unordered_map<std::pair<FT_UInt, FT_Int32>, FT_Fixed, boost::hash<std::pair<FT_UInt, FT_Int32>>> get_advance_cache_face;
-        typedef std::unordered_map<FT_Face, get_advance_cache_face> get_advance_cache;
-        get_advance_cache sGetAdvanceCache;
-
         extern "C"
         {
             FT_EXPORT(FT_Error) orig_FT_Get_Advance(FT_Face face, FT_UInt gindex, FT_Int32 load_flags, FT_Fixed* padvance);
         }
 
+        // faces created by native_font_face carry their metrics cache in the (client reserved) generic field of their size
+        glyph_metrics_cache* metrics_cache(FT_Face aFace)
+        {
+            return aFace->size != nullptr ? static_cast<glyph_metrics_cache*>(aFace->size->generic.data) : nullptr;
+        }
+
         FT_Error neogfx_FT_Get_Advance(FT_Face face, FT_UInt gindex, FT_Int32 load_flags, FT_Fixed* padvance)
         {
-            auto cachedFace = sGetAdvanceCache.find(face);
-            if (cachedFace != sGetAdvanceCache.end())
+            auto cache = metrics_cache(face);
+            if (cache != nullptr)
             {
-                auto entry = cachedFace->second.find(std::make_pair(gindex, load_flags));
-                if (entry != cachedFace->second.end())
-                {
-                    *padvance = entry->second;
+                if (cache->advance(gindex, load_flags, *padvance))
                     return FT_Err_Ok;
-                }
                 auto result = orig_FT_Get_Advance(face, gindex, load_flags, padvance);
                 if (result == FT_Err_Ok)
-                    cachedFace->second[std::make_pair(gindex, load_flags)] = *padvance;
+                    cache->set_advance(gindex, load_flags, *padvance);
                 return result;
             }
             auto result = orig_FT_Get_Advance(face, gindex, load_flags, padvance);
@@ -75,19 +72,125 @@ namespace neogfx
                 return neogfx_FT_Get_Advance(face, gindex, load_flags, padvance);
             }
         }
+
+        // one dimensional squared Euclidean distance transform (Felzenszwalb and Huttenlocher)
+        void squared_distance_transform(const float* aInput, float* aOutput, std::size_t aCount, std::size_t aStride, std::vector<float>& aSamples, std::vector<int32_t>& aParabolas, std::vector<float>& aBoundaries)
+        {
+            auto const n = static_cast<int32_t>(aCount);
+            aSamples.resize(aCount);
+            aParabolas.resize(aCount);
+            aBoundaries.resize(aCount + 1u);
+            for (int32_t q = 0; q < n; ++q)
+                aSamples[q] = aInput[q * aStride];
+            int32_t k = 0;
+            aParabolas[0] = 0;
+            aBoundaries[0] = -std::numeric_limits<float>::infinity();
+            aBoundaries[1] = std::numeric_limits<float>::infinity();
+            for (int32_t q = 1; q < n; ++q)
+            {
+                float s = 0.0f;
+                for (;;)
+                {
+                    auto const p = aParabolas[k];
+                    s = ((aSamples[q] + q * q) - (aSamples[p] + p * p)) / (2.0f * (q - p));
+                    if (s > aBoundaries[k] || k == 0)
+                        break;
+                    --k;
+                }
+                if (s <= aBoundaries[k])
+                    s = aBoundaries[k];
+                ++k;
+                aParabolas[k] = q;
+                aBoundaries[k] = s;
+                aBoundaries[k + 1] = std::numeric_limits<float>::infinity();
+            }
+            k = 0;
+            for (int32_t q = 0; q < n; ++q)
+            {
+                while (aBoundaries[k + 1] < q)
+                    ++k;
+                auto const p = aParabolas[k];
+                aOutput[q * aStride] = (q - p) * (q - p) + aSamples[p];
+            }
+        }
+
+        // squared distance of each pixel to the nearest seed pixel (seeds are zero, everything else is infinite on input)
+        void squared_distance_transform(std::vector<float>& aField, std::size_t aWidth, std::size_t aHeight)
+        {
+            thread_local std::vector<float> samples;
+            thread_local std::vector<int32_t> parabolas;
+            thread_local std::vector<float> boundaries;
+            for (std::size_t x = 0; x < aWidth; ++x)
+                squared_distance_transform(&aField[x], &aField[x], aHeight, aWidth, samples, parabolas, boundaries);
+            for (std::size_t y = 0; y < aHeight; ++y)
+                squared_distance_transform(&aField[y * aWidth], &aField[y * aWidth], aWidth, 1u, samples, parabolas, boundaries);
+        }
+
+        // Converts an 8-bit coverage bitmap into a distance field padded by aSpread pixels on each side; each texel stores
+        // 0.5 + d / (2 * aSpread) where d is the signed distance (positive inside) to the glyph edge. Rows are flipped to
+        // match the glyph texture layout.
+        void coverage_to_distance_field(const FT_Bitmap& aBitmap, uint32_t aSpread, std::vector<GLubyte>& aOutput)
+        {
+            std::size_t const width = aBitmap.width + aSpread * 2u;
+            std::size_t const height = aBitmap.rows + aSpread * 2u;
+            thread_local std::vector<float> coverage;
+            thread_local std::vector<float> toInside;
+            thread_local std::vector<float> toOutside;
+            coverage.assign(width * height, 0.0f);
+            for (uint32_t y = 0; y < aBitmap.rows; ++y)
+                for (uint32_t x = 0; x < aBitmap.width; ++x)
+                    coverage[(x + aSpread) + (y + aSpread) * width] = (aBitmap.pixel_mode == FT_PIXEL_MODE_MONO ?
+                        ((aBitmap.buffer[x / 8 + aBitmap.pitch * y] & (1 << (7 - x % 8))) != 0 ? 1.0f : 0.0f) :
+                        aBitmap.buffer[x + aBitmap.pitch * y] / 255.0f);
+            float const infinity = static_cast<float>(width * width + height * height);
+            toInside.resize(coverage.size());
+            toOutside.resize(coverage.size());
+            for (std::size_t i = 0; i < coverage.size(); ++i)
+            {
+                toInside[i] = (coverage[i] >= 0.5f ? 0.0f : infinity);
+                toOutside[i] = (coverage[i] < 0.5f ? 0.0f : infinity);
+            }
+            squared_distance_transform(toInside, width, height);
+            squared_distance_transform(toOutside, width, height);
+            aOutput.resize(width * height);
+            for (std::size_t y = 0; y < height; ++y)
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    auto const i = x + y * width;
+                    float distance = 0.0f;
+                    if (coverage[i] > 0.0f && coverage[i] < 1.0f)
+                        distance = coverage[i] - 0.5f; // anti-aliased edge pixel: coverage gives a sub-pixel estimate
+                    else if (coverage[i] >= 0.5f)
+                        distance = std::sqrt(toOutside[i]) - 0.5f;
+                    else
+                        distance = 0.5f - std::sqrt(toInside[i]);
+                    auto const value = std::max(0.0f, std::min(1.0f, 0.5f + distance / (2.0f * aSpread)));
+                    aOutput[x + (height - 1u - y) * width] = static_cast<GLubyte>(value * 255.0f + 0.5f);
+                }
+        }
     }
 
     native_font_face::native_font_face(font_id aId, i_native_font& aFont, font_style aStyle, font::point_size aSize, neogfx::size aDpiResolution, FT_Face aHandle) :
         iId{ aId }, iFont{ aFont }, iStyle{ aStyle }, iStyleName{ aHandle->style_name }, iSize{ aSize }, iPixelDensityDpi{ aDpiResolution }, iHandle{ aHandle }, iHasKerning{ !!FT_HAS_KERNING(iHandle) }
     {
         set_metrics();
-        sGetAdvanceCache[iHandle] = get_advance_cache_face{};
+        create_metrics_cache();
+        create_rasterizer_queue();
     }
 
     native_font_face::~native_font_face()
     {
-        if (iHandle != nullptr)
-            sGetAdvanceCache.erase(sGetAdvanceCache.find(iHandle));
+        cancel_rasterizer_queue();
+        release_glyph_textures(iGlyphs);
+        release_glyph_textures(iGlyphDistanceFields);
+        if (iInvalidGlyph != std::nullopt)
+        {
+            auto& glyphAtlas = service<i_font_manager>().glyph_atlas();
+            if (glyphAtlas.has_sub_texture(iInvalidGlyph->texture().atlas_id()))
+                glyphAtlas.destroy_sub_texture(glyphAtlas.sub_texture(iInvalidGlyph->texture().atlas_id()));
+        }
+        destroy_metrics_cache();
+        service<i_font_manager>().glyph_text_cache().invalidate(id());
         FT_Done_Face(iHandle);
         if (iFallbackFont != nullptr)
             iFallbackFont->release();
@@ -177,12 +280,13 @@ namespace neogfx
     {
         if (!iHasKerning)
             return 0.0;
-        auto existing = iKerningTable.find(std::make_pair(aLeftGlyphIndex, aRightGlyphIndex));
-        if (existing != iKerningTable.end())
-            return existing->second;
+        FT_Pos cached;
+        if (iMetricsCache->kerning(aLeftGlyphIndex, aRightGlyphIndex, cached))
+            return cached / 64.0;
         FT_Vector delta;
         freetypeCheck(FT_Get_Kerning(iHandle, aLeftGlyphIndex, aRightGlyphIndex, FT_KERNING_DEFAULT, &delta));
-        return (iKerningTable[std::make_pair(aLeftGlyphIndex, aRightGlyphIndex)] = delta.x / 64.0);
+        iMetricsCache->set_kerning(aLeftGlyphIndex, aRightGlyphIndex, delta.x);
+        return delta.x / 64.0;
     }
 
     bool native_font_face::is_bitmap_font() const
@@ -230,14 +334,16 @@ namespace neogfx
 
     void native_font_face::update_handle(void* aHandle) 
     { 
-        if (iHandle != nullptr)
-            sGetAdvanceCache.erase(sGetAdvanceCache.find(iHandle));
+        cancel_rasterizer_queue();
+        destroy_metrics_cache();
         iHandle = static_cast<FT_Face>(aHandle);
-        if (iHandle != nullptr)
-            sGetAdvanceCache[iHandle] = get_advance_cache_face{};
         iAuxHandle.reset();
         if (iHandle != nullptr)
+        {
             set_metrics();
+            create_metrics_cache();
+            create_rasterizer_queue();
+        }
     }
 
     void* native_font_face::aux_handle() const
@@ -252,55 +358,26 @@ namespace neogfx
         return FT_Get_Char_Index(iHandle, aCodePoint);
     }
 
-    inline glyph_pixel_mode to_glyph_pixel_mode(unsigned char aFreeTypePixelMode)
-    {
-        switch (aFreeTypePixelMode)
-        {
-        default:
-        case FT_PIXEL_MODE_NONE:
-            return glyph_pixel_mode::None;
-        case FT_PIXEL_MODE_MONO:
-            return glyph_pixel_mode::Mono;
-        case FT_PIXEL_MODE_GRAY:
-            return glyph_pixel_mode::Gray;
-        case FT_PIXEL_MODE_GRAY2:
-            return glyph_pixel_mode::Gray2Bit;
-        case FT_PIXEL_MODE_GRAY4:
-            return glyph_pixel_mode::Gray4Bit;
-        case FT_PIXEL_MODE_LCD:
-            return glyph_pixel_mode::LCD;
-        case FT_PIXEL_MODE_LCD_V:
-            return glyph_pixel_mode::LCD_V;
-        case FT_PIXEL_MODE_BGRA:
-            return glyph_pixel_mode::BGRA;
-        }
-    }
-         
     i_glyph_texture& native_font_face::glyph_texture(const glyph& aGlyph) const
     {
         auto existingGlyph = iGlyphs.find(aGlyph.value());
         if (existingGlyph != iGlyphs.end())
+        {
+            service<i_font_manager>().glyph_atlas().touch(existingGlyph->second.texture());
             return existingGlyph->second;
+        }
+        if (iRasterizerQueue != nullptr)
+        {
+            // upload a bitmap rasterized in the background if there is one otherwise rasterize now
+            auto rasterized = iRasterizerQueue->take(aGlyph.value());
+            if (rasterized != std::nullopt && *rasterized != std::nullopt)
+                return upload_glyph_texture(aGlyph, **rasterized);
+            iRasterizerQueue->discard(aGlyph.value());
+        }
+        thread_local glyph_bitmap bitmap;
         try
         {
-            try
-            {
-                freetypeCheck(FT_Load_Glyph(iHandle, aGlyph.value(), FT_LOAD_TARGET_LCD | FT_LOAD_NO_BITMAP));
-            }
-            catch (freetype_error fe)
-            {
-                std::cerr << "neogfx: warning: Cannot load font glyph" << std::endl;
-                throw freetype_load_glyph_error(fe.what());
-            }
-            try
-            {
-                freetypeCheck(FT_Render_Glyph(iHandle->glyph, FT_RENDER_MODE_LCD));
-            }
-            catch (freetype_error fe)
-            {
-                std::cerr << "neogfx: warning: Cannot render font glyph" << std::endl;
-                throw freetype_render_glyph_error(fe.what());
-            }
+            rasterize_glyph(iHandle, aGlyph.value(), bitmap);
         }
         catch (...)
         {
@@ -331,79 +408,134 @@ namespace neogfx
             return *iInvalidGlyph;
         }
 
-        bool useSubpixelFiltering = true;
+        return upload_glyph_texture(aGlyph, bitmap);
+    }
 
-        FT_Bitmap& bitmap = iHandle->glyph->bitmap;
+    bool native_font_face::glyph_texture_ready(const glyph& aGlyph) const
+    {
+        if (iRasterizerQueue == nullptr || iGlyphs.find(aGlyph.value()) != iGlyphs.end())
+            return true;
+        return service<i_font_manager>().glyph_rasterizer().request(iRasterizerQueue, aGlyph.value(), true);
+    }
 
-        auto pixelMode = to_glyph_pixel_mode(bitmap.pixel_mode);
+    i_glyph_texture& native_font_face::glyph_distance_field(const glyph& aGlyph) const
+    {
+        auto existingGlyph = iGlyphDistanceFields.find(aGlyph.value());
+        if (existingGlyph != iGlyphDistanceFields.end())
+        {
+            service<i_font_manager>().glyph_atlas().touch(existingGlyph->second.texture());
+            return existingGlyph->second;
+        }
 
-        if (pixelMode != glyph_pixel_mode::LCD)
-            useSubpixelFiltering = false;
+        auto const spread = static_cast<uint32_t>(GlyphDistanceFieldSpread);
+
+        // same hinting as the glyph texture so effects line up with the glyph; rendered without sub-pixel filtering
+        bool rendered = true;
+        try
+        {
+            freetypeCheck(FT_Load_Glyph(iHandle, aGlyph.value(), FT_LOAD_TARGET_LCD | FT_LOAD_NO_BITMAP));
+            freetypeCheck(FT_Render_Glyph(iHandle->glyph, FT_RENDER_MODE_NORMAL));
+        }
+        catch (freetype_error fe)
+        {
+            std::cerr << "neogfx: warning: Cannot render font glyph distance field" << std::endl;
+            rendered = false;
+        }
+
+        FT_Bitmap emptyBitmap = {};
+        FT_Bitmap const& bitmap = (rendered ? iHandle->glyph->bitmap : emptyBitmap);
+
+        thread_local std::vector<GLubyte> distanceFieldData;
+        coverage_to_distance_field(bitmap, spread, distanceFieldData);
 
-        auto subTextureWidth = bitmap.width / (useSubpixelFiltering ? 3 : 1);
         auto& subTexture = service<i_font_manager>().glyph_atlas().create_sub_texture(
-            neogfx::size{ static_cast<dimension>(subTextureWidth), static_cast<dimension>(bitmap.rows) }.ceil(),
-            1.0, texture_sampling::Normal, pixelMode != glyph_pixel_mode::Mono ? texture_data_format::SubPixel : texture_data_format::Red);
+            neogfx::size{ static_cast<dimension>(bitmap.width + spread * 2u), static_cast<dimension>(bitmap.rows + spread * 2u) },
+            1.0, texture_sampling::Normal, texture_data_format::Red);
 
-        rect glyphRect{ subTexture.atlas_location() };
+        i_glyph_texture& distanceField = iGlyphDistanceFields.insert(std::make_pair(aGlyph.value(),
+            neogfx::glyph_texture{
+                subTexture,
+                false,
+                rendered ?
+                    point{
+                        iHandle->glyph->metrics.horiBearingX / 64.0 - spread,
+                        (iHandle->glyph->metrics.horiBearingY - iHandle->glyph->metrics.height) / 64.0 - spread } :
+                    point{ -GlyphDistanceFieldSpread, -GlyphDistanceFieldSpread },
+                glyph_pixel_mode::Gray })).first->second;
+        service<i_font_manager>().glyph_atlas().set_evictable(subTexture, [this, glyphIndex = aGlyph.value()]() { iGlyphDistanceFields.erase(glyphIndex); });
+
+        distanceField.texture().native_texture()->set_pixels(rect{ subTexture.atlas_location() }, &distanceFieldData[0], 1u);
+
+        return distanceField;
+    }
+
+    i_glyph_texture& native_font_face::upload_glyph_texture(const glyph& aGlyph, const glyph_bitmap& aBitmap) const
+    {
+        auto& glyphAtlas = service<i_font_manager>().glyph_atlas();
+        auto& subTexture = glyphAtlas.create_sub_texture(
+            neogfx::size{ static_cast<dimension>(aBitmap.extents.cx), static_cast<dimension>(aBitmap.extents.cy) },
+            1.0, texture_sampling::Normal, aBitmap.pixelMode != glyph_pixel_mode::Mono ? texture_data_format::SubPixel : texture_data_format::Red);
         i_glyph_texture& glyphTexture = iGlyphs.insert(std::make_pair(aGlyph.value(),
             neogfx::glyph_texture{
                 subTexture,
-                useSubpixelFiltering,
-                point{
-                    iHandle->glyph->metrics.horiBearingX / 64.0,
-                    (iHandle->glyph->metrics.horiBearingY - iHandle->glyph->metrics.height) / 64.0 },
-                pixelMode })).first->second;
-
-        thread_local std::vector<GLubyte> glyphTextureData;
-        thread_local std::vector<std::array<GLubyte, 4>> subpixelGlyphTextureData;
-        glyphTextureData.clear();
-        subpixelGlyphTextureData.clear();
-
-        const GLubyte* textureData = 0;
-        
-        if (useSubpixelFiltering)
-        {
-            subpixelGlyphTextureData.resize(static_cast<std::size_t>(glyphRect.cx * glyphRect.cy));
-            // sub-pixel FIR filter.
-            static double coefficients[] = { 0.5 / 16.0, 4.0 / 16.0, 7.0 / 16.0, 4.0 / 16.0, 0.5 / 16.0 };
-            for (uint32_t y = 0; y < bitmap.rows; y++)
+                aBitmap.subpixel,
+                aBitmap.placement,
+                aBitmap.pixelMode })).first->second;
+        glyphAtlas.set_evictable(subTexture, [this, glyphIndex = aGlyph.value()]() { iGlyphs.erase(glyphIndex); });
+        glyphTexture.texture().native_texture()->set_pixels(rect{ subTexture.atlas_location() }, aBitmap.data.data(), 1u);
+        return glyphTexture;
+    }
+
+    void native_font_face::release_glyph_textures(glyph_map& aGlyphs)
+    {
+        auto& glyphAtlas = service<i_font_manager>().glyph_atlas();
+        for (auto const& g : aGlyphs)
+            if (glyphAtlas.has_sub_texture(g.second.texture().atlas_id()))
+                glyphAtlas.destroy_sub_texture(glyphAtlas.sub_texture(g.second.texture().atlas_id()));
+        aGlyphs.clear();
+    }
+
+    void native_font_face::create_metrics_cache()
+    {
+        iMetricsCache = std::make_unique<glyph_metrics_cache>(iHandle->num_glyphs);
+        if (iHandle->size != nullptr)
+            iHandle->size->generic.data = iMetricsCache.get();
+    }
+
+    void native_font_face::destroy_metrics_cache()
+    {
+        if (iHandle != nullptr && iHandle->size != nullptr && iHandle->size->generic.data == iMetricsCache.get())
+            iHandle->size->generic.data = nullptr;
+        iMetricsCache.reset();
+    }
+
+    void native_font_face::create_rasterizer_queue()
+    {
+        // bitmap fonts are rasterized on demand as are faces FreeType did not open from memory
+        if (is_bitmap_font() || iHandle->stream == nullptr || iHandle->stream->base == nullptr)
+            return;
+        auto& fontManager = service<i_font_manager>();
+        iRasterizerQueue = fontManager.glyph_rasterizer().create_queue(glyph_rasterizer::face_source{
+            iHandle->stream->base,
+            static_cast<FT_Long>(iHandle->stream->size),
+            iHandle->face_index,
+            static_cast<FT_F26Dot6>(iSize * 64),
+            static_cast<FT_UInt>(iPixelDensityDpi.cx),
+            static_cast<FT_UInt>(iPixelDensityDpi.cy) });
+        for (auto const& range : fontManager.prewarm_glyph_ranges())
+            for (auto codePoint = range.first; codePoint <= range.second; ++codePoint)
             {
-                for (uint32_t x = 0; x < bitmap.width; x++)
-                {
-                    uint8_t alpha = 0;
-                    for (int32_t z = -2; z <= 2; ++z)
-                        alpha += static_cast<uint8_t>(bitmap.buffer[std::max(0, std::min<int32_t>(bitmap.width - 1, x + z)) + bitmap.pitch * y] * coefficients[z + 2]);
-                    subpixelGlyphTextureData[(x / 3) + (bitmap.rows - 1 - y) * static_cast<std::size_t>(glyphRect.cx)][x % 3] = alpha;
-                }
+                auto const glyphIndex = FT_Get_Char_Index(iHandle, codePoint);
+                if (glyphIndex != 0)
+                    fontManager.glyph_rasterizer().request(iRasterizerQueue, glyphIndex, false);
             }
-            textureData = &subpixelGlyphTextureData[0][0];
-        }
-        else
-        {
-            glyphTextureData.resize(static_cast<std::size_t>(glyphRect.cx * glyphRect.cy));
-            for (uint32_t y = 0; y < bitmap.rows; y++)
-                switch (bitmap.pixel_mode)
-                {
-                case FT_PIXEL_MODE_MONO: // 1 bit per pixel monochrome
-                    for (uint32_t x = 0; x < bitmap.width; x += 8)
-                        for (uint32_t b = 0; b < std::min(bitmap.width - x, 8u); ++b)
-                            glyphTextureData[(x + b) + (bitmap.rows - 1 - y) * static_cast<std::size_t>(glyphRect.cx)] =
-                                (x >= bitmap.width || y >= bitmap.rows) ? 0x00 : ((bitmap.buffer[x / 8 + bitmap.pitch * y] & (1 << (7 - b))) != 0 ? 0xFF : 0x00);
-                    break;
-                case FT_PIXEL_MODE_GRAY:
-                default:
-                    for (uint32_t x = 0; x < bitmap.width; x++)
-                        glyphTextureData[x + (bitmap.rows - 1 - y) * static_cast<std::size_t>(glyphRect.cx)] =
-                            (x >= bitmap.width || y >= bitmap.rows) ? 0x00 : bitmap.buffer[x + bitmap.pitch * y];
-                    break;
-                }
-            textureData = &glyphTextureData[0];
-        }
-        
-        glyphTexture.texture().native_texture()->set_pixels(glyphRect, &textureData[0], 1u);
+    }
 
-        return glyphTexture;
+    void native_font_face::cancel_rasterizer_queue()
+    {
+        if (iRasterizerQueue != nullptr)
+            iRasterizerQueue->cancel();
+        iRasterizerQueue.reset();
     }
 
     void native_font_face::set_metrics()
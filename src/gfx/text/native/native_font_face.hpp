@@ -21,8 +21,6 @@
 
 #include <neogfx/neogfx.hpp>
 #include <unordered_map>
-#include <boost/functional/hash.hpp>
-#include <boost/pool/pool_alloc.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #ifdef u8
@@ -41,6 +39,8 @@
 #include <neogfx/hid/i_surface.hpp>
 #include <neogfx/gfx/text/font.hpp>
 #include "glyph_texture.hpp"
+#include "glyph_rasterizer.hpp"
+#include "glyph_metrics_cache.hpp"
 #include "i_native_font.hpp"
 #include "i_native_font_face.hpp"
 
@@ -73,9 +73,6 @@ namespace neogfx
     {
     private:
         typedef std::unordered_map<glyph_index_t, neogfx::glyph_texture> glyph_map;
-        typedef std::pair<glyph_index_t, glyph_index_t> kerning_pair;
-        typedef std::unordered_map<kerning_pair, dimension, boost::hash<kerning_pair>, std::equal_to<kerning_pair>,
-            boost::fast_pool_allocator<std::pair<const kerning_pair, dimension>>> kerning_table;
     public:
         struct hb_handle
         {
@@ -126,7 +123,15 @@ namespace neogfx
         void* aux_handle() const override;
         glyph_index_t glyph_index(char32_t aCodePoint) const override;
         i_glyph_texture& glyph_texture(const glyph& aGlyph) const override;
+        bool glyph_texture_ready(const glyph& aGlyph) const override;
+        i_glyph_texture& glyph_distance_field(const glyph& aGlyph) const override;
     private:
+        i_glyph_texture& upload_glyph_texture(const glyph& aGlyph, const glyph_bitmap& aBitmap) const;
+        void release_glyph_textures(glyph_map& aGlyphs);
+        void create_metrics_cache();
+        void destroy_metrics_cache();
+        void create_rasterizer_queue();
+        void cancel_rasterizer_queue();
         void set_metrics();
     private:
         font_id iId;
@@ -139,9 +144,11 @@ namespace neogfx
         mutable std::unique_ptr<hb_handle> iAuxHandle;
         mutable ref_ptr<i_native_font_face> iFallbackFont;
         mutable glyph_map iGlyphs;
+        mutable glyph_map iGlyphDistanceFields;
         bool iHasKerning;
-        mutable kerning_table iKerningTable;
+        std::unique_ptr<glyph_metrics_cache> iMetricsCache;
         mutable std::optional<bool> iHasFallback;
         mutable std::optional<neogfx::glyph_texture> iInvalidGlyph;
+        std::shared_ptr<glyph_rasterizer::face_queue> iRasterizerQueue;
     };
 }
\ No newline at end of file
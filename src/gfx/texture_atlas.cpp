@@ -26,16 +26,21 @@
 namespace neogfx
 {
     texture_atlas::texture_atlas(const size& aPageSize) :
-        iTextureManager{ service<i_texture_manager>() }, iPageSize{ aPageSize }
+        iTextureManager{ service<i_texture_manager>() }, iPageSize{ aPageSize }, iGeneration{ 1u }
     {
     }
 
+    bool texture_atlas::has_sub_texture(texture_id aSubTextureId) const
+    {
+        return iEntries.find(aSubTextureId) != iEntries.end();
+    }
+
     const i_sub_texture& texture_atlas::sub_texture(texture_id aSubTextureId) const
     {
         auto iterEntry = iEntries.find(aSubTextureId);
         if (iterEntry == iEntries.end())
             throw sub_texture_not_found();
-        return iterEntry->second.second;
+        return iterEntry->second.subTexture;
     }
 
     i_sub_texture& texture_atlas::sub_texture(texture_id aSubTextureId)
@@ -43,42 +48,124 @@ namespace neogfx
         auto iterEntry = iEntries.find(aSubTextureId);
         if (iterEntry == iEntries.end())
             throw sub_texture_not_found();
-        return iterEntry->second.second;
+        return iterEntry->second.subTexture;
     }
 
     i_sub_texture& texture_atlas::create_sub_texture(const size& aSize, dimension aDpiScaleFactor, texture_sampling aSampling, texture_data_format aDataFormat)
     {
-        auto newSpace = allocate_space(aSize, aDpiScaleFactor, aSampling, aDataFormat);
-        auto nextId = iTextureManager.allocate_texture_id();
-        auto entry = iEntries.insert(std::make_pair(nextId, std::make_pair(newSpace.first, neogfx::sub_texture{ nextId, newSpace.first->first, newSpace.second, aSize })));
-        iTextureManager.add_sub_texture(entry.first->second.second);
-        return entry.first->second.second;
+        return add_entry(allocate_space(aSize, aDpiScaleFactor, aSampling, aDataFormat), aSize);
     }
 
     i_sub_texture& texture_atlas::create_sub_texture(const i_image& aImage)
     {
-        auto newSpace = allocate_space(aImage.extents(), aImage.dpi_scale_factor(), aImage.sampling(), aImage.data_format());
-        auto nextId = iTextureManager.allocate_texture_id();
-        auto entry = iEntries.insert(std::make_pair(nextId, std::make_pair(newSpace.first, neogfx::sub_texture{ nextId, newSpace.first->first, newSpace.second, aImage.extents() })));
-        entry.first->second.second.set_pixels(aImage);
-        iTextureManager.add_sub_texture(entry.first->second.second);
-        return entry.first->second.second;
+        auto& newSubTexture = add_entry(allocate_space(aImage.extents(), aImage.dpi_scale_factor(), aImage.sampling(), aImage.data_format()), aImage.extents());
+        newSubTexture.set_pixels(aImage);
+        return newSubTexture;
     }
 
     void texture_atlas::destroy_sub_texture(i_sub_texture& aSubTexture)
     {
         auto iterEntry = iEntries.find(aSubTexture.atlas_id());
-        if (iterEntry == iEntries.end() || &aSubTexture != &iterEntry->second.second)
+        if (iterEntry == iEntries.end() || &aSubTexture != &iterEntry->second.subTexture)
             throw sub_texture_not_found();
-        auto rectEntry = iterEntry->second.second.atlas_location();
-        auto space = iterEntry->second.first->second.used.find(rectEntry);
-        if (space != iterEntry->second.first->second.used.end())
-            iterEntry->second.first->second.used.erase(space);
-        iterEntry->second.first->second.freed.insert(rectEntry);
+        iterEntry->second.page->second.remove(iterEntry->second.space);
         iTextureManager.remove_sub_texture(aSubTexture);
         iEntries.erase(iterEntry);
     }
 
+    uint32_t texture_atlas::page_count() const
+    {
+        return static_cast<uint32_t>(iPages.size());
+    }
+
+    uint32_t texture_atlas::sub_texture_count() const
+    {
+        return static_cast<uint32_t>(iEntries.size());
+    }
+
+    double texture_atlas::occupancy() const
+    {
+        if (iPages.empty())
+            return 0.0;
+        dimension usedArea = 0.0;
+        for (auto const& p : iPages)
+            usedArea += p.second.pack.used_area();
+        return usedArea / (page_size().cx * page_size().cy * iPages.size());
+    }
+
+    uint64_t texture_atlas::memory_usage() const
+    {
+        uint64_t result = 0u;
+        for (auto const& p : iPages)
+            result += page_memory(p);
+        return result;
+    }
+
+    const std::optional<uint64_t>& texture_atlas::memory_budget() const
+    {
+        return iMemoryBudget;
+    }
+
+    void texture_atlas::set_memory_budget(const std::optional<uint64_t>& aMemoryBudget)
+    {
+        iMemoryBudget = aMemoryBudget;
+    }
+
+    void texture_atlas::set_evictable(const i_sub_texture& aSubTexture, std::function<void()> aEvicted)
+    {
+        auto iterEntry = iEntries.find(aSubTexture.atlas_id());
+        if (iterEntry == iEntries.end())
+            throw sub_texture_not_found();
+        iterEntry->second.evicted = aEvicted;
+    }
+
+    void texture_atlas::touch(const i_sub_texture& aSubTexture)
+    {
+        auto iterEntry = iEntries.find(aSubTexture.atlas_id());
+        if (iterEntry != iEntries.end())
+            iterEntry->second.lastUse = iGeneration;
+    }
+
+    void texture_atlas::evict(bool aDefragment)
+    {
+        // pages are the unit of eviction as only an empty page gives memory back; a page is a candidate if every
+        // sub-texture on it is evictable and none have been touched for EvictionAge calls
+        struct page_usage
+        {
+            pages::iterator page;
+            uint64_t lastUse;
+            bool evictable;
+        };
+        thread_local std::vector<page_usage> usage;
+        usage.clear();
+        std::unordered_map<const page*, std::size_t> pageIndices;
+        for (auto p = iPages.begin(); p != iPages.end(); ++p)
+        {
+            pageIndices[&*p] = usage.size();
+            usage.push_back(page_usage{ p, 0u, true });
+        }
+        for (auto const& e : iEntries)
+        {
+            auto& u = usage[pageIndices[&*e.second.page]];
+            u.lastUse = std::max(u.lastUse, e.second.lastUse);
+            u.evictable = u.evictable && e.second.evicted && iGeneration - e.second.lastUse >= EvictionAge;
+        }
+        std::stable_sort(usage.begin(), usage.end(), [](const page_usage& aLhs, const page_usage& aRhs) { return aLhs.lastUse < aRhs.lastUse; });
+        auto usedMemory = memory_usage();
+        for (auto const& u : usage)
+        {
+            if (!u.evictable)
+                continue;
+            bool const overBudget = iMemoryBudget && usedMemory > *iMemoryBudget;
+            bool const sparse = aDefragment && u.page->second.pack.used_area() < page_size().cx * page_size().cy * DefragmentOccupancyThreshold;
+            if (!overBudget && !sparse)
+                continue;
+            usedMemory -= page_memory(*u.page);
+            destroy_page(u.page);
+        }
+        ++iGeneration;
+    }
+
     const size& texture_atlas::page_size() const
     {
         return iPageSize;
@@ -96,11 +183,45 @@ namespace neogfx
         rect result;
         for (auto iterPage = iPages.begin(); iterPage != iPages.end(); ++iterPage)
             if (iterPage->first.dpi_scale_factor() == aDpiScaleFactor && iterPage->first.sampling() == aSampling && iterPage->first.data_format() == aDataFormat && iterPage->second.insert(aSize + size{ 2.0, 2.0 }, result))
-                return std::make_pair(iterPage, result + point{ 1.0, 1.0 } + size{ -2.0, -2.0 });
+                return std::make_pair(iterPage, result);
         auto iterPage = create_page(aDpiScaleFactor, aSampling, aDataFormat);
         if (iterPage->second.insert(aSize + size{ 2.0, 2.0 }, result))
-            return std::make_pair(iterPage, result + point{ 1.0, 1.0 } + size{ -2.0, -2.0 });
+            return std::make_pair(iterPage, result);
         iPages.erase(iterPage);
         throw texture_too_big_for_atlas();
     }
+
+    i_sub_texture& texture_atlas::add_entry(const std::pair<pages::iterator, rect>& aSpace, const size& aSize)
+    {
+        auto nextId = iTextureManager.allocate_texture_id();
+        auto newEntry = iEntries.emplace(nextId, entry{ aSpace.first, aSpace.second,
+            neogfx::sub_texture{ nextId, aSpace.first->first, aSpace.second + point{ 1.0, 1.0 } + size{ -2.0, -2.0 }, aSize }, iGeneration, {} });
+        iTextureManager.add_sub_texture(newEntry.first->second.subTexture);
+        return newEntry.first->second.subTexture;
+    }
+
+    void texture_atlas::destroy_page(pages::iterator aPage)
+    {
+        thread_local std::vector<texture_id> victims;
+        victims.clear();
+        for (auto const& e : iEntries)
+            if (e.second.page == aPage)
+                victims.push_back(e.first);
+        for (auto id : victims)
+        {
+            auto iterEntry = iEntries.find(id);
+            if (iterEntry->second.evicted)
+                iterEntry->second.evicted();
+            iTextureManager.remove_sub_texture(iterEntry->second.subTexture);
+            iEntries.erase(iterEntry);
+        }
+        iPages.erase(aPage);
+    }
+
+    uint64_t texture_atlas::page_memory(const page& aPage)
+    {
+        auto const& extents = aPage.first.storage_extents();
+        uint64_t const bytesPerTexel = (aPage.first.data_format() == texture_data_format::Red ? 1u : 4u);
+        return static_cast<uint64_t>(extents.cx) * static_cast<uint64_t>(extents.cy) * bytesPerTexel;
+    }
 }
\ No newline at end of file
@@ -46,7 +46,8 @@ namespace neogfx
         iMinimumSize{},
         iMaximumSize{},
         iLayoutStarted{ false },
-        iInvalidated{ false }
+        iInvalidated{ false },
+        iGeneration{ 0u }
     {
         enable();
     }
@@ -61,7 +62,8 @@ namespace neogfx
         iMinimumSize{},
         iMaximumSize{},
         iLayoutStarted{ false },
-        iInvalidated{ false }
+        iInvalidated{ false },
+        iGeneration{ 0u }
     {
         aOwner.set_layout(*this);
         enable();
@@ -78,7 +80,8 @@ namespace neogfx
         iMinimumSize{},
         iMaximumSize{},
         iLayoutStarted{ false },
-        iInvalidated{ false }
+        iInvalidated{ false },
+        iGeneration{ 0u }
     {
         aParent.add(*this);
         enable();
@@ -386,6 +389,8 @@ namespace neogfx
             iPadding = newPadding;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -409,6 +414,8 @@ namespace neogfx
                 aSpacing);
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -419,7 +426,11 @@ namespace neogfx
 
     void layout::set_always_use_spacing(bool aAlwaysUseSpacing)
     {
-        iAlwaysUseSpacing = aAlwaysUseSpacing;
+        if (iAlwaysUseSpacing != aAlwaysUseSpacing)
+        {
+            iAlwaysUseSpacing = aAlwaysUseSpacing;
+            invalidate_size_hints();
+        }
     }
 
     neogfx::alignment layout::alignment() const
@@ -435,6 +446,8 @@ namespace neogfx
             AlignmentChanged.trigger();
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -450,6 +463,8 @@ namespace neogfx
             iIgnoreVisibility = aIgnoreVisibility;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -490,6 +505,8 @@ namespace neogfx
 
     void layout::invalidate(bool aDeferLayout)
     {
+        // cached size hints are stale even if a layout is already pending
+        invalidate_size_hints();
         if (!enabled())
             return;
         if (invalidated())
@@ -520,6 +537,20 @@ namespace neogfx
         iInvalidated = false;
     }
 
+    uint32_t layout::generation() const
+    {
+        return iGeneration;
+    }
+
+    void layout::invalidate_size_hints()
+    {
+        ++iGeneration;
+        if (has_parent_layout())
+            parent_layout().invalidate_size_hints();
+        else if (has_layout_owner() && layout_owner().has_parent_layout())
+            layout_owner().parent_layout().invalidate_size_hints();
+    }
+
     point layout::position() const
     {
         return units_converter(*this).from_device_units(iPosition);
@@ -569,6 +600,8 @@ namespace neogfx
             iSizePolicy = aSizePolicy;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -592,6 +625,8 @@ namespace neogfx
             iWeight = aWeight;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -622,6 +657,8 @@ namespace neogfx
             iMinimumSize = newMinimumSize;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -652,6 +689,8 @@ namespace neogfx
             iMaximumSize = newMaximumSize;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -677,6 +716,8 @@ namespace neogfx
             iFixedSize = newFixedSize;
             if (aUpdateLayout)
                 invalidate();
+            else
+                invalidate_size_hints();
         }
     }
 
@@ -132,6 +132,8 @@ namespace neogfx
     template <typename AxisPolicy>
     size layout::do_minimum_size(const optional_size& aAvailableSpace) const
     {
+        if (auto const cachedResult = iMinimumSizeHints.find(generation(), aAvailableSpace))
+            return *cachedResult;
         if (debug() == this)
             std::cerr << "layout(" << this << ")::do_minimum_size(" << aAvailableSpace << "): " << std::endl;
         uint32_t itemsVisible = always_use_spacing() ? items_visible(static_cast<item_type_e>(ItemTypeWidget | ItemTypeLayout | ItemTypeSpacer)) : items_visible();
@@ -164,12 +166,14 @@ namespace neogfx
         }
         if (debug() == this)
             std::cerr << "layout(" << this << ")::do_minimum_size(" << aAvailableSpace << ") --> " << result << std::endl;
-        return result;
+        return iMinimumSizeHints.insert(generation(), aAvailableSpace, result);
     }
 
     template <typename AxisPolicy>
     size layout::do_maximum_size(const optional_size& aAvailableSpace) const
     {
+        if (auto const cachedResult = iMaximumSizeHints.find(generation(), aAvailableSpace))
+            return *cachedResult;
         if (debug() == this)
             std::cerr << "layout(" << this << ")::do_maximum_size(" << aAvailableSpace << "): " << std::endl;
         if (items_visible(static_cast<item_type_e>(ItemTypeWidget | ItemTypeLayout | ItemTypeSpacer)) == 0)
@@ -179,7 +183,7 @@ namespace neogfx
                 AxisPolicy::cx(result) = size::max_dimension();
             if (AxisPolicy::size_policy_y(effective_size_policy()) == size_constraint::Expanding)
                 AxisPolicy::cy(result) = size::max_dimension();
-            return result;
+            return iMaximumSizeHints.insert(generation(), aAvailableSpace, result);
         }
         auto availableSpaceForChildren = aAvailableSpace;
         if (availableSpaceForChildren != std::nullopt)
@@ -202,7 +206,7 @@ namespace neogfx
             else if (AxisPolicy::cx(itemMaxSize) == size::max_dimension())
                 AxisPolicy::cx(result) = size::max_dimension();
             if (result == size::max_size())
-                return result;
+                return iMaximumSizeHints.insert(generation(), aAvailableSpace, result);
         }
         if (AxisPolicy::cx(result) != size::max_dimension() && AxisPolicy::cx(result) != 0.0)
         {
@@ -222,7 +226,7 @@ namespace neogfx
             AxisPolicy::cy(result) = size::max_dimension();
         if (debug() == this)
             std::cerr << "layout(" << this << ")::do_maximum_size(" << aAvailableSpace << ") --> " << result << std::endl;
-        return result;
+        return iMaximumSizeHints.insert(generation(), aAvailableSpace, result);
     }
 
     template <typename AxisPolicy>
@@ -32,13 +32,13 @@ namespace neogfx
     }
 
     layout_item_proxy::layout_item_proxy(std::shared_ptr<i_layout_item> aItem) :
-        iSubject{ aItem }, iSubjectIsProxy{ aItem->is_proxy() }, iMinimumSize{ static_cast<uint32_t>(-1), {} }, iMaximumSize{ static_cast<uint32_t>(-1), {} }
+        iSubject{ aItem }, iSubjectIsProxy{ aItem->is_proxy() }, iVisible{ static_cast<uint32_t>(-1), false }
     {
         set_alive();
     }
 
     layout_item_proxy::layout_item_proxy(const layout_item_proxy& aOther) :
-        iSubject{ aOther.iSubject }, iSubjectIsProxy{ aOther.iSubject->is_proxy() }, iMinimumSize{ static_cast<uint32_t>(-1), {} }, iMaximumSize{ static_cast<uint32_t>(-1), {} }
+        iSubject{ aOther.iSubject }, iSubjectIsProxy{ aOther.iSubject->is_proxy() }, iVisible{ static_cast<uint32_t>(-1), false }
     {
         set_alive();
     }
@@ -288,11 +288,12 @@ namespace neogfx
     {
         if (!visible())
             return size{};
-        auto& minSize = iMinimumSize.second;
-        if (iMinimumSize.first == global_layout_id())
-            return minSize;
+        auto const generation = layout_generation();
+        if (auto const cachedMinSize = iMinimumSize.find(generation, aAvailableSpace))
+            return *cachedMinSize;
         else
         {
+            size minSize;
             if (iMinimumSizeAnchor == std::nullopt)
             {   
                 auto anchorIter = anchors().find(string{ "MinimumSize" });
@@ -323,16 +324,14 @@ namespace neogfx
                         minSize = size{ minSize.cx, minSize.cx * (aspectRatio.cy / aspectRatio.cx) };
                 }
             }
-            iMinimumSize.first = global_layout_id();
-            return minSize;
+            return iMinimumSize.insert(generation, aAvailableSpace, minSize);
         }
     }
 
     void layout_item_proxy::set_minimum_size(const optional_size& aMinimumSize, bool aUpdateLayout)
     {
         subject().set_minimum_size(aMinimumSize, aUpdateLayout);
-        if (aMinimumSize != std::nullopt)
-            iMinimumSize.second = *aMinimumSize;
+        iMinimumSize.clear();
     }
 
     bool layout_item_proxy::has_maximum_size() const
@@ -344,21 +343,17 @@ namespace neogfx
     {
         if (!visible())
             return size::max_size();
-        if (iMaximumSize.first == global_layout_id())
-            return iMaximumSize.second;
+        auto const generation = layout_generation();
+        if (auto const cachedMaxSize = iMaximumSize.find(generation, aAvailableSpace))
+            return *cachedMaxSize;
         else
-        {
-            iMaximumSize.second = subject().maximum_size(aAvailableSpace);
-            iMaximumSize.first = global_layout_id();
-            return iMaximumSize.second;
-        }
+            return iMaximumSize.insert(generation, aAvailableSpace, subject().maximum_size(aAvailableSpace));
     }
 
     void layout_item_proxy::set_maximum_size(const optional_size& aMaximumSize, bool aUpdateLayout)
     {
         subject().set_maximum_size(aMaximumSize, aUpdateLayout);
-        if (aMaximumSize != std::nullopt)
-            iMaximumSize.second = *aMaximumSize;
+        iMaximumSize.clear();
     }
 
     bool layout_item_proxy::has_fixed_size() const
@@ -368,21 +363,17 @@ namespace neogfx
 
     size layout_item_proxy::fixed_size() const
     {
-        if (iFixedSize.first == global_layout_id())
-            return iFixedSize.second;
+        auto const generation = layout_generation();
+        if (auto const cachedFixedSize = iFixedSize.find(generation, std::nullopt))
+            return *cachedFixedSize;
         else
-        {
-            iFixedSize.second = subject().fixed_size();
-            iFixedSize.first = global_layout_id();
-            return iFixedSize.second;
-        }
+            return iFixedSize.insert(generation, std::nullopt, subject().fixed_size());
     }
 
     void layout_item_proxy::set_fixed_size(const optional_size& aFixedSize, bool aUpdateLayout)
     {
         subject().set_fixed_size(aFixedSize, aUpdateLayout);
-        if (aFixedSize != std::nullopt)
-            iFixedSize.second = *aFixedSize;
+        iFixedSize.clear();
     }
 
     bool layout_item_proxy::has_padding() const
@@ -402,10 +393,10 @@ namespace neogfx
 
     bool layout_item_proxy::visible() const
     {
-        if (iVisible.first != global_layout_id())
+        if (iVisible.first != layout_generation())
         {
             iVisible.second = subject().visible() || parent_layout().ignore_visibility();
-            iVisible.first = global_layout_id();
+            iVisible.first = layout_generation();
         }
         return iVisible.second;
     }
@@ -419,4 +410,12 @@ namespace neogfx
     {
         return iSubjectIsProxy;
     }
+
+    uint32_t layout_item_proxy::layout_generation() const
+    {
+        // size hints are cached for as long as nothing affecting the size of an item in the parent layout changes
+        if (has_parent_layout())
+            return parent_layout().generation();
+        return global_layout_id();
+    }
 }
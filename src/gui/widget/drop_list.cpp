@@ -628,6 +628,8 @@ namespace neogfx
         }
         if (view_created())
             view().set_model(aModel);
+        if (has_parent_layout())
+            parent_layout().invalidate_size_hints();
         layout_manager().layout_items(true);
         update();
     }
@@ -666,6 +668,8 @@ namespace neogfx
             selection_model().set_presentation_model(*aPresentationModel);
         if (view_created())
             view().set_presentation_model(aPresentationModel);
+        if (has_parent_layout())
+            parent_layout().invalidate_size_hints();
         if (has_layout_manager())
             layout_manager().layout_items(true);
         update();
@@ -63,16 +63,31 @@ namespace neogfx
                 destroyed_flag surfaceDestroyed{ aParent.surface() };
                 if (destroyed || surfaceDestroyed)
                     return;
-                for (auto& sw : aParent.iSectionWidths)
-                {
-                    sw.calculated = 0.0;
-                    sw.max = 0.0;
-                }
+                graphics_context gc{ aParent, graphics_context::type::Unattached };
                 if (iRow == 0)
+                {
+                    for (auto& sw : aParent.iSectionWidths)
+                    {
+                        sw.calculated = 0.0;
+                        sw.max = 0.0;
+                    }
                     aParent.update_buttons();
+                    if (aParent.presentation_model().width_mode() == i_item_presentation_model::column_width_mode::Estimated)
+                    {
+                        // lay out using the estimated widths without measuring every row (which for a virtual item model
+                        // would also fetch every page); rows measured later widen the sections as they are added or
+                        // changed (see update_incrementally())
+                        for (uint32_t col = 0; col < aParent.presentation_model().columns(); ++col)
+                            aParent.update_section_width(col, size{ aParent.presentation_model().column_width(col, gc, false), 0.0 } + aParent.presentation_model().cell_padding(aParent).size() * 2.0, gc);
+                        aParent.layout_items();
+                        iRow = aParent.presentation_model().rows();
+                        iFinished = true;
+                        aParent.iOwner.header_view_updated(aParent, header_view_update_reason::FullUpdate);
+                        return;
+                    }
+                }
                 uint64_t since = neolib::thread::program_elapsed_ms();
                 event_processing_context epc{ service<async_task>(), "neogfx::header_view::updater" };
-                graphics_context gc{ aParent, graphics_context::type::Unattached };
                 for (uint32_t c = 0; c < 1000 && iRow < aParent.presentation_model().rows(); ++c, ++iRow)
                 {
                     aParent.update_from_row(iRow, gc);
@@ -86,11 +101,15 @@ namespace neogfx
                     }
                 }
                 if (iRow == aParent.presentation_model().rows())
+                {
+                    iFinished = true;
                     aParent.iOwner.header_view_updated(aParent, header_view_update_reason::FullUpdate);
+                }
                 else
                     again();
             }, 10 },
-            iRow{ 0 }
+            iRow{ 0 },
+            iFinished{ false }
         {
         }
         ~updater()
@@ -98,6 +117,7 @@ namespace neogfx
             cancel();
         }
         uint32_t iRow;
+        bool iFinished;
     };
 
     header_view::header_view(i_header_view_owner& aOwner, header_view_type aType) :
@@ -206,11 +226,13 @@ namespace neogfx
             presentation_model().item_model_changed([this](const i_item_model& aItemModel) { item_model_changed(aItemModel); });
             presentation_model().item_added([this](const item_presentation_model_index& aItemIndex) { item_added(aItemIndex); });
             presentation_model().item_changed([this](const item_presentation_model_index& aItemIndex) { item_changed(aItemIndex); });
+            presentation_model().items_changed([this](item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow) { items_changed(aFirstRow, aEndRow); });
             presentation_model().item_removed([this](const item_presentation_model_index& aItemIndex) { item_removed(aItemIndex); });
             presentation_model().items_sorting([this]() { items_sorting(); });
             presentation_model().items_sorted([this]() { items_sorted(); });
             presentation_model().items_filtering([this]() { items_filtering(); });
             presentation_model().items_filtered([this]() { items_filtered(); });
+            presentation_model().items_updated([this]() { items_updated(); });
             neolib::destroying(presentation_model(), [this]() { iPresentationModel = nullptr; });
             if (has_model())
                 presentation_model().set_item_model(model());
@@ -246,20 +268,37 @@ namespace neogfx
         iUpdater.reset(new updater(*this));
     }
 
-    void header_view::item_added(const item_presentation_model_index&)
+    void header_view::item_added(const item_presentation_model_index& aItemIndex)
     {
         iSectionWidths.resize(presentation_model().columns());
-        /* todo : optimize (don't do full update) */
-        iUpdater.reset();
-        iUpdater.reset(new updater(*this));
+        if (!update_incrementally(aItemIndex.row(), aItemIndex.row() + 1u))
+        {
+            /* todo : optimize (don't do full update) */
+            iUpdater.reset();
+            iUpdater.reset(new updater(*this));
+        }
     }
 
-    void header_view::item_changed(const item_presentation_model_index&)
+    void header_view::item_changed(const item_presentation_model_index& aItemIndex)
     {
         iSectionWidths.resize(presentation_model().columns());
-        /* todo : optimize (don't do full update) */
-        iUpdater.reset();
-        iUpdater.reset(new updater(*this));
+        if (!update_incrementally(aItemIndex.row(), aItemIndex.row() + 1u))
+        {
+            /* todo : optimize (don't do full update) */
+            iUpdater.reset();
+            iUpdater.reset(new updater(*this));
+        }
+    }
+
+    void header_view::items_changed(item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow)
+    {
+        iSectionWidths.resize(presentation_model().columns());
+        if (!update_incrementally(aFirstRow, aEndRow))
+        {
+            /* todo : optimize (don't do full update) */
+            iUpdater.reset();
+            iUpdater.reset(new updater(*this));
+        }
     }
 
     void header_view::item_removed(const item_presentation_model_index&)
@@ -290,6 +329,13 @@ namespace neogfx
         iUpdater.reset(new updater(*this));
     }
 
+    void header_view::items_updated()
+    {
+        iSectionWidths.resize(presentation_model().columns());
+        iUpdater.reset();
+        iUpdater.reset(new updater(*this));
+    }
+
     dimension header_view::separator_width() const
     {
         if (iSeparatorWidth != std::nullopt)
@@ -495,6 +541,18 @@ namespace neogfx
         iOwner.header_view_updated(*this, header_view_update_reason::FullUpdate);
     }
 
+    bool header_view::update_incrementally(uint32_t aFirstRow, uint32_t aEndRow)
+    {
+        // section widths only grow when estimating column widths so a completed update can be extended by the rows
+        if (presentation_model().width_mode() != i_item_presentation_model::column_width_mode::Estimated || iUpdater == nullptr || !iUpdater->iFinished)
+            return false;
+        graphics_context gc{ *this, graphics_context::type::Unattached };
+        for (auto row = aFirstRow; row < aEndRow; ++row)
+            update_from_row(row, gc);
+        iOwner.header_view_updated(*this, header_view_update_reason::FullUpdate);
+        return true;
+    }
+
     void header_view::update_from_row(uint32_t aRow, i_graphics_context& aGc)
     {
         bool updated = false;
@@ -140,6 +140,7 @@ namespace neogfx
             iPresentationModelSink += presentation_model().item_model_changed([this](const i_item_model& aItemModel) { item_model_changed(aItemModel); });
             iPresentationModelSink += presentation_model().item_added([this](const item_presentation_model_index& aItemIndex) { item_added(aItemIndex); });
             iPresentationModelSink += presentation_model().item_changed([this](const item_presentation_model_index& aItemIndex) { item_changed(aItemIndex); });
+            iPresentationModelSink += presentation_model().items_changed([this](item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type aEndRow) { items_changed(aFirstRow, aEndRow); });
             iPresentationModelSink += presentation_model().item_removed([this](const item_presentation_model_index& aItemIndex) { item_removed(aItemIndex); });
             iPresentationModelSink += presentation_model().item_expanded([this](const item_presentation_model_index& aItemIndex) { invalidate_item(aItemIndex); });
             iPresentationModelSink += presentation_model().item_collapsed([this](const item_presentation_model_index& aItemIndex) { invalidate_item(aItemIndex); });
@@ -148,6 +149,7 @@ namespace neogfx
             iPresentationModelSink += presentation_model().items_sorted([this]() { items_sorted(); });
             iPresentationModelSink += presentation_model().items_filtering([this]() { items_filtering(); });
             iPresentationModelSink += presentation_model().items_filtered([this]() { items_filtered(); });
+            iPresentationModelSink += presentation_model().items_updated([this]() { items_updated(); });
         }
         presentation_model_changed();
         update_scrollbar_visibility();
@@ -260,38 +262,55 @@ namespace neogfx
     {
         framed_scrollable_widget::paint(aGc);
         auto first = first_visible_item(aGc);
-        bool finished = false;
+        auto end = first.first;
         rect clipRect = default_clip_rect().intersection(item_display_rect());
-        for (item_presentation_model_index::value_type row = first.first; row < presentation_model().rows() && !finished; ++row)
+        // a single scissor for every cell so that drawing is not broken into a batch per cell: adjacent cell
+        // backgrounds of the same color are filled together and only tree expanders and cell parts that overflow
+        // their cell (text too long for the column, a check box or image wider than it) get a scissor of their own
+        scoped_scissor scissor(aGc, clipRect);
+        for (item_presentation_model_index::value_type row = first.first; row < presentation_model().rows() && presentation_model().columns() != 0; ++row)
         {
-            finished = true;
+            if (cell_rect(item_presentation_model_index{ row, 0u }, aGc).y > clipRect.bottom())
+                break;
+            end = row + 1u;
+            optional_color runColor;
+            rect runRect;
             for (uint32_t col = 0; col < presentation_model().columns(); ++col)
             {
                 auto const itemIndex = item_presentation_model_index{ row, col };
                 bool const currentCell = selection_model().has_current_index() && selection_model().current_index() == itemIndex;
-                rect cellRect = cell_rect(itemIndex, aGc);
-                if (cellRect.y > clipRect.bottom())
-                    continue;
-                finished = false;
                 optional_color cellBackgroundColor = presentation_model().cell_color(itemIndex, color_role::Background);
                 if (!cellBackgroundColor)
                     cellBackgroundColor = background_color();
+                if (selection_model().is_selected(itemIndex) && (!currentCell || !editing()))
+                    cellBackgroundColor = cellBackgroundColor->
+                        shade(selection_model().has_current_index() && selection_model().current_index().row() == itemIndex.row() ? 0x80 : 0x60).with_alpha(0.875);
+                rect const cellBackgroundRect = cell_rect(itemIndex, aGc, cell_part::Background);
+                if (runColor == cellBackgroundColor && runRect.right() >= cellBackgroundRect.x)
+                    runRect = runRect.combine(cellBackgroundRect);
+                else
+                {
+                    if (runColor)
+                        aGc.fill_rect(runRect, *runColor);
+                    runColor = cellBackgroundColor;
+                    runRect = cellBackgroundRect;
+                }
+            }
+            if (runColor)
+                aGc.fill_rect(runRect, *runColor);
+            for (uint32_t col = 0; col < presentation_model().columns(); ++col)
+            {
+                auto const itemIndex = item_presentation_model_index{ row, col };
+                bool const currentCell = selection_model().has_current_index() && selection_model().current_index() == itemIndex;
+                rect const cellBackgroundRect = cell_rect(itemIndex, aGc, cell_part::Background);
+                if (cellBackgroundRect.x > clipRect.right() || cellBackgroundRect.right() < clipRect.x)
+                    continue;
+                rect const cellRect = cell_rect(itemIndex, aGc);
                 optional_color textColor = presentation_model().cell_color(itemIndex, color_role::Text);
                 if (textColor == std::nullopt)
                     textColor = service<i_app>().current_style().palette().color(color_role::Text);
-                rect cellBackgroundRect = cell_rect(itemIndex, aGc, cell_part::Background);
-                {
-                    scoped_scissor scissor(aGc, clipRect.intersection(cellBackgroundRect));
-                    if (selection_model().is_selected(itemIndex) && (!currentCell || !editing()))
-                        aGc.fill_rect(cellBackgroundRect, cellBackgroundColor->
-                            shade(selection_model().has_current_index() && selection_model().current_index().row() == itemIndex.row() ? 0x80 : 0x60).with_alpha(0.875));
-                    else
-                        aGc.fill_rect(cellBackgroundRect, *cellBackgroundColor);
-                }
                 if (model().is_tree() && model().has_children(presentation_model().to_item_model_index(itemIndex)))
                 {
-                    auto const expanderRect = cell_rect(itemIndex, aGc, cell_part::TreeExpander);
-                    scoped_scissor scissor(aGc, clipRect.intersection(expanderRect));
                     thread_local struct : i_skinnable_item
                     {
                         const item_view* widget;
@@ -317,54 +336,77 @@ namespace neogfx
                         }
                     } skinnableItem = {};
                     skinnableItem.widget = this;
-                    skinnableItem.treeExpanderRect = expanderRect;
+                    skinnableItem.treeExpanderRect = cell_rect(itemIndex, aGc, cell_part::TreeExpander);
+                    scoped_scissor expanderScissor(aGc, clipRect.intersection(skinnableItem.treeExpanderRect));
                     service<i_skin_manager>().active_skin().draw_tree_expander(aGc, skinnableItem, presentation_model().cell_meta(itemIndex).expanded);
                 }
+                if (presentation_model().cell_checkable(itemIndex))
                 {
-                    scoped_scissor scissor(aGc, clipRect.intersection(cellRect));
-                    if (presentation_model().cell_checkable(itemIndex))
+                    thread_local struct : i_skinnable_item
                     {
-                        thread_local struct : i_skinnable_item
-                        {
-                            const item_view* widget;
-                            rect checkBoxRect;
+                        const item_view* widget;
+                        rect checkBoxRect;
 
-                            bool is_widget() const override
-                            {
-                                return true;
-                            }
+                        bool is_widget() const override
+                        {
+                            return true;
+                        }
 
-                            const i_widget& as_widget() const override
-                            {
-                                return *widget;
-                            }
+                        const i_widget& as_widget() const override
+                        {
+                            return *widget;
+                        }
 
-                            rect element_rect(skin_element aElement) const override
+                        rect element_rect(skin_element aElement) const override
+                        {
+                            switch (aElement)
                             {
-                                switch (aElement)
-                                {
-                                case skin_element::ClickableArea:
-                                case skin_element::CheckBox:
-                                    return checkBoxRect;
-                                default:
-                                    return widget->element_rect(aElement);
-                                }
+                            case skin_element::ClickableArea:
+                            case skin_element::CheckBox:
+                                return checkBoxRect;
+                            default:
+                                return widget->element_rect(aElement);
                             }
-                        } skinnableItem = {};
-                        skinnableItem.widget = this;
-                        skinnableItem.checkBoxRect = cell_rect(itemIndex, aGc, cell_part::CheckBox);
-                        service<i_skin_manager>().active_skin().draw_check_box(aGc, skinnableItem, presentation_model().cell_meta(itemIndex).checked);
-                    }
-                    auto const& cellImage = presentation_model().cell_image(itemIndex);
-                    if (cellImage != std::nullopt)
-                        aGc.draw_texture(cell_rect(itemIndex, aGc, cell_part::Image), *cellImage);
-                    auto cellTextRect = cell_rect(itemIndex, aGc, cell_part::Text);
+                        }
+                    } skinnableItem = {};
+                    skinnableItem.widget = this;
+                    skinnableItem.checkBoxRect = cell_rect(itemIndex, aGc, cell_part::CheckBox);
+                    // only a column too narrow for its check box needs clipping
+                    std::optional<scoped_scissor> checkBoxScissor;
+                    if (skinnableItem.checkBoxRect.right() > cellRect.right())
+                        checkBoxScissor.emplace(aGc, clipRect.intersection(cellRect));
+                    service<i_skin_manager>().active_skin().draw_check_box(aGc, skinnableItem, presentation_model().cell_meta(itemIndex).checked);
+                }
+                auto const& cellImage = presentation_model().cell_image(itemIndex);
+                if (cellImage != std::nullopt)
+                {
+                    auto const cellImageRect = cell_rect(itemIndex, aGc, cell_part::Image);
+                    std::optional<scoped_scissor> imageScissor;
+                    if (cellImageRect.right() > cellRect.right())
+                        imageScissor.emplace(aGc, clipRect.intersection(cellRect));
+                    aGc.draw_texture(cellImageRect, *cellImage);
+                }
+                {
+                    auto const cellTextRect = cell_rect(itemIndex, aGc, cell_part::Text);
                     auto const& glyphText = presentation_model().cell_glyph_text(itemIndex, aGc);
-                    aGc.draw_glyph_text(cellTextRect.top_left(), glyphText, *textColor);
+                    auto const textWidth = cellRect.right() - cellTextRect.x;
+                    auto textEnd = glyphText.cend();
+                    std::optional<scoped_scissor> textScissor;
+                    if (glyphText.extents().cx > textWidth)
+                    {
+                        // glyphs wholly past the end of the cell are not drawn; the glyph straddling it is clipped
+                        dimension x = 0.0;
+                        for (textEnd = glyphText.cbegin(); textEnd != glyphText.cend() && x < textWidth; ++textEnd)
+                            x += textEnd->advance().cx;
+                        textScissor.emplace(aGc, clipRect.intersection(cellRect));
+                    }
+                    aGc.draw_glyph_text(cellTextRect.top_left(), glyphText, glyphText.cbegin(), textEnd, *textColor);
                 }
                 if (currentCell)
                 {
-                    scoped_scissor scissor(aGc, clipRect.intersection(cellBackgroundRect));
+                    optional_color cellBackgroundColor = presentation_model().cell_color(itemIndex, color_role::Background);
+                    if (!cellBackgroundColor)
+                        cellBackgroundColor = background_color();
                     // todo: make the following optional (style-based)
                     aGc.draw_rect(cellBackgroundRect, pen{ selection_model().current_index() == editing() ? *textColor : *cellBackgroundColor });
                     if (selection_model().current_index() != editing() && has_focus())
@@ -372,6 +414,9 @@ namespace neogfx
                 }
             }
         }
+        // only the rows within a page of the viewport keep their shaped text
+        auto const visibleRows = end - first.first;
+        presentation_model().retain_glyph_text(first.first > visibleRows ? first.first - visibleRows : 0u, end + visibleRows);
     }
 
     void item_view::capture_released()
@@ -764,6 +809,11 @@ namespace neogfx
         invalidate_item(aItemIndex);
     }
 
+    void item_view::items_changed(item_presentation_model_index::row_type aFirstRow, item_presentation_model_index::row_type)
+    {
+        invalidate_item(item_presentation_model_index{ aFirstRow });
+    }
+
     void item_view::item_removed(const item_presentation_model_index& aItemIndex)
     {
         invalidate_item(aItemIndex);
@@ -797,6 +847,12 @@ namespace neogfx
         update();
     }
 
+    void item_view::items_updated()
+    {
+        update_scrollbar_visibility();
+        update();
+    }
+
     void item_view::presentation_model_added(i_item_presentation_model&)
     {
     }
@@ -58,6 +58,8 @@ namespace neogfx
         if (iOrientation != aOrientation)
         {
             iOrientation = aOrientation;
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
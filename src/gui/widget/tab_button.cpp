@@ -390,6 +390,8 @@ namespace neogfx
             if (aSelectedState)
                 iContainer.selecting_tab(*this);
             iSelectedState = aSelectedState;
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (has_layout_manager())
                 layout_manager().layout_items(true);
             update();
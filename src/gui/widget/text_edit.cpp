@@ -960,6 +960,7 @@ namespace neogfx
         if (WordWrap != aWordWrap)
         {
             WordWrap = aWordWrap;
+            iLineLayout.reset();
             refresh_columns();
         }
     }
@@ -1252,6 +1253,7 @@ namespace neogfx
         iGlyphParagraphs.clear();
         for (std::size_t i = 0; i < iGlyphColumns.size(); ++i)
             iGlyphColumns[i].lines().clear();
+        iLineLayout.reset();
     }
 
     const std::string& text_edit::text() const
@@ -1424,6 +1426,8 @@ namespace neogfx
         {
             iSizeHint = aHint;
             iHintedSize = std::nullopt;
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (has_layout_manager())
                 layout_manager().layout_items(true);
             update();
@@ -1454,6 +1458,7 @@ namespace neogfx
         if (iTabStops != newTabStops)
         {
             iTabStops = newTabStops;
+            iLineLayout.reset();
             refresh_columns();
         }
         iCalculatedTabStops.reset();
@@ -1596,22 +1601,58 @@ namespace neogfx
 
     void text_edit::refresh_paragraph(document_text::const_iterator aWhere, ptrdiff_t aDelta)
     {
-        /* simple (naive) implementation just to get things moving (so just refresh everything) ... */
-        (void)aWhere;
         graphics_context gc{ *this, graphics_context::type::Unattached };
         if (password())
             gc.set_password(true, PasswordMask.value().empty() ? "\xE2\x97\x8F"s : PasswordMask);
-        iGlyphs.clear();
-        iGlyphParagraphs.clear();
         iCharacterToParagraphCache.clear();
         iCharacterToParagraphCacheLastAccess.reset();
         iGlyphToParagraphCache.clear();
         iGlyphToParagraphCacheLastAccess.reset();
+        auto const findParagraph = [this](document_text::size_type aCharacterPos)
+        {
+            return iGlyphParagraphs.find_by_foreign_index(glyph_paragraph_index{ aCharacterPos, 0 }, [](const glyph_paragraph_index& aLhs, const glyph_paragraph_index& aRhs) { return aLhs.characters() < aRhs.characters(); }).first;
+        };
+        // only the paragraphs touched by the edit are reshaped; glyphs of the remaining paragraphs are kept
+        // as is and their positions follow from the paragraph index...
+        document_text::size_type textStart = 0;
+        document_text::size_type textEnd = iText.size();
+        document_glyphs::size_type glyphInsertPos = 0;
+        document_glyphs::size_type glyphEraseStart = 0;
+        document_glyphs::size_type glyphEraseEnd = 0;
+        auto paragraphInsertPos = iGlyphParagraphs.end();
+        bool fullRefresh = (aDelta == 0 || iGlyphParagraphs.empty() ||
+            std::prev(iGlyphParagraphs.end())->first.text_end_index() != static_cast<document_text::size_type>(static_cast<ptrdiff_t>(iText.size()) - aDelta));
+        if (!fullRefresh)
+        {
+            auto const editStart = static_cast<document_text::size_type>(aWhere - iText.begin());
+            auto const editEnd = editStart + static_cast<document_text::size_type>(aDelta < 0 ? -aDelta : 0);
+            auto first = findParagraph(editStart);
+            if (first == iGlyphParagraphs.end())
+                first = std::prev(iGlyphParagraphs.end());
+            auto stop = findParagraph(editEnd);
+            if (stop != iGlyphParagraphs.end())
+                ++stop;
+            textStart = first->first.text_start_index();
+            glyphInsertPos = first->first.start_index();
+            if (stop != iGlyphParagraphs.end())
+                textEnd = static_cast<document_text::size_type>(static_cast<ptrdiff_t>(stop->first.text_start_index()) + aDelta);
+            glyphEraseStart = glyphInsertPos;
+            glyphEraseEnd = (stop != iGlyphParagraphs.end() ? stop->first.start_index() : iGlyphs.size());
+            iGlyphs.erase(iGlyphs.begin() + glyphEraseStart, iGlyphs.begin() + glyphEraseEnd);
+            paragraphInsertPos = iGlyphParagraphs.erase(first, stop);
+        }
+        else
+        {
+            iGlyphs.clear();
+            iGlyphParagraphs.clear();
+            iLineLayout.reset();
+        }
         std::u32string paragraphBuffer;
-        auto paragraphStart = iText.begin();
+        auto paragraphStart = iText.begin() + textStart;
+        auto const regionEnd = iText.begin() + textEnd;
         auto iterColumn = iGlyphColumns.begin();
         neolib::vecarray<std::u32string::size_type, 16, -1> columnDelimiters;
-        auto fs = [this, paragraphStart, &columnDelimiters](std::u32string::size_type aSourceIndex)
+        auto fs = [this, &paragraphStart, &columnDelimiters](std::u32string::size_type aSourceIndex)
         {
             auto const& tagStyle = iText.tag(paragraphStart + aSourceIndex).style();
             std::size_t indexColumn = std::lower_bound(columnDelimiters.begin(), columnDelimiters.end(), aSourceIndex) - columnDelimiters.begin();
@@ -1623,7 +1664,7 @@ namespace neogfx
                 columnStyle.font() != std::nullopt ? columnStyle : iDefaultStyle;
             return style.font() != std::nullopt ? *style.font() : font();
         };
-        for (auto iterChar = iText.begin(); iterChar != iText.end(); ++iterChar)
+        for (auto iterChar = paragraphStart; iterChar != regionEnd; ++iterChar)
         {
             auto& column = *(iterColumn);
             auto ch = *iterChar;
@@ -1634,61 +1675,60 @@ namespace neogfx
                 continue;
             }
             bool newLine = (ch == U'\n');
-            if (newLine || iterChar == iText.end() - 1)
+            if (newLine || iterChar == regionEnd - 1)
             {
                 paragraphBuffer.assign(paragraphStart, iterChar + 1);
                 auto gt = gc.to_glyph_text(paragraphBuffer.begin(), paragraphBuffer.end(), fs);
                 if (gt.cbegin() != gt.cend())
                 {
-                    auto paragraphGlyphs = iGlyphs.insert(iGlyphs.end(), gt.cbegin(), gt.cend());
+                    auto const glyphCount = static_cast<document_glyphs::size_type>(std::distance(gt.cbegin(), gt.cend()));
+                    auto paragraphGlyphs = iGlyphs.insert(iGlyphs.begin() + glyphInsertPos, gt.cbegin(), gt.cend());
                     for (auto& newGlyph : gt)
                         iGlyphs.cache_glyph_font(newGlyph.font_id());
-                    auto newParagraph = iGlyphParagraphs.insert(iGlyphParagraphs.end(),
+                    auto newParagraph = iGlyphParagraphs.insert(paragraphInsertPos,
                         std::make_pair(
                             glyph_paragraph{ *this },
                             glyph_paragraph_index{
-                                static_cast<std::size_t>((iterChar + 1) - iText.begin()) - static_cast<std::size_t>(paragraphStart - iText.begin()),
-                                iGlyphs.size() - static_cast<std::size_t>(paragraphGlyphs - iGlyphs.begin()) }),
+                                static_cast<std::size_t>((iterChar + 1) - paragraphStart),
+                                glyphCount }),
                                 glyph_paragraphs::skip_type{ glyph_paragraph_index{}, glyph_paragraph_index{} });
                     newParagraph->first.set_self(newParagraph);
-                }
-                paragraphStart = iterChar + 1;
-                columnDelimiters.clear();
-            }
-        }
-        for (auto p = iGlyphParagraphs.begin(); p != iGlyphParagraphs.end(); ++p)
-        {
-            auto& paragraph = *p;
-            if (paragraph.first.start() == paragraph.first.end())
-                continue;
-            coordinate x = 0.0;
-            iterColumn = iGlyphColumns.begin();
-            for (auto iterGlyph = paragraph.first.start(); iterGlyph != paragraph.first.end(); ++iterGlyph)
-            {
-                auto& glyph = *iterGlyph;
-                if (iText[glyph.source().first] == iterColumn->delimiter() && iterColumn + 1 != iGlyphColumns.end())
-                {
-                    glyph.set_advance(size{});
-                    ++iterColumn;
-                    continue;
-                }
-                else if (glyph.is_whitespace())
-                {
-                    if (glyph.value() == U'\t')
-                    {
-                        auto advance = glyph.advance();
-                        advance.cx = tab_stops() - std::fmod(x, tab_stops());
-                        glyph.set_advance(advance);
-                    }
-                    else if (glyph.is_line_breaking_whitespace())
+                    coordinate x = 0.0;
+                    auto iterParagraphColumn = iGlyphColumns.begin();
+                    for (auto iterGlyph = paragraphGlyphs; iterGlyph != paragraphGlyphs + glyphCount; ++iterGlyph)
                     {
-                        glyph.set_advance(size{});
+                        auto& glyph = *iterGlyph;
+                        if (*(paragraphStart + glyph.source().first) == iterParagraphColumn->delimiter() && iterParagraphColumn + 1 != iGlyphColumns.end())
+                        {
+                            glyph.set_advance(size{});
+                            ++iterParagraphColumn;
+                            continue;
+                        }
+                        else if (glyph.is_whitespace())
+                        {
+                            if (glyph.value() == U'\t')
+                            {
+                                auto advance = glyph.advance();
+                                advance.cx = tab_stops() - std::fmod(x, tab_stops());
+                                glyph.set_advance(advance);
+                            }
+                            else if (glyph.is_line_breaking_whitespace())
+                            {
+                                glyph.set_advance(size{});
+                            }
+                        }
+                        glyph.x = x;
+                        x += glyph.advance().cx;
                     }
+                    glyphInsertPos += glyphCount;
                 }
-                glyph.x = x;
-                x += glyph.advance().cx;
+                paragraphStart = iterChar + 1;
+                iterColumn = iGlyphColumns.begin();
+                columnDelimiters.clear();
             }
         }
+        if (!fullRefresh && iLineLayout != std::nullopt)
+            iLineLayout->invalidate(glyphEraseStart, glyphEraseEnd, glyphInsertPos);
         refresh_columns();
     }
 
@@ -1702,22 +1742,74 @@ namespace neogfx
     {
         try
         {
-            /* simple (naive) implementation just to get things moving... */
             iOutOfMemory = false;
-            for (auto& column : iGlyphColumns)
-                column.lines().clear();
+            // lay out in the area available with no scrollbars visible so the result does not depend on which
+            // scrollbars happened to be shown when we were called; the passes below account for them
+            auto area = column_rect(0).extents(); // todo: columns
+            if (vertical_scrollbar().visible() && vertical_scrollbar().style() == scrollbar_style::Normal)
+                area.cx += vertical_scrollbar().width();
+            if (horizontal_scrollbar().visible() && horizontal_scrollbar().style() == scrollbar_style::Normal)
+                area.cy += horizontal_scrollbar().width();
             point pos{};
-            dimension availableWidth = column_rect(0).width(); // todo: columns
-            dimension availableHeight = column_rect(0).height();
+            dimension availableWidth = area.cx;
+            dimension availableHeight = area.cy;
             bool showVerticalScrollbar = false;
             bool showHorizontalScrollbar = false;
-            iTextExtents = size{};
             uint32_t pass = 1;
             auto iterColumn = iGlyphColumns.begin();
-            for (auto p = iGlyphParagraphs.begin(); p != iGlyphParagraphs.end();)
+            auto p = iGlyphParagraphs.begin();
+            auto stop = iGlyphParagraphs.end();
+            bool incremental = false;
+            glyph_lines relaid;
+            glyph_lines::iterator firstDirty;
+            glyph_lines::iterator firstRetained;
+            if (iLineLayout != std::nullopt && iLineLayout->area == area)
+            {
+                if (!iLineLayout->dirty)
+                    return;
+                // only the lines of the paragraphs reshaped since the last layout are laid out again, using the
+                // previous scrollbar decisions (verified once the layout is complete); the lines after them are
+                // moved by the change in glyph count and height...
+                auto& lines = iterColumn->lines();
+                auto const dirtyStart = iLineLayout->dirtyStart;
+                auto const dirtyEnd = iLineLayout->dirtyEnd;
+                auto const previousDirtyEnd = static_cast<document_glyphs::size_type>(static_cast<std::ptrdiff_t>(dirtyEnd) - iLineLayout->glyphDelta);
+                firstDirty = std::partition_point(lines.begin(), lines.end(),
+                    [&](const glyph_line& aLine) { return aLine.lineStart.first < dirtyStart; });
+                firstRetained = std::partition_point(firstDirty, lines.end(),
+                    [&](const glyph_line& aLine) { return aLine.lineStart.first < previousDirtyEnd; });
+                if (firstDirty != lines.end() || lines.empty())
+                {
+                    incremental = true;
+                    pos.y = (firstDirty != lines.end() ? firstDirty->ypos : 0.0);
+                    auto const byGlyph = [](const glyph_paragraph_index& aLhs, const glyph_paragraph_index& aRhs) { return aLhs.glyphs() < aRhs.glyphs(); };
+                    p = (dirtyStart < iGlyphs.size() ? iGlyphParagraphs.find_by_foreign_index(glyph_paragraph_index{ 0, dirtyStart }, byGlyph).first : iGlyphParagraphs.end());
+                    stop = (dirtyEnd < iGlyphs.size() ? iGlyphParagraphs.find_by_foreign_index(glyph_paragraph_index{ 0, dirtyEnd }, byGlyph).first : iGlyphParagraphs.end());
+                    // the edit moved the glyphs from dirtyStart onward so glyph iterators of the preceding lines
+                    // that refer to them are recalculated
+                    for (auto line = std::make_reverse_iterator(firstDirty); line != lines.rend() && line->lineEnd.first >= dirtyStart; ++line)
+                    {
+                        line->lineStart.second = iGlyphs.begin() + line->lineStart.first;
+                        line->lineEnd.second = iGlyphs.begin() + line->lineEnd.first;
+                    }
+                    showVerticalScrollbar = iLineLayout->verticalScrollbar;
+                    showHorizontalScrollbar = iLineLayout->horizontalScrollbar;
+                    if (showVerticalScrollbar)
+                        availableWidth -= vertical_scrollbar().width();
+                    if (showHorizontalScrollbar)
+                        availableHeight -= horizontal_scrollbar().width();
+                }
+            }
+            if (!incremental)
+            {
+                for (auto& column : iGlyphColumns)
+                    column.lines().clear();
+                iTextExtents = size{};
+            }
+            while (p != stop)
             {
                 auto& column = *iterColumn;
-                auto& lines = column.lines();
+                auto& lines = (incremental ? relaid : column.lines());
                 auto& paragraph = *p;
                 auto paragraphStart = paragraph.first.start();
                 auto paragraphEnd = paragraph.first.end();
@@ -1821,8 +1913,13 @@ namespace neogfx
                     pos.y += lines.back().extents.cy;
                     iTextExtents.cx = std::max(iTextExtents.cx, lines.back().extents.cx);
                 }
-                if (p + 1 == iGlyphParagraphs.end() && !iGlyphs.empty() && iGlyphs.back().is_line_breaking_whitespace())
+                if (!incremental && p + 1 == iGlyphParagraphs.end() && !iGlyphs.empty() && iGlyphs.back().is_line_breaking_whitespace())
                     pos.y += font().height();
+                if (incremental)
+                {
+                    ++p;
+                    continue;
+                }
                 auto next_pass = [&]()
                 {
                     if (pass <= 3)
@@ -1857,17 +1954,49 @@ namespace neogfx
                     else if (++p == iGlyphParagraphs.end())
                         next_pass();
                     break;
-                case 4:
-                    ++p;
-                    break;
                 }
             }
+            if (incremental)
+            {
+                auto& lines = iterColumn->lines();
+                if (firstRetained != lines.end())
+                {
+                    auto const yDelta = pos.y - firstRetained->ypos;
+                    auto const glyphDelta = iLineLayout->glyphDelta;
+                    auto const paragraphDelta = static_cast<std::ptrdiff_t>(stop - iGlyphParagraphs.begin()) - static_cast<std::ptrdiff_t>(firstRetained->paragraph.first);
+                    for (auto line = firstRetained; line != lines.end(); ++line)
+                    {
+                        line->paragraph.first = static_cast<glyph_paragraphs::size_type>(static_cast<std::ptrdiff_t>(line->paragraph.first) + paragraphDelta);
+                        line->lineStart.first = static_cast<document_glyphs::size_type>(static_cast<std::ptrdiff_t>(line->lineStart.first) + glyphDelta);
+                        line->lineStart.second = iGlyphs.begin() + line->lineStart.first;
+                        line->lineEnd.first = static_cast<document_glyphs::size_type>(static_cast<std::ptrdiff_t>(line->lineEnd.first) + glyphDelta);
+                        line->lineEnd.second = iGlyphs.begin() + line->lineEnd.first;
+                        line->ypos += yDelta;
+                    }
+                    pos.y = iTextExtents.cy + yDelta;
+                }
+                else if (!iGlyphs.empty() && iGlyphs.back().is_line_breaking_whitespace())
+                    pos.y += font().height();
+                lines.insert(lines.erase(firstDirty, firstRetained), relaid.begin(), relaid.end());
+                iTextExtents.cx = 0.0;
+                for (auto const& line : lines)
+                    iTextExtents.cx = std::max(iTextExtents.cx, line.extents.cx);
+            }
             iTextExtents.cy = pos.y;
+            if (incremental && (showVerticalScrollbar != (pos.y >= availableHeight) || showHorizontalScrollbar != (iTextExtents.cx > availableWidth)))
+            {
+                // the edit changed whether a scrollbar is needed so do the full layout
+                iLineLayout.reset();
+                refresh_lines();
+                return;
+            }
+            iLineLayout = line_layout{ area, showVerticalScrollbar, showHorizontalScrollbar };
         }
         catch (std::bad_alloc)
         {
             for (auto& column : iGlyphColumns)
                 column.lines().clear();
+            iLineLayout.reset();
             iOutOfMemory = true;
         }
     }
@@ -0,0 +1,601 @@
+// virtual_item_model.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/gui/widget/virtual_item_model.hpp>
+
+namespace neogfx
+{
+    virtual_item_model::virtual_item_model(i_item_data_source& aSource, item_fetch_mode aFetchMode, uint32_t aPageSize, uint32_t aMaxResidentPages) :
+        iSource{ aSource },
+        iFetchMode{ aFetchMode },
+        iPageSize{ std::max(aPageSize, 1u) },
+        iMaxResidentPages{ std::max(aMaxResidentPages, 1u) },
+        iRows{ 0u },
+        iColumnCount{ 0u },
+        iUpdateDepth{ 0u },
+        iCollecting{ false },
+        iGeneration{ 0u },
+        iStopping{ false }
+    {
+        {
+            std::lock_guard<std::mutex> lock{ iSourceMutex };
+            iRows = iSource.rows();
+            iColumnCount = iSource.columns();
+            for (item_model_index::column_type col = 0; col < iColumnCount; ++col)
+                iColumns.push_back(column_info{ iSource.column_name(col), item_cell_info{ iSource.column_data_type(col) } });
+        }
+        if (iFetchMode == item_fetch_mode::Asynchronous)
+        {
+            iCollecting = true;
+            iCollector.emplace(service<async_task>(), [this](neolib::callback_timer& aTimer)
+            {
+                collect_fetched_pages();
+                if (!iRequested.empty())
+                    aTimer.again();
+                else
+                    iCollecting = false;
+            }, 10);
+            iFetcher = std::thread{ [this]() { work(); } };
+        }
+        set_alive();
+    }
+
+    virtual_item_model::~virtual_item_model()
+    {
+        set_destroying();
+        iCollector = std::nullopt;
+        {
+            std::lock_guard<std::mutex> lock{ iMutex };
+            iStopping = true;
+        }
+        iWork.notify_all();
+        if (iFetcher.joinable())
+            iFetcher.join();
+    }
+
+    bool virtual_item_model::is_tree() const
+    {
+        return false;
+    }
+
+    uint32_t virtual_item_model::rows() const
+    {
+        return iRows;
+    }
+
+    uint32_t virtual_item_model::columns() const
+    {
+        return static_cast<uint32_t>(iColumns.size());
+    }
+
+    uint32_t virtual_item_model::columns(const item_model_index&) const
+    {
+        return iColumnCount;
+    }
+
+    const std::string& virtual_item_model::column_name(item_model_index::column_type aColumnIndex) const
+    {
+        return column(aColumnIndex).name;
+    }
+
+    void virtual_item_model::set_column_name(item_model_index::column_type aColumnIndex, const std::string& aName)
+    {
+        column(aColumnIndex).name = aName;
+        ColumnInfoChanged.trigger(aColumnIndex);
+    }
+
+    item_data_type virtual_item_model::column_data_type(item_model_index::column_type aColumnIndex) const
+    {
+        return column(aColumnIndex).info.dataType;
+    }
+
+    void virtual_item_model::set_column_data_type(item_model_index::column_type aColumnIndex, item_data_type aType)
+    {
+        column(aColumnIndex).info.dataType = aType;
+        ColumnInfoChanged.trigger(aColumnIndex);
+    }
+
+    const item_cell_data& virtual_item_model::column_min_value(item_model_index::column_type aColumnIndex) const
+    {
+        return column(aColumnIndex).info.dataMin;
+    }
+
+    void virtual_item_model::set_column_min_value(item_model_index::column_type aColumnIndex, const item_cell_data& aValue)
+    {
+        column(aColumnIndex).info.dataMin = aValue;
+        ColumnInfoChanged.trigger(aColumnIndex);
+    }
+
+    const item_cell_data& virtual_item_model::column_max_value(item_model_index::column_type aColumnIndex) const
+    {
+        return column(aColumnIndex).info.dataMax;
+    }
+
+    void virtual_item_model::set_column_max_value(item_model_index::column_type aColumnIndex, const item_cell_data& aValue)
+    {
+        column(aColumnIndex).info.dataMax = aValue;
+        ColumnInfoChanged.trigger(aColumnIndex);
+    }
+
+    const item_cell_data& virtual_item_model::column_step_value(item_model_index::column_type aColumnIndex) const
+    {
+        return column(aColumnIndex).info.dataStep;
+    }
+
+    void virtual_item_model::set_column_step_value(item_model_index::column_type aColumnIndex, const item_cell_data& aValue)
+    {
+        column(aColumnIndex).info.dataStep = aValue;
+        ColumnInfoChanged.trigger(aColumnIndex);
+    }
+
+    i_item_model::iterator virtual_item_model::index_to_iterator(const item_model_index&)
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::index_to_iterator(const item_model_index&) const
+    {
+        throw wrong_model_type();
+    }
+
+    item_model_index virtual_item_model::iterator_to_index(const_iterator) const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::begin()
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::begin() const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::end()
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::end() const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::sbegin()
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::sbegin() const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::send()
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::send() const
+    {
+        throw wrong_model_type();
+    }
+
+    bool virtual_item_model::has_children(const_iterator) const
+    {
+        throw wrong_model_type();
+    }
+
+    bool virtual_item_model::has_children(const item_model_index&) const
+    {
+        throw wrong_model_type();
+    }
+
+    bool virtual_item_model::has_parent(const_iterator) const
+    {
+        throw wrong_model_type();
+    }
+
+    bool virtual_item_model::has_parent(const item_model_index&) const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::parent(const_iterator)
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::parent(const_iterator) const
+    {
+        throw wrong_model_type();
+    }
+
+    item_model_index virtual_item_model::parent(const item_model_index&) const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::sbegin(const_iterator)
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::sbegin(const_iterator) const
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::iterator virtual_item_model::send(const_iterator)
+    {
+        throw wrong_model_type();
+    }
+
+    i_item_model::const_iterator virtual_item_model::send(const_iterator) const
+    {
+        throw wrong_model_type();
+    }
+
+    bool virtual_item_model::empty() const
+    {
+        return iRows == 0u;
+    }
+
+    void virtual_item_model::reserve(uint32_t)
+    {
+        throw read_only();
+    }
+
+    uint32_t virtual_item_model::capacity() const
+    {
+        return iRows;
+    }
+
+    i_item_model::iterator virtual_item_model::insert_item(const_iterator, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    i_item_model::iterator virtual_item_model::insert_item(const item_model_index&, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    i_item_model::iterator virtual_item_model::append_item(const_iterator, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    i_item_model::iterator virtual_item_model::append_item(const item_model_index&, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    void virtual_item_model::clear()
+    {
+        throw read_only();
+    }
+
+    i_item_model::iterator virtual_item_model::erase(const_iterator)
+    {
+        throw read_only();
+    }
+
+    void virtual_item_model::begin_update()
+    {
+        ++iUpdateDepth;
+    }
+
+    void virtual_item_model::end_update()
+    {
+        if (iUpdateDepth == 0u)
+            throw not_updating();
+        --iUpdateDepth;
+    }
+
+    bool virtual_item_model::updating() const
+    {
+        return iUpdateDepth != 0u;
+    }
+
+    void virtual_item_model::insert_cell_data(const_iterator, item_model_index::column_type, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    void virtual_item_model::insert_cell_data(const item_model_index&, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    void virtual_item_model::update_cell_data(const item_model_index&, const item_cell_data&)
+    {
+        throw read_only();
+    }
+
+    const item_cell_info& virtual_item_model::cell_info(const item_model_index& aIndex) const
+    {
+        return column(aIndex.column()).info;
+    }
+
+    const item_cell_data& virtual_item_model::cell_data(const item_model_index& aIndex) const
+    {
+        static const item_cell_data sEmpty;
+        if (aIndex.row() >= iRows || aIndex.column() >= iColumnCount)
+            return sEmpty;
+        auto const pageIndex = page_of(aIndex.row());
+        auto existing = find_page(pageIndex);
+        if (existing == nullptr)
+        {
+            if (iFetchMode == item_fetch_mode::Asynchronous)
+            {
+                request_page(pageIndex);
+                return sEmpty;
+            }
+            existing = &fetch_page(pageIndex);
+        }
+        return existing->cells[static_cast<std::size_t>(aIndex.row() - pageIndex * iPageSize) * iColumnCount + aIndex.column()];
+    }
+
+    i_item_data_source& virtual_item_model::source() const
+    {
+        return iSource;
+    }
+
+    item_fetch_mode virtual_item_model::fetch_mode() const
+    {
+        return iFetchMode;
+    }
+
+    uint32_t virtual_item_model::page_size() const
+    {
+        return iPageSize;
+    }
+
+    uint32_t virtual_item_model::max_resident_pages() const
+    {
+        return iMaxResidentPages;
+    }
+
+    void virtual_item_model::set_max_resident_pages(uint32_t aMaxResidentPages)
+    {
+        iMaxResidentPages = std::max(aMaxResidentPages, 1u);
+        evict(iMaxResidentPages);
+    }
+
+    bool virtual_item_model::resident(item_model_index::row_type aRow) const
+    {
+        return aRow < iRows && iPages.find(page_of(aRow)) != iPages.end();
+    }
+
+    void virtual_item_model::fetch(item_model_index::row_type aFirstRow, item_model_index::row_type aEndRow) const
+    {
+        aEndRow = std::min(aEndRow, iRows);
+        if (aFirstRow >= aEndRow)
+            return;
+        for (auto pageIndex = page_of(aFirstRow); pageIndex <= page_of(aEndRow - 1u); ++pageIndex)
+            if (find_page(pageIndex) == nullptr)
+                fetch_page(pageIndex);
+    }
+
+    void virtual_item_model::refresh()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ iSourceMutex };
+            iRows = iSource.rows();
+            ++iGeneration;
+        }
+        discard_pages();
+        ItemsUpdated.trigger(0u, iRows);
+    }
+
+    bool virtual_item_model::can_sort() const
+    {
+        std::lock_guard<std::mutex> lock{ iSourceMutex };
+        return iSource.can_sort();
+    }
+
+    void virtual_item_model::sort_by(const std::vector<sort>& aSortOrder)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ iSourceMutex };
+            iSource.sort_by(aSortOrder);
+            iRows = iSource.rows();
+            ++iGeneration;
+        }
+        discard_pages();
+        ItemsUpdated.trigger(0u, iRows);
+    }
+
+    bool virtual_item_model::can_filter() const
+    {
+        std::lock_guard<std::mutex> lock{ iSourceMutex };
+        return iSource.can_filter();
+    }
+
+    void virtual_item_model::filter_by(const std::vector<filter>& aFilters)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ iSourceMutex };
+            if (!iSource.can_filter())
+                throw cannot_filter();
+            iSource.filter_by(aFilters);
+            iRows = iSource.rows();
+            ++iGeneration;
+        }
+        discard_pages();
+        ItemsUpdated.trigger(0u, iRows);
+    }
+
+    const virtual_item_model::column_info& virtual_item_model::column(item_model_index::column_type aColumnIndex) const
+    {
+        if (aColumnIndex >= iColumns.size())
+            throw bad_column_index();
+        return iColumns[aColumnIndex];
+    }
+
+    virtual_item_model::column_info& virtual_item_model::column(item_model_index::column_type aColumnIndex)
+    {
+        return const_cast<column_info&>(to_const(*this).column(aColumnIndex));
+    }
+
+    virtual_item_model::page_index virtual_item_model::page_of(item_model_index::row_type aRow) const
+    {
+        return aRow / iPageSize;
+    }
+
+    uint32_t virtual_item_model::page_rows(page_index aPage) const
+    {
+        return std::min(iPageSize, iRows - aPage * iPageSize);
+    }
+
+    const virtual_item_model::page* virtual_item_model::find_page(page_index aPage) const
+    {
+        auto existing = iPages.find(aPage);
+        if (existing == iPages.end())
+            return nullptr;
+        iUsed.splice(iUsed.begin(), iUsed, existing->second.used);
+        return &existing->second;
+    }
+
+    const virtual_item_model::page& virtual_item_model::make_resident(page_index aPage, std::vector<item_cell_data>&& aCells) const
+    {
+        evict(iMaxResidentPages - 1u);
+        aCells.resize(static_cast<std::size_t>(page_rows(aPage)) * iColumnCount);
+        iUsed.push_front(aPage);
+        auto& newPage = iPages[aPage];
+        newPage.cells = std::move(aCells);
+        newPage.used = iUsed.begin();
+        iRequested.erase(aPage);
+        return newPage;
+    }
+
+    void virtual_item_model::evict(std::size_t aKeep) const
+    {
+        while (iPages.size() > aKeep)
+        {
+            iPages.erase(iUsed.back());
+            iUsed.pop_back();
+        }
+    }
+
+    const virtual_item_model::page& virtual_item_model::fetch_page(page_index aPage) const
+    {
+        std::vector<item_cell_data> cells;
+        {
+            std::lock_guard<std::mutex> lock{ iSourceMutex };
+            iSource.fetch(aPage * iPageSize, page_rows(aPage), cells);
+        }
+        return make_resident(aPage, std::move(cells));
+    }
+
+    void virtual_item_model::request_page(page_index aPage) const
+    {
+        if (!iRequested.insert(aPage).second)
+            return;
+        {
+            std::lock_guard<std::mutex> lock{ iMutex };
+            iRequests.push_front(page_request{ iGeneration, aPage, aPage * iPageSize, page_rows(aPage) });
+            // the oldest requests would be evicted again by the time they were fetched
+            while (iRequests.size() > iMaxResidentPages)
+            {
+                iRequested.erase(iRequests.back().index);
+                iRequests.pop_back();
+            }
+        }
+        iWork.notify_one();
+        if (!iCollecting)
+        {
+            iCollecting = true;
+            iCollector->again();
+        }
+    }
+
+    void virtual_item_model::collect_fetched_pages()
+    {
+        std::vector<fetched_page> fetched;
+        {
+            std::lock_guard<std::mutex> lock{ iMutex };
+            fetched.swap(iFetched);
+        }
+        for (auto& f : fetched)
+        {
+            if (f.generation != iGeneration)
+                continue;
+            if (f.cells == std::nullopt)
+            {
+                // the source failed to fetch the page; it is requested again when next needed
+                iRequested.erase(f.index);
+                continue;
+            }
+            if (iPages.find(f.index) != iPages.end())
+                continue;
+            make_resident(f.index, std::move(*f.cells));
+            auto const firstRow = f.index * iPageSize;
+            RowsFetched.trigger(firstRow, firstRow + page_rows(f.index));
+        }
+    }
+
+    void virtual_item_model::discard_pages()
+    {
+        iPages.clear();
+        iUsed.clear();
+        iRequested.clear();
+        std::lock_guard<std::mutex> lock{ iMutex };
+        iRequests.clear();
+        iFetched.clear();
+    }
+
+    void virtual_item_model::work()
+    {
+        for (;;)
+        {
+            page_request next;
+            {
+                std::unique_lock<std::mutex> lock{ iMutex };
+                iWork.wait(lock, [this]() { return iStopping || !iRequests.empty(); });
+                if (iStopping)
+                    break;
+                next = iRequests.front();
+                iRequests.pop_front();
+            }
+            fetched_page result{ next.generation, next.index };
+            {
+                std::lock_guard<std::mutex> lock{ iSourceMutex };
+                // the source has been sorted, filtered or refreshed since the request was made
+                if (next.generation != iGeneration)
+                    continue;
+                try
+                {
+                    result.cells.emplace();
+                    iSource.fetch(next.firstRow, next.rowCount, *result.cells);
+                }
+                catch (...)
+                {
+                    result.cells = std::nullopt;
+                }
+            }
+            std::lock_guard<std::mutex> lock{ iMutex };
+            iFetched.push_back(std::move(result));
+        }
+    }
+}
\ No newline at end of file
@@ -856,6 +856,8 @@ namespace neogfx
         if (SizePolicy != aSizePolicy)
         {
             SizePolicy = aSizePolicy;
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
@@ -878,6 +880,8 @@ namespace neogfx
         if (Weight != aWeight)
         {
             Weight.assign(aWeight, aUpdateLayout);
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
@@ -918,6 +922,8 @@ namespace neogfx
             if (debug() == this)
                 std::cerr << "widget::set_minimum_size(" << aMinimumSize << ", " << aUpdateLayout << ")" << std::endl;
             MinimumSize.assign(newMinimumSize, aUpdateLayout);
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
@@ -960,6 +966,8 @@ namespace neogfx
             if (debug() == this)
                 std::cerr << "widget::set_maximum_size(" << aMaximumSize << ", " << aUpdateLayout << ")" << std::endl;
             MaximumSize.assign(newMaximumSize, aUpdateLayout);
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
@@ -985,6 +993,8 @@ namespace neogfx
             if (debug() == this)
                 std::cerr << "widget::set_fixed_size(" << aFixedSize << ", " << aUpdateLayout << ")" << std::endl;
             FixedSize.assign(newFixedSize, aUpdateLayout);
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
@@ -1007,6 +1017,8 @@ namespace neogfx
         if (Padding != newPadding)
         {
             Padding = newPadding;
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (aUpdateLayout && has_layout_manager())
                 layout_manager().layout_items(true);
         }
@@ -1263,6 +1275,8 @@ namespace neogfx
         if (Font != aFont)
         {
             Font = aFont;
+            if (has_parent_layout())
+                parent_layout().invalidate_size_hints();
             if (has_layout_manager())
                 layout_manager().layout_items(true);
             update();
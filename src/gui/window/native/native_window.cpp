@@ -27,6 +27,7 @@
 #include <neogfx/gfx/i_rendering_engine.hpp>
 #include <neogfx/hid/i_surface_manager.hpp>
 #include <neogfx/hid/i_surface_window.hpp>
+#include <neogfx/gui/layout/i_layout.hpp>
 #include "native_window.hpp"
 
 namespace neogfx
@@ -380,6 +381,7 @@ namespace neogfx
     {
         surface_manager().display(surface_window()).update_dpi();
         iPixelDensityDpi = std::nullopt;
+        global_layout_state::instance().invalidate_size_hints();
         surface_window().handle_dpi_changed();
         surface_manager().dpi_changed().trigger(surface_window());
     }
@@ -22,6 +22,9 @@
 
 #include <neogfx/hid/surface_manager.hpp>
 #include <neogfx/gui/window/i_window.hpp>
+#include <neogfx/gui/layout/i_layout.hpp>
+#include <neogfx/gfx/i_texture_atlas.hpp>
+#include <neogfx/gfx/text/i_font_manager.hpp>
 #include "native/i_native_surface.hpp"
 #include "../gui/window/native/i_native_window.hpp"
 
@@ -124,6 +127,8 @@ namespace neogfx
 
     void surface_manager::layout_surfaces()
     {
+        // surfaces are laid out again when the style changes so any size hints calculated using the old style are stale
+        global_layout_state::instance().invalidate_size_hints();
         for (auto i = iSurfaces.begin(); i != iSurfaces.end(); ++i)
             (*i)->layout_surface();
     }
@@ -139,8 +144,15 @@ namespace neogfx
         if (iRenderingSurfaces || iRenderingEngine.creating_window())
             return;
         iRenderingSurfaces = true;
+        // glyphs skipped by an earlier frame because they were still being rasterized in the background are now ready
+        if (iRenderingEngine.font_manager().glyph_redraw_needed())
+            for (auto& s : iSurfaces)
+                if (s->has_native_surface())
+                    s->invalidate_surface(rect{ point{}, s->surface_size() });
         for (auto& s : iSurfaces)
             s->render_surface();
+        // every glyph drawn this frame has now been touched so cold glyphs can be safely evicted
+        iRenderingEngine.font_manager().glyph_atlas().evict();
         iRenderingSurfaces = false;
     }
 
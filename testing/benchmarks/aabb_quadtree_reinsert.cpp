@@ -0,0 +1,95 @@
+// aabb_quadtree_reinsert.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Broadphase re-insert benchmark: a few thousand 2D colliders of which a small fraction move each frame
+// (mostly within their fat AABB margin); compares a full tree rebuild per frame with dynamic_update().
+// Build against neogfx and neolib and run without arguments.
+
+#include <neogfx/neogfx.hpp>
+#include <chrono>
+#include <iostream>
+#include <neolib/core/random.hpp>
+#include <neolib/ecs/ecs.hpp>
+#include <neogfx/game/entity_archetype.hpp>
+#include <neogfx/game/box_collider.hpp>
+#include <neogfx/game/aabb_quadtree.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    constexpr std::size_t ColliderCount = 5000;
+    constexpr std::size_t FrameCount = 500;
+    constexpr ng::scalar WorldSize = 3000.0;
+    constexpr ng::scalar ColliderSize = 16.0;
+
+    void move_colliders(ng::game::i_ecs& aEcs, neolib::basic_random<ng::scalar>& aPrng, ng::scalar aJitter, ng::scalar aJumpProbability)
+    {
+        auto& colliders = aEcs.component<ng::game::box_collider_2d>();
+        for (auto entity : colliders.entities())
+        {
+            auto& collider = colliders.entity_record(entity);
+            ng::vec2 offset;
+            if (aPrng(1.0) < aJumpProbability)
+                offset = ng::vec2{ aPrng(WorldSize) - WorldSize / 2.0, aPrng(WorldSize) - WorldSize / 2.0 } - collider.currentAabb->min;
+            else
+                offset = ng::vec2{ aPrng(aJitter * 2.0) - aJitter, aPrng(aJitter * 2.0) - aJitter };
+            collider.currentAabb = ng::aabb_2d{ collider.currentAabb->min + offset, collider.currentAabb->max + offset };
+        }
+    }
+
+    template <typename Update>
+    double run(const char* aName, Update aUpdate, ng::game::aabb_quadtree<ng::game::box_collider_2d>& aTree, ng::game::i_ecs& aEcs)
+    {
+        neolib::basic_random<ng::scalar> prng{ 42 };
+        uint64_t reinserts = 0;
+        double elapsed = 0.0;
+        for (std::size_t frame = 0; frame < FrameCount; ++frame)
+        {
+            move_colliders(aEcs, prng, 1.0, 0.002);
+            auto const start = std::chrono::high_resolution_clock::now();
+            aUpdate();
+            elapsed += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            reinserts += aTree.reinsert_count();
+        }
+        std::cout << aName << ": " << elapsed / FrameCount << " ms/frame, " <<
+            static_cast<double>(reinserts) / FrameCount << " re-inserts/frame, depth " << aTree.depth() << ", nodes " << aTree.count() << std::endl;
+        return elapsed;
+    }
+}
+
+int main()
+{
+    neolib::ecs::ecs ecs{ neolib::ecs::ecs_flags::None };
+    ng::game::entity_archetype const collidable{ "Collidable", { ng::game::box_collider_2d::meta::id() } };
+    neolib::basic_random<ng::scalar> prng{ 1 };
+    for (std::size_t i = 0; i < ColliderCount; ++i)
+    {
+        auto const position = ng::vec2{ prng(WorldSize) - WorldSize / 2.0, prng(WorldSize) - WorldSize / 2.0 };
+        ecs.create_entity(collidable, ng::game::box_collider_2d{ 0ull, {}, {}, ng::aabb_2d{ position, position + ng::vec2{ ColliderSize, ColliderSize } } });
+    }
+
+    ng::game::aabb_quadtree<ng::game::box_collider_2d> tree{ ecs };
+    tree.full_update();
+    auto const full = run("full_update", [&]() { tree.full_update(); }, tree, ecs);
+    tree.full_update();
+    auto const dynamic = run("dynamic_update", [&]() { tree.dynamic_update(); }, tree, ecs);
+    std::cout << "speedup: " << full / dynamic << "x" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+// barnes_hut_gravitation.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Universal gravitation benchmark at 10k bodies: one step of the exact all-pairs solver against building
+// a barnes_hut_tree and evaluating every body's force with it for a range of opening angles.
+
+#include <neogfx/neogfx.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <neogfx/core/numerical.hpp>
+#include <neogfx/game/barnes_hut_tree.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    constexpr std::size_t BodyCount = 10000;
+    constexpr ng::scalar G = 6.67430e-11;
+
+    struct body
+    {
+        ng::vec3 position;
+        ng::scalar mass;
+    };
+
+    template <typename Step>
+    double time_ms(Step aStep)
+    {
+        auto const start = std::chrono::high_resolution_clock::now();
+        aStep();
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    std::mt19937 prng{ 42 };
+    std::uniform_real_distribution<ng::scalar> uniform{ -1000.0, 1000.0 };
+    std::uniform_real_distribution<ng::scalar> mass{ 1.0, 1.0e6 };
+    std::vector<body> bodies;
+    for (std::size_t i = 0; i < BodyCount; ++i)
+        bodies.push_back(body{ ng::vec3{ uniform(prng), uniform(prng), uniform(prng) }, mass(prng) });
+
+    std::vector<ng::vec3> exact(BodyCount);
+    auto const exactTime = time_ms([&]()
+    {
+        for (std::size_t i = 0; i < BodyCount; ++i)
+            for (auto const& other : bodies)
+            {
+                ng::vec3 const distance = bodies[i].position - other.position;
+                if (distance.magnitude() > 0.0)
+                    exact[i] += -G * other.mass * bodies[i].mass * distance / std::pow(distance.magnitude(), 3.0);
+            }
+    });
+    std::cout << "exact: " << exactTime << " ms" << std::endl;
+
+    for (auto theta : { 0.3, 0.5, 0.7, 1.0 })
+    {
+        ng::game::barnes_hut_tree tree{ theta };
+        std::vector<ng::vec3> approximate(BodyCount);
+        auto const buildTime = time_ms([&]()
+        {
+            tree.clear();
+            for (auto const& b : bodies)
+                tree.add(b.position, b.mass);
+            tree.build();
+        });
+        auto const forceTime = time_ms([&]()
+        {
+            for (std::size_t i = 0; i < BodyCount; ++i)
+                approximate[i] = tree.force(bodies[i].position, bodies[i].mass, G);
+        });
+        ng::scalar sumSquares = 0.0;
+        for (std::size_t i = 0; i < BodyCount; ++i)
+        {
+            auto const error = (approximate[i] - exact[i]).magnitude() / exact[i].magnitude();
+            sumSquares += error * error;
+        }
+        std::cout << "barnes-hut (theta " << theta << "): build " << buildTime << " ms, forces " << forceTime << " ms, " <<
+            tree.node_count() << " nodes, speedup " << exactTime / (buildTime + forceTime) << "x, RMS relative error " <<
+            std::sqrt(sumSquares / BodyCount) << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+// gaussian_blur.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// graphics_context::blur benchmark: blurs a hard edged 512x512 texture with increasing radii, reporting the
+// time per blur and the quality of the resulting edge profile along the centre row (it should fall off
+// monotonically in small steps; large steps are banding). Needs a display for the OpenGL context; build
+// against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <chrono>
+#include <iostream>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/window/window.hpp>
+#include <neogfx/gfx/texture.hpp>
+#include <neogfx/gfx/graphics_context.hpp>
+
+namespace ng = neogfx;
+using namespace ng::unit_literals;
+
+namespace
+{
+    constexpr ng::dimension Extent = 512.0;
+    constexpr uint32_t BlurCount = 50;
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "gaussian blur benchmark");
+    ng::window window{ ng::size{ 640_dip, 480_dip } };
+
+    ng::rect const area{ ng::point{}, ng::size{ Extent, Extent } };
+    ng::texture source{ area.extents(), 1.0, ng::texture_sampling::Scaled };
+    ng::texture destination{ area.extents(), 1.0, ng::texture_sampling::Scaled };
+    ng::graphics_context sourceGc{ source };
+    sourceGc.clear(ng::color{ ng::vec4{ 0.0, 0.0, 0.0, 0.0 } });
+    sourceGc.fill_rect(ng::rect{ ng::point{}, ng::size{ Extent / 2.0, Extent } }, ng::color::White);
+    ng::graphics_context destinationGc{ destination };
+
+    for (uint32_t radius : { 2u, 4u, 8u, 16u, 32u, 64u })
+    {
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < BlurCount; ++i)
+        {
+            destinationGc.clear(ng::color{ ng::vec4{ 0.0, 0.0, 0.0, 0.0 } });
+            destinationGc.blur(area, sourceGc, area, ng::blurring_algorithm::Gaussian, radius, radius / 3.0);
+        }
+        destinationGc.flush();
+        (void)destination.get_pixel(ng::point{});
+        auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / BlurCount;
+        bool monotonic = true;
+        uint32_t largestStep = 0;
+        uint32_t previous = 255;
+        for (ng::coordinate x = Extent / 2.0 - radius; x <= Extent / 2.0 + radius; x += 1.0)
+        {
+            auto const level = static_cast<uint32_t>(destination.get_pixel(ng::point{ x, Extent / 2.0 }).alpha());
+            monotonic = monotonic && level <= previous;
+            largestStep = std::max(largestStep, previous >= level ? previous - level : level - previous);
+            previous = level;
+        }
+        std::cout << "radius " << radius << ": " << elapsed << " ms/blur, edge profile " << (monotonic ? "monotonic" : "NOT monotonic") <<
+            ", largest step " << largestStep << "/255" << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+// item_sort.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Item sort benchmark: sorts a flat item model of a million rows through an item presentation model by a string
+// column, by a numeric column and by two columns (a low cardinality string column then a string or a numeric
+// column), reporting the time taken by each sort; the target is under 200 ms per sort. Rows are generated from a
+// fixed seed so runs are comparable. Build against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/widget/item_model.hpp>
+#include <neogfx/gui/widget/item_presentation_model.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    constexpr uint32_t RowCount = 1000000;
+    constexpr ng::item_presentation_model_index::column_type NameColumn = 0;
+    constexpr ng::item_presentation_model_index::column_type SizeColumn = 1;
+    constexpr ng::item_presentation_model_index::column_type CategoryColumn = 2;
+
+    typedef ng::basic_item_model<void*, 3u> item_model;
+    typedef ng::basic_item_presentation_model<item_model> item_presentation_model;
+
+    void populate(item_model& aModel)
+    {
+        std::mt19937 prng{ 42u };
+        std::uniform_int_distribution<uint32_t> nameLength{ 4u, 16u };
+        std::uniform_int_distribution<int> letter{ 0, 51 };
+        std::uniform_int_distribution<uint32_t> size{ 0u, 0xFFFFFFFFu };
+        std::uniform_int_distribution<std::size_t> category{ 0u, 15u };
+        char const* const categories[] =
+        {
+            "Alpha", "bravo", "Charlie", "delta", "Echo", "foxtrot", "Golf", "hotel",
+            "India", "juliett", "Kilo", "lima", "Mike", "november", "Oscar", "papa"
+        };
+        aModel.reserve(RowCount);
+        for (uint32_t row = 0; row < RowCount; ++row)
+        {
+            // mixed case so that comparisons have to case fold
+            std::string name;
+            for (uint32_t c = nameLength(prng); c-- > 0;)
+            {
+                auto const l = letter(prng);
+                name += static_cast<char>(l < 26 ? 'A' + l : 'a' + (l - 26));
+            }
+            aModel.insert_item(ng::item_model_index(row), name);
+            aModel.insert_cell_data(ng::item_model_index(row, SizeColumn), size(prng));
+            aModel.insert_cell_data(ng::item_model_index(row, CategoryColumn), std::string{ categories[category(prng)] });
+        }
+    }
+
+    // the presentation model is not sortable until sort_by is called so it starts unsorted and only the timed sort
+    // orders its rows; aSetup may sort first to make the timed sort a multi-column one
+    double sort_ms(item_model& aModel, ng::item_presentation_model_index::column_type aColumn, std::function<void(item_presentation_model&)> aSetup = {})
+    {
+        item_presentation_model presentationModel{ aModel };
+        if (aSetup)
+            aSetup(presentationModel);
+        auto const start = std::chrono::high_resolution_clock::now();
+        presentationModel.sort_by(aColumn, ng::i_item_presentation_model::sort_direction::Ascending);
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "item sort benchmark");
+
+    item_model model;
+    auto const populateStart = std::chrono::high_resolution_clock::now();
+    populate(model);
+    std::cout << RowCount << " rows populated in " <<
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - populateStart).count() << " ms" << std::endl;
+
+    std::cout << "single column, string: " << sort_ms(model, NameColumn) << " ms" << std::endl;
+    std::cout << "single column, numeric: " << sort_ms(model, SizeColumn) << " ms" << std::endl;
+    std::cout << "two columns, string then string: " << sort_ms(model, CategoryColumn, [](item_presentation_model& aModel)
+        { aModel.sort_by(NameColumn, ng::i_item_presentation_model::sort_direction::Ascending); }) << " ms" << std::endl;
+    std::cout << "two columns, string then numeric: " << sort_ms(model, CategoryColumn, [](item_presentation_model& aModel)
+        { aModel.sort_by(SizeColumn, ng::i_item_presentation_model::sort_direction::Ascending); }) << " ms" << std::endl;
+    std::cout << "(target: under 200 ms per sort)" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+// nested_layout.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Layout pass benchmark for a 10 level nested layout holding 5000 text widgets: times full passes (every cached
+// size hint stale, as after a style change), passes that only lay out again, passes while resizing and passes after
+// changing the text of a single widget. Build against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/window/window.hpp>
+#include <neogfx/gui/widget/widget.hpp>
+#include <neogfx/gui/widget/text_widget.hpp>
+#include <neogfx/gui/layout/horizontal_layout.hpp>
+#include <neogfx/gui/layout/vertical_layout.hpp>
+
+namespace ng = neogfx;
+using namespace ng::unit_literals;
+
+namespace
+{
+    constexpr uint32_t Depth = 10;
+    constexpr std::size_t WidgetCount = 5000;
+    constexpr uint32_t PassCount = 20;
+
+    struct nested_layout
+    {
+        std::vector<std::unique_ptr<ng::layout>> layouts;
+        std::vector<std::unique_ptr<ng::text_widget>> widgets;
+
+        ~nested_layout()
+        {
+            widgets.clear();
+            while (!layouts.empty())
+                layouts.pop_back();
+        }
+    };
+
+    // a binary tree of alternately horizontal and vertical layouts with the widgets spread evenly over its leaves
+    void build(nested_layout& aNested, ng::i_layout& aParent, uint32_t aLevel, std::size_t aFirstWidget, std::size_t aEndWidget)
+    {
+        if (aLevel == Depth)
+        {
+            for (auto w = aFirstWidget; w != aEndWidget; ++w)
+                aNested.widgets.push_back(std::make_unique<ng::text_widget>(aParent, "item " + std::to_string(w)));
+            return;
+        }
+        for (std::size_t half = 0; half < 2; ++half)
+        {
+            if (aLevel % 2 == 0)
+                aNested.layouts.push_back(std::make_unique<ng::vertical_layout>(aParent));
+            else
+                aNested.layouts.push_back(std::make_unique<ng::horizontal_layout>(aParent));
+            build(aNested, *aNested.layouts.back(), aLevel + 1,
+                aFirstWidget + (aEndWidget - aFirstWidget) * half / 2, aFirstWidget + (aEndWidget - aFirstWidget) * (half + 1) / 2);
+        }
+    }
+
+    template <typename Pass>
+    double pass_ms(Pass aPass)
+    {
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (uint32_t pass = 0; pass < PassCount; ++pass)
+            aPass(pass);
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / PassCount;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "nested layout benchmark");
+    ng::window window{ ng::size{ 1024_dip, 768_dip } };
+    ng::widget container{ window.client_layout() };
+    ng::vertical_layout root{ container };
+    nested_layout nested;
+    build(nested, root, 1, 0, WidgetCount);
+
+    auto const buildStart = std::chrono::high_resolution_clock::now();
+    window.layout_items();
+    auto const initial = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - buildStart).count();
+
+    // a style or DPI change makes every cached size hint stale
+    auto const full = pass_ms([&](uint32_t) { ng::global_layout_state::instance().invalidate_size_hints(); container.layout_items(); });
+    // nothing has changed so every size hint comes from the caches
+    auto const relayout = pass_ms([&](uint32_t) { container.layout_items(); });
+    auto const resize = pass_ms([&](uint32_t aPass) { container.resize(ng::size{ 800.0 + aPass * 4.0, 600.0 + aPass * 2.0 }); });
+    auto& changing = *nested.widgets[WidgetCount / 2];
+    // changing the minimum size of a text widget invalidates the size hints of its parent layouts only and lays out
+    // its window straight away
+    auto const leafChange = pass_ms([&](uint32_t aPass) { changing.set_text(aPass % 2 == 0 ? "a somewhat longer item" : "item"); });
+
+    std::cout << Depth << " levels, " << nested.layouts.size() + 1 << " layouts, " << WidgetCount << " widgets: initial layout " << initial <<
+        " ms, full pass " << full << " ms, unchanged pass " << relayout << " ms, resize pass " << resize << " ms, single widget change pass " << leafChange << " ms" << std::endl;
+    return 0;
+}
\ No newline at end of file
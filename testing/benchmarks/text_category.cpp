@@ -0,0 +1,177 @@
+// text_category.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Text category lookup benchmark: categorizes a mixed corpus (ASCII, Latin-1, CJK, Arabic and emoji including ZWJ
+// sequences) one code point at a time with get_text_category and with the binary search of text_category_MAP it
+// replaced, and matches the emoji sequences in the corpus by growing a reused buffer and by concatenating strings
+// as the glyph text code used to. Reports the time per code point and any disagreement between the lookups. Build
+// against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/window/window.hpp>
+#include <neogfx/gfx/text/i_font_manager.hpp>
+#include <neogfx/gfx/text/i_emoji_atlas.hpp>
+#include <neogfx/gfx/text/text_category_map.hpp>
+
+namespace ng = neogfx;
+using namespace ng::unit_literals;
+
+namespace
+{
+    constexpr std::size_t CorpusLength = 4000000;
+    constexpr uint32_t Iterations = 10;
+
+    std::u32string make_corpus()
+    {
+        std::u32string const samples[] =
+        {
+            U"The quick brown fox jumps over the lazy dog 0123456789. ",
+            U"Caf\u00E9 cr\u00E8me br\u00FBl\u00E9e, na\u00EFve fa\u00E7ade, \u00A3\u00A7\u00B1\u00BD \u00DF\u00F8\u00E5. ",
+            U"\u6F22\u5B57\u4EEE\u540D\u4EA4\u3058\u308A\u6587\u3002\u4E2D\u6587\u6587\u672C\uFF0C\uD55C\uAD6D\uC5B4\u3002 ",
+            U"\u0645\u0631\u062D\u0628\u0627 \u0628\u0627\u0644\u0639\u0627\u0644\u0645 \u0661\u0662\u0663\u060C ",
+            U"\U0001F600 \U0001F468\u200D\U0001F469\u200D\U0001F467 \U0001F3F3\uFE0F\u200D\U0001F308 \U0001F44D\U0001F3FD \u2764\uFE0F "
+        };
+        std::u32string result;
+        for (std::size_t sample = 0; result.size() < CorpusLength; ++sample)
+            result += samples[sample % (sizeof(samples) / sizeof(samples[0]))];
+        result.resize(CorpusLength);
+        return result;
+    }
+
+    // get_text_category as it was before the page table: an emoji check then a binary search of the range table
+    ng::text_category range_table_category(const ng::i_emoji_atlas& aEmojiAtlas, const char32_t* aCodePoint, const char32_t* aCodePointEnd)
+    {
+        char32_t ch = aCodePoint[0];
+        if (aEmojiAtlas.is_emoji(ch))
+        {
+            if (aCodePoint + 1 == aCodePointEnd || aCodePoint[1] != 0xEF0E)
+                return ng::text_category::Emoji;
+            return ng::text_category::LTR;
+        }
+        else if (ch == 0xFE0F || ch == 0xFE0E)
+            return ng::text_category::Control;
+        const ng::detail::text_category_MAP_VALUE_TYPE* rangeStart = std::lower_bound(
+            &ng::detail::text_category_MAP[0],
+            &ng::detail::text_category_MAP[0] + sizeof(ng::detail::text_category_MAP) / sizeof(ng::detail::text_category_MAP[0]),
+            ng::detail::text_category_MAP_VALUE_TYPE(ch, ng::text_category::Unknown),
+            [](const ng::detail::text_category_MAP_VALUE_TYPE& lhs, const ng::detail::text_category_MAP_VALUE_TYPE& rhs) -> bool
+        {
+            return lhs.first < rhs.first;
+        });
+        if (rangeStart != &ng::detail::text_category_MAP[0] && ch < rangeStart->first)
+            --rangeStart;
+        return rangeStart->second;
+    }
+
+    template <typename Lookup>
+    double categorize_ns(const std::u32string& aCorpus, Lookup aLookup, std::vector<ng::text_category>& aCategories)
+    {
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < Iterations; ++iteration)
+        {
+            auto const begin = aCorpus.data();
+            auto const end = begin + aCorpus.size();
+            for (auto codePoint = begin; codePoint != end; ++codePoint)
+                aCategories[codePoint - begin] = aLookup(codePoint, end);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / (Iterations * aCorpus.size());
+    }
+
+    // the longest emoji sequence starting at each emoji, as the glyph text code finds it
+    template <typename Match>
+    double match_ns(const std::u32string& aCorpus, const ng::i_emoji_atlas& aEmojiAtlas, Match aMatch, std::size_t& aSequences)
+    {
+        aSequences = 0;
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < Iterations; ++iteration)
+            for (std::size_t i = 0; i < aCorpus.size(); ++i)
+                if (aEmojiAtlas.is_emoji(aCorpus[i]))
+                {
+                    auto const length = aMatch(aCorpus, i);
+                    if (length > 1)
+                        ++aSequences;
+                    i += length - 1;
+                }
+        aSequences /= Iterations;
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / (Iterations * aCorpus.size());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "text category benchmark");
+    ng::window window{ ng::size{ 640_dip, 480_dip } };
+    auto const& emojiAtlas = ng::service<ng::i_font_manager>().emoji_atlas();
+
+    auto const corpus = make_corpus();
+    std::vector<ng::text_category> rangeTableCategories(corpus.size());
+    std::vector<ng::text_category> pageTableCategories(corpus.size());
+
+    auto const rangeTable = categorize_ns(corpus, [&](const char32_t* aCodePoint, const char32_t* aCodePointEnd)
+    {
+        return range_table_category(emojiAtlas, aCodePoint, aCodePointEnd);
+    }, rangeTableCategories);
+    auto const pageTable = categorize_ns(corpus, [&](const char32_t* aCodePoint, const char32_t* aCodePointEnd)
+    {
+        return ng::get_text_category(emojiAtlas, aCodePoint, aCodePointEnd);
+    }, pageTableCategories);
+    auto const mismatches = std::inner_product(rangeTableCategories.begin(), rangeTableCategories.end(), pageTableCategories.begin(), std::size_t{ 0 },
+        std::plus<std::size_t>{}, [](ng::text_category lhs, ng::text_category rhs) { return lhs != rhs ? 1u : 0u; });
+    std::cout << corpus.size() << " code points: binary search " << rangeTable << " ns/code point, page table " << pageTable <<
+        " ns/code point (" << rangeTable / pageTable << "x), " << mismatches << " mismatch(es)" << std::endl;
+
+    std::size_t concatenatedSequences = 0;
+    auto const concatenated = match_ns(corpus, emojiAtlas, [&](const std::u32string& aText, std::size_t aStart)
+    {
+        std::u32string sequence;
+        sequence += aText[aStart];
+        auto j = aStart + 1;
+        for (; j != aText.size() && emojiAtlas.is_emoji(sequence + aText[j]); ++j)
+            sequence += aText[j];
+        return j - aStart;
+    }, concatenatedSequences);
+    std::size_t reusedSequences = 0;
+    auto const reused = match_ns(corpus, emojiAtlas, [&](const std::u32string& aText, std::size_t aStart)
+    {
+        thread_local std::u32string sequence;
+        sequence.assign(1u, aText[aStart]);
+        auto j = aStart + 1;
+        for (; j != aText.size(); ++j)
+        {
+            sequence.push_back(aText[j]);
+            if (!emojiAtlas.is_emoji(sequence.data(), sequence.data() + sequence.size()))
+            {
+                sequence.pop_back();
+                break;
+            }
+        }
+        return j - aStart;
+    }, reusedSequences);
+    std::cout << "emoji sequence matching: string concatenation " << concatenated << " ns/code point (" << concatenatedSequences <<
+        " sequences), reused buffer " << reused << " ns/code point (" << reusedSequences << " sequences)" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+// text_edit_typing.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Keystroke latency benchmark for a multi-line text_edit: loads log-like documents of increasing size
+// (up to about 5 MB) and times single character insertions near the end, in the middle and at the start
+// of the document. Build against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <chrono>
+#include <iostream>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/window/window.hpp>
+#include <neogfx/gui/widget/text_edit.hpp>
+
+namespace ng = neogfx;
+using namespace ng::unit_literals;
+
+namespace
+{
+    constexpr std::size_t KeystrokeCount = 50;
+
+    std::string make_log(std::size_t aLineCount)
+    {
+        std::string result;
+        for (std::size_t line = 0; line < aLineCount; ++line)
+            result += "2020-06-01 12:00:00.000 [worker " + std::to_string(line % 16) + "] processed request " +
+                std::to_string(line) + " in " + std::to_string(line % 997) + " us; status OK\n";
+        return result;
+    }
+
+    double keystroke_ms(ng::text_edit& aTextEdit, std::size_t& aLength, double aWhere)
+    {
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (std::size_t keystroke = 0; keystroke < KeystrokeCount; ++keystroke)
+        {
+            auto const position = static_cast<ng::text_edit::position_type>(aWhere * (aLength - 1));
+            aTextEdit.insert_text(position, "x");
+            ++aLength;
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / KeystrokeCount;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "text_edit typing benchmark");
+    ng::window window{ ng::size{ 1024_dip, 768_dip } };
+    ng::text_edit textEdit{ window.client_layout() };
+    window.layout_items();
+
+    for (std::size_t lines : { 1000, 10000, 60000 })
+    {
+        auto const text = make_log(lines);
+        auto const loadStart = std::chrono::high_resolution_clock::now();
+        textEdit.set_text(text);
+        auto const loadTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+        std::size_t length = text.size();
+        auto const end = keystroke_ms(textEdit, length, 1.0);
+        auto const middle = keystroke_ms(textEdit, length, 0.5);
+        auto const start = keystroke_ms(textEdit, length, 0.0);
+        std::cout << lines << " lines (" << text.size() / 1024 << " KiB): load " << loadTime << " ms, keystroke at end " << end <<
+            " ms, middle " << middle << " ms, start " << start << " ms" << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+// text_shaping.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Text shaping benchmark: converts prose with plenty of kerning pairs to glyph text with to_glyph_text, first with
+// fonts whose faces have not shaped anything yet (every advance and kerning pair is fetched from FreeType) and then
+// again with the same, now warm, fonts (advances and kerning pairs come from the faces' metrics caches). The shaped
+// text cache is emptied before every conversion so that each one is shaped; the time taken to find text already in
+// that cache is reported for comparison. Uses only public interfaces so the same source can be built against older
+// revisions for a baseline.
+// Build against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/window/window.hpp>
+#include <neogfx/gfx/texture.hpp>
+#include <neogfx/gfx/graphics_context.hpp>
+#include <neogfx/gfx/text/font.hpp>
+#include <neogfx/gfx/text/i_font_manager.hpp>
+#include <neogfx/gfx/text/glyph_text_cache.hpp>
+
+namespace ng = neogfx;
+using namespace ng::unit_literals;
+
+namespace
+{
+    constexpr uint32_t FontCount = 8;
+    constexpr uint32_t WarmIterations = 5;
+
+    std::string make_text(std::size_t aLength)
+    {
+        std::string const paragraph =
+            "AVAST! To WAVY Tokyo, Yvonne and Vera drove a Ford. \"LTA, PAY TAXES\" read the sign; Ted's Tavern was "
+            "open, yet few were awake. Quick zephyrs blow, vexing daft Jim. The five boxing wizards jump quickly. "
+            "Typography: AT&T, VAT, W.A.Y., fj ff fi fl ffi -- 1,234,567.89 (72%) [sic] {ok} <tag/>\n";
+        std::string result;
+        while (result.size() < aLength)
+            result += paragraph;
+        result.resize(aLength);
+        return result;
+    }
+
+    double shape_ms(const ng::graphics_context& aGc, const std::string& aText, const ng::font& aFont, std::size_t& aGlyphCount, bool aShape = true)
+    {
+        if (aShape)
+            ng::service<ng::i_font_manager>().glyph_text_cache().invalidate();
+        auto const start = std::chrono::high_resolution_clock::now();
+        auto const glyphText = aGc.to_glyph_text(aText, aFont);
+        auto const time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        aGlyphCount = glyphText.size();
+        return time;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "text shaping benchmark");
+    ng::window window{ ng::size{ 640_dip, 480_dip } };
+
+    ng::texture target{ ng::size{ 64.0, 64.0 }, 1.0, ng::texture_sampling::Normal };
+    ng::graphics_context gc{ target };
+
+    // a new point size for every font (and every text length) so that each one starts with its own empty caches
+    ng::point_size nextSize = 8.0;
+
+    for (std::size_t length : { 10000, 100000, 1000000 })
+    {
+        auto const text = make_text(length);
+        std::vector<ng::font> fonts;
+        for (uint32_t f = 0; f < FontCount; ++f)
+        {
+            fonts.emplace_back(ng::font{}, ng::font_style::Normal, nextSize);
+            nextSize += 0.5;
+        }
+
+        std::size_t glyphCount = 0;
+        double uncached = 0.0;
+        for (auto const& font : fonts)
+            uncached += shape_ms(gc, text, font, glyphCount);
+        uncached /= FontCount;
+
+        double warm = 0.0;
+        for (uint32_t iteration = 0; iteration < WarmIterations; ++iteration)
+            for (auto const& font : fonts)
+                warm += shape_ms(gc, text, font, glyphCount);
+        warm /= (WarmIterations * FontCount);
+
+        for (auto const& font : fonts)
+            shape_ms(gc, text, font, glyphCount, false);
+        double cached = 0.0;
+        for (auto const& font : fonts)
+            cached += shape_ms(gc, text, font, glyphCount, false);
+        cached /= FontCount;
+
+        std::cout << text.size() / 1024 << " KiB (" << glyphCount << " glyphs): uncached " << uncached << " ms (" <<
+            uncached * 1000000.0 / glyphCount << " ns/glyph), warm " << warm << " ms (" << warm * 1000000.0 / glyphCount << " ns/glyph), " <<
+            "shaped text cache hit " << cached << " ms" << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
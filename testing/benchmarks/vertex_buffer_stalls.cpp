@@ -0,0 +1,76 @@
+// vertex_buffer_stalls.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Vertex buffer stall benchmark: renders frames of increasingly many filled rectangles (enough for the larger
+// frames to fill several regions of the vertex buffer and wrap within the frame) into an offscreen texture,
+// reporting the time per frame and how often writing vertices had to wait for the GPU. A well behaved ring
+// buffer stalls rarely, if at all, once the buffer has grown to fit a frame. Run it under Mesa's llvmpipe
+// (Mesa's opengl32.dll beside the executable) as well as on a hardware driver. Needs a display for the OpenGL
+// context; build against neogfx and neolib and run without arguments.
+
+#include <neolib/neolib.hpp>
+#include <chrono>
+#include <iostream>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gui/window/window.hpp>
+#include <neogfx/gfx/texture.hpp>
+#include <neogfx/gfx/graphics_context.hpp>
+#include <neogfx/gfx/i_rendering_engine.hpp>
+
+namespace ng = neogfx;
+using namespace ng::unit_literals;
+
+namespace
+{
+    constexpr ng::dimension Extent = 512.0;
+    constexpr uint32_t FrameCount = 100;
+}
+
+int main(int argc, char* argv[])
+{
+    ng::app app(argc, argv, "vertex buffer stall benchmark");
+    ng::window window{ ng::size{ 640_dip, 480_dip } };
+
+    ng::texture target{ ng::size{ Extent, Extent }, 1.0, ng::texture_sampling::Normal };
+    ng::graphics_context gc{ target };
+    auto& renderingEngine = ng::service<ng::i_rendering_engine>();
+
+    for (uint32_t rectsPerFrame : { 100u, 1000u, 10000u, 50000u, 200000u })
+    {
+        renderingEngine.reset_vertex_buffer_stall_count();
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < FrameCount; ++frame)
+        {
+            gc.clear(ng::color::Black);
+            for (uint32_t r = 0; r < rectsPerFrame; ++r)
+            {
+                auto const x = static_cast<ng::coordinate>((r * 7u + frame) % static_cast<uint32_t>(Extent));
+                auto const y = static_cast<ng::coordinate>((r * 13u) % static_cast<uint32_t>(Extent));
+                gc.fill_rect(ng::rect{ ng::point{ x, y }, ng::size{ 4.0, 4.0 } }, ng::color{ static_cast<uint8_t>(r), static_cast<uint8_t>(frame), 128u });
+            }
+            gc.flush();
+            renderingEngine.execute_vertex_buffers();
+        }
+        (void)target.get_pixel(ng::point{});
+        auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / FrameCount;
+        std::cout << rectsPerFrame << " rects/frame: " << elapsed << " ms/frame, " << renderingEngine.vertex_buffer_stall_count() <<
+            " stalls in " << FrameCount << " frames" << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -199,6 +199,14 @@ ng::game::i_ecs& create_game(ng::i_layout& aLayout)
             }
             if (aButton == ng::game_controller_button::LeftShoulder)
                 gameState->autoFire = !gameState->autoFire;
+            if (aButton == ng::game_controller_button::RightShoulder)
+            {
+                auto& collisionDetector = ecs.system<ng::game::collision_detector>();
+                if (collisionDetector.parallel_detection_enabled())
+                    collisionDetector.disable_parallel_detection();
+                else
+                    collisionDetector.enable_parallel_detection();
+            }
         });
     }
 
@@ -231,6 +239,8 @@ ng::game::i_ecs& create_game(ng::i_layout& aLayout)
                 }
                 debugText << "Collision tree (quadtree) nodes: " << ecs.system<ng::game::collision_detector>().broadphase_2d_tree().count() << "\n";
                 debugText << "Collision tree (quadtree) depth: " << ecs.system<ng::game::collision_detector>().broadphase_2d_tree().depth() << "\n";
+                debugText << "Collision tree (quadtree) re-inserts: " << ecs.system<ng::game::collision_detector>().broadphase_2d_tree().reinsert_count() << "\n";
+                debugText << "Collision detection: " << (ecs.system<ng::game::collision_detector>().parallel_detection_enabled() ? "parallel" : "serial") << "\n";
                 // debugText << "Collision tree (quadtree) update type: " << (spritePlane.dynamic_update_enabled() ? "dynamic" : "full") << "\n";
                 gc.draw_multiline_text(ng::point{ 64.0, 128.0 }, debugText.str(), debugFont,
                     ng::text_appearance{ ng::color::PowderBlue, ng::text_effect{ ng::text_effect_type::Outline, ng::color::Black, 2.0 } });
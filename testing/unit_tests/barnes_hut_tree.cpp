@@ -0,0 +1,120 @@
+// barnes_hut_tree.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Measures the force error of barnes_hut_tree against the exact all-pairs solver used by simple_physics.
+// Exits with a non-zero status if the error exceeds the bound for the opening angle under test.
+
+#include <neogfx/neogfx.hpp>
+#include <iostream>
+#include <random>
+#include <neogfx/core/numerical.hpp>
+#include <neogfx/game/barnes_hut_tree.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    constexpr ng::scalar G = 6.67430e-11;
+
+    struct body
+    {
+        ng::vec3 position;
+        ng::scalar mass;
+    };
+
+    std::vector<body> make_bodies(std::size_t aCount, uint32_t aSeed)
+    {
+        std::mt19937 prng{ aSeed };
+        std::uniform_real_distribution<ng::scalar> uniform{ -1000.0, 1000.0 };
+        std::normal_distribution<ng::scalar> cluster{ 0.0, 20.0 };
+        std::uniform_real_distribution<ng::scalar> mass{ 1.0, 1.0e6 };
+        std::vector<body> bodies;
+        for (std::size_t i = 0; i < aCount; ++i)
+        {
+            // a quarter of the bodies in a dense cluster off centre, the rest spread throughout the volume
+            if (i % 4 == 0)
+                bodies.push_back(body{ ng::vec3{ 300.0 + cluster(prng), -200.0 + cluster(prng), cluster(prng) }, mass(prng) });
+            else
+                bodies.push_back(body{ ng::vec3{ uniform(prng), uniform(prng), uniform(prng) }, mass(prng) });
+        }
+        return bodies;
+    }
+
+    ng::vec3 exact_force(const std::vector<body>& aBodies, const body& aBody)
+    {
+        ng::vec3 result;
+        for (auto const& other : aBodies)
+        {
+            ng::vec3 const distance = aBody.position - other.position;
+            if (distance.magnitude() > 0.0)
+                result += -G * other.mass * aBody.mass * distance / std::pow(distance.magnitude(), 3.0);
+        }
+        return result;
+    }
+
+    // returns the RMS of the per-body relative force error and the worst per-body relative error
+    std::pair<ng::scalar, ng::scalar> force_error(const std::vector<body>& aBodies, ng::scalar aTheta)
+    {
+        ng::game::barnes_hut_tree tree{ aTheta };
+        for (auto const& b : aBodies)
+            tree.add(b.position, b.mass);
+        tree.build();
+        ng::scalar sumSquares = 0.0;
+        ng::scalar worst = 0.0;
+        for (auto const& b : aBodies)
+        {
+            auto const exact = exact_force(aBodies, b);
+            auto const approximate = tree.force(b.position, b.mass, G);
+            auto const error = (approximate - exact).magnitude() / exact.magnitude();
+            sumSquares += error * error;
+            worst = std::max(worst, error);
+        }
+        return { std::sqrt(sumSquares / aBodies.size()), worst };
+    }
+
+    bool check(const char* aName, bool aPassed)
+    {
+        std::cout << (aPassed ? "PASS: " : "FAIL: ") << aName << std::endl;
+        return aPassed;
+    }
+}
+
+int main()
+{
+    bool passed = true;
+
+    // a body must never attract itself: with an opening angle large enough to accept any node the only
+    // nodes not approximated are those holding the body, so this isolates the self-interaction term
+    {
+        std::vector<body> const pair = { { ng::vec3{ 0.0, 0.0, 0.0 }, 1.0 }, { ng::vec3{ 10.0, 0.0, 0.0 }, 1000.0 } };
+        auto const [rms, worst] = force_error(pair, 1.0e9);
+        passed = check("no self attraction (two bodies, theta = 1e9)", worst < 1.0e-12) && passed;
+    }
+
+    auto const bodies = make_bodies(2000, 42);
+    struct bound { ng::scalar theta; ng::scalar rms; ng::scalar worst; };
+    for (auto const& b : { bound{ 0.0, 1.0e-12, 1.0e-10 }, bound{ 0.3, 5.0e-3, 5.0e-2 }, bound{ 0.5, 1.0e-2, 1.0e-1 }, bound{ 1.0, 5.0e-2, 5.0e-1 } })
+    {
+        auto const [rms, worst] = force_error(bodies, b.theta);
+        std::cout << "theta " << b.theta << ": RMS relative error " << rms << ", worst " << worst << std::endl;
+        passed = check("force error within bound", rms <= b.rms && worst <= b.worst) && passed;
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
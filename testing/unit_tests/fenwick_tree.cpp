@@ -0,0 +1,196 @@
+// fenwick_tree.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Unit tests for fenwick_tree (prefix sums, searching by sum and the update and splice operations used for item
+// row heights and visible tree nodes). Exits with a non-zero status if any test fails.
+
+#include <neogfx/neogfx.hpp>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <neogfx/core/fenwick_tree.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    uint32_t sFailures = 0;
+
+    void check(bool aCondition, const char* aExpression, int aLine)
+    {
+        if (!aCondition)
+        {
+            ++sFailures;
+            std::cout << "FAIL (line " << aLine << "): " << aExpression << std::endl;
+        }
+    }
+
+    #define CHECK(x) check((x), #x, __LINE__)
+
+    // compares every prefix sum, value and search result with those of a plain vector of values
+    template <typename T>
+    bool matches(const ng::fenwick_tree<T>& aTree, const std::vector<T>& aValues)
+    {
+        if (aTree.size() != aValues.size())
+            return false;
+        T sum{};
+        for (std::size_t i = 0; i < aValues.size(); ++i)
+        {
+            if (aTree.prefix_sum(i) != sum || aTree.value(i) != aValues[i])
+                return false;
+            // the element spanning a sum is the last one starting at or before it
+            if (aValues[i] != T{} && aTree.find(sum) != i)
+                return false;
+            sum += aValues[i];
+        }
+        return aTree.total() == sum && aTree.find(sum) == aValues.size();
+    }
+
+    void test_assign()
+    {
+        ng::fenwick_tree<uint32_t> tree;
+        CHECK(tree.empty());
+        CHECK(tree.total() == 0u);
+        CHECK(tree.find(0u) == 0u);
+        for (std::size_t count : { 1u, 2u, 7u, 8u, 9u, 100u })
+        {
+            tree.assign(count, 3u);
+            CHECK(matches(tree, std::vector<uint32_t>(count, 3u)));
+        }
+        std::vector<uint32_t> const values = { 5u, 0u, 2u, 0u, 0u, 7u, 1u, 1u, 4u, 0u, 3u };
+        tree.assign(values.begin(), values.end());
+        CHECK(matches(tree, values));
+        CHECK(tree.find(4u) == 0u);
+        CHECK(tree.find(5u) == 2u);
+        CHECK(tree.find(6u) == 2u);
+        CHECK(tree.find(7u) == 5u);
+        tree.clear();
+        CHECK(tree.empty());
+    }
+
+    void test_update()
+    {
+        ng::fenwick_tree<double> tree;
+        std::vector<double> values(37u, 18.0);
+        tree.assign(values.size(), 18.0);
+        // rows measured as they are scrolled into view
+        for (std::size_t row : { 0u, 1u, 2u, 20u, 36u })
+        {
+            values[row] = 35.0;
+            tree.set(row, 35.0);
+        }
+        CHECK(matches(tree, values));
+        values[20u] += 4.0;
+        tree.add(20u, 4.0);
+        CHECK(matches(tree, values));
+        // a changed row returns to the estimate until it is measured again
+        values[1u] = 18.0;
+        tree.set(1u, 18.0);
+        CHECK(matches(tree, values));
+        bool threw = false;
+        try
+        {
+            tree.set(values.size(), 1.0);
+        }
+        catch (const ng::fenwick_tree<double>::bad_index&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    void test_splice()
+    {
+        ng::fenwick_tree<uint32_t> tree;
+        std::vector<uint32_t> values = { 1u, 2u, 3u, 4u, 5u };
+        tree.assign(values.begin(), values.end());
+        tree.insert(2u, 3u, 10u);
+        values.insert(values.begin() + 2u, 3u, 10u);
+        CHECK(matches(tree, values));
+        tree.insert(0u, 1u, 7u);
+        values.insert(values.begin(), 7u);
+        CHECK(matches(tree, values));
+        tree.insert(tree.size(), 2u, 0u);
+        values.insert(values.end(), 2u, 0u);
+        CHECK(matches(tree, values));
+        tree.erase(1u, 4u);
+        values.erase(values.begin() + 1u, values.begin() + 4u);
+        CHECK(matches(tree, values));
+        tree.erase(0u, tree.size());
+        CHECK(tree.empty());
+        tree.insert(0u, 4u, 1u);
+        CHECK(matches(tree, std::vector<uint32_t>(4u, 1u)));
+    }
+
+    void test_against_model()
+    {
+        // random updates and splices checked against a plain vector of values
+        std::mt19937 prng{ 19 };
+        ng::fenwick_tree<uint32_t> tree;
+        std::vector<uint32_t> values;
+        for (int step = 0; step < 5000; ++step)
+        {
+            switch (prng() % 4)
+            {
+            case 0:
+                {
+                    auto const index = prng() % (values.size() + 1u);
+                    auto const count = prng() % 8u;
+                    auto const value = prng() % 3u;
+                    tree.insert(index, count, value);
+                    values.insert(values.begin() + index, count, value);
+                }
+                break;
+            case 1:
+                if (!values.empty())
+                {
+                    auto const first = prng() % values.size();
+                    auto const last = first + prng() % (values.size() - first + 1u) / 4u;
+                    tree.erase(first, last);
+                    values.erase(values.begin() + first, values.begin() + last);
+                }
+                break;
+            default:
+                if (!values.empty())
+                {
+                    auto const index = prng() % values.size();
+                    auto const value = prng() % 50u;
+                    tree.set(index, value);
+                    values[index] = value;
+                }
+                break;
+            }
+            CHECK(matches(tree, values));
+            if (sFailures != 0)
+                return;
+        }
+    }
+}
+
+int main()
+{
+    test_assign();
+    test_update();
+    test_splice();
+    test_against_model();
+    if (sFailures == 0)
+        std::cout << "PASS" << std::endl;
+    return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
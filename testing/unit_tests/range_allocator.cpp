@@ -0,0 +1,210 @@
+// range_allocator.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Unit tests for range_allocator (allocation, freeing, coalescing and reclaiming space); build together
+// with src/gfx/range_allocator.cpp. Exits with a non-zero status if any test fails.
+
+#include <neogfx/neogfx.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <neogfx/gfx/range_allocator.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    uint32_t sFailures = 0;
+
+    void check(bool aCondition, const char* aExpression, int aLine)
+    {
+        if (!aCondition)
+        {
+            ++sFailures;
+            std::cout << "FAIL (line " << aLine << "): " << aExpression << std::endl;
+        }
+    }
+
+    #define CHECK(x) check((x), #x, __LINE__)
+
+    void test_allocate()
+    {
+        ng::range_allocator allocator;
+        CHECK(allocator.empty());
+        CHECK(allocator.allocate(1) == std::nullopt);
+        allocator.deallocate(100, 200);
+        CHECK(!allocator.empty());
+        CHECK(allocator.free_space() == 100);
+        CHECK(allocator.allocate(0) == std::nullopt);
+        CHECK(allocator.allocate(101) == std::nullopt);
+        CHECK(allocator.allocate(30) == std::optional<std::size_t>{ 100 });
+        CHECK(allocator.free_space() == 70);
+        CHECK(allocator.free_range_count() == 1);
+        CHECK(allocator.allocate(70) == std::optional<std::size_t>{ 130 });
+        CHECK(allocator.empty());
+        CHECK(allocator.free_space() == 0);
+    }
+
+    void test_best_fit()
+    {
+        ng::range_allocator allocator;
+        allocator.deallocate(0, 50);
+        allocator.deallocate(100, 110);
+        allocator.deallocate(200, 220);
+        CHECK(allocator.free_range_count() == 3);
+        CHECK(allocator.largest_free_range() == 50);
+        // the smallest range that fits is chosen, leaving the larger ranges intact
+        CHECK(allocator.allocate(10) == std::optional<std::size_t>{ 100 });
+        CHECK(allocator.allocate(15) == std::optional<std::size_t>{ 200 });
+        CHECK(allocator.free_range_count() == 2);
+        CHECK(allocator.allocate(5) == std::optional<std::size_t>{ 215 });
+        CHECK(allocator.allocate(40) == std::optional<std::size_t>{ 0 });
+        CHECK(allocator.free_space() == 10);
+    }
+
+    void test_coalesce()
+    {
+        ng::range_allocator allocator;
+        allocator.deallocate(10, 20);
+        allocator.deallocate(30, 40);
+        CHECK(allocator.free_range_count() == 2);
+        CHECK(allocator.fragmentation() == 0.5);
+        // adjacent on the left
+        allocator.deallocate(40, 50);
+        CHECK(allocator.free_range_count() == 2);
+        CHECK(allocator.largest_free_range() == 20);
+        // adjacent on the right
+        allocator.deallocate(0, 10);
+        CHECK(allocator.free_range_count() == 2);
+        // bridging both neighbours
+        allocator.deallocate(20, 30);
+        CHECK(allocator.free_range_count() == 1);
+        CHECK(allocator.free_space() == 50);
+        CHECK(allocator.largest_free_range() == 50);
+        CHECK(allocator.fragmentation() == 0.0);
+        CHECK(allocator.allocate(50) == std::optional<std::size_t>{ 0 });
+    }
+
+    void test_overlapping_free()
+    {
+        ng::range_allocator allocator;
+        allocator.deallocate(0, 10);
+        allocator.deallocate(5, 15);
+        CHECK(allocator.free_range_count() == 1);
+        CHECK(allocator.free_space() == 15);
+        allocator.deallocate(2, 8);
+        CHECK(allocator.free_space() == 15);
+        allocator.deallocate(20, 20);
+        allocator.deallocate(30, 25);
+        CHECK(allocator.free_range_count() == 1);
+    }
+
+    void test_reclaim()
+    {
+        // reclaimed ranges are handed out again before any new space is used and clear() forgets them
+        ng::range_allocator allocator;
+        std::vector<std::pair<std::size_t, std::size_t>> cached = { { 0, 36 }, { 36, 72 }, { 72, 90 }, { 90, 144 } };
+        allocator.deallocate(cached[1].first, cached[1].second);
+        allocator.deallocate(cached[2].first, cached[2].second);
+        CHECK(allocator.free_range_count() == 1);
+        CHECK(allocator.allocate(54) == std::optional<std::size_t>{ 36 });
+        CHECK(allocator.empty());
+        allocator.deallocate(cached[0].first, cached[0].second);
+        allocator.deallocate(cached[3].first, cached[3].second);
+        CHECK(allocator.free_space() == 90);
+        allocator.clear();
+        CHECK(allocator.empty());
+        CHECK(allocator.free_space() == 0);
+        CHECK(allocator.largest_free_range() == 0);
+        CHECK(allocator.allocate(1) == std::nullopt);
+    }
+
+    void test_against_model()
+    {
+        // random allocate/free sequences checked against a simple occupancy map
+        constexpr std::size_t Space = 4096;
+        std::mt19937 prng{ 7 };
+        ng::range_allocator allocator;
+        std::vector<bool> free(Space, true);
+        allocator.deallocate(0, Space);
+        std::vector<std::pair<std::size_t, std::size_t>> allocated;
+        for (int step = 0; step < 20000; ++step)
+        {
+            if (allocated.empty() || prng() % 2 == 0)
+            {
+                auto const count = 1 + prng() % 64;
+                auto const start = allocator.allocate(count);
+                std::size_t best = Space + 1;
+                std::size_t run = 0;
+                for (std::size_t i = 0; i <= Space; ++i)
+                {
+                    if (i < Space && free[i])
+                        ++run;
+                    else
+                    {
+                        if (run >= count && run < best)
+                            best = run;
+                        run = 0;
+                    }
+                }
+                CHECK(start.has_value() == (best <= Space));
+                if (!start)
+                    continue;
+                for (std::size_t i = *start; i < *start + count; ++i)
+                {
+                    CHECK(free[i]);
+                    free[i] = false;
+                }
+                allocated.emplace_back(*start, *start + count);
+            }
+            else
+            {
+                auto const victim = prng() % allocated.size();
+                for (std::size_t i = allocated[victim].first; i < allocated[victim].second; ++i)
+                    free[i] = true;
+                allocator.deallocate(allocated[victim].first, allocated[victim].second);
+                allocated.erase(allocated.begin() + victim);
+            }
+            std::size_t freeSpace = 0;
+            std::size_t ranges = 0;
+            for (std::size_t i = 0; i < Space; ++i)
+            {
+                freeSpace += free[i] ? 1 : 0;
+                ranges += (free[i] && (i == 0 || !free[i - 1])) ? 1 : 0;
+            }
+            CHECK(allocator.free_space() == freeSpace);
+            CHECK(allocator.free_range_count() == ranges);
+            if (sFailures != 0)
+                return;
+        }
+    }
+}
+
+int main()
+{
+    test_allocate();
+    test_best_fit();
+    test_coalesce();
+    test_overlapping_free();
+    test_reclaim();
+    test_against_model();
+    if (sFailures == 0)
+        std::cout << "PASS" << std::endl;
+    return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+// software_renderer.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Pixel tests for the software renderer: draws into an offscreen texture with the headless software rendering
+// engine (the --software program option) and compares the pixels written with the pixels expected. Needs no
+// display; build against neogfx and neolib and run without arguments. Exits with a non-zero status if any test
+// fails.
+
+#include <neolib/neolib.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <neogfx/app/app.hpp>
+#include <neogfx/gfx/image.hpp>
+#include <neogfx/gfx/texture.hpp>
+#include <neogfx/gfx/graphics_context.hpp>
+#include <neogfx/gfx/i_rendering_engine.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    constexpr ng::dimension Extent = 64.0;
+
+    uint32_t sFailures = 0;
+
+    void check(bool aCondition, const char* aExpression, int aLine)
+    {
+        if (!aCondition)
+        {
+            ++sFailures;
+            std::cout << "FAIL (line " << aLine << "): " << aExpression << std::endl;
+        }
+    }
+
+    #define CHECK(x) check((x), #x, __LINE__)
+
+    // render targets are read from the bottom row up; the tests address pixels from the top row down
+    ng::color pixel(const ng::texture& aTarget, int32_t aX, int32_t aY)
+    {
+        return aTarget.native_texture()->read_pixel(ng::point{ static_cast<ng::coordinate>(aX), Extent - 1.0 - aY });
+    }
+
+    // allows for rounding when blended values are quantized to eight bits
+    bool matches(const ng::color& aActual, const ng::color& aExpected, int aTolerance = 1)
+    {
+        return std::abs(static_cast<int>(aActual.red()) - static_cast<int>(aExpected.red())) <= aTolerance &&
+            std::abs(static_cast<int>(aActual.green()) - static_cast<int>(aExpected.green())) <= aTolerance &&
+            std::abs(static_cast<int>(aActual.blue()) - static_cast<int>(aExpected.blue())) <= aTolerance &&
+            std::abs(static_cast<int>(aActual.alpha()) - static_cast<int>(aExpected.alpha())) <= aTolerance;
+    }
+
+    void test_clear_and_fill(ng::texture& aTarget, ng::graphics_context& aGc)
+    {
+        aGc.clear(ng::color::Black);
+        aGc.fill_rect(ng::rect{ ng::point{ 8.0, 8.0 }, ng::size{ 16.0, 16.0 } }, ng::color::Red);
+        aGc.flush();
+        CHECK(matches(pixel(aTarget, 0, 0), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 63, 63), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 8, 8), ng::color::Red));
+        CHECK(matches(pixel(aTarget, 23, 23), ng::color::Red));
+        CHECK(matches(pixel(aTarget, 7, 8), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 24, 23), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 8, 24), ng::color::Black));
+    }
+
+    void test_line(ng::texture& aTarget, ng::graphics_context& aGc)
+    {
+        aGc.clear(ng::color::Black);
+        aGc.draw_line(ng::point{ 0.0, 40.0 }, ng::point{ 63.0, 40.0 }, ng::pen{ ng::color::Green, 2.0 });
+        aGc.flush();
+        CHECK(matches(pixel(aTarget, 32, 39), ng::color::Green));
+        CHECK(matches(pixel(aTarget, 32, 40), ng::color::Green));
+        CHECK(matches(pixel(aTarget, 0, 40), ng::color::Green));
+        CHECK(matches(pixel(aTarget, 32, 38), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 32, 41), ng::color::Black));
+    }
+
+    void test_circle(ng::texture& aTarget, ng::graphics_context& aGc)
+    {
+        aGc.clear(ng::color::Black);
+        aGc.fill_circle(ng::point{ 48.0, 16.0 }, 8.0, ng::color::Blue);
+        aGc.flush();
+        CHECK(matches(pixel(aTarget, 48, 16), ng::color::Blue));
+        CHECK(matches(pixel(aTarget, 42, 16), ng::color::Blue));
+        CHECK(matches(pixel(aTarget, 48, 21), ng::color::Blue));
+        CHECK(matches(pixel(aTarget, 41, 9), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 48, 25), ng::color::Black));
+        // edge pixels are partially covered
+        auto const edge = pixel(aTarget, 48, 8);
+        CHECK(edge.blue() > 0 && edge.blue() < 255);
+    }
+
+    void test_texture(ng::texture& aTarget, ng::graphics_context& aGc)
+    {
+        ng::image source{ ng::size{ 4.0, 4.0 }, ng::color::White, 1.0, ng::texture_sampling::Nearest };
+        source.set_pixel(ng::point{ 0.0, 0.0 }, ng::color::Red);
+        source.set_pixel(ng::point{ 3.0, 3.0 }, ng::color::Blue);
+        ng::texture const texture{ source };
+        aGc.clear(ng::color::Black);
+        aGc.draw_texture(ng::point{ 8.0, 48.0 }, texture);
+        aGc.flush();
+        CHECK(matches(pixel(aTarget, 8, 48), ng::color::Red));
+        CHECK(matches(pixel(aTarget, 11, 51), ng::color::Blue));
+        CHECK(matches(pixel(aTarget, 9, 49), ng::color::White));
+        CHECK(matches(pixel(aTarget, 11, 48), ng::color::White));
+        CHECK(matches(pixel(aTarget, 12, 48), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 8, 52), ng::color::Black));
+    }
+
+    void test_blending(ng::texture& aTarget, ng::graphics_context& aGc)
+    {
+        aGc.clear(ng::color::Black);
+        aGc.fill_rect(ng::rect{ ng::point{ 30.0, 50.0 }, ng::size{ 10.0, 10.0 } }, ng::color::White.with_alpha(0.5));
+        aGc.flush();
+        CHECK(matches(pixel(aTarget, 35, 55), ng::color{ 128, 128, 128, 255 }, 2));
+        CHECK(matches(pixel(aTarget, 29, 55), ng::color::Black));
+    }
+
+    void test_scissor(ng::texture& aTarget, ng::graphics_context& aGc)
+    {
+        aGc.clear(ng::color::Black);
+        aGc.scissor_on(ng::rect{ ng::point{ 0.0, 0.0 }, ng::size{ 4.0, 4.0 } });
+        aGc.fill_rect(ng::rect{ ng::point{ 0.0, 0.0 }, ng::size{ Extent, Extent } }, ng::color::Magenta);
+        aGc.scissor_off();
+        aGc.flush();
+        CHECK(matches(pixel(aTarget, 2, 2), ng::color::Magenta));
+        CHECK(matches(pixel(aTarget, 3, 3), ng::color::Magenta));
+        CHECK(matches(pixel(aTarget, 4, 3), ng::color::Black));
+        CHECK(matches(pixel(aTarget, 3, 4), ng::color::Black));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    char software[] = "--software";
+    char* args[] = { argv[0], software, nullptr };
+    ng::app app(2, args, "software renderer unit tests");
+    if (ng::service<ng::i_rendering_engine>().renderer() != ng::renderer::Software)
+    {
+        std::cout << "FAIL: software renderer not selected" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ng::texture target{ ng::size{ Extent, Extent }, 1.0, ng::texture_sampling::Normal };
+    ng::graphics_context gc{ target };
+
+    test_clear_and_fill(target, gc);
+    test_line(target, gc);
+    test_circle(target, gc);
+    test_texture(target, gc);
+    test_blending(target, gc);
+    test_scissor(target, gc);
+
+    if (sFailures == 0)
+        std::cout << "PASS" << std::endl;
+    return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
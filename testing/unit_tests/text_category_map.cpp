@@ -0,0 +1,99 @@
+// text_category_map.cpp
+/*
+  neogfx C++ App/Game Engine
+  Copyright (c) 2020 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Unit tests for the page table behind get_text_category: every code point must have the category the range
+// table (text_category_MAP) gives it when binary searched. Header only; build against neogfx and neolib. Exits
+// with a non-zero status if any test fails.
+
+#include <neogfx/neogfx.hpp>
+#include <algorithm>
+#include <iostream>
+#include <neogfx/gfx/text/text_category_map.hpp>
+
+namespace ng = neogfx;
+
+namespace
+{
+    uint32_t sFailures = 0;
+
+    void check(bool aCondition, const char* aExpression, int aLine)
+    {
+        if (!aCondition)
+        {
+            ++sFailures;
+            std::cout << "FAIL (line " << aLine << "): " << aExpression << std::endl;
+        }
+    }
+
+    #define CHECK(x) check((x), #x, __LINE__)
+
+    // the binary search get_text_category used before the page table
+    ng::text_category range_table_category(char32_t aCodePoint)
+    {
+        auto const mapBegin = &ng::detail::text_category_MAP[0];
+        auto const mapEnd = mapBegin + sizeof(ng::detail::text_category_MAP) / sizeof(ng::detail::text_category_MAP[0]);
+        auto rangeStart = std::lower_bound(mapBegin, mapEnd, ng::detail::text_category_MAP_VALUE_TYPE(aCodePoint, ng::text_category::Unknown),
+            [](const ng::detail::text_category_MAP_VALUE_TYPE& lhs, const ng::detail::text_category_MAP_VALUE_TYPE& rhs) -> bool
+        {
+            return lhs.first < rhs.first;
+        });
+        if (rangeStart != mapBegin && (rangeStart == mapEnd || aCodePoint < rangeStart->first))
+            --rangeStart;
+        return rangeStart->second;
+    }
+
+    void test_known_categories()
+    {
+        auto const& table = ng::detail::text_category_table::instance();
+        CHECK(table[U'\t'] == ng::text_category::Whitespace);
+        CHECK(table[U' '] == ng::text_category::Whitespace);
+        CHECK(table[U'0'] == ng::text_category::Digit);
+        CHECK(table[U'A'] == ng::text_category::LTR);
+        CHECK(table[0x00300] == ng::text_category::Mark);
+        CHECK(table[0x00378] == ng::text_category::Unknown);
+        CHECK(table[0x0058A] == ng::text_category::None);
+        CHECK(table[0x005BE] == ng::text_category::RTL);
+        CHECK(table[0x10FFFD] == ng::text_category::LTR);
+        CHECK(table[0x110000] == ng::text_category::Unknown);
+    }
+
+    void test_every_code_point()
+    {
+        auto const& table = ng::detail::text_category_table::instance();
+        uint32_t mismatches = 0;
+        for (char32_t codePoint = 0; codePoint <= 0x10FFFD; ++codePoint)
+        {
+            if (table[codePoint] != range_table_category(codePoint))
+            {
+                if (++mismatches <= 10)
+                    std::cout << "mismatch at U+" << std::hex << static_cast<uint32_t>(codePoint) << std::dec << std::endl;
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+int main()
+{
+    test_known_categories();
+    test_every_code_point();
+    if (sFailures == 0)
+        std::cout << "PASS" << std::endl;
+    return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file